@@ -0,0 +1,523 @@
+"""
+export_model.py
+
+Trains the int8 obstacle classifier and writes it into the firmware:
+  src/main/model_data.cpp  TFLite flatbuffer plus the feature scaler
+  src/main/model_ops.h     TFLite Micro ops the flatbuffer uses
+
+Features are computed exactly like AIClassifier::extractFeatures, in
+firmware units, so the scaler and the model see what the cane sees.
+The flatbuffer is written directly against the TFLite schema (v3), so
+only numpy and flatbuffers are needed:
+
+  pip install numpy flatbuffers
+  python3 export_model.py [--data ../data/obstacle_data]
+
+Recordings are CSV files in <data>/<type>/*.csv with lower_distance and
+upper_distance columns in cm, one row per 10 Hz classifier step. Without
+recordings the model is trained on simulated traces that follow the
+firmware's heuristic rules, which keeps the model and the fallback in
+agreement until real data is collected.
+"""
+
+import argparse
+import glob
+import os
+
+import flatbuffers
+import numpy as np
+
+# Must match the firmware (AIClassifier.h, SlidingDft.h, ObstacleTypes.h)
+SENSORS = 2
+SPECTRAL_BANDS = 4
+FEATURE_COUNT = (5 + SPECTRAL_BANDS) * SENSORS
+WINDOW = 8
+SAMPLE_HZ = 10.0
+SPECTRAL_WINDOW = 64
+SPECTRAL_BINS = SPECTRAL_WINDOW // 4
+SDFT_MIN_POWER = 0.25
+MAX_DISTANCE_CM = 400.0
+OBSTACLE_TYPES = ['wall', 'person', 'chair', 'table', 'stairs', 'door', 'pole', 'other']
+
+HIDDEN = 32
+WINDOW_STRIDE = 2   # Steps between training windows of one trace
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+MAIN = os.path.join(HERE, '..', 'main')
+
+# TFLite schema constants
+TENSOR_INT32 = 2
+TENSOR_INT8 = 9
+OP_FULLY_CONNECTED = 9
+OP_SOFTMAX = 25
+OPTIONS_FULLY_CONNECTED = 8
+OPTIONS_SOFTMAX = 9
+ACTIVATION_NONE = 0
+ACTIVATION_RELU = 1
+
+# MicroMutableOpResolver::Add<Name>() for each builtin the exporter emits
+RESOLVER_NAMES = {OP_FULLY_CONNECTED: 'FullyConnected', OP_SOFTMAX: 'Softmax'}
+
+
+# ---------------------------------------------------------------------------
+# Features
+
+def extract_features(distances):
+    """Feature columns of one trace, shape (steps, FEATURE_COUNT).
+
+    distances has shape (steps, SENSORS) in cm. Layout as in SensorArray.h:
+    [distance x N][height difference x N-1][average][rate x N][variance x N][frequency x N]
+    [band energy x SPECTRAL_BANDS, per sensor]
+    """
+    d = np.asarray(distances, dtype=np.float64)
+    steps = len(d)
+    n = SENSORS
+    features = np.zeros((steps, FEATURE_COUNT))
+
+    features[:, 0:n] = d
+    features[:, n:2 * n - 1] = np.abs(d[:, :1] - d[:, 1:])
+    features[:, 2 * n - 1] = d.mean(axis=1)
+    features[1:, 2 * n:3 * n] = d[:-1] - d[1:]   # Previous minus current
+
+    # Population variance over the window including this step (FeatureWindow)
+    for t in range(steps):
+        window = d[max(0, t - WINDOW + 1):t + 1]
+        features[t, 3 * n:4 * n] = window.var(axis=0)
+
+    # Dominant frequency and band energies of the last SPECTRAL_WINDOW
+    # samples (SlidingDft), the history starts out filled with the first sample
+    padded = np.vstack([np.repeat(d[:1], SPECTRAL_WINDOW - 1, axis=0), d])
+    bins = np.arange(1, SPECTRAL_BINS + 1)
+    phase = np.exp(-2j * np.pi * np.outer(bins, np.arange(SPECTRAL_WINDOW)) / SPECTRAL_WINDOW)
+    for t in range(steps):
+        history = padded[t:t + SPECTRAL_WINDOW]
+        power = np.abs(phase @ history / SPECTRAL_WINDOW) ** 2
+        for s in range(n):
+            best = np.argmax(power[:, s])
+            if power[best, s] > SDFT_MIN_POWER:
+                features[t, 4 * n + s] = bins[best] * SAMPLE_HZ / SPECTRAL_WINDOW
+            bands = power[:, s].reshape(SPECTRAL_BANDS, -1).sum(axis=1)
+            features[t, 5 * n + s * SPECTRAL_BANDS:5 * n + (s + 1) * SPECTRAL_BANDS] = bands
+    return features
+
+
+def windows(features):
+    """Model inputs of one trace, oldest step first, shape (count, WINDOW, FEATURE_COUNT)."""
+    starts = range(0, len(features) - WINDOW + 1, WINDOW_STRIDE)
+    return np.array([features[i:i + WINDOW] for i in starts])
+
+
+# ---------------------------------------------------------------------------
+# Data
+
+def load_recordings(data_root):
+    """Distance traces per class from CSV recordings, empty if there are none."""
+    traces = []
+    for label, name in enumerate(OBSTACLE_TYPES):
+        for path in sorted(glob.glob(os.path.join(data_root, name, '*.csv'))):
+            rows = np.genfromtxt(path, delimiter=',', names=True)
+            d = np.column_stack([rows['lower_distance'], rows['upper_distance']])
+            d = np.clip(np.nan_to_num(d, nan=MAX_DISTANCE_CM), 0, MAX_DISTANCE_CM)
+            if len(d) >= WINDOW:
+                traces.append((d, label))
+    return traces
+
+
+def simulate_trace(label, rng, steps=200):
+    """Lower and upper distances of one simulated approach, in cm."""
+    t = np.arange(steps) / SAMPLE_HZ
+    approach = rng.uniform(0, 3) * t / t[-1]   # Slow drift while walking up
+    name = OBSTACLE_TYPES[label]
+
+    if name == 'wall':
+        lower = rng.uniform(22, 45) + approach
+        upper = lower + rng.uniform(-3, 3)
+        noise = 0.7
+    elif name == 'person':
+        base = rng.uniform(60, 180)
+        amplitude = rng.uniform(6, 10)
+        hz = rng.uniform(0.8, 2.0)
+        lower = base + approach + amplitude * np.sin(2 * np.pi * hz * t + rng.uniform(0, 6.3))
+        upper = base + rng.uniform(-20, 20) + 0.4 * amplitude * np.sin(2 * np.pi * hz * t)
+        noise = 1.0
+    elif name == 'chair':
+        lower = rng.uniform(35, 75) + approach
+        upper = lower + rng.uniform(35, 75)
+        noise = 1.0
+    elif name == 'table':
+        lower = rng.uniform(30, 65) + approach
+        upper = rng.uniform(160, 300) + approach
+        noise = 1.5
+    elif name == 'stairs':
+        riser = rng.uniform(15, 20)
+        period = rng.uniform(0.8, 1.6)
+        lower = rng.uniform(45, 60) + riser * np.floor((t % (3 * period)) / period)
+        upper = rng.uniform(55, 95) + approach
+        noise = 1.0
+    elif name == 'door':
+        lower = rng.uniform(55, 115) + approach
+        upper = lower + rng.uniform(-15, 15)
+        noise = 0.8
+    elif name == 'pole':
+        lower = rng.uniform(12, 28) + 0.3 * approach
+        upper = rng.uniform(85, 145) + approach
+        noise = 0.8
+    else:
+        # Open space, clutter and reflections that match no rule
+        lower = rng.uniform(150, MAX_DISTANCE_CM) + 20 * np.sin(2 * np.pi * rng.uniform(0.1, 0.4) * t)
+        upper = rng.uniform(150, MAX_DISTANCE_CM) + approach
+        noise = 4.0
+
+    d = np.column_stack([np.broadcast_to(lower, t.shape), np.broadcast_to(upper, t.shape)])
+    d = d + rng.normal(0, noise, d.shape)
+
+    # Missed echoes read as maximum range
+    d[rng.random(d.shape) < 0.01] = MAX_DISTANCE_CM
+    return np.clip(d, 2, MAX_DISTANCE_CM)
+
+
+def simulate_traces(per_class, seed):
+    rng = np.random.default_rng(seed)
+    return [(simulate_trace(label, rng), label)
+            for label in range(len(OBSTACLE_TYPES)) for _ in range(per_class)]
+
+
+def build_dataset(traces):
+    x, y = [], []
+    for distances, label in traces:
+        w = windows(extract_features(distances))
+        x.append(w)
+        y.append(np.full(len(w), label))
+    return np.concatenate(x), np.concatenate(y)
+
+
+# ---------------------------------------------------------------------------
+# Training
+
+def fit_scaler(x):
+    """Per-feature mean and standard deviation over all time steps."""
+    flat = x.reshape(-1, FEATURE_COUNT)
+    mean = flat.mean(axis=0)
+    std = flat.std(axis=0)
+    std[std < 1e-6] = 1.0
+    return mean, std
+
+
+def train(x, y, epochs=40, batch=128, rate=2e-3, seed=1):
+    """Dense(HIDDEN, relu) and Dense(classes, softmax) trained with Adam."""
+    rng = np.random.default_rng(seed)
+    inputs = x.shape[1]
+    classes = len(OBSTACLE_TYPES)
+    params = {
+        'w1': rng.normal(0, np.sqrt(2.0 / inputs), (inputs, HIDDEN)),
+        'b1': np.zeros(HIDDEN),
+        'w2': rng.normal(0, np.sqrt(1.0 / HIDDEN), (HIDDEN, classes)),
+        'b2': np.zeros(classes),
+    }
+    moments = {k: (np.zeros_like(v), np.zeros_like(v)) for k, v in params.items()}
+    step = 0
+
+    for _ in range(epochs):
+        order = rng.permutation(len(x))
+        for i in range(0, len(x), batch):
+            idx = order[i:i + batch]
+            xb, yb = x[idx], y[idx]
+
+            hidden = np.maximum(xb @ params['w1'] + params['b1'], 0)
+            logits = hidden @ params['w2'] + params['b2']
+            p = np.exp(logits - logits.max(axis=1, keepdims=True))
+            p /= p.sum(axis=1, keepdims=True)
+
+            grad_logits = p
+            grad_logits[np.arange(len(yb)), yb] -= 1
+            grad_logits /= len(yb)
+            grad_hidden = (grad_logits @ params['w2'].T) * (hidden > 0)
+            grads = {
+                'w1': xb.T @ grad_hidden + 1e-4 * params['w1'],
+                'b1': grad_hidden.sum(axis=0),
+                'w2': hidden.T @ grad_logits + 1e-4 * params['w2'],
+                'b2': grad_logits.sum(axis=0),
+            }
+
+            step += 1
+            for k in params:
+                m, v = moments[k]
+                m[:] = 0.9 * m + 0.1 * grads[k]
+                v[:] = 0.999 * v + 0.001 * grads[k] ** 2
+                params[k] -= rate * (m / (1 - 0.9 ** step)) / (np.sqrt(v / (1 - 0.999 ** step)) + 1e-8)
+    return params
+
+
+def predict_float(params, x):
+    hidden = np.maximum(x @ params['w1'] + params['b1'], 0)
+    return hidden @ params['w2'] + params['b2']
+
+
+# ---------------------------------------------------------------------------
+# Int8 quantization, TFLite conventions
+
+def activation_params(low, high):
+    """Asymmetric int8 scale and zero point covering [low, high] and 0."""
+    low, high = min(low, 0.0), max(high, 0.0)
+    scale = (high - low) / 255.0 or 1.0
+    zero_point = int(np.clip(round(-128 - low / scale), -128, 127))
+    return scale, zero_point
+
+
+def quantize(params, x_calibration):
+    """Per-tensor symmetric int8 weights, int32 biases and int8 activations."""
+    hidden = np.maximum(x_calibration @ params['w1'] + params['b1'], 0)
+    logits = hidden @ params['w2'] + params['b2']
+
+    q = {}
+    q['in'] = activation_params(*np.percentile(x_calibration, [0.01, 99.99]))
+    q['hidden'] = activation_params(0.0, np.percentile(hidden, 99.99))
+    q['logits'] = activation_params(logits.min(), logits.max())
+    q['out'] = (1.0 / 256.0, -128)   # Required by the int8 softmax kernel
+
+    previous = q['in'][0]
+    for layer in ('1', '2'):
+        w = params['w' + layer].T   # TFLite stores [outputs, inputs]
+        w_scale = np.abs(w).max() / 127.0
+        q['w' + layer] = (np.clip(np.round(w / w_scale), -127, 127).astype(np.int8), w_scale)
+        bias_scale = previous * w_scale
+        q['b' + layer] = (np.round(params['b' + layer] / bias_scale).astype(np.int32), bias_scale)
+        previous = q['hidden'][0]
+    return q
+
+
+def quantize_input(x, q):
+    scale, zero_point = q['in']
+    return np.clip(np.round(x / scale) + zero_point, -128, 127).astype(np.int32)
+
+
+def fully_connected(x_q, x_params, w, b, out_params, relu):
+    acc = (x_q - x_params[1]) @ w[0].astype(np.int32).T + b[0]
+    out = np.round(acc * (x_params[0] * w[1] / out_params[0])) + out_params[1]
+    return np.clip(out, out_params[1] if relu else -128, 127).astype(np.int32)
+
+
+def predict_int8(q, x_q):
+    """Reference of the int8 graph, returns the quantized probabilities."""
+    hidden = fully_connected(x_q, q['in'], q['w1'], q['b1'], q['hidden'], True)
+    logits = fully_connected(hidden, q['hidden'], q['w2'], q['b2'], q['logits'], False)
+    values = (logits - q['logits'][1]) * q['logits'][0]
+    p = np.exp(values - values.max(axis=1, keepdims=True))
+    p /= p.sum(axis=1, keepdims=True)
+    return np.clip(np.round(p / q['out'][0]) + q['out'][1], -128, 127).astype(np.int32)
+
+
+# ---------------------------------------------------------------------------
+# TFLite flatbuffer
+
+def _vector(builder, values, dtype):
+    return builder.CreateNumpyVector(np.asarray(values, dtype=dtype))
+
+
+def _buffer_data(builder, data):
+    # Buffer.data is force_align: 16 in the schema
+    builder.StartVector(1, len(data), 16)
+    builder.head = builder.head - len(data)
+    builder.Bytes[builder.head:builder.head + len(data)] = data
+    return builder.EndVector()
+
+
+def _table(builder, fields):
+    """fields: (slot, kind, value); kind is 'offset', 'uint', 'int', 'byte' or 'float'."""
+    builder.StartObject(max(slot for slot, _, _ in fields) + 1)
+    for slot, kind, value in fields:
+        if kind == 'offset':
+            builder.PrependUOffsetTRelativeSlot(slot, value, 0)
+        elif kind == 'uint':
+            builder.PrependUint32Slot(slot, value, 0)
+        elif kind == 'int':
+            builder.PrependInt32Slot(slot, value, 0)
+        elif kind == 'byte':
+            builder.PrependInt8Slot(slot, value, 0)
+        elif kind == 'float':
+            builder.PrependFloat32Slot(slot, value, 0.0)
+    return builder.EndObject()
+
+
+def _offsets(builder, offsets):
+    builder.StartVector(4, len(offsets), 4)
+    for offset in reversed(offsets):
+        builder.PrependUOffsetTRelative(offset)
+    return builder.EndVector()
+
+
+def build_flatbuffer(q):
+    """Model with FULLY_CONNECTED(relu), FULLY_CONNECTED and SOFTMAX on an int8 [1, inputs] tensor."""
+    inputs = q['w1'][0].shape[1]
+    classes = q['w2'][0].shape[0]
+    builder = flatbuffers.Builder(8192)
+
+    # Buffer 0 is the empty sentinel, constant tensors get their own
+    constants = [q['w1'][0], q['b1'][0], q['w2'][0], q['b2'][0]]
+    buffers = [_table(builder, [(0, 'offset', _buffer_data(builder, b''))])]
+    for array in constants:
+        data = _buffer_data(builder, np.ascontiguousarray(array).tobytes())
+        buffers.append(_table(builder, [(0, 'offset', data)]))
+
+    # name, shape, type, buffer, scale, zero point
+    specs = [
+        ('input', [1, inputs], TENSOR_INT8, 0) + q['in'],
+        ('dense/weights', [HIDDEN, inputs], TENSOR_INT8, 1, q['w1'][1], 0),
+        ('dense/bias', [HIDDEN], TENSOR_INT32, 2, q['b1'][1], 0),
+        ('dense/relu', [1, HIDDEN], TENSOR_INT8, 0) + q['hidden'],
+        ('logits/weights', [classes, HIDDEN], TENSOR_INT8, 3, q['w2'][1], 0),
+        ('logits/bias', [classes], TENSOR_INT32, 4, q['b2'][1], 0),
+        ('logits', [1, classes], TENSOR_INT8, 0) + q['logits'],
+        ('probabilities', [1, classes], TENSOR_INT8, 0) + q['out'],
+    ]
+    tensors = []
+    for name, shape, tensor_type, buffer, scale, zero_point in specs:
+        name_offset = builder.CreateString(name)
+        shape_offset = _vector(builder, shape, np.int32)
+        scale_offset = _vector(builder, [scale], np.float32)
+        zero_offset = _vector(builder, [zero_point], np.int64)
+        quantization = _table(builder, [(2, 'offset', scale_offset), (3, 'offset', zero_offset)])
+        tensors.append(_table(builder, [(0, 'offset', shape_offset), (1, 'byte', tensor_type),
+                                        (2, 'uint', buffer), (3, 'offset', name_offset),
+                                        (4, 'offset', quantization)]))
+
+    # opcode index, inputs, outputs, options type, options
+    relu = _table(builder, [(0, 'byte', ACTIVATION_RELU)])
+    linear = _table(builder, [(0, 'byte', ACTIVATION_NONE)])
+    softmax = _table(builder, [(0, 'float', 1.0)])
+    layers = [
+        (0, [0, 1, 2], [3], OPTIONS_FULLY_CONNECTED, relu),
+        (0, [3, 4, 5], [6], OPTIONS_FULLY_CONNECTED, linear),
+        (1, [6], [7], OPTIONS_SOFTMAX, softmax),
+    ]
+    operators = []
+    for opcode, ins, outs, options_type, options in layers:
+        ins_offset = _vector(builder, ins, np.int32)
+        outs_offset = _vector(builder, outs, np.int32)
+        operators.append(_table(builder, [(0, 'uint', opcode), (1, 'offset', ins_offset),
+                                          (2, 'offset', outs_offset), (3, 'byte', options_type),
+                                          (4, 'offset', options)]))
+
+    subgraph = _table(builder, [(0, 'offset', _offsets(builder, tensors)),
+                                (1, 'offset', _vector(builder, [0], np.int32)),
+                                (2, 'offset', _vector(builder, [7], np.int32)),
+                                (3, 'offset', _offsets(builder, operators)),
+                                (4, 'offset', builder.CreateString('main'))])
+
+    # deprecated_builtin_code, version, builtin_code
+    codes = [_table(builder, [(0, 'byte', op), (2, 'int', 1), (3, 'int', op)])
+             for op in (OP_FULLY_CONNECTED, OP_SOFTMAX)]
+
+    description = builder.CreateString('SmartGuide obstacle classifier')
+    model = _table(builder, [(0, 'uint', 3), (1, 'offset', _offsets(builder, codes)),
+                             (2, 'offset', _offsets(builder, [subgraph])), (3, 'offset', description),
+                             (4, 'offset', _offsets(builder, buffers))])
+    builder.Finish(model, file_identifier=b'TFL3')
+    return bytes(builder.Output()), [OP_FULLY_CONNECTED, OP_SOFTMAX]
+
+
+# ---------------------------------------------------------------------------
+# Firmware sources
+
+def _floats(values):
+    return ', '.join('%.6ff' % v for v in values)
+
+
+def write_model_data(path, model, mean, std, note):
+    lines = [
+        '/*',
+        ' * model_data.cpp',
+        ' *',
+        ' * Generated by src/ai_model/export_model.py, do not edit.',
+        ' * %s' % note,
+        ' */',
+        '',
+        ' #ifdef SMARTGUIDE_USE_TFLITE',
+        ' ',
+        ' #include "model_data.h"',
+        ' ',
+        ' alignas(16) const unsigned char g_model_data[] = {',
+    ]
+    for i in range(0, len(model), 12):
+        lines.append('   ' + ', '.join('0x%02x' % b for b in model[i:i + 12]) + ',')
+    lines += [
+        ' };',
+        ' const unsigned int g_model_data_len = %d;' % len(model),
+        ' ',
+        ' const int g_model_feature_count = %d;' % FEATURE_COUNT,
+        ' const int g_model_window = %d;' % WINDOW,
+        ' ',
+        ' const float g_feature_mean[] = { %s };' % _floats(mean),
+        ' const float g_feature_std[] = { %s };' % _floats(std),
+        ' ',
+        ' #endif',
+    ]
+    with open(path, 'w') as f:
+        f.write('\n'.join(lines))
+
+
+def write_model_ops(path, ops):
+    names = ' '.join('OP(%s)' % RESOLVER_NAMES[op] for op in ops)
+    lines = [
+        '/*',
+        ' * model_ops.h',
+        ' *',
+        ' * Generated by src/ai_model/export_model.py, do not edit.',
+        ' * TFLite Micro ops of the model in model_data.cpp, in the order of',
+        ' * its operator codes.',
+        ' */',
+        '',
+        ' #ifndef MODEL_OPS_H',
+        ' #define MODEL_OPS_H',
+        ' ',
+        ' #define MODEL_OP_COUNT %d' % len(ops),
+        ' #define MODEL_OPS(OP) %s' % names,
+        ' ',
+        ' #endif',
+    ]
+    with open(path, 'w') as f:
+        f.write('\n'.join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[1])
+    parser.add_argument('--data', default=os.path.join(HERE, '..', 'data', 'obstacle_data'))
+    parser.add_argument('--out', default=MAIN)
+    parser.add_argument('--simulated-per-class', type=int, default=60)
+    parser.add_argument('--seed', type=int, default=7)
+    args = parser.parse_args()
+
+    traces = load_recordings(args.data)
+    source = '%d recorded traces' % len(traces)
+    if not traces:
+        traces = simulate_traces(args.simulated_per_class, args.seed)
+        source = '%d simulated traces' % len(traces)
+
+    # Split by trace so overlapping windows do not leak into the test set
+    order = np.random.default_rng(args.seed).permutation(len(traces))
+    split = int(len(traces) * 0.8)
+    x_train, y_train = build_dataset([traces[i] for i in order[:split]])
+    x_test, y_test = build_dataset([traces[i] for i in order[split:]])
+
+    mean, std = fit_scaler(x_train)
+    x_train = ((x_train - mean) / std).reshape(len(x_train), -1)
+    x_test = ((x_test - mean) / std).reshape(len(x_test), -1)
+
+    params = train(x_train, y_train)
+    q = quantize(params, x_train)
+    float_accuracy = np.mean(predict_float(params, x_test).argmax(axis=1) == y_test)
+    int8_accuracy = np.mean(predict_int8(q, quantize_input(x_test, q)).argmax(axis=1) == y_test)
+    print('Trained on %s: float accuracy %.3f, int8 accuracy %.3f on %d test windows'
+          % (source, float_accuracy, int8_accuracy, len(y_test)))
+
+    model, ops = build_flatbuffer(q)
+    note = ('%d byte int8 model, %d features x %d steps, %d classes.\n'
+            ' * Trained on %s, int8 test accuracy %.1f%%.'
+            % (len(model), FEATURE_COUNT, WINDOW, len(OBSTACLE_TYPES), source, 100 * int8_accuracy))
+    write_model_data(os.path.join(args.out, 'model_data.cpp'), model, mean, std, note)
+    write_model_ops(os.path.join(args.out, 'model_ops.h'), ops)
+    print('Wrote %d byte model to %s' % (len(model), os.path.normpath(args.out)))
+
+
+if __name__ == '__main__':
+    main()
@@ -7,211 +7,212 @@
  #include "AIClassifier.h"
  #include <Arduino.h>
  
- // In a real implementation, this would include TensorFlow Lite
- // #include <TensorFlowLite.h>
- // #include "tensorflow/lite/micro/all_ops_resolver.h"
- // #include "tensorflow/lite/micro/micro_error_reporter.h"
- // #include "tensorflow/lite/micro/micro_interpreter.h"
- // #include "tensorflow/lite/schema/schema_generated.h"
- // #include "model_data.h" // Contains the TFLite model
+ #ifdef SMARTGUIDE_USE_TFLITE
+ #include "model_data.h"
+ #endif
  
- // Obstacle type definitions
- const char* obstacle_types[] = {
-   "wall", "person", "chair", "table", "stairs", 
-   "door", "pole", "unknown"
- };
- 
- AIClassifier::AIClassifier() {
+ AIClassifier::AIClassifier() : gate(ObstacleType::UNKNOWN) {
    modelInitialized = false;
-   currentObstacleType = "unknown";
-   confidenceScore = 0.0;
-   
-   // Initialize sensor buffer
-   for (int i = 0; i < 10; i++) {
-     for (int j = 0; j < 8; j++) {
-       sensorBuffer[i][j] = 0.0;
-     }
-   }
+   useModel = false;
+   lastInferenceUs = 0;
  }
  
  bool AIClassifier::begin() {
-   // In a real implementation, this would initialize TensorFlow Lite
-   // model = tflite::GetModel(g_model_data);
-   // interpreter->AllocateTensors();
-   // etc.
+   const char* fallbackReason = model.getStatusText();
+ #ifdef SMARTGUIDE_USE_TFLITE
+   // The model must have been trained on this sensor layout and window
+   if (g_model_feature_count != FEATURE_COUNT || g_model_window != CLASSIFIER_WINDOW) {
+     fallbackReason = "model trained for another sensor layout";
+   } else if (!model.begin(FEATURE_COUNT * CLASSIFIER_WINDOW)) {
+     fallbackReason = model.getStatusText();
+   } else {
+     for (int i = 0; i < FEATURE_COUNT; i++) {
+       float std = g_feature_std[i] > 0 ? g_feature_std[i] : 1.0;
+       float step = std * model.getInputScale();
+       inputScale[i] = 1.0 / step;
+       inputOffset[i] = model.getInputZeroPoint() - g_feature_mean[i] / step;
+     }
+     useModel = true;
+   }
+ #endif
    
-   // For this prototype, we'll simulate model initialization
+   // Rule-based classification is always available as a fallback
    modelInitialized = true;
-   Serial.println("AI Classifier initialized");
+   if (useModel) {
+     Serial.print("AI Classifier initialized, tensor arena ");
+     Serial.print(model.getArenaUsedBytes());
+     Serial.print("/");
+     Serial.print(model.getArenaBytes());
+     Serial.println(" bytes");
+   } else {
+     Serial.print("AI Classifier initialized (rule-based): ");
+     Serial.println(fallbackReason);
+   }
    return modelInitialized;
  }
  
- void AIClassifier::updateReadings(float distLower, float distUpper) {
+ void AIClassifier::updateReadings(const float* distances) {
    // Extract features and update buffer
-   extractFeatures(distLower, distUpper);
+   extractFeatures(distances);
  }
  
- String AIClassifier::classifyObstacle() {
+ ObstacleType AIClassifier::classifyObstacle() {
    if (!modelInitialized) {
-     return "unknown";
+     return ObstacleType::UNKNOWN;
    }
    
-   // In a real implementation, this would run inference using TensorFlow Lite
-   // TfLiteStatus invoke_status = interpreter->Invoke();
-   // Process outputs
-   // etc.
+   // Reuse the last result while the window looks the same
+   float fingerprint[FINGERPRINT_SIZE];
+   takeFingerprint(fingerprint);
+   if (!gate.shouldRun(fingerprint, millis())) {
+     return gate.getLabel();
+   }
    
-   // For this prototype, we'll simulate classification based on patterns
+   ObstacleType detectedType = ObstacleType::UNKNOWN;
+   float confidence = 0.6; // Default confidence
    
-   // Simple heuristic classification based on sensor readings
-   float lowerAvg = 0, upperAvg = 0, variance = 0;
+   // Model inference once the window is full, rules otherwise
+   if (!useModel || !classifyWithModel(detectedType, confidence)) {
+     classifyWithRules(detectedType, confidence);
+   }
    
-   // Calculate average distances
-   for (int i = 0; i < 8; i++) {
-     lowerAvg += sensorBuffer[0][i];
-     upperAvg += sensorBuffer[1][i];
+   // Update current classification if confidence is high enough and
+   // clearly better than the label we already report
+   gate.update(fingerprint, millis(), detectedType, confidence);
+   
+   return gate.getLabel();
+ }
+ 
+ void AIClassifier::takeFingerprint(float* fingerprint) {
+   for (int s = 0; s < CaneSensors::COUNT; s++) {
+     int row = CaneSensors::distanceFeature(s);
+     fingerprint[3 * s] = sensorBuffer.mean(row);
+     fingerprint[3 * s + 1] = sqrt(sensorBuffer.variance(row));
+     fingerprint[3 * s + 2] = getDominantFrequency(s) * FINGERPRINT_FREQ_WEIGHT;
+   }
+ }
+ 
+ bool AIClassifier::classifyWithModel(ObstacleType& type, float& confidence) {
+   // Quantize straight from the feature window into the input tensor
+   if (!sensorBuffer.quantize(model.getInput(), inputScale, inputOffset)) {
+     return false;
    }
-   lowerAvg /= 8;
-   upperAvg /= 8;
    
-   // Calculate height difference
-   float heightDiff = abs(upperAvg - lowerAvg);
+   unsigned long start = micros();
+   int bestClass;
+   float probability;
+   if (!model.invoke(bestClass, probability)) {
+     return false;
+   }
+   lastInferenceUs = micros() - start;
    
-   // Calculate variance
-   for (int i = 0; i < 8; i++) {
-     variance += pow(sensorBuffer[0][i] - lowerAvg, 2);
+   // Output classes follow the ObstacleType order
+   if (bestClass < 0 || bestClass >= (int)ObstacleType::COUNT) {
+     return false;
    }
-   variance /= 8;
    
-   // Simplified classification logic
-   String detectedType = "unknown";
-   float confidence = 0.6; // Default confidence
+   type = (ObstacleType)bestClass;
+   confidence = probability;
+   return true;
+ }
+ 
+ void AIClassifier::classifyWithRules(ObstacleType& type, float& confidence) {
+   // Simple heuristic classification based on sensor readings
+   const int lowerRow = CaneSensors::distanceFeature(SENSOR_LOWER);
+   const int upperRow = CaneSensors::distanceFeature(SENSOR_UPPER);
+   
+   // Average distances and lower variance are kept up to date by the window
+   float lowerAvg = sensorBuffer.mean(lowerRow);
+   float upperAvg = sensorBuffer.mean(upperRow);
+   float variance = sensorBuffer.variance(lowerRow);
+   
+   // Calculate height difference
+   float heightDiff = abs(upperAvg - lowerAvg);
    
    // Very close readings at both sensors with low variance
    if (lowerAvg < 50 && upperAvg < 50 && variance < 10) {
-     detectedType = "wall";
+     type = ObstacleType::WALL;
      confidence = 0.92;
    }
    // Close lower reading, far upper reading
    else if (lowerAvg < 70 && upperAvg > 150) {
-     detectedType = "table";
+     type = ObstacleType::TABLE;
      confidence = 0.81;
    }
    // Medium distance with high variance in lower sensor
    else if (lowerAvg < 100 && upperAvg < 100 && variance > 50) {
-     detectedType = "stairs";
+     type = ObstacleType::STAIRS;
      confidence = 0.89;
    }
    // Medium-high variance with similar upper/lower readings
    else if (variance > 20 && variance < 50 && abs(lowerAvg - upperAvg) < 30) {
-     detectedType = "person";
+     type = ObstacleType::PERSON;
      confidence = 0.87;
    }
    // Close readings with medium height difference
    else if (lowerAvg < 80 && heightDiff > 30 && heightDiff < 80) {
-     detectedType = "chair";
+     type = ObstacleType::CHAIR;
      confidence = 0.81;
    }
    // Very close lower, medium upper
    else if (lowerAvg < 30 && upperAvg > 80 && upperAvg < 150) {
-     detectedType = "pole";
+     type = ObstacleType::POLE;
      confidence = 0.78;
    }
    // Medium readings with specific height difference
    else if (lowerAvg > 50 && lowerAvg < 120 && heightDiff < 20) {
-     detectedType = "door";
+     type = ObstacleType::DOOR;
      confidence = 0.72;
    }
-   
-   // Update current classification if confidence is high enough
-   if (confidence > 0.6) {
-     currentObstacleType = detectedType;
-     confidenceScore = confidence;
-   }
-   
-   return currentObstacleType;
  }
  
- void AIClassifier::extractFeatures(float distLower, float distUpper) {
-   // Shift buffer to make room for new data
-   for (int i = 0; i < 10; i++) {
-     for (int j = 0; j < 7; j++) {
-       sensorBuffer[i][j] = sensorBuffer[i][j+1];
-     }
-   }
+ void AIClassifier::extractFeatures(const float* distances) {
+   float column[FEATURE_COUNT];
    
    // Calculate features for this time step
-   sensorBuffer[0][7] = distLower;                            // Lower sensor distance
-   sensorBuffer[1][7] = distUpper;                            // Upper sensor distance
-   sensorBuffer[2][7] = abs(distLower - distUpper);           // Height difference
-   sensorBuffer[3][7] = (distLower + distUpper) / 2;          // Average distance
-   
-   // Rate of change (if we have previous readings)
-   if (sensorBuffer[0][6] != 0) {
-     sensorBuffer[4][7] = sensorBuffer[0][6] - distLower;     // Lower sensor rate of change
-     sensorBuffer[5][7] = sensorBuffer[1][6] - distUpper;     // Upper sensor rate of change
-   } else {
-     sensorBuffer[4][7] = 0;
-     sensorBuffer[5][7] = 0;
+   float sum = 0;
+   for (int s = 0; s < CaneSensors::COUNT; s++) {
+     column[CaneSensors::distanceFeature(s)] = distances[s];   // Sensor distance
+     sum += distances[s];
+   }
+   for (int s = 1; s < CaneSensors::COUNT; s++) {
+     // Height difference relative to the lower sensor
+     column[CaneSensors::heightDiffFeature(s - 1)] = abs(distances[SENSOR_LOWER] - distances[s]);
    }
+   column[CaneSensors::averageFeature()] = sum / CaneSensors::COUNT; // Average distance
    
-   sensorBuffer[6][7] = calculateVariance(0);                 // Lower sensor variance
-   sensorBuffer[7][7] = calculateVariance(1);                 // Upper sensor variance
-   sensorBuffer[8][7] = calculatePeakFrequency(0);            // Lower sensor dominant frequency
-   sensorBuffer[9][7] = calculatePeakFrequency(1);            // Upper sensor dominant frequency
- }
- 
- float AIClassifier::calculateVariance(int sensorIndex) {
-   float mean = 0;
-   int validSamples = 0;
-   
-   // Calculate mean of valid samples
-   for (int i = 0; i < 8; i++) {
-     if (sensorBuffer[sensorIndex][i] > 0) {
-       mean += sensorBuffer[sensorIndex][i];
-       validSamples++;
+   // Rate of change (if we have previous readings)
+   bool hasPrevious = !sensorBuffer.isEmpty();
+   for (int s = 0; s < CaneSensors::COUNT; s++) {
+     int row = CaneSensors::distanceFeature(s);
+     column[CaneSensors::rateFeature(s)] = hasPrevious ? sensorBuffer.at(row, 0) - distances[s] : 0;
+   }
+   
+   // Statistics of the window including this step
+   for (int s = 0; s < CaneSensors::COUNT; s++) {
+     column[CaneSensors::varianceFeature(s)] = 0;
+     column[CaneSensors::frequencyFeature(s)] = 0;
+     for (int b = 0; b < SPECTRAL_BANDS; b++) {
+       column[CaneSensors::bandFeature(s, b)] = 0;
      }
    }
+   sensorBuffer.push(column);
    
-   if (validSamples == 0) return 0;
-   mean /= validSamples;
-   
-   // Calculate variance
-   float variance = 0;
-   for (int i = 0; i < 8; i++) {
-     if (sensorBuffer[sensorIndex][i] > 0) {
-       variance += pow(sensorBuffer[sensorIndex][i] - mean, 2);
+   float* latest = sensorBuffer.latest();
+   for (int s = 0; s < CaneSensors::COUNT; s++) {
+     spectra[s].push(distances[s]);
+     latest[CaneSensors::varianceFeature(s)] = sensorBuffer.variance(CaneSensors::distanceFeature(s));        // Sensor variance
+     latest[CaneSensors::frequencyFeature(s)] = getDominantFrequency(s);                                      // Sensor dominant frequency
+     for (int b = 0; b < SPECTRAL_BANDS; b++) {
+       latest[CaneSensors::bandFeature(s, b)] = getBandEnergy(s, b);                                          // Gait and sway energy
      }
    }
-   
-   return variance / validSamples;
  }
  
- float AIClassifier::calculatePeakFrequency(int sensorIndex) {
-   // Simple implementation of frequency detection
-   // In a real implementation, this would use FFT
-   int zero_crossings = 0;
-   bool above = false;
-   float mean = 0;
-   
-   // Calculate mean
-   for (int i = 0; i < 8; i++) {
-     if (sensorBuffer[sensorIndex][i] > 0) {
-       mean += sensorBuffer[sensorIndex][i];
-     }
-   }
-   mean /= 8;
-   
-   // Count zero crossings around mean
-   above = sensorBuffer[sensorIndex][0] > mean;
-   for (int i = 1; i < 8; i++) {
-     bool now_above = sensorBuffer[sensorIndex][i] > mean;
-     if (above != now_above && sensorBuffer[sensorIndex][i] > 0) {
-       zero_crossings++;
-       above = now_above;
-     }
+ float AIClassifier::getBandEnergy(int sensor, int band) {
+   const int binsPerBand = SPECTRAL_BINS / SPECTRAL_BANDS;
+   if (sensor < 0 || sensor >= CaneSensors::COUNT || band < 0 || band >= SPECTRAL_BANDS) {
+     return 0;
    }
-   
-   // Return estimated frequency based on zero crossings
-   return zero_crossings / (8 * 0.1); // 0.1s is our sampling period (assuming 10Hz)
+   return spectra[sensor].bandEnergy(band * binsPerBand, (band + 1) * binsPerBand - 1);
  }
\ No newline at end of file
@@ -8,23 +8,68 @@
  #define AI_CLASSIFIER_H
  
  #include <Arduino.h>
+ #include "SensorConfig.h"
+ #include "FeatureWindow.h"
+ #include "TfliteBackend.h"
+ #include "ObstacleTypes.h"
+ #include "SlidingDft.h"
+ #include "ClassificationGate.h"
+ 
+ // Time steps kept for classification, can be overridden by a build flag
+ #ifndef CLASSIFIER_WINDOW
+ #define CLASSIFIER_WINDOW 8
+ #endif
+ 
+ // Classifier update rate (readings per second)
+ #define CLASSIFIER_SAMPLE_HZ 10.0
+ 
+ // Spectral features: 6.4 s of history, bins up to 2.5 Hz in 4 bands
+ #ifndef SPECTRAL_WINDOW
+ #define SPECTRAL_WINDOW 64
+ #endif
+ #define SPECTRAL_BINS (SPECTRAL_WINDOW / 4)
+ static_assert(SPECTRAL_BINS % SPECTRAL_BANDS == 0, "Bands must split the bins evenly");
+ 
+ // Fingerprint for lazy classification: mean, spread and dominant
+ // frequency per sensor, frequency weighted so 0.5 Hz counts like 10 cm
+ #define FINGERPRINT_SIZE (CaneSensors::COUNT * 3)
+ #define FINGERPRINT_FREQ_WEIGHT 20.0
+ 
+ // Running statistics are kept for the distance rows, which come first
+ static_assert(CaneSensors::distanceFeature(CaneSensors::COUNT - 1) == CaneSensors::COUNT - 1, "Distance features must lead the layout");
  
  class AIClassifier {
+   public:
+     // Feature tensor size follows from the sensor layout
+     static const int FEATURE_COUNT = CaneSensors::FEATURE_COUNT;
+     
    private:
-     // Sensor data buffer for classification
-     float sensorBuffer[10][8]; // 10 features across 8 time steps
+     // Features across time steps, with running mean and variance per sensor distance
+     FeatureWindow<FEATURE_COUNT, CLASSIFIER_WINDOW, CaneSensors::COUNT> sensorBuffer;
      
-     // Current obstacle classification
-     String currentObstacleType;
-     float confidenceScore;
+     // Current obstacle classification, re-run only when the window drifted
+     ClassificationGate<ObstacleType, FINGERPRINT_SIZE> gate;
+     
+     // Sliding DFT of each sensor's distance, for gait and movement signatures
+     SlidingDft<SPECTRAL_WINDOW, SPECTRAL_BINS> spectra[CaneSensors::COUNT];
      
      // Helper functions
-     float calculateVariance(int sensorIndex);
-     float calculatePeakFrequency(int sensorIndex);
-     void extractFeatures(float distLower, float distUpper);
+     void extractFeatures(const float* distances);
+     void takeFingerprint(float* fingerprint);
+     
+     // Classification backends, the rules are used when no model is loaded
+     bool classifyWithModel(ObstacleType& type, float& confidence);
+     void classifyWithRules(ObstacleType& type, float& confidence);
      
      // TFLite model variables
      bool modelInitialized;
+     bool useModel;
+     TfliteBackend model;
+     unsigned long lastInferenceUs;
+     
+     // Normalization and input quantization folded into q = x * scale + offset
+     float inputScale[FEATURE_COUNT];
+     float inputOffset[FEATURE_COUNT];
      
    public:
      AIClassifier();
@@ -32,13 +77,27 @@
      // Initialize the classifier
      bool begin();
      
-     // Update with new sensor readings
-     void updateReadings(float distLower, float distUpper);
+     // Update with new sensor readings (one distance per sensor)
+     void updateReadings(const float* distances);
      
      // Get current obstacle classification
-     String classifyObstacle();
-     String getLastObstacleType() { return currentObstacleType; }
-     float getConfidence() { return confidenceScore; }
+     ObstacleType classifyObstacle();
+     ObstacleType getLastObstacleType() { return gate.getLabel(); }
+     float getConfidence() { return gate.getConfidence(); }
+     
+     // Lazy mode (default) reuses the last result while the features are steady
+     void setLazyClassification(bool enabled) { gate.setLazy(enabled); }
+     unsigned long getInferenceCount() { return gate.getRunCount(); }
+     unsigned long getSkippedCount() { return gate.getSkipCount(); }
+     
+     // Spectral features per sensor
+     float getDominantFrequency(int sensor) { return spectra[sensor].dominantFrequency(CLASSIFIER_SAMPLE_HZ); }
+     float getBandEnergy(int sensor, int band);
+     
+     // Inference diagnostics
+     bool isUsingModel() { return useModel; }
+     unsigned long getLastInferenceUs() { return lastInferenceUs; }
+     size_t getArenaUsedBytes() { return model.getArenaUsedBytes(); }
  };
  
  #endif
\ No newline at end of file
@@ -0,0 +1,114 @@
+/*
+ * ClassificationGate.h
+ *
+ * Decides when the classifier needs to run again and smooths its
+ * output. Inference is skipped while a small fingerprint of the feature
+ * window stays within a drift threshold of the one seen at the last run
+ * and the result is younger than a maximum age. A different label only
+ * replaces the current one if it is clearly more confident; each
+ * contradicting result wears the current confidence down so a real
+ * change still wins after a few runs. No Arduino dependencies.
+ */
+
+ #ifndef CLASSIFICATION_GATE_H
+ #define CLASSIFICATION_GATE_H
+ 
+ #include <stdint.h>
+ 
+ #define GATE_DRIFT_THRESHOLD 10.0     // Largest fingerprint change that reuses the last result
+ #define GATE_MAX_AGE_MS 1000          // Run at least this often while being asked
+ #define GATE_MIN_CONFIDENCE 0.6       // Results at or below this are ignored
+ #define GATE_SWITCH_MARGIN 0.1        // A new label must beat the current confidence by this
+ #define GATE_CONFIDENCE_DECAY 0.8     // Applied to the current label when contradicted
+ 
+ template <typename Label, int SIZE>
+ class ClassificationGate {
+   private:
+     float fingerprint[SIZE];
+     bool hasRun;
+     uint32_t lastRunMs;
+     bool lazy;
+     
+     Label label;
+     float confidence;
+     
+     uint32_t runCount;
+     uint32_t skipCount;
+     uint32_t heldCount;
+     
+   public:
+     ClassificationGate(Label initial) {
+       label = initial;
+       lazy = true;
+       reset();
+     }
+     
+     void reset() {
+       hasRun = false;
+       lastRunMs = 0;
+       confidence = 0;
+       runCount = 0;
+       skipCount = 0;
+       heldCount = 0;
+     }
+     
+     // With lazy mode off every request runs the classifier
+     void setLazy(bool enabled) { lazy = enabled; }
+     
+     // True if the classifier has to run for this fingerprint, counts a skip otherwise
+     bool shouldRun(const float* current, uint32_t nowMs) {
+       if (!lazy || !hasRun || nowMs - lastRunMs >= GATE_MAX_AGE_MS) {
+         return true;
+       }
+       
+       for (int i = 0; i < SIZE; i++) {
+         float change = current[i] - fingerprint[i];
+         if (change > GATE_DRIFT_THRESHOLD || change < -GATE_DRIFT_THRESHOLD) {
+           return true;
+         }
+       }
+       
+       skipCount++;
+       return false;
+     }
+     
+     // Record a classifier run and feed its result through the hysteresis.
+     // Returns true if the reported label changed.
+     bool update(const float* current, uint32_t nowMs, Label result, float resultConfidence) {
+       for (int i = 0; i < SIZE; i++) {
+         fingerprint[i] = current[i];
+       }
+       hasRun = true;
+       lastRunMs = nowMs;
+       runCount++;
+       
+       if (resultConfidence <= (float)GATE_MIN_CONFIDENCE) {
+         return false;
+       }
+       
+       if (result == label) {
+         confidence = resultConfidence;
+         return false;
+       }
+       
+       if (resultConfidence >= confidence + GATE_SWITCH_MARGIN) {
+         label = result;
+         confidence = resultConfidence;
+         return true;
+       }
+       
+       // Keep the current label for now, but trust it a little less
+       confidence *= GATE_CONFIDENCE_DECAY;
+       heldCount++;
+       return false;
+     }
+     
+     Label getLabel() const { return label; }
+     float getConfidence() const { return confidence; }
+     
+     uint32_t getRunCount() const { return runCount; }
+     uint32_t getSkipCount() const { return skipCount; }
+     uint32_t getHeldCount() const { return heldCount; }
+ };
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+/*
+ * Crc32.h
+ *
+ * CRC-32 (IEEE 802.3, as used by zip and PNG) for checking records
+ * written to the SD card. Uses a 16-entry nibble table to keep the
+ * flash footprint small. No Arduino dependencies.
+ */
+
+ #ifndef CRC32_H
+ #define CRC32_H
+ 
+ #include <stdint.h>
+ #include <stddef.h>
+ 
+ #define CRC32_INITIAL 0xFFFFFFFFu
+ 
+ // Feed bytes into a running CRC started at CRC32_INITIAL
+ inline uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t length) {
+   static const uint32_t nibbleTable[16] = {
+     0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+     0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+   };
+   for (size_t i = 0; i < length; i++) {
+     crc ^= data[i];
+     crc = (crc >> 4) ^ nibbleTable[crc & 0x0F];
+     crc = (crc >> 4) ^ nibbleTable[crc & 0x0F];
+   }
+   return crc;
+ }
+ 
+ inline uint32_t crc32Final(uint32_t crc) { return crc ^ 0xFFFFFFFFu; }
+ 
+ inline uint32_t crc32(const uint8_t* data, size_t length) {
+   return crc32Final(crc32Update(CRC32_INITIAL, data, length));
+ }
+ 
+ #endif
\ No newline at end of file
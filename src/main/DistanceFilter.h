@@ -0,0 +1,289 @@
+/*
+ * DistanceFilter.h
+ *
+ * Allocation-free per-sensor filter pipeline between ranging and its
+ * consumers: rolling median, rate-of-change gate and a 1D constant
+ * velocity Kalman filter. All arithmetic is Q16.16 fixed point so every
+ * sample costs a bounded number of cycles. No Arduino dependencies.
+ */
+
+ #ifndef DISTANCE_FILTER_H
+ #define DISTANCE_FILTER_H
+ 
+ #include <stdint.h>
+ 
+ #define FILTER_FRAC_BITS 16
+ #define FILTER_ONE ((int32_t)1 << FILTER_FRAC_BITS)
+ #define FILTER_MAX_DISTANCE_CM 400
+ #define FILTER_MAX_DT_US 1000000        // Longer gaps are treated as one second
+ 
+ typedef int32_t fixed_t; // Q16.16
+ 
+ inline fixed_t toFixed(float value) { return (fixed_t)(value * FILTER_ONE); }
+ inline float fromFixed(int64_t value) { return (float)value / FILTER_ONE; }
+ 
+ // Q16.16 multiply with a 64-bit intermediate
+ inline int64_t fixedMul(int64_t a, int64_t b) { return (a * b) >> FILTER_FRAC_BITS; }
+ 
+ // Sample flowing through the pipeline
+ struct FilterSample {
+   fixed_t distance;     // cm, Q16.16
+   uint32_t timestampUs;
+   bool valid;           // Cleared by a stage that rejects the sample
+   bool step;            // Set by a stage that let a real step change through
+ };
+ 
+ // Rolling median over the last WINDOW samples, removes isolated spikes
+ template <int WINDOW>
+ class MedianStage {
+   static_assert(WINDOW % 2 == 1 && WINDOW <= 9, "Median window must be odd and small");
+   
+   private:
+     fixed_t window[WINDOW];
+     uint8_t next;
+     uint8_t filled;
+     
+   public:
+     MedianStage() { reset(); }
+     
+     void reset() {
+       next = 0;
+       filled = 0;
+     }
+     
+     void process(FilterSample& sample) {
+       if (!sample.valid) {
+         return;
+       }
+       
+       window[next] = sample.distance;
+       next = (next + 1) % WINDOW;
+       if (filled < WINDOW) {
+         filled++;
+       }
+       
+       // Insertion sort of at most WINDOW values
+       fixed_t sorted[WINDOW];
+       for (int i = 0; i < filled; i++) {
+         fixed_t value = window[i];
+         int j = i;
+         while (j > 0 && sorted[j - 1] > value) {
+           sorted[j] = sorted[j - 1];
+           j--;
+         }
+         sorted[j] = value;
+       }
+       
+       sample.distance = sorted[filled / 2];
+     }
+ };
+ 
+ // Rejects samples that moved faster than anything the cane can see.
+ // After maxRejects consecutive rejections the next sample is accepted so
+ // a real step change (someone stepping in front) is not ignored for long,
+ // and flagged as a step so later stages do not smooth across it.
+ class RateGateStage {
+   private:
+     int64_t maxRate;      // cm/s, Q16.16
+     fixed_t minStep;      // Always allowed jitter, cm Q16.16
+     uint8_t maxRejects;
+     fixed_t last;
+     uint32_t lastUs;
+     bool hasLast;
+     uint8_t rejects;
+     uint16_t rejectedTotal;
+     
+   public:
+     RateGateStage() {
+       configure(500.0, 10.0, 2);
+       reset();
+     }
+     
+     void configure(float maxRateCmPerS, float minStepCm, uint8_t rejectLimit) {
+       maxRate = toFixed(maxRateCmPerS);
+       minStep = toFixed(minStepCm);
+       maxRejects = rejectLimit;
+     }
+     
+     void reset() {
+       hasLast = false;
+       rejects = 0;
+       rejectedTotal = 0;
+     }
+     
+     void process(FilterSample& sample) {
+       if (!sample.valid) {
+         return;
+       }
+       
+       if (hasLast && rejects >= maxRejects) {
+         sample.step = true;
+       } else if (hasLast) {
+         uint32_t dt = sample.timestampUs - lastUs;
+         if (dt > FILTER_MAX_DT_US) {
+           dt = FILTER_MAX_DT_US;
+         }
+         int64_t allowed = maxRate * dt / 1000000 + minStep;
+         int64_t delta = (int64_t)sample.distance - last;
+         if (delta < 0) {
+           delta = -delta;
+         }
+         
+         if (delta > allowed) {
+           rejects++;
+           rejectedTotal++;
+           sample.valid = false;
+           return;
+         }
+       }
+       
+       last = sample.distance;
+       lastUs = sample.timestampUs;
+       hasLast = true;
+       rejects = 0;
+     }
+     
+     uint16_t getRejectedCount() const { return rejectedTotal; }
+ };
+ 
+ // Constant velocity Kalman filter on [distance, velocity]. Rejected
+ // samples only advance the prediction. A step restarts the filter at the
+ // new distance: taken as one innovation it would build up a large
+ // velocity and overshoot well below the new distance.
+ class KalmanStage {
+   private:
+     int64_t d;            // cm, Q16.16
+     int64_t v;            // cm/s, Q16.16
+     int64_t p00, p01, p11;
+     int64_t q;            // Acceleration noise, (cm/s^2)^2 Q16.16
+     int64_t r;            // Measurement noise, cm^2 Q16.16
+     int64_t initialVelocityVar;
+     int64_t maxVariance;
+     uint32_t lastUs;
+     bool initialized;
+     
+     void start(const FilterSample& sample) {
+       d = sample.distance;
+       v = 0;
+       p00 = r;
+       p01 = 0;
+       p11 = initialVelocityVar;
+       lastUs = sample.timestampUs;
+       initialized = true;
+     }
+     
+   public:
+     KalmanStage() {
+       configure(150.0, 4.0);
+       reset();
+     }
+     
+     // accelStdDev: how hard the distance can change pace (cm/s^2)
+     // measurementStdDev: sensor noise after the median (cm)
+     void configure(float accelStdDev, float measurementStdDev) {
+       q = toFixed(accelStdDev * accelStdDev);
+       r = toFixed(measurementStdDev * measurementStdDev);
+       initialVelocityVar = toFixed(100.0f * 100.0f);
+       maxVariance = (int64_t)FILTER_MAX_DISTANCE_CM * FILTER_MAX_DISTANCE_CM * FILTER_ONE;
+     }
+     
+     void reset() {
+       initialized = false;
+       d = 0;
+       v = 0;
+     }
+     
+     void process(FilterSample& sample) {
+       if (!initialized || (sample.valid && sample.step)) {
+         if (sample.valid) {
+           start(sample);
+         }
+         return;
+       }
+       
+       // Predict
+       uint32_t dtUs = sample.timestampUs - lastUs;
+       if (dtUs > FILTER_MAX_DT_US) {
+         dtUs = FILTER_MAX_DT_US;
+       }
+       lastUs = sample.timestampUs;
+       
+       int64_t dt = ((int64_t)dtUs << FILTER_FRAC_BITS) / 1000000; // seconds, Q16.16
+       int64_t dt2 = fixedMul(dt, dt);
+       int64_t qdt2 = fixedMul(q, dt2);
+       
+       d += fixedMul(v, dt);
+       p00 += fixedMul(dt, 2 * p01 + fixedMul(dt, p11)) + fixedMul(qdt2, dt2) / 4;
+       p01 += fixedMul(dt, p11) + fixedMul(qdt2, dt) / 2;
+       p11 += qdt2;
+       
+       if (p00 > maxVariance) {
+         p00 = maxVariance;
+       }
+       
+       // Update
+       if (sample.valid) {
+         int64_t s = p00 + r;
+         int64_t k0 = (p00 << FILTER_FRAC_BITS) / s;
+         int64_t k1 = (p01 << FILTER_FRAC_BITS) / s;
+         int64_t y = (int64_t)sample.distance - d;
+         
+         d += fixedMul(k0, y);
+         v += fixedMul(k1, y);
+         
+         int64_t oldP01 = p01;
+         p00 = fixedMul(FILTER_ONE - k0, p00);
+         p01 = fixedMul(FILTER_ONE - k0, p01);
+         p11 -= fixedMul(k1, oldP01);
+       }
+       
+       // Keep the estimate inside the sensor's range
+       if (d < 0) {
+         d = 0;
+       } else if (d > (int64_t)FILTER_MAX_DISTANCE_CM * FILTER_ONE) {
+         d = (int64_t)FILTER_MAX_DISTANCE_CM * FILTER_ONE;
+       }
+       
+       sample.distance = (fixed_t)d;
+       sample.valid = true;
+     }
+     
+     float getVelocity() const { return fromFixed(v); }
+ };
+ 
+ // Runs a sample through each stage in order
+ template <typename... Stages>
+ class FilterPipeline;
+ 
+ template <>
+ class FilterPipeline<> {
+   public:
+     void process(FilterSample&) {}
+     void reset() {}
+ };
+ 
+ template <typename First, typename... Rest>
+ class FilterPipeline<First, Rest...> {
+   private:
+     First stage;
+     FilterPipeline<Rest...> remaining;
+     
+   public:
+     void process(FilterSample& sample) {
+       stage.process(sample);
+       remaining.process(sample);
+     }
+     
+     void reset() {
+       stage.reset();
+       remaining.reset();
+     }
+     
+     First& first() { return stage; }
+     FilterPipeline<Rest...>& rest() { return remaining; }
+ };
+ 
+ // Default pipeline for one HC-SR04
+ typedef FilterPipeline<MedianStage<3>, RateGateStage, KalmanStage> DistanceFilter;
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+/*
+ * EdgeIndex.h
+ *
+ * Per-node adjacency lists for the map edges, so finding the edge
+ * between two nodes walks one node's neighbours instead of every edge.
+ * Each edge is stored as two half-edges, one in each endpoint's list,
+ * chained through fixed arrays. No Arduino dependencies.
+ */
+
+ #ifndef EDGE_INDEX_H
+ #define EDGE_INDEX_H
+ 
+ #include <stdint.h>
+ 
+ #define EDGE_NONE -1
+ 
+ template <int MAX_NODES, int MAX_EDGES>
+ class EdgeIndex {
+   private:
+     // Half-edge h belongs to edge h / 2 and leads to neighbour[h]
+     int32_t firstHalf[MAX_NODES];
+     int32_t nextHalf[2 * MAX_EDGES];
+     int32_t neighbour[2 * MAX_EDGES];
+     
+     void link(int32_t half, int32_t from, int32_t to) {
+       neighbour[half] = to;
+       nextHalf[half] = firstHalf[from];
+       firstHalf[from] = half;
+     }
+     
+     void unlink(int32_t half, int32_t from) {
+       int32_t* link = &firstHalf[from];
+       while (*link != EDGE_NONE && *link != half) {
+         link = &nextHalf[*link];
+       }
+       if (*link == half) {
+         *link = nextHalf[half];
+       }
+     }
+     
+   public:
+     EdgeIndex() {
+       clear();
+     }
+     
+     void clear() {
+       for (int n = 0; n < MAX_NODES; n++) {
+         firstHalf[n] = EDGE_NONE;
+       }
+     }
+     
+     // Record edge e between nodes a and b
+     void add(int32_t edge, int32_t a, int32_t b) {
+       link(2 * edge, a, b);
+       link(2 * edge + 1, b, a);
+     }
+     
+     // Forget edge e between nodes a and b
+     void remove(int32_t edge, int32_t a, int32_t b) {
+       unlink(2 * edge, a);
+       unlink(2 * edge + 1, b);
+     }
+     
+     // Index of the edge joining a and b in either direction, or EDGE_NONE
+     int32_t find(int32_t a, int32_t b) const {
+       for (int32_t h = firstHalf[a]; h != EDGE_NONE; h = nextHalf[h]) {
+         if (neighbour[h] == b) {
+           return h / 2;
+         }
+       }
+       return EDGE_NONE;
+     }
+     
+     int degree(int32_t node) const {
+       int count = 0;
+       for (int32_t h = firstHalf[node]; h != EDGE_NONE; h = nextHalf[h]) {
+         count++;
+       }
+       return count;
+     }
+     
+     // Walk a node's neighbours: for (h = first(n); h != EDGE_NONE; h = next(h))
+     int32_t first(int32_t node) const { return firstHalf[node]; }
+     int32_t next(int32_t half) const { return nextHalf[half]; }
+     int32_t neighbourOf(int32_t half) const { return neighbour[half]; }
+     static int32_t edgeOf(int32_t half) { return half / 2; }
+ };
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,147 @@
+/*
+ * FeatureWindow.h
+ *
+ * Circular buffer of feature columns (one column per time step) with
+ * running mean and variance for the first STAT_ROWS rows. Pushing a
+ * step costs O(ROWS) no matter how long the window is. No Arduino
+ * dependencies.
+ */
+
+ #ifndef FEATURE_WINDOW_H
+ #define FEATURE_WINDOW_H
+ 
+ #include <stdint.h>
+ 
+ #define FEATURE_RESYNC_STEPS 1024   // Recompute the running statistics this often to cancel float drift
+ 
+ template <int ROWS, int WINDOW, int STAT_ROWS>
+ class FeatureWindow {
+   static_assert(WINDOW >= 2 && WINDOW <= 4096, "Window length out of range");
+   static_assert(STAT_ROWS <= ROWS, "Statistics rows must be feature rows");
+   
+   private:
+     float values[WINDOW][ROWS];   // Column per time step
+     uint16_t head;                // Column the next step goes into
+     uint16_t count;
+     uint16_t stepsSinceResync;
+     
+     // Welford state per statistics row
+     float means[STAT_ROWS];
+     float m2[STAT_ROWS];
+     
+     // Exact recomputation over the stored window
+     void resync() {
+       for (int r = 0; r < STAT_ROWS; r++) {
+         float sum = 0;
+         for (int i = 0; i < count; i++) {
+           sum += values[i][r];
+         }
+         float mean = count > 0 ? sum / count : 0;
+         
+         float squares = 0;
+         for (int i = 0; i < count; i++) {
+           float diff = values[i][r] - mean;
+           squares += diff * diff;
+         }
+         means[r] = mean;
+         m2[r] = squares;
+       }
+       stepsSinceResync = 0;
+     }
+     
+   public:
+     static const int LENGTH = WINDOW;
+     
+     FeatureWindow() { clear(); }
+     
+     void clear() {
+       head = 0;
+       count = 0;
+       stepsSinceResync = 0;
+       for (int r = 0; r < STAT_ROWS; r++) {
+         means[r] = 0;
+         m2[r] = 0;
+       }
+       for (int i = 0; i < WINDOW; i++) {
+         for (int r = 0; r < ROWS; r++) {
+           values[i][r] = 0;
+         }
+       }
+     }
+     
+     // Add a time step, evicting the oldest one once the window is full
+     void push(const float* column) {
+       float* slot = values[head];
+       
+       if (count < WINDOW) {
+         // Growing window: plain Welford update
+         count++;
+         for (int r = 0; r < STAT_ROWS; r++) {
+           float delta = column[r] - means[r];
+           means[r] += delta / count;
+           m2[r] += delta * (column[r] - means[r]);
+         }
+       } else {
+         // Full window: replace the oldest value in the same update
+         for (int r = 0; r < STAT_ROWS; r++) {
+           float oldValue = slot[r];
+           float oldMean = means[r];
+           means[r] += (column[r] - oldValue) / WINDOW;
+           m2[r] += (column[r] - oldValue) * (column[r] - means[r] + oldValue - oldMean);
+         }
+       }
+       
+       for (int r = 0; r < ROWS; r++) {
+         slot[r] = column[r];
+       }
+       
+       head = (head + 1) % WINDOW;
+       
+       if (++stepsSinceResync >= FEATURE_RESYNC_STEPS) {
+         resync();
+       }
+     }
+     
+     // Newest column, for features computed after the push
+     float* latest() { return values[(head + WINDOW - 1) % WINDOW]; }
+     
+     // Value of a row, age 0 is the newest step
+     float at(int row, int age) const { return values[(head + WINDOW - 1 - age) % WINDOW][row]; }
+     
+     int size() const { return count; }
+     bool isEmpty() const { return count == 0; }
+     
+     // Write the full window, oldest step first, as int8 model input:
+     // q = x * scale[row] + offset[row], rounded and saturated
+     bool quantize(int8_t* out, const float* scale, const float* offset) const {
+       if (count < WINDOW) {
+         return false;
+       }
+       
+       int step = head; // Oldest column once the window is full
+       for (int i = 0; i < WINDOW; i++) {
+         const float* column = values[step];
+         for (int r = 0; r < ROWS; r++) {
+           float q = column[r] * scale[r] + offset[r];
+           if (q > 127) {
+             q = 127;
+           } else if (q < -128) {
+             q = -128;
+           }
+           *out++ = (int8_t)(q < 0 ? q - 0.5f : q + 0.5f);
+         }
+         step = step + 1 == WINDOW ? 0 : step + 1;
+       }
+       return true;
+     }
+     
+     float mean(int row) const { return means[row]; }
+     float variance(int row) const {
+       if (count == 0 || m2[row] <= 0) {
+         return 0;
+       }
+       return m2[row] / count;
+     }
+ };
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,111 @@
+/*
+ * FreeSpaceEstimator.cpp
+ *
+ * Implementation of the history-based free-space estimator
+ */
+
+ #include "FreeSpaceEstimator.h"
+ 
+ FreeSpaceEstimator::FreeSpaceEstimator() {
+   head = 0;
+   count = 0;
+ }
+ 
+ void FreeSpaceEstimator::addReading(uint32_t timestampUs, float headingDeg, int yawDeg, float distanceCm) {
+   int bearing = (int)(headingDeg + yawDeg) % 360;
+   if (bearing < 0) {
+     bearing += 360;
+   }
+   if (distanceCm < 0) {
+     distanceCm = 0;
+   }
+   
+   ClearanceReading& reading = history[head];
+   reading.timestampUs = timestampUs;
+   reading.bearingDeg = bearing;
+   reading.distanceCm = (uint16_t)distanceCm;
+   
+   head = (head + 1) % FREESPACE_HISTORY;
+   if (count < FREESPACE_HISTORY) {
+     count++;
+   }
+ }
+ 
+ void FreeSpaceEstimator::sideClearance(uint32_t nowUs, float headingDeg, float& left, float& right) const {
+   // Closest recent reading per sector, 0xFFFF = no data
+   uint16_t leftSectors[FREESPACE_SIDE_SECTORS];
+   uint16_t rightSectors[FREESPACE_SIDE_SECTORS];
+   for (int i = 0; i < FREESPACE_SIDE_SECTORS; i++) {
+     leftSectors[i] = 0xFFFF;
+     rightSectors[i] = 0xFFFF;
+   }
+   
+   for (int i = 0; i < count; i++) {
+     const ClearanceReading& reading = history[i];
+     if ((uint32_t)(nowUs - reading.timestampUs) > FREESPACE_MAX_AGE_US) {
+       continue;
+     }
+     
+     int relative = relativeBearing(reading.bearingDeg, headingDeg);
+     int offset = relative < 0 ? -relative : relative;
+     if (offset < FREESPACE_AHEAD_DEG) {
+       continue;
+     }
+     
+     int sector = (offset - FREESPACE_AHEAD_DEG) / FREESPACE_SECTOR_DEG;
+     if (sector >= FREESPACE_SIDE_SECTORS) {
+       continue;
+     }
+     
+     uint16_t* sectors = relative < 0 ? leftSectors : rightSectors;
+     if (reading.distanceCm < sectors[sector]) {
+       sectors[sector] = reading.distanceCm;
+     }
+   }
+   
+   left = 0;
+   right = 0;
+   for (int i = 0; i < FREESPACE_SIDE_SECTORS; i++) {
+     if (leftSectors[i] != 0xFFFF && leftSectors[i] > left) {
+       left = leftSectors[i];
+     }
+     if (rightSectors[i] != 0xFFFF && rightSectors[i] > right) {
+       right = rightSectors[i];
+     }
+   }
+ }
+ 
+ int FreeSpaceEstimator::recommend(uint32_t nowUs, float headingDeg) const {
+   float left, right;
+   sideClearance(nowUs, headingDeg, left, right);
+   
+   // Compare and suggest direction, unknown sides count as blocked
+   if (left > right * FREESPACE_MARGIN) {
+     return -1; // Suggest left
+   } else if (right > left * FREESPACE_MARGIN) {
+     return 1;  // Suggest right
+   }
+   return 0;    // Suggest stop/wait
+ }
+ 
+ float FreeSpaceEstimator::getLeftClearance(uint32_t nowUs, float headingDeg) const {
+   float left, right;
+   sideClearance(nowUs, headingDeg, left, right);
+   return left;
+ }
+ 
+ float FreeSpaceEstimator::getRightClearance(uint32_t nowUs, float headingDeg) const {
+   float left, right;
+   sideClearance(nowUs, headingDeg, left, right);
+   return right;
+ }
+ 
+ int FreeSpaceEstimator::relativeBearing(int bearingDeg, float headingDeg) {
+   int relative = bearingDeg - (int)headingDeg;
+   
+   // Normalize to -180 to +180
+   while (relative > 180) relative -= 360;
+   while (relative <= -180) relative += 360;
+   
+   return relative;
+ }
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+ * FreeSpaceEstimator.h
+ *
+ * Keeps a short history of timestamped range readings tagged with the
+ * bearing they were taken at (walking heading plus sensor yaw) and
+ * turns it into a left/right/stop recommendation without taking any
+ * new measurements. Readings only reach the side sectors when the
+ * sensor or the cane points away from the walking heading; see
+ * ObstacleDetection::setSweepYaw(). No Arduino dependencies.
+ */
+
+ #ifndef FREE_SPACE_ESTIMATOR_H
+ #define FREE_SPACE_ESTIMATOR_H
+ 
+ #include <stdint.h>
+ 
+ #define FREESPACE_MAX_AGE_US 3000000    // Readings older than this are ignored
+ #define FREESPACE_MAX_READING_RATE 50   // Per second: one per scan slot, slots last over 20 ms
+ #define FREESPACE_HISTORY (FREESPACE_MAX_AGE_US / 1000000 * FREESPACE_MAX_READING_RATE)  // All readings of that age
+ #define FREESPACE_SECTOR_DEG 20         // Width of one side sector
+ #define FREESPACE_SIDE_SECTORS 4        // Sectors per side, from 10 to 90 degrees off heading
+ #define FREESPACE_AHEAD_DEG 10          // Bearings within this are straight ahead
+ #define FREESPACE_MARGIN 1.25           // One side must be this much clearer to be suggested
+ 
+ // One reading in the history
+ struct ClearanceReading {
+   uint32_t timestampUs;
+   int16_t bearingDeg;   // Absolute bearing, 0-359
+   uint16_t distanceCm;
+ };
+ 
+ class FreeSpaceEstimator {
+   private:
+     ClearanceReading history[FREESPACE_HISTORY];
+     uint16_t head;
+     uint16_t count;
+     
+     // Best opening on one side: the clearest sector, where each sector
+     // is as clear as its closest recent reading. 0 if nothing is known.
+     void sideClearance(uint32_t nowUs, float headingDeg, float& left, float& right) const;
+     
+   public:
+     FreeSpaceEstimator();
+     
+     // Record a reading taken while walking at headingDeg by a sensor mounted at yawDeg
+     void addReading(uint32_t timestampUs, float headingDeg, int yawDeg, float distanceCm);
+     
+     // -1 for left, 0 for stop, 1 for right
+     int recommend(uint32_t nowUs, float headingDeg) const;
+     
+     // Clearance on each side of the current heading (in cm)
+     float getLeftClearance(uint32_t nowUs, float headingDeg) const;
+     float getRightClearance(uint32_t nowUs, float headingDeg) const;
+     
+     int getReadingCount() const { return count; }
+     void clear() { head = 0; count = 0; }
+     
+     // Signed difference between two bearings, -180 to +180
+     static int relativeBearing(int bearingDeg, float headingDeg);
+ };
+ 
+ #endif
\ No newline at end of file
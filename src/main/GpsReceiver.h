@@ -0,0 +1,114 @@
+/*
+ * GpsReceiver.h
+ *
+ * GPS input in three stages, each in its own context:
+ *  - capture: the UART receive event copies bytes into a ring buffer and
+ *    notes when each line ended, however long the main loop is blocked
+ *  - parse: a separate task feeds the ring through the NMEA parser and
+ *    publishes each fix, stamped with its sentence's last byte
+ *  - read: the main loop takes the latest fix from a lock-free slot
+ * No Arduino dependencies so it can be driven by a simulated clock.
+ */
+
+ #ifndef GPS_RECEIVER_H
+ #define GPS_RECEIVER_H
+ 
+ #include <stdint.h>
+ #include <stddef.h>
+ #include <atomic>
+ #include "SpscRing.h"
+ #include "SpscSlot.h"
+ #include "NmeaParser.h"
+ 
+ #define GPS_RING_BYTES 2048    // About two seconds of NMEA at 9600 baud
+ #define GPS_LINE_STAMPS 128    // Line ends waiting to be parsed
+ #define GPS_BITS_PER_BYTE 10   // Start bit, eight data bits, stop bit
+ 
+ // Arrival time of the line with the given number
+ struct GpsLineStamp {
+   uint32_t line;
+   uint32_t us;
+ };
+ 
+ class GpsReceiver {
+   private:
+     SpscRing<uint8_t, GPS_RING_BYTES> bytes;
+     SpscRing<GpsLineStamp, GPS_LINE_STAMPS> lineEnds;
+     SpscSlot<GpsFix> fixes;
+     uint32_t byteUs;
+     
+     // Capture stage
+     uint32_t capturedLines;
+     std::atomic<uint32_t> capturedBytes;
+     
+     // Parse stage
+     NmeaParser parser;
+     uint32_t parsedLines;
+     GpsLineStamp pending;
+     bool hasPending;
+     
+     // When the given line ended; the parse time if its stamp was dropped
+     uint32_t lineEnd(uint32_t line, uint32_t nowUs) {
+       while (hasPending || lineEnds.pop(pending)) {
+         hasPending = true;
+         if (pending.line == line) {
+           hasPending = false;
+           return pending.us;
+         }
+         if (pending.line > line) {
+           break;
+         }
+         hasPending = false;
+       }
+       return nowUs;
+     }
+     
+   public:
+     GpsReceiver(uint32_t baud = 9600)
+         : byteUs(GPS_BITS_PER_BYTE * 1000000UL / baud), capturedLines(0), capturedBytes(0), parsedLines(0),
+           hasPending(false) {}
+     
+     // Capture stage: bytes read from the UART at nowUs. Earlier bytes of a
+     // chunk arrived a character time apart before the last one.
+     void capture(const uint8_t* data, size_t length, uint32_t nowUs) {
+       for (size_t i = 0; i < length; i++) {
+         if (!bytes.push(data[i])) {
+           continue;
+         }
+         if (data[i] == '\n') {
+           GpsLineStamp stamp = {++capturedLines, nowUs - (uint32_t)(length - 1 - i) * byteUs};
+           lineEnds.push(stamp);
+         }
+       }
+       capturedBytes.fetch_add(length, std::memory_order_relaxed);
+     }
+     
+     // Parse stage: everything captured so far. Returns the fixes published.
+     int parse(uint32_t nowUs) {
+       int published = 0;
+       uint8_t c;
+       while (bytes.pop(c)) {
+         if (c == '\n') {
+           parsedLines++;
+         }
+         if (parser.encode(c)) {
+           GpsFix fix = parser.getFix();
+           fix.lineEndUs = lineEnd(parsedLines, nowUs);
+           fixes.publish(fix);
+           published++;
+         }
+       }
+       return published;
+     }
+     
+     // Read stage: the latest fix, if one was published since the last call
+     bool readFix(GpsFix& fix) { return fixes.read(fix); }
+     
+     uint32_t getCapturedBytes() const { return capturedBytes.load(std::memory_order_relaxed); }
+     uint16_t getDroppedBytes() const { return bytes.getOverruns(); }
+     uint16_t getReplacedFixes() const { return fixes.getReplaced(); }
+     uint32_t getSentences() const { return parser.getSentences(); }
+     uint32_t getChecksumErrors() const { return parser.getChecksumErrors(); }
+ };
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,232 @@
+/*
+ * LandmarkHeuristic.h
+ *
+ * ALT route heuristic: walked distances from a few landmark nodes to every
+ * node, so that |d(L, a) - d(L, b)| bounds the walk from a to b far more
+ * tightly than the straight line does when the map has detours. Named
+ * places are taken as landmarks first, since a route that starts or ends
+ * at a landmark gets an exact estimate; the rest are spread out by picking
+ * the node farthest from those already chosen.
+ *
+ * Distances are kept in whole eighths of a meter, summed from edge lengths
+ * rounded down, which keeps the estimate consistent without any float
+ * tables. New edges only shorten walks, so they are patched in by
+ * relaxing outwards from their ends. Removed or longer edges need nothing:
+ * the old distances still never overestimate. No Arduino dependencies.
+ */
+
+ #ifndef LANDMARK_HEURISTIC_H
+ #define LANDMARK_HEURISTIC_H
+ 
+ #include <stdint.h>
+ 
+ // Table resolution; 16-bit entries then reach 8 km of walking
+ #ifndef LANDMARK_UNITS_PER_M
+ #define LANDMARK_UNITS_PER_M 8
+ #endif
+ #define LANDMARK_FAR 0xFFFF   // Not reached, or out of range
+ #define LANDMARK_NONE -1
+ 
+ template <int MAX_NODES, int LANDMARKS>
+ class LandmarkHeuristic {
+   static_assert(MAX_NODES <= INT16_MAX, "The search queue holds 16-bit nodes");
+   
+   private:
+     uint16_t walk[LANDMARKS][MAX_NODES];  // From landmark l to each node
+     int32_t landmark[LANDMARKS];
+     int landmarkCount;
+     
+     // Nodes whose distance went down, nearest first, while a row is updated
+     int16_t queue[MAX_NODES];
+     int16_t queuePos[MAX_NODES];
+     int queueSize;
+     
+     static const int16_t NOT_QUEUED = -1;
+     
+     static uint32_t unitsOf(float meters) { return (uint32_t)(meters * LANDMARK_UNITS_PER_M); }
+     
+     void place(int pos, int16_t node) {
+       queue[pos] = node;
+       queuePos[node] = pos;
+     }
+     
+     void siftUp(const uint16_t* row, int pos) {
+       int16_t node = queue[pos];
+       while (pos > 0 && row[queue[(pos - 1) / 2]] > row[node]) {
+         place(pos, queue[(pos - 1) / 2]);
+         pos = (pos - 1) / 2;
+       }
+       place(pos, node);
+     }
+     
+     void siftDown(const uint16_t* row, int pos) {
+       int16_t node = queue[pos];
+       while (true) {
+         int child = 2 * pos + 1;
+         if (child >= queueSize) {
+           break;
+         }
+         if (child + 1 < queueSize && row[queue[child + 1]] < row[queue[child]]) {
+           child++;
+         }
+         if (row[queue[child]] >= row[node]) {
+           break;
+         }
+         place(pos, queue[child]);
+         pos = child;
+       }
+       place(pos, node);
+     }
+     
+     // Lower a node's distance and queue it to pass the change on
+     void lower(uint16_t* row, int32_t node, uint32_t units) {
+       if (units >= row[node]) {
+         return;
+       }
+       row[node] = units;
+       if (queuePos[node] == NOT_QUEUED) {
+         queuePos[node] = queueSize++;
+         queue[queuePos[node]] = node;
+       }
+       siftUp(row, queuePos[node]);
+     }
+     
+     // Dijkstra from the queued nodes, over integer edge lengths
+     template <typename Graph>
+     void settle(uint16_t* row, Graph& graph) {
+       while (queueSize > 0) {
+         int16_t node = queue[0];
+         queuePos[node] = NOT_QUEUED;
+         if (--queueSize > 0) {
+           queue[0] = queue[queueSize];
+           siftDown(row, 0);
+         }
+         for (int32_t h = graph.first(node); h >= 0; h = graph.next(h)) {
+           lower(row, graph.neighbourOf(h), row[node] + unitsOf(graph.weight(h)));
+         }
+       }
+     }
+     
+     template <typename Graph>
+     void fillRow(uint16_t* row, int32_t from, Graph& graph) {
+       for (int n = 0; n < MAX_NODES; n++) {
+         row[n] = LANDMARK_FAR;
+       }
+       lower(row, from, 0);
+       settle(row, graph);
+     }
+     
+     // The node, preferred or not, farthest from every landmark so far
+     template <typename Graph>
+     int32_t farthest(int nodeCount, Graph& graph, bool preferredOnly) {
+       int32_t best = LANDMARK_NONE;
+       uint32_t bestUnits = 0;
+       for (int32_t n = 0; n < nodeCount; n++) {
+         if (graph.first(n) < 0 || (preferredOnly && !graph.isPreferred(n))) {
+           continue;
+         }
+         uint32_t units = LANDMARK_FAR;
+         for (int l = 0; l < landmarkCount; l++) {
+           if (walk[l][n] < units) {
+             units = walk[l][n];
+           }
+         }
+         if (units == LANDMARK_FAR && landmarkCount > 0) {
+           continue;  // Cut off from every landmark so far
+         }
+         if (best == LANDMARK_NONE || units > bestUnits) {
+           best = n;
+           bestUnits = units;
+         }
+       }
+       return bestUnits > 0 ? best : LANDMARK_NONE;
+     }
+     
+   public:
+     LandmarkHeuristic() {
+       landmarkCount = 0;
+       queueSize = 0;
+       for (int n = 0; n < MAX_NODES; n++) {
+         queuePos[n] = NOT_QUEUED;
+       }
+     }
+     
+     void clear() {
+       landmarkCount = 0;
+     }
+     
+     // Choose the landmarks and fill in their distances. The graph walks
+     // edges like EdgeIndex, with first(n), next(h) and neighbourOf(h) and
+     // a negative half-edge at the end of a list, plus weight(h) in meters
+     // and isPreferred(n) for named places, which take up to half the
+     // landmarks. Nodes without edges are never chosen.
+     template <typename Graph>
+     void build(int nodeCount, Graph& graph) {
+       landmarkCount = 0;
+       while (landmarkCount < LANDMARKS) {
+         int32_t next = LANDMARK_NONE;
+         if (landmarkCount < (LANDMARKS + 1) / 2) {
+           next = farthest(nodeCount, graph, true);
+         }
+         if (next == LANDMARK_NONE) {
+           next = farthest(nodeCount, graph, false);
+         }
+         if (next == LANDMARK_NONE) {
+           break;  // Every node with edges is already a landmark
+         }
+         
+         // With no named places, start from the far end of a first search
+         if (landmarkCount == 0 && !graph.isPreferred(next)) {
+           fillRow(walk[0], next, graph);
+           landmarkCount = 1;
+           next = farthest(nodeCount, graph, false);
+           landmarkCount = 0;
+         }
+         landmark[landmarkCount] = next;
+         fillRow(walk[landmarkCount], next, graph);
+         landmarkCount++;
+       }
+     }
+     
+     // A node slot was taken for a new node, which no walk reaches yet
+     void addNode(int32_t node) {
+       for (int l = 0; l < landmarkCount; l++) {
+         walk[l][node] = LANDMARK_FAR;
+       }
+     }
+     
+     // An edge was added or shortened: pass the shorter walks on through it
+     template <typename Graph>
+     void addEdge(int32_t a, int32_t b, float meters, Graph& graph) {
+       uint32_t units = unitsOf(meters);
+       for (int l = 0; l < landmarkCount; l++) {
+         uint16_t* row = walk[l];
+         lower(row, b, row[a] + units);
+         lower(row, a, row[b] + units);
+         settle(row, graph);
+       }
+     }
+     
+     // Lower bound on the walk between two nodes, in meters
+     float estimate(int32_t a, int32_t b) const {
+       uint32_t best = 0;
+       for (int l = 0; l < landmarkCount; l++) {
+         uint32_t fromA = walk[l][a], fromB = walk[l][b];
+         if (fromA == LANDMARK_FAR || fromB == LANDMARK_FAR) {
+           continue;
+         }
+         uint32_t gap = fromA > fromB ? fromA - fromB : fromB - fromA;
+         if (gap > best) {
+           best = gap;
+         }
+       }
+       return (float)best / LANDMARK_UNITS_PER_M;
+     }
+     
+     bool isBuilt() const { return landmarkCount > 0; }
+     int getLandmarkCount() const { return landmarkCount; }
+     int32_t getLandmark(int l) const { return landmark[l]; }
+     uint16_t getWalk(int l, int32_t node) const { return walk[l][node]; }
+ };
+ 
+ #endif
\ No newline at end of file
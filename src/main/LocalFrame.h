@@ -0,0 +1,121 @@
+/*
+ * LocalFrame.h
+ *
+ * Local east/north frame in whole centimetres around an origin, for the
+ * short-range distance checks of the map. Converting a position costs
+ * two subtractions and two multiplies; comparing distances is integer
+ * math on squared centimetres, with no trig and no square root.
+ *
+ * The frame is equirectangular at the origin latitude. For points within
+ * LOCAL_FRAME_RADIUS_M of the origin the distance differs from the
+ * great-circle distance by at most tan|lat0| * r / R of its length (under
+ * 0.06% at 60 degrees of latitude) plus 1.5 cm of rounding. Callers move
+ * the origin once the user leaves that radius. No Arduino dependencies.
+ */
+
+ #ifndef LOCAL_FRAME_H
+ #define LOCAL_FRAME_H
+ 
+ #include <stdint.h>
+ #include <math.h>
+ 
+ #define LOCAL_FRAME_CM_PER_DEG 11119493.0f  // One degree of a great circle on the 6371 km sphere
+ #define LOCAL_FRAME_MIN_COS_LAT 0.01f
+ #define LOCAL_FRAME_MAX_CM 1000000000       // Clamp far positions so squares fit in 64 bits
+ #ifndef LOCAL_FRAME_RADIUS_M
+ #define LOCAL_FRAME_RADIUS_M 2000           // Move the origin beyond this
+ #endif
+ 
+ // Position in the frame, in centimetres east and north of the origin
+ struct LocalPoint {
+   int32_t east;
+   int32_t north;
+ };
+ 
+ class LocalFrame {
+   private:
+     float originLat;
+     float originLng;
+     float cmPerDegLng;
+     bool set;
+     
+     static int32_t toCm(float cm) {
+       if (cm > LOCAL_FRAME_MAX_CM) {
+         return LOCAL_FRAME_MAX_CM;
+       }
+       if (cm < -LOCAL_FRAME_MAX_CM) {
+         return -LOCAL_FRAME_MAX_CM;
+       }
+       return (int32_t)lroundf(cm);
+     }
+     
+   public:
+     LocalFrame() {
+       originLat = 0;
+       originLng = 0;
+       cmPerDegLng = LOCAL_FRAME_CM_PER_DEG;
+       set = false;
+     }
+     
+     // The only trig call, once per origin
+     void setOrigin(float lat, float lng) {
+       float cosLat = cosf(lat * (float)M_PI / 180.0f);
+       originLat = lat;
+       originLng = lng;
+       cmPerDegLng = LOCAL_FRAME_CM_PER_DEG * (cosLat > LOCAL_FRAME_MIN_COS_LAT ? cosLat : LOCAL_FRAME_MIN_COS_LAT);
+       set = true;
+     }
+     
+     bool isSet() const { return set; }
+     float getOriginLat() const { return originLat; }
+     float getOriginLng() const { return originLng; }
+     
+     LocalPoint toLocal(float lat, float lng) const {
+       LocalPoint point = {toCm((lng - originLng) * cmPerDegLng), toCm((lat - originLat) * LOCAL_FRAME_CM_PER_DEG)};
+       return point;
+     }
+     
+     void toGeo(const LocalPoint& point, float& lat, float& lng) const {
+       lat = originLat + point.north / LOCAL_FRAME_CM_PER_DEG;
+       lng = originLng + point.east / cmPerDegLng;
+     }
+     
+     // Whether a point is close enough to the origin for the error bound
+     bool isInside(const LocalPoint& point) const {
+       LocalPoint origin = {0, 0};
+       return isWithin(origin, point, LOCAL_FRAME_RADIUS_M);
+     }
+     
+     static int64_t distanceSquared(const LocalPoint& a, const LocalPoint& b) {
+       int64_t east = (int64_t)a.east - b.east;
+       int64_t north = (int64_t)a.north - b.north;
+       return east * east + north * north;
+     }
+     
+     // Squared radius to compare distanceSquared() against
+     static int64_t radiusSquared(float meters) {
+       int64_t cm = (int64_t)(meters * 100.0f);
+       return cm * cm;
+     }
+     
+     static bool isWithin(const LocalPoint& a, const LocalPoint& b, float meters) {
+       return distanceSquared(a, b) <= radiusSquared(meters);
+     }
+     
+     // Meters, for edge weights and the route heuristic
+     static float distance(const LocalPoint& a, const LocalPoint& b) {
+       return sqrtf((float)distanceSquared(a, b)) / 100.0f;
+     }
+     
+     // Meters from a point to the segment a-b
+     static float segmentDistance(const LocalPoint& point, const LocalPoint& a, const LocalPoint& b) {
+       float east = (float)b.east - a.east, north = (float)b.north - a.north;
+       float length = east * east + north * north;
+       float t = length > 0 ? (((float)point.east - a.east) * east + ((float)point.north - a.north) * north) / length : 0;
+       t = t < 0 ? 0 : (t > 1 ? 1 : t);
+       float dEast = a.east + t * east - point.east, dNorth = a.north + t * north - point.north;
+       return sqrtf(dEast * dEast + dNorth * dNorth) / 100.0f;
+     }
+ };
+ 
+ #endif
\ No newline at end of file
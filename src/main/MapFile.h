@@ -0,0 +1,349 @@
+/*
+ * MapFile.h
+ *
+ * Binary map file, written and read in chunks through one small buffer
+ * so saving or loading any map size needs the same few kilobytes.
+ *
+ * Layout (little-endian):
+ *   header   32 bytes: "SGMP", version, header size, node, edge and
+ *            name counts, string pool size, generation, CRC-32 of the rest
+ *   chunks   12-byte chunk header (type, record count, payload size,
+ *            CRC-32 of the payload) followed by the payload:
+ *              NODES   20-byte records: lat/lng in 1e-7 degrees, type,
+ *                      obstacle type, flags, visit count, last seen
+ *              EDGES   20-byte records: source, target, weight, traverse
+ *                      count, last traversed (source and target -1 for
+ *                      a free slot)
+ *              STRINGS raw bytes of the landmark name pool
+ *              NAMES   8-byte records: node handle, pool offset
+ *              END     no payload, marks a complete file
+ *
+ * Works with any Output/Input offering write(const uint8_t*, size_t) and
+ * read(uint8_t*, size_t), such as an SD File. No Arduino dependencies.
+ */
+
+ #ifndef MAP_FILE_H
+ #define MAP_FILE_H
+ 
+ #include <stdint.h>
+ #include <string.h>
+ #include <math.h>
+ #include "Crc32.h"
+ #include "ObstacleTypes.h"
+ 
+ #define MAPFILE_VERSION 1
+ #define MAPFILE_HEADER_BYTES 32
+ #define MAPFILE_CHUNK_HEADER_BYTES 12
+ #define MAPFILE_CHUNK_RECORDS 64
+ #define MAPFILE_NODE_BYTES 20
+ #define MAPFILE_EDGE_BYTES 20
+ #define MAPFILE_NAME_BYTES 8
+ #define MAPFILE_CHUNK_PAYLOAD (MAPFILE_CHUNK_RECORDS * MAPFILE_NODE_BYTES)
+ #define MAPFILE_COORD_SCALE 1e7
+ 
+ enum class MapFileStatus : uint8_t {
+   OK,
+   IN_PROGRESS,    // A save started with beginSave has more chunks to write
+   TRUNCATED,      // Loaded, but the file held more than fits in memory
+   IO_ERROR,       // Short read or write, including a file cut short
+   BAD_HEADER,
+   BAD_VERSION,
+   BAD_CHUNK,
+   BAD_CRC
+ };
+ 
+ enum class MapChunk : uint8_t {
+   NODES = 1,
+   EDGES = 2,
+   STRINGS = 3,
+   NAMES = 4,
+   END = 0xFF
+ };
+ 
+ class MapFile {
+   private:
+     enum class Section : uint8_t { HEADER, NODES, EDGES, STRINGS, NAMES, END, DONE };
+     
+     uint8_t buffer[MAPFILE_CHUNK_HEADER_BYTES + MAPFILE_CHUNK_PAYLOAD];
+     uint16_t chunkRecords;
+     uint32_t chunkBytes;
+     
+     // Save progress, so a save can be spread over several calls
+     Section section;
+     uint32_t cursor;
+     uint32_t saveNodes, saveEdges, saveNamed, savePool;
+     uint32_t generation;
+     
+     uint8_t* payload() { return buffer + MAPFILE_CHUNK_HEADER_BYTES; }
+     
+     template <typename Output>
+     bool writeChunk(Output& out, MapChunk type) {
+       buffer[0] = (uint8_t)type;
+       buffer[1] = 0;
+       put16(buffer + 2, chunkRecords);
+       put32(buffer + 4, chunkBytes);
+       put32(buffer + 8, crc32(payload(), chunkBytes));
+       
+       size_t total = MAPFILE_CHUNK_HEADER_BYTES + chunkBytes;
+       return (size_t)out.write(buffer, total) == total;
+     }
+     
+     // Fill the buffer with the section's next records. False once the section is done.
+     template <typename Store, typename Names>
+     bool fillChunk(const Store& store, const Names& names) {
+       chunkRecords = 0;
+       chunkBytes = 0;
+       uint8_t* record = payload();
+       
+       if (section == Section::NODES) {
+         for (; cursor < saveNodes && chunkRecords < MAPFILE_CHUNK_RECORDS; cursor++, chunkRecords++) {
+           put32(record, toFixed(store.getLat(cursor)));
+           put32(record + 4, toFixed(store.getLng(cursor)));
+           record[8] = (uint8_t)store.getType(cursor);
+           record[9] = (uint8_t)store.getObstacleType(cursor);
+           record[10] = store.getFlags(cursor);
+           record[11] = 0;
+           put16(record + 12, store.getVisitCount(cursor));
+           put16(record + 14, 0);
+           put32(record + 16, store.getLastSeen(cursor));
+           record += MAPFILE_NODE_BYTES;
+         }
+         chunkBytes = chunkRecords * MAPFILE_NODE_BYTES;
+       } else if (section == Section::EDGES) {
+         for (; cursor < saveEdges && chunkRecords < MAPFILE_CHUNK_RECORDS; cursor++, chunkRecords++) {
+           put32(record, store.getSource(cursor));
+           put32(record + 4, store.getTarget(cursor));
+           put32(record + 8, floatBits(store.getWeight(cursor)));
+           put16(record + 12, store.getTraverseCount(cursor));
+           put16(record + 14, 0);
+           put32(record + 16, store.getLastTraversed(cursor));
+           record += MAPFILE_EDGE_BYTES;
+         }
+         chunkBytes = chunkRecords * MAPFILE_EDGE_BYTES;
+       } else if (section == Section::STRINGS) {
+         // Raw pool bytes, in payload-sized pieces
+         chunkBytes = savePool - cursor;
+         if (chunkBytes > MAPFILE_CHUNK_PAYLOAD) {
+           chunkBytes = MAPFILE_CHUNK_PAYLOAD;
+         }
+         memcpy(record, names.getPool() + cursor, chunkBytes);
+         cursor += chunkBytes;
+       } else if (section == Section::NAMES) {
+         for (; cursor < saveNamed && chunkRecords < MAPFILE_CHUNK_RECORDS; cursor++, chunkRecords++) {
+           put32(record, names.getNamedNode(cursor));
+           put32(record + 4, names.getEntryOffset(cursor));
+           record += MAPFILE_NAME_BYTES;
+         }
+         chunkBytes = chunkRecords * MAPFILE_NAME_BYTES;
+       }
+       return chunkBytes > 0;
+     }
+     
+   public:
+     static void put16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+     static void put32(uint8_t* p, uint32_t v) { put16(p, v); put16(p + 2, v >> 16); }
+     static uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+     static uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+     
+     static uint32_t floatBits(float f) { uint32_t v; memcpy(&v, &f, 4); return v; }
+     static float bitsFloat(uint32_t v) { float f; memcpy(&f, &v, 4); return f; }
+     
+     static int32_t toFixed(float degrees) { return (int32_t)lround(degrees * MAPFILE_COORD_SCALE); }
+     static float fromFixed(int32_t fixed) { return (float)(fixed / MAPFILE_COORD_SCALE); }
+     
+     // Stored edge endpoints: two nodes of the map, or none for a free slot
+     template <typename Store>
+     static bool isEdgeRecord(const Store& store, int32_t source, int32_t target) {
+       return (store.isNode(source) && store.isNode(target)) || (source == -1 && target == -1);
+     }
+     
+     MapFile() {
+       section = Section::DONE;
+       generation = 0;
+     }
+     
+     // Start a save of the map as it is now. Records added later are
+     // left out, so the map may keep growing while the save runs, but
+     // existing names must not be changed until it finishes.
+     template <typename Store, typename Names>
+     void beginSave(const Store& store, const Names& names, uint32_t saveGeneration) {
+       section = Section::HEADER;
+       cursor = 0;
+       saveNodes = store.getNodeCount();
+       saveEdges = store.getEdgeCount();
+       saveNamed = names.getNamedCount();
+       savePool = names.getPoolUsed();
+       generation = saveGeneration;
+     }
+     
+     // Write up to maxChunks chunks. IN_PROGRESS until the end marker is out.
+     template <typename Output, typename Store, typename Names>
+     MapFileStatus saveStep(Output& out, const Store& store, const Names& names, int maxChunks) {
+       for (int written = 0; written < maxChunks && section != Section::DONE; ) {
+         bool ok = true;
+         if (section == Section::HEADER) {
+           uint8_t* header = buffer;
+           memcpy(header, "SGMP", 4);
+           put16(header + 4, MAPFILE_VERSION);
+           put16(header + 6, MAPFILE_HEADER_BYTES);
+           put32(header + 8, saveNodes);
+           put32(header + 12, saveEdges);
+           put32(header + 16, saveNamed);
+           put32(header + 20, savePool);
+           put32(header + 24, generation);
+           put32(header + 28, crc32(header, 28));
+           ok = (size_t)out.write(header, MAPFILE_HEADER_BYTES) == MAPFILE_HEADER_BYTES;
+           section = Section::NODES;
+           written++;
+         } else if (section == Section::END) {
+           chunkRecords = 0;
+           chunkBytes = 0;
+           ok = writeChunk(out, MapChunk::END);
+           section = Section::DONE;
+           written++;
+         } else if (fillChunk(store, names)) {
+           static const MapChunk types[] = {MapChunk::NODES, MapChunk::EDGES, MapChunk::STRINGS, MapChunk::NAMES};
+           ok = writeChunk(out, types[(int)section - (int)Section::NODES]);
+           written++;
+         } else {
+           section = (Section)((int)section + 1);
+           cursor = 0;
+         }
+         
+         if (!ok) {
+           section = Section::DONE;
+           return MapFileStatus::IO_ERROR;
+         }
+       }
+       return section == Section::DONE ? MapFileStatus::OK : MapFileStatus::IN_PROGRESS;
+     }
+     
+     template <typename Output, typename Store, typename Names>
+     MapFileStatus save(Output& out, const Store& store, const Names& names, uint32_t saveGeneration = 0) {
+       beginSave(store, names, saveGeneration);
+       MapFileStatus status;
+       do {
+         status = saveStep(out, store, names, MAPFILE_CHUNK_RECORDS);
+       } while (status == MapFileStatus::IN_PROGRESS);
+       return status;
+     }
+     
+     // Generation number of the last file saved or loaded
+     uint32_t getGeneration() const { return generation; }
+     
+     // Replace the store and names with the file's contents. On any
+     // status other than OK or TRUNCATED both are left empty.
+     template <typename Input, typename Store, typename Names>
+     MapFileStatus load(Input& in, Store& store, Names& names) {
+       store.clear();
+       names.clear();
+       MapFileStatus status = readChunks(in, store, names);
+       if (status != MapFileStatus::OK && status != MapFileStatus::TRUNCATED) {
+         store.clear();
+         names.clear();
+       }
+       return status;
+     }
+     
+   private:
+     template <typename Input, typename Store, typename Names>
+     MapFileStatus readChunks(Input& in, Store& store, Names& names) {
+       uint8_t* header = buffer;
+       if ((size_t)in.read(header, MAPFILE_HEADER_BYTES) != MAPFILE_HEADER_BYTES) {
+         return MapFileStatus::IO_ERROR;
+       }
+       if (memcmp(header, "SGMP", 4) != 0 || get32(header + 28) != crc32(header, 28)) {
+         return MapFileStatus::BAD_HEADER;
+       }
+       if (get16(header + 4) != MAPFILE_VERSION || get16(header + 6) != MAPFILE_HEADER_BYTES) {
+         return MapFileStatus::BAD_VERSION;
+       }
+       uint32_t nodeCount = get32(header + 8);
+       uint32_t edgeCount = get32(header + 12);
+       uint32_t namedCount = get32(header + 16);
+       uint32_t poolBytes = get32(header + 20);
+       generation = get32(header + 24);
+       
+       bool truncated = false;
+       uint32_t nodesRead = 0, edgesRead = 0, namesRead = 0, poolRead = 0;
+       
+       while (true) {
+         if ((size_t)in.read(buffer, MAPFILE_CHUNK_HEADER_BYTES) != MAPFILE_CHUNK_HEADER_BYTES) {
+           return MapFileStatus::IO_ERROR;
+         }
+         MapChunk type = (MapChunk)buffer[0];
+         uint16_t records = get16(buffer + 2);
+         uint32_t bytes = get32(buffer + 4);
+         uint32_t crc = get32(buffer + 8);
+         
+         if (type == MapChunk::END) {
+           break;
+         }
+         
+         uint32_t recordBytes = type == MapChunk::NODES ? MAPFILE_NODE_BYTES :
+                                type == MapChunk::EDGES ? MAPFILE_EDGE_BYTES :
+                                type == MapChunk::NAMES ? MAPFILE_NAME_BYTES : 0;
+         if (bytes > MAPFILE_CHUNK_PAYLOAD ||
+             (type == MapChunk::STRINGS ? records != 0 : recordBytes == 0 || bytes != records * recordBytes)) {
+           return MapFileStatus::BAD_CHUNK;
+         }
+         if ((size_t)in.read(payload(), bytes) != bytes) {
+           return MapFileStatus::IO_ERROR;
+         }
+         if (crc32(payload(), bytes) != crc) {
+           return MapFileStatus::BAD_CRC;
+         }
+         
+         const uint8_t* record = payload();
+         for (uint16_t r = 0; r < records; r++, record += recordBytes) {
+           if (type == MapChunk::NODES) {
+             nodesRead++;
+             int32_t node = store.addNode(fromFixed(get32(record)), fromFixed(get32(record + 4)),
+                                          (NodeType)record[8], get32(record + 16));
+             if (node < 0) {
+               truncated = true;
+               continue;
+             }
+             store.setObstacleType(node, (ObstacleType)record[9]);
+             store.setFlags(node, record[10]);
+             store.setVisitCount(node, get16(record + 12));
+           } else if (type == MapChunk::EDGES) {
+             edgesRead++;
+             int32_t source = get32(record);
+             int32_t target = get32(record + 4);
+             int32_t edge = -1;
+             if (isEdgeRecord(store, source, target)) {
+               edge = store.addEdge(source, target, bitsFloat(get32(record + 8)), get32(record + 16));
+             }
+             if (edge < 0) {
+               truncated = true;
+               continue;
+             }
+             store.setTraverseCount(edge, get16(record + 12));
+           } else {
+             namesRead++;
+             int32_t node = get32(record);
+             uint32_t offset = get32(record + 4);
+             if (!store.isNode(node) || offset > 0xFFFF || !names.restoreEntry(node, offset)) {
+               truncated = true;
+             }
+           }
+         }
+         
+         if (type == MapChunk::STRINGS) {
+           poolRead += bytes;
+           if (!names.appendPool((const char*)payload(), bytes)) {
+             truncated = true;
+           }
+         }
+       }
+       
+       // Every record the header announced must have been there
+       if (nodesRead != nodeCount || edgesRead != edgeCount || namesRead != namedCount || poolRead != poolBytes) {
+         return MapFileStatus::BAD_CHUNK;
+       }
+       return truncated ? MapFileStatus::TRUNCATED : MapFileStatus::OK;
+     }
+ };
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,406 @@
+/*
+ * MapJournal.h
+ *
+ * Keeps the map on the SD card up to date without rewriting it. Every
+ * change is appended to a journal as a small checksummed record, and
+ * the saved map is the last snapshot (MapFile) plus its journal. Once
+ * the journal grows past MAPJOURNAL_COMPACT_BYTES a new snapshot is
+ * written a few chunks per call while the map keeps changing, and
+ * replaces the old one when complete.
+ *
+ * Power-cut safety:
+ * - A record overwrites the whole state of a node or edge, so replaying
+ *   one that the snapshot already holds changes nothing.
+ * - A record cut short fails its CRC and ends the replay there.
+ * - Snapshots and journals carry a generation number. Compaction opens
+ *   the next journal before starting the snapshot, so changes made while
+ *   the snapshot is written are in the new journal, and an interrupted
+ *   compaction is recovered from the old snapshot and both journals.
+ *
+ * Works with any file system offering open/exists/remove/rename like
+ * the Arduino SD library. No Arduino dependencies.
+ */
+
+ #ifndef MAP_JOURNAL_H
+ #define MAP_JOURNAL_H
+ 
+ #include <stdint.h>
+ #include <string.h>
+ #include <utility>
+ #include "Crc32.h"
+ #include "MapFile.h"
+ #include "MapStore.h"
+ 
+ #define MAPJOURNAL_SNAPSHOT "/map_data.bin"
+ #define MAPJOURNAL_TEMP "/map_data.tmp"
+ #define MAPJOURNAL_EVEN "/map_journal_0.bin"   // Journal of even generations
+ #define MAPJOURNAL_ODD "/map_journal_1.bin"
+ 
+ #define MAPJOURNAL_HEADER_BYTES 12          // "SGJL", generation, CRC-32
+ #define MAPJOURNAL_MAX_PAYLOAD 64
+ #define MAPJOURNAL_MAX_NAME (MAPJOURNAL_MAX_PAYLOAD - 4)
+ #ifndef MAPJOURNAL_COMPACT_BYTES
+ #define MAPJOURNAL_COMPACT_BYTES 32768      // Journal size that starts a new snapshot
+ #endif
+ #define MAPJOURNAL_CHUNKS_PER_STEP 2        // Snapshot chunks written per compactStep
+ 
+ enum class JournalRecord : uint8_t {
+   NODE = 1,   // handle, lat/lng, type, obstacle type, flags, visits, last seen
+   EDGE = 2,   // handle, source, target, weight, traverse count, last traversed
+   NAME = 3    // node handle, name without its terminator
+ };
+ 
+ template <typename FS>
+ class MapJournal {
+   typedef decltype(std::declval<FS&>().open("", "r")) FileHandle;
+   
+   private:
+     FS& fs;
+     MapFile codec;
+     FileHandle journalFile;
+     FileHandle snapshotFile;
+     bool journalOpen;
+     bool compacting;
+     uint32_t snapshotGeneration;
+     uint32_t journalGeneration;    // One ahead of the snapshot while compacting
+     uint32_t journalBytes;
+     
+     // Type, length, payload, CRC-32
+     uint8_t record[2 + MAPJOURNAL_MAX_PAYLOAD + 4];
+     
+     static const char* journalPath(uint32_t generation) {
+       return (generation & 1) ? MAPJOURNAL_ODD : MAPJOURNAL_EVEN;
+     }
+     
+     bool append(JournalRecord type, int length) {
+       if (!journalOpen) {
+         return false;
+       }
+       record[0] = (uint8_t)type;
+       record[1] = length;
+       MapFile::put32(record + 2 + length, crc32(record, 2 + length));
+       
+       size_t total = 2 + length + 4;
+       bool written = (size_t)journalFile.write(record, total) == total;
+       journalFile.flush();
+       journalBytes += total;
+       return written;
+     }
+     
+     // Start an empty journal for a generation
+     bool startJournal(uint32_t generation) {
+       closeJournal();
+       journalFile = fs.open(journalPath(generation), "w");
+       if (!journalFile) {
+         return false;
+       }
+       memcpy(record, "SGJL", 4);
+       MapFile::put32(record + 4, generation);
+       MapFile::put32(record + 8, crc32(record, 8));
+       if ((size_t)journalFile.write(record, MAPJOURNAL_HEADER_BYTES) != MAPJOURNAL_HEADER_BYTES) {
+         journalFile.close();
+         return false;
+       }
+       journalFile.flush();
+       journalOpen = true;
+       journalGeneration = generation;
+       journalBytes = MAPJOURNAL_HEADER_BYTES;
+       return true;
+     }
+     
+     void closeJournal() {
+       if (journalOpen) {
+         journalFile.close();
+         journalOpen = false;
+       }
+     }
+     
+     void abortSnapshot() {
+       if (compacting) {
+         snapshotFile.close();
+         fs.remove(MAPJOURNAL_TEMP);
+         compacting = false;
+       }
+     }
+     
+     // Swap the finished temporary snapshot in for the old one
+     bool commitSnapshot(uint32_t generation) {
+       if (fs.exists(MAPJOURNAL_SNAPSHOT)) {
+         fs.remove(MAPJOURNAL_SNAPSHOT);
+       }
+       if (!fs.rename(MAPJOURNAL_TEMP, MAPJOURNAL_SNAPSHOT)) {
+         return false;
+       }
+       snapshotGeneration = generation;
+       return true;
+     }
+     
+     template <typename Store, typename Names>
+     bool loadSnapshot(const char* path, Store& store, Names& names) {
+       if (!fs.exists(path)) {
+         return false;
+       }
+       FileHandle file = fs.open(path, "r");
+       if (!file) {
+         return false;
+       }
+       MapFileStatus status = codec.load(file, store, names);
+       file.close();
+       return status == MapFileStatus::OK || status == MapFileStatus::TRUNCATED;
+     }
+     
+     // Apply one record. False if it does not fit the map, which ends the replay.
+     template <typename Store, typename Names>
+     bool apply(JournalRecord type, const uint8_t* p, int length, Store& store, Names& names) {
+       MapHandle handle = MapFile::get32(p);
+       if (type == JournalRecord::NODE && length == 24) {
+         if (handle == store.getNodeCount()) {
+           handle = store.addNode(MapFile::fromFixed(MapFile::get32(p + 4)), MapFile::fromFixed(MapFile::get32(p + 8)),
+                                  (NodeType)p[12], 0);
+         }
+         if (!store.isNode(handle)) {
+           return false;
+         }
+         store.setPosition(handle, MapFile::fromFixed(MapFile::get32(p + 4)), MapFile::fromFixed(MapFile::get32(p + 8)));
+         store.setType(handle, (NodeType)p[12]);
+         store.setObstacleType(handle, (ObstacleType)p[13]);
+         store.setFlags(handle, p[14]);
+         store.setVisitCount(handle, MapFile::get16(p + 16));
+         store.setLastSeen(handle, MapFile::get32(p + 20));
+         return true;
+       }
+       if (type == JournalRecord::EDGE && length == 22) {
+         MapHandle source = MapFile::get32(p + 4);
+         MapHandle target = MapFile::get32(p + 8);
+         float weight = MapFile::bitsFloat(MapFile::get32(p + 12));
+         if (!MapFile::isEdgeRecord(store, source, target)) {
+           return false;
+         }
+         if (handle == store.getEdgeCount()) {
+           handle = store.addEdge(source, target, weight, 0);
+         }
+         if (handle < 0 || handle >= store.getEdgeCount()) {
+           return false;
+         }
+         store.setEdge(handle, source, target, weight);
+         store.setTraverseCount(handle, MapFile::get16(p + 16));
+         store.setLastTraversed(handle, MapFile::get32(p + 18));
+         return true;
+       }
+       if (type == JournalRecord::NAME && length > 4 && length <= MAPJOURNAL_MAX_PAYLOAD) {
+         char name[MAPJOURNAL_MAX_NAME + 1];
+         memcpy(name, p + 4, length - 4);
+         name[length - 4] = '\0';
+         if (!store.isNode(handle) || !names.setName(handle, name)) {
+           return false;
+         }
+         store.setFlag(handle, NODE_FLAG_NAMED);
+         return true;
+       }
+       return false;
+     }
+     
+     // Replay a journal written for the given generation. Returns false if
+     // there is none; clean is set when it ends on a record boundary.
+     template <typename Store, typename Names>
+     bool replay(uint32_t generation, Store& store, Names& names, bool& clean) {
+       const char* path = journalPath(generation);
+       if (!fs.exists(path)) {
+         return false;
+       }
+       FileHandle file = fs.open(path, "r");
+       if (!file) {
+         return false;
+       }
+       
+       bool valid = (size_t)file.read(record, MAPJOURNAL_HEADER_BYTES) == MAPJOURNAL_HEADER_BYTES &&
+                    memcmp(record, "SGJL", 4) == 0 &&
+                    MapFile::get32(record + 4) == generation &&
+                    MapFile::get32(record + 8) == crc32(record, 8);
+       
+       clean = true;
+       while (valid) {
+         int head = file.read(record, 2);
+         if (head <= 0) {
+           break;  // End of journal
+         }
+         int length = record[1];
+         if (head != 2 || length > MAPJOURNAL_MAX_PAYLOAD ||
+             (size_t)file.read(record + 2, length + 4) != (size_t)length + 4 ||
+             MapFile::get32(record + 2 + length) != crc32(record, 2 + length) ||
+             !apply((JournalRecord)record[0], record + 2, length, store, names)) {
+           clean = false;  // Torn by a power cut, nothing after it can be trusted
+           break;
+         }
+       }
+       file.close();
+       return valid;
+     }
+     
+   public:
+     MapJournal(FS& fileSystem) : fs(fileSystem) {
+       journalOpen = false;
+       compacting = false;
+       snapshotGeneration = 0;
+       journalGeneration = 0;
+       journalBytes = 0;
+     }
+     
+     // Load the snapshot and replay its journals. False if there is no
+     // readable snapshot. Call saveAll afterwards if isReady() is false.
+     template <typename Store, typename Names>
+     bool recover(Store& store, Names& names) {
+       abortSnapshot();
+       closeJournal();
+       
+       // The temporary snapshot is complete if the card lost power between
+       // removing the old snapshot and renaming the new one
+       bool found = loadSnapshot(MAPJOURNAL_SNAPSHOT, store, names) ||
+                    loadSnapshot(MAPJOURNAL_TEMP, store, names);
+       snapshotGeneration = found ? codec.getGeneration() : 0;
+       journalGeneration = snapshotGeneration;
+       if (!found) {
+         return false;  // Journals only make sense on top of their snapshot
+       }
+       
+       bool clean = false;
+       bool journaled = replay(snapshotGeneration, store, names, clean);
+       
+       // Changes made while the next snapshot was being written
+       bool nextClean = false;
+       if (journaled && replay(snapshotGeneration + 1, store, names, nextClean)) {
+         journalGeneration = snapshotGeneration + 1;
+         clean = false;  // Finish the interrupted compaction with a fresh snapshot
+       }
+       
+       // Keep appending only to an intact journal of the current snapshot
+       if (journaled && clean) {
+         journalFile = fs.open(journalPath(journalGeneration), "a");
+         journalOpen = (bool)journalFile;
+         journalBytes = journalOpen ? journalFile.size() : 0;
+       }
+       return true;
+     }
+     
+     // Write a complete snapshot now and start an empty journal after it
+     template <typename Store, typename Names>
+     bool saveAll(const Store& store, const Names& names) {
+       abortSnapshot();
+       closeJournal();
+       uint32_t generation = (journalGeneration > snapshotGeneration ? journalGeneration : snapshotGeneration) + 1;
+       
+       FileHandle file = fs.open(MAPJOURNAL_TEMP, "w");
+       if (!file) {
+         return false;
+       }
+       MapFileStatus status = codec.save(file, store, names, generation);
+       file.close();
+       if (status != MapFileStatus::OK || !commitSnapshot(generation)) {
+         fs.remove(MAPJOURNAL_TEMP);
+         return false;
+       }
+       
+       // The snapshot holds everything. An older journal left behind could
+       // later be mistaken for the next generation's.
+       const char* other = journalPath(generation + 1);
+       if (fs.exists(other)) {
+         fs.remove(other);
+       }
+       return startJournal(generation);
+     }
+     
+     // Start or continue a compaction once the journal is large. Call often;
+     // each call writes at most MAPJOURNAL_CHUNKS_PER_STEP snapshot chunks.
+     template <typename Store, typename Names>
+     void compactStep(const Store& store, const Names& names) {
+       if (!compacting) {
+         if (!journalOpen || journalBytes < MAPJOURNAL_COMPACT_BYTES) {
+           return;
+         }
+         
+         // New changes go to the next journal from here on. After a failed
+         // attempt that journal is already open and still needed.
+         if (journalGeneration == snapshotGeneration && !startJournal(snapshotGeneration + 1)) {
+           return;
+         }
+         snapshotFile = fs.open(MAPJOURNAL_TEMP, "w");
+         if (!snapshotFile) {
+           return;
+         }
+         codec.beginSave(store, names, journalGeneration);
+         compacting = true;
+       }
+       
+       MapFileStatus status = codec.saveStep(snapshotFile, store, names, MAPJOURNAL_CHUNKS_PER_STEP);
+       if (status == MapFileStatus::IN_PROGRESS) {
+         return;
+       }
+       snapshotFile.close();
+       compacting = false;
+       if (status != MapFileStatus::OK || !commitSnapshot(journalGeneration)) {
+         fs.remove(MAPJOURNAL_TEMP);
+       }
+     }
+     
+     // Record the current state of a node or edge. False if it was not written.
+     template <typename Store>
+     bool logNode(const Store& store, MapHandle node) {
+       uint8_t* p = record + 2;
+       MapFile::put32(p, node);
+       MapFile::put32(p + 4, MapFile::toFixed(store.getLat(node)));
+       MapFile::put32(p + 8, MapFile::toFixed(store.getLng(node)));
+       p[12] = (uint8_t)store.getType(node);
+       p[13] = (uint8_t)store.getObstacleType(node);
+       p[14] = store.getFlags(node);
+       p[15] = 0;
+       MapFile::put16(p + 16, store.getVisitCount(node));
+       MapFile::put16(p + 18, 0);
+       MapFile::put32(p + 20, store.getLastSeen(node));
+       return append(JournalRecord::NODE, 24);
+     }
+     
+     template <typename Store>
+     bool logEdge(const Store& store, MapHandle edge) {
+       uint8_t* p = record + 2;
+       MapFile::put32(p, edge);
+       MapFile::put32(p + 4, store.getSource(edge));
+       MapFile::put32(p + 8, store.getTarget(edge));
+       MapFile::put32(p + 12, MapFile::floatBits(store.getWeight(edge)));
+       MapFile::put16(p + 16, store.getTraverseCount(edge));
+       MapFile::put32(p + 18, store.getLastTraversed(edge));
+       return append(JournalRecord::EDGE, 22);
+     }
+     
+     // Names longer than MAPJOURNAL_MAX_NAME wait for the next snapshot
+     bool logName(MapHandle node, const char* name) {
+       size_t length = strlen(name);
+       if (length == 0 || length > MAPJOURNAL_MAX_NAME) {
+         return false;
+       }
+       MapFile::put32(record + 2, node);
+       memcpy(record + 6, name, length);
+       return append(JournalRecord::NAME, 4 + length);
+     }
+     
+     // Close and delete every snapshot and journal
+     void clear() {
+       abortSnapshot();
+       closeJournal();
+       const char* files[] = {MAPJOURNAL_SNAPSHOT, MAPJOURNAL_TEMP, MAPJOURNAL_EVEN, MAPJOURNAL_ODD};
+       for (int i = 0; i < 4; i++) {
+         if (fs.exists(files[i])) {
+           fs.remove(files[i]);
+         }
+       }
+       snapshotGeneration = 0;
+       journalGeneration = 0;
+       journalBytes = 0;
+     }
+     
+     bool isReady() const { return journalOpen; }
+     bool isCompacting() const { return compacting; }
+     uint32_t getJournalBytes() const { return journalBytes; }
+     uint32_t getGeneration() const { return snapshotGeneration; }
+ };
+ 
+ #endif
\ No newline at end of file
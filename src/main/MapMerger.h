@@ -0,0 +1,538 @@
+/*
+ * MapMerger.h
+ *
+ * Combines the learned maps of several canes that walk the same places
+ * into one map to load back onto each of them. Host side: it uses the
+ * C++ standard library and threads and is not built into the sketch;
+ * tools/mapmerge.cpp is the command-line front end.
+ *
+ * Nodes of different maps that stand for the same place are fused: path
+ * nodes within MAP_FUSE_DISTANCE, other places of the same type and name
+ * likewise, and obstacles within MAPMERGE_OBSTACLE_DISTANCE. Candidate
+ * pairs come from a spatial hash of MAP_FUSE_DISTANCE cells, joined on
+ * all cores with each thread taking a run of cells. Pairs are fused
+ * closest first and never put two nodes of one map together, so a
+ * corridor walked by two canes does not collapse into a single node.
+ *
+ * A fused node stays where its most visited member was, with the visits
+ * summed and the latest time seen. Edges between the same fused nodes
+ * become one, with the traversals summed; like the simplifier, an edge
+ * moved with its end grows by the distance moved. Obstacles are settled
+ * by recency: the newest sighting gives the type, and an obstacle is
+ * forgotten if its lifetime has run out by the newest time in any map,
+ * or if a cane that did not see it stood beside it later. As on the
+ * device, a forgotten obstacle with edges stays as a path node.
+ */
+
+ #ifndef MAP_MERGER_H
+ #define MAP_MERGER_H
+ 
+ #include <stdint.h>
+ #include <string.h>
+ #include <math.h>
+ #include <string>
+ #include <vector>
+ #include <map>
+ #include <unordered_map>
+ #include <algorithm>
+ #include <iterator>
+ #include <functional>
+ #include <thread>
+ #include "MapFile.h"
+ #include "MapStore.h"
+ #include "MapSimplifier.h"
+ 
+ #define MAPMERGE_OBSTACLE_DISTANCE 2.0f   // Meters, as ROUTE_BLOCK_RADIUS_M
+ #define MAPMERGE_TIME_VALID_FROM 1577836800UL  // As MAP_TIME_VALID_FROM: older times are not GPS time
+ #define MAPMERGE_NO_NAME -1
+ 
+ struct MapMergeStats {
+   uint32_t maps;
+   uint32_t inputNodes;
+   uint32_t inputEdges;
+   uint32_t pairs;               // Candidate pairs from the spatial join
+   uint32_t fusedNodes;          // Input nodes folded into another
+   uint32_t expiredObstacles;
+   uint32_t passedObstacles;     // Another cane stood there later
+   uint32_t nodes;               // In the merged map
+   uint32_t edges;
+   uint32_t threads;
+ };
+ 
+ class MapMerger {
+   private:
+     struct Node {
+       int32_t lat;              // 1e-7 degrees
+       int32_t lng;
+       NodeType type;
+       ObstacleType obstacle;
+       uint16_t map;
+       int32_t name;             // Index into nameList, or MAPMERGE_NO_NAME
+       uint32_t visits;
+       uint32_t lastSeen;
+     };
+     
+     struct Edge {
+       int32_t a;
+       int32_t b;
+       float weight;
+       uint32_t traversals;
+       uint32_t lastTraversed;
+     };
+     
+     struct Pair {
+       int32_t a;
+       int32_t b;
+       uint32_t millimetres;     // Whole numbers sort faster, and the same on every machine
+       
+       bool operator<(const Pair& other) const {
+         return millimetres < other.millimetres ||
+                (millimetres == other.millimetres && (a < other.a || (a == other.a && b < other.b)));
+       }
+     };
+     
+     struct Cell {
+       uint32_t first;           // Range of sorted
+       uint32_t end;
+     };
+     
+     std::vector<Node> nodes;
+     std::vector<Edge> edges;
+     std::vector<std::string> nameList;
+     std::map<std::string, int32_t> nameIds;
+     uint16_t mapCount;
+     
+     // Spatial hash: nodes sorted by cell, and each cell's run of them
+     double cellLat;
+     double cellLng;
+     double cosLat;
+     std::vector<uint64_t> nodeCell;
+     std::vector<int32_t> sorted;
+     std::unordered_map<uint64_t, Cell> cells;
+     
+     // Fused groups: union-find, with each root's maps and name
+     std::vector<int32_t> parent;
+     std::vector<std::vector<uint16_t> > groupMaps;
+     std::vector<int32_t> groupName;
+     
+     // Per root after merge(): the member it stands at, totals, and fate
+     std::vector<int32_t> keeper;
+     std::vector<uint32_t> groupVisits;
+     std::vector<uint32_t> groupSeen;
+     std::vector<ObstacleType> groupObstacle;
+     std::vector<uint8_t> forgotten;
+     std::vector<Edge> merged;
+     
+     MapMergeStats stats;
+     
+     int32_t internName(const char* name) {
+       std::map<std::string, int32_t>::iterator it = nameIds.find(name);
+       if (it != nameIds.end()) {
+         return it->second;
+       }
+       nameList.push_back(name);
+       nameIds[name] = nameList.size() - 1;
+       return nameList.size() - 1;
+     }
+     
+     double metersSquared(const Node& a, const Node& b) const {
+       double north = ((double)b.lat - a.lat) * (LOCAL_FRAME_CM_PER_DEG / 100.0 / MAPFILE_COORD_SCALE);
+       double east = ((double)b.lng - a.lng) * (LOCAL_FRAME_CM_PER_DEG / 100.0 / MAPFILE_COORD_SCALE) * cosLat;
+       return north * north + east * east;
+     }
+     
+     double metersBetween(const Node& a, const Node& b) const { return sqrt(metersSquared(a, b)); }
+     
+     static uint64_t keyOf(int32_t x, int32_t y) { return ((uint64_t)(uint32_t)y << 32) | (uint32_t)x; }
+     int32_t cellX(const Node& node) const { return (int32_t)floor(node.lng / cellLng); }
+     int32_t cellY(const Node& node) const { return (int32_t)floor(node.lat / cellLat); }
+     
+     // Cells of MAP_FUSE_DISTANCE or more everywhere, so pairs are in neighbouring cells
+     void buildHash() {
+       double maxLat = 0, sumLat = 0;
+       for (size_t n = 0; n < nodes.size(); n++) {
+         maxLat = std::max(maxLat, fabs(nodes[n].lat / MAPFILE_COORD_SCALE));
+         sumLat += nodes[n].lat / MAPFILE_COORD_SCALE;
+       }
+       cosLat = cos((nodes.empty() ? 0 : sumLat / nodes.size()) * M_PI / 180.0);
+       cellLat = MAP_FUSE_DISTANCE / (LOCAL_FRAME_CM_PER_DEG / 100.0) * MAPFILE_COORD_SCALE;
+       cellLng = cellLat / std::max(cos(std::min(maxLat, 89.0) * M_PI / 180.0), (double)LOCAL_FRAME_MIN_COS_LAT);
+       
+       nodeCell.resize(nodes.size());
+       sorted.resize(nodes.size());
+       for (size_t n = 0; n < nodes.size(); n++) {
+         nodeCell[n] = keyOf(cellX(nodes[n]), cellY(nodes[n]));
+         sorted[n] = n;
+       }
+       std::stable_sort(sorted.begin(), sorted.end(), CellOrder(this));
+       cells.clear();
+       for (uint32_t i = 0; i < sorted.size(); ) {
+         Cell cell = {i, i};
+         while (cell.end < sorted.size() && nodeCell[sorted[cell.end]] == nodeCell[sorted[i]]) {
+           cell.end++;
+         }
+         cells[nodeCell[sorted[i]]] = cell;
+         i = cell.end;
+       }
+     }
+     
+     struct CellOrder {
+       const MapMerger* merger;
+       CellOrder(const MapMerger* owner) : merger(owner) {}
+       bool operator()(int32_t a, int32_t b) const { return merger->nodeCell[a] < merger->nodeCell[b]; }
+     };
+     
+     // Calls visit(other) for every node in the cells around a node
+     template <typename Visitor>
+     void forEachNear(const Node& node, Visitor& visit) const {
+       int32_t x = cellX(node), y = cellY(node);
+       for (int32_t dy = -1; dy <= 1; dy++) {
+         for (int32_t dx = -1; dx <= 1; dx++) {
+           std::unordered_map<uint64_t, Cell>::const_iterator it = cells.find(keyOf(x + dx, y + dy));
+           if (it == cells.end()) {
+             continue;
+           }
+           for (uint32_t i = it->second.first; i < it->second.end; i++) {
+             visit(sorted[i]);
+           }
+         }
+       }
+     }
+     
+     bool namesAgree(int32_t a, int32_t b) const {
+       return a == MAPMERGE_NO_NAME || b == MAPMERGE_NO_NAME || a == b;
+     }
+     
+     // Whether two nodes may be the same place, and how close they must be
+     float fuseDistance(const Node& a, const Node& b) const {
+       bool obstacle = a.type == NodeType::OBSTACLE;
+       if (a.map == b.map || (b.type == NodeType::OBSTACLE) != obstacle) {
+         return -1;
+       }
+       if (obstacle) {
+         return MAPMERGE_OBSTACLE_DISTANCE;
+       }
+       return a.type == b.type && namesAgree(a.name, b.name) ? MAP_FUSE_DISTANCE : -1;
+     }
+     
+     // Candidate pairs for the whole cells in sorted[first..end), each pair
+     // found once. The cells around are looked up once per cell.
+     void joinRange(uint32_t first, uint32_t end, std::vector<Pair>& pairs) const {
+       for (uint32_t i = first; i < end; ) {
+         const Node& here = nodes[sorted[i]];
+         Cell around[9];
+         int count = 0;
+         for (int32_t dy = -1; dy <= 1; dy++) {
+           for (int32_t dx = -1; dx <= 1; dx++) {
+             std::unordered_map<uint64_t, Cell>::const_iterator it = cells.find(keyOf(cellX(here) + dx, cellY(here) + dy));
+             if (it != cells.end()) {
+               around[count++] = it->second;
+             }
+           }
+         }
+         
+         uint32_t cellEnd = cells.find(nodeCell[sorted[i]])->second.end;
+         for (; i < cellEnd; i++) {
+           int32_t node = sorted[i];
+           const Node& a = nodes[node];
+           for (int c = 0; c < count; c++) {
+             for (uint32_t j = around[c].first; j < around[c].end; j++) {
+               int32_t other = sorted[j];
+               const Node& b = nodes[other];
+               if (other <= node || a.map == b.map) {
+                 continue;
+               }
+               float limit = fuseDistance(a, b);
+               double squared = metersSquared(a, b);
+               if (limit >= 0 && squared <= (double)limit * limit) {
+                 Pair pair = {node, other, (uint32_t)lround(sqrt(squared) * 1000)};
+                 pairs.push_back(pair);
+               }
+             }
+           }
+         }
+       }
+       std::sort(pairs.begin(), pairs.end());
+     }
+     
+     // Split the sorted nodes into runs of whole cells, one per thread,
+     // each sorting its own pairs, then merge the sorted runs closest first
+     void join(int threads, std::vector<Pair>& pairs) {
+       std::vector<uint32_t> bounds(1, 0);
+       for (int t = 1; t < threads; t++) {
+         uint32_t at = std::max((uint32_t)((uint64_t)sorted.size() * t / threads), bounds.back());
+         while (at < sorted.size() && at > 0 && nodeCell[sorted[at]] == nodeCell[sorted[at - 1]]) {
+           at++;
+         }
+         bounds.push_back(at);
+       }
+       bounds.push_back(sorted.size());
+       
+       std::vector<std::vector<Pair> > found(threads);
+       std::vector<std::thread> workers;
+       for (int t = 1; t < threads; t++) {
+         workers.push_back(std::thread(&MapMerger::joinRange, this, bounds[t], bounds[t + 1], std::ref(found[t])));
+       }
+       joinRange(bounds[0], bounds[1], found[0]);
+       for (size_t w = 0; w < workers.size(); w++) {
+         workers[w].join();
+       }
+       for (int t = 0; t < threads; t++) {
+         size_t middle = pairs.size();
+         pairs.insert(pairs.end(), found[t].begin(), found[t].end());
+         std::vector<Pair>().swap(found[t]);
+         std::inplace_merge(pairs.begin(), pairs.begin() + middle, pairs.end());
+       }
+     }
+     
+     int32_t find(int32_t node) {
+       while (parent[node] != node) {
+         parent[node] = parent[parent[node]];
+         node = parent[node];
+       }
+       return node;
+     }
+     
+     // Join two groups unless they share a map or disagree on the name
+     bool unite(int32_t a, int32_t b) {
+       a = find(a);
+       b = find(b);
+       if (a == b || !namesAgree(groupName[a], groupName[b])) {
+         return false;
+       }
+       const std::vector<uint16_t>& mapsA = groupMaps[a];
+       const std::vector<uint16_t>& mapsB = groupMaps[b];
+       for (size_t i = 0, j = 0; i < mapsA.size() && j < mapsB.size(); ) {
+         if (mapsA[i] == mapsB[j]) {
+           return false;
+         }
+         mapsA[i] < mapsB[j] ? i++ : j++;
+       }
+       std::vector<uint16_t> both;
+       both.reserve(mapsA.size() + mapsB.size());
+       std::merge(mapsA.begin(), mapsA.end(), mapsB.begin(), mapsB.end(), std::back_inserter(both));
+       if (a > b) {
+         std::swap(a, b);
+       }
+       parent[b] = a;
+       groupMaps[a].swap(both);
+       std::vector<uint16_t>().swap(groupMaps[b]);
+       if (groupName[a] == MAPMERGE_NO_NAME) {
+         groupName[a] = groupName[b];
+       }
+       return true;
+     }
+     
+     // Whether a cane outside the group stood beside an obstacle after it was seen
+     bool passedLater(int32_t root) const {
+       struct Passer {
+         const MapMerger* merger;
+         int32_t root;
+         bool found;
+         
+         void operator()(int32_t other) {
+           const Node& node = merger->nodes[other];
+           const std::vector<uint16_t>& maps = merger->groupMaps[root];
+           if (!found && node.type != NodeType::OBSTACLE && node.lastSeen > merger->groupSeen[root] &&
+               !std::binary_search(maps.begin(), maps.end(), node.map) &&
+               merger->metersBetween(merger->nodes[merger->keeper[root]], node) <= MAPMERGE_OBSTACLE_DISTANCE) {
+             found = true;
+           }
+         }
+       } passer = {this, root, false};
+       forEachNear(nodes[keeper[root]], passer);
+       return passer.found;
+     }
+     
+     // One edge per pair of groups, grown by how far its ends moved
+     void mergeEdges() {
+       merged.clear();
+       for (size_t e = 0; e < edges.size(); e++) {
+         Edge edge = edges[e];
+         int32_t a = find(edge.a), b = find(edge.b);
+         if (a == b) {
+           continue;
+         }
+         edge.weight += metersBetween(nodes[edge.a], nodes[keeper[a]]) + metersBetween(nodes[edge.b], nodes[keeper[b]]);
+         edge.a = std::min(a, b);
+         edge.b = std::max(a, b);
+         merged.push_back(edge);
+       }
+       std::sort(merged.begin(), merged.end(), EdgeOrder());
+       
+       size_t kept = 0;
+       for (size_t e = 0; e < merged.size(); e++) {
+         Edge& last = merged[kept > 0 ? kept - 1 : 0];
+         if (kept > 0 && last.a == merged[e].a && last.b == merged[e].b) {
+           if (merged[e].traversals > last.traversals) {
+             last.weight = merged[e].weight;    // The usual walk between them
+           }
+           last.traversals += merged[e].traversals;
+           last.lastTraversed = std::max(last.lastTraversed, merged[e].lastTraversed);
+         } else {
+           merged[kept++] = merged[e];
+         }
+       }
+       merged.resize(kept);
+     }
+     
+     struct EdgeOrder {
+       bool operator()(const Edge& x, const Edge& y) const { return x.a < y.a || (x.a == y.a && x.b < y.b); }
+     };
+     
+   public:
+     MapMerger() {
+       mapCount = 0;
+       cellLat = cellLng = 1;
+       cosLat = 1;
+       memset(&stats, 0, sizeof(stats));
+     }
+     
+     // Add one cane's map. Free slots are skipped.
+     template <typename Store, typename Names>
+     void addMap(const Store& store, const Names& names) {
+       std::vector<int32_t> index(store.getNodeCount(), -1);
+       for (MapHandle n = 0; n < store.getNodeCount(); n++) {
+         if (store.isFree(n)) {
+           continue;
+         }
+         const char* name = store.hasFlag(n, NODE_FLAG_NAMED) ? names.nameOf(n) : 0;
+         Node node = {MapFile::toFixed(store.getLat(n)), MapFile::toFixed(store.getLng(n)), store.getType(n),
+                      store.getObstacleType(n), mapCount, name ? internName(name) : MAPMERGE_NO_NAME,
+                      store.getVisitCount(n), store.getLastSeen(n)};
+         index[n] = nodes.size();
+         nodes.push_back(node);
+       }
+       for (MapHandle e = 0; e < store.getEdgeCount(); e++) {
+         if (store.isFreeEdge(e) || index[store.getSource(e)] < 0 || index[store.getTarget(e)] < 0) {
+           continue;
+         }
+         Edge edge = {index[store.getSource(e)], index[store.getTarget(e)], store.getWeight(e),
+                      store.getTraverseCount(e), store.getLastTraversed(e)};
+         edges.push_back(edge);
+       }
+       mapCount++;
+       stats.maps = mapCount;
+       stats.inputNodes = nodes.size();
+       stats.inputEdges = edges.size();
+     }
+     
+     // Fuse the maps added so far, on the given number of threads (0 for one per core)
+     void merge(int threads = 0) {
+       if (threads <= 0) {
+         threads = std::max(1, (int)std::thread::hardware_concurrency());
+       }
+       stats.threads = threads;
+       buildHash();
+       std::vector<Pair> pairs;
+       join(threads, pairs);
+       stats.pairs = pairs.size();
+       
+       parent.resize(nodes.size());
+       groupMaps.assign(nodes.size(), std::vector<uint16_t>());
+       groupName.resize(nodes.size());
+       for (size_t n = 0; n < nodes.size(); n++) {
+         parent[n] = n;
+         groupMaps[n].push_back(nodes[n].map);
+         groupName[n] = nodes[n].name;
+       }
+       stats.fusedNodes = 0;
+       for (size_t p = 0; p < pairs.size(); p++) {
+         stats.fusedNodes += unite(pairs[p].a, pairs[p].b);
+       }
+       
+       // Totals per group, and the member it stands at: the most visited
+       // place, or the newest sighting of an obstacle
+       keeper.assign(nodes.size(), -1);
+       groupVisits.assign(nodes.size(), 0);
+       groupSeen.assign(nodes.size(), 0);
+       groupObstacle.assign(nodes.size(), ObstacleType::UNKNOWN);
+       uint32_t clock = 0;
+       for (size_t n = 0; n < nodes.size(); n++) {
+         int32_t root = find(n);
+         const Node& node = nodes[n];
+         bool newest = keeper[root] < 0 || node.lastSeen > groupSeen[root];
+         if (keeper[root] < 0 || (node.type == NodeType::OBSTACLE ? newest : node.visits > nodes[keeper[root]].visits)) {
+           keeper[root] = n;
+         }
+         if (newest) {
+           groupObstacle[root] = node.obstacle;
+         }
+         groupVisits[root] += node.visits;
+         groupSeen[root] = std::max(groupSeen[root], node.lastSeen);
+         clock = std::max(clock, node.lastSeen);
+       }
+       for (size_t e = 0; e < edges.size(); e++) {
+         clock = std::max(clock, edges[e].lastTraversed);
+       }
+       
+       // Obstacles by recency, judged at the newest time in any map
+       forgotten.assign(nodes.size(), 0);
+       stats.expiredObstacles = stats.passedObstacles = 0;
+       for (size_t n = 0; n < nodes.size(); n++) {
+         if (parent[n] != (int32_t)n || nodes[n].type != NodeType::OBSTACLE) {
+           continue;
+         }
+         uint32_t ttl = obstacleTtl(groupObstacle[n]);
+         if (ttl != OBSTACLE_TTL_PERMANENT && groupSeen[n] >= MAPMERGE_TIME_VALID_FROM &&
+             (uint64_t)groupSeen[n] + ttl <= clock) {
+           forgotten[n] = 1;
+           stats.expiredObstacles++;
+         } else if (passedLater(n)) {
+           forgotten[n] = 1;
+           stats.passedObstacles++;
+         }
+       }
+       mergeEdges();
+     }
+     
+     // Write the merged map into a store and name table, which are
+     // cleared first. False if it does not fit them.
+     template <typename Store, typename Names>
+     bool build(Store& store, Names& names) {
+       store.clear();
+       names.clear();
+       std::vector<uint8_t> linked(nodes.size(), 0);
+       for (size_t e = 0; e < merged.size(); e++) {
+         linked[merged[e].a] = linked[merged[e].b] = 1;
+       }
+       
+       std::vector<MapHandle> handle(nodes.size(), MAP_NO_HANDLE);
+       bool fits = true;
+       for (size_t n = 0; n < nodes.size() && fits; n++) {
+         if (parent[n] != (int32_t)n || (forgotten[n] && !linked[n])) {
+           continue;
+         }
+         const Node& at = nodes[keeper[n]];
+         NodeType type = forgotten[n] ? NodeType::PATH : at.type;
+         handle[n] = store.addNode(MapFile::fromFixed(at.lat), MapFile::fromFixed(at.lng), type, groupSeen[n]);
+         if (handle[n] == MAP_NO_HANDLE) {
+           fits = false;
+           break;
+         }
+         if (type == NodeType::OBSTACLE) {
+           store.setObstacleType(handle[n], groupObstacle[n]);
+         }
+         store.setVisitCount(handle[n], std::min(groupVisits[n], (uint32_t)UINT16_MAX));
+         if (groupName[n] != MAPMERGE_NO_NAME) {
+           fits = names.setName(handle[n], nameList[groupName[n]].c_str());
+           store.setFlag(handle[n], NODE_FLAG_NAMED);
+         }
+       }
+       for (size_t e = 0; e < merged.size() && fits; e++) {
+         const Edge& edge = merged[e];
+         MapHandle added = store.addEdge(handle[edge.a], handle[edge.b], edge.weight, edge.lastTraversed);
+         fits = added != MAP_NO_HANDLE;
+         if (fits) {
+           store.setTraverseCount(added, std::min(edge.traversals, (uint32_t)UINT16_MAX));
+         }
+       }
+       stats.nodes = store.getNodeCount();
+       stats.edges = store.getEdgeCount();
+       return fits;
+     }
+     
+     const MapMergeStats& getStats() const { return stats; }
+ };
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,222 @@
+/*
+ * MapSimplifier.h
+ *
+ * Keeps the learned map from growing on routes walked again and again.
+ * A few nodes are examined per step, round robin, and each may be:
+ *
+ * - fused with a duplicate: another path node within MAP_FUSE_DISTANCE
+ *   that GPS drift placed beside it. The less visited one goes and its
+ *   edges move to the other, merging with edges that already exist.
+ * - dropped from a chain: a path node with exactly two neighbours a and c
+ *   is replaced by one edge a-c if the walk it stood for stays within
+ *   MAP_SIMPLIFY_TOLERANCE of the straight line, as in Douglas-Peucker.
+ *
+ * An edge's weight is the length of the walk it stands for, so every
+ * point absorbed into edge a-c lies on a path of that length from a to c
+ * and therefore within sqrt(w^2 - d^2) / 2 of the chord d. The check is
+ * exact over any number of merges and needs no memory per edge.
+ *
+ * Obstacles, landmarks, named nodes and the pinned node are never
+ * touched. Changed nodes and edges are reported to a listener so the
+ * caller can journal them. No Arduino dependencies.
+ */
+
+ #ifndef MAP_SIMPLIFIER_H
+ #define MAP_SIMPLIFIER_H
+ 
+ #include <stdint.h>
+ #include "MapStore.h"
+ #include "EdgeIndex.h"
+ #include "LocalFrame.h"
+ 
+ #ifndef MAP_FUSE_DISTANCE
+ #define MAP_FUSE_DISTANCE 7.0f         // Meters; new nodes are at least 5 m apart
+ #endif
+ #ifndef MAP_SIMPLIFY_TOLERANCE
+ #define MAP_SIMPLIFY_TOLERANCE 2.0f    // Meters, about the GPS error
+ #endif
+ #define MAP_SIMPLIFY_MAX_EDGE 25.0f    // Longest edge a merge may create, in meters
+ 
+ template <typename Store, typename Grid, typename Adjacency>
+ class MapSimplifier {
+   private:
+     Store& store;
+     Grid& grid;
+     Adjacency& adjacency;
+     const LocalPoint* local;    // Node positions in the caller's frame
+     MapHandle cursor;
+     MapHandle pinned;
+     uint32_t fused;
+     uint32_t dropped;
+     
+     static uint16_t saturatingAdd(uint16_t a, uint16_t b) { return a + b > UINT16_MAX ? UINT16_MAX : a + b; }
+     
+     bool isCandidate(MapHandle node) const {
+       return !store.isFree(node) && node != pinned && store.getType(node) == NodeType::PATH &&
+              !store.hasFlag(node, NODE_FLAG_NAMED);
+     }
+     
+     // Neighbours, or two steps apart along a walk hardly longer than the
+     // gap between them: part of the same walk, for dropFromChain()
+     bool isClose(MapHandle a, MapHandle b, float gap) const {
+       for (int32_t h = adjacency.first(a); h != EDGE_NONE; h = adjacency.next(h)) {
+         int32_t neighbour = adjacency.neighbourOf(h);
+         if (neighbour == b) {
+           return true;
+         }
+         int32_t onward = adjacency.find(neighbour, b);
+         if (onward != EDGE_NONE &&
+             store.getWeight(Adjacency::edgeOf(h)) + store.getWeight(onward) <= gap + 2 * MAP_SIMPLIFY_TOLERANCE) {
+           return true;
+         }
+       }
+       return false;
+     }
+     
+     void unindex(MapHandle edge) {
+       adjacency.remove(edge, store.getSource(edge), store.getTarget(edge));
+     }
+     
+     template <typename Listener>
+     bool fuseDuplicate(MapHandle node, Listener& changed) {
+       struct DuplicateSearch {
+         MapSimplifier* simplifier;
+         MapHandle node;
+         MapHandle found;
+         int64_t best;
+         
+         bool operator()(int other) {
+           int64_t distance = LocalFrame::distanceSquared(simplifier->local[node], simplifier->local[other]);
+           if (other != node && distance <= best && simplifier->isCandidate(other) &&
+               !simplifier->isClose(node, other, sqrtf((float)distance) / 100.0f)) {
+             best = distance;
+             found = other;
+           }
+           return true;
+         }
+       } search = {this, node, MAP_NO_HANDLE, LocalFrame::radiusSquared(MAP_FUSE_DISTANCE)};
+       
+       grid.forEachNear(store.getLat(node), store.getLng(node), MAP_FUSE_DISTANCE, search);
+       if (search.found == MAP_NO_HANDLE) {
+         return false;
+       }
+       
+       // The better-known node stays where it is
+       MapHandle keep = node, drop = search.found;
+       if (store.getVisitCount(drop) > store.getVisitCount(keep)) {
+         keep = search.found;
+         drop = node;
+       }
+       float gap = LocalFrame::distance(local[keep], local[drop]);
+       store.setVisitCount(keep, saturatingAdd(store.getVisitCount(keep), store.getVisitCount(drop)));
+       if (store.getLastSeen(drop) > store.getLastSeen(keep)) {
+         store.setLastSeen(keep, store.getLastSeen(drop));
+       }
+       
+       int32_t half;
+       while ((half = adjacency.first(drop)) != EDGE_NONE) {
+         MapHandle edge = Adjacency::edgeOf(half);
+         MapHandle other = adjacency.neighbourOf(half);
+         unindex(edge);
+         MapHandle existing = adjacency.find(keep, other);
+         if (other != keep && existing == EDGE_NONE) {
+           // Now a walk from other to the dropped node and on to the kept one
+           store.setEdge(edge, keep, other, store.getWeight(edge) + gap);
+           adjacency.add(edge, keep, other);
+         } else {
+           if (existing != EDGE_NONE) {
+             store.setTraverseCount(existing, saturatingAdd(store.getTraverseCount(existing), store.getTraverseCount(edge)));
+             if (store.getLastTraversed(edge) > store.getLastTraversed(existing)) {
+               store.setLastTraversed(existing, store.getLastTraversed(edge));
+             }
+             changed.edgeChanged(existing);
+           }
+           store.freeEdge(edge);
+         }
+         changed.edgeChanged(edge);
+       }
+       
+       grid.remove(drop);
+       store.freeNode(drop);
+       changed.nodeChanged(drop);
+       changed.nodeChanged(keep);
+       fused++;
+       return true;
+     }
+     
+     template <typename Listener>
+     bool dropFromChain(MapHandle node, Listener& changed) {
+       int32_t first = adjacency.first(node);
+       int32_t second = first == EDGE_NONE ? EDGE_NONE : adjacency.next(first);
+       if (second == EDGE_NONE || adjacency.next(second) != EDGE_NONE) {
+         return false;
+       }
+       MapHandle a = adjacency.neighbourOf(first), c = adjacency.neighbourOf(second);
+       if (a == c || adjacency.find(a, c) != EDGE_NONE) {
+         return false;
+       }
+       
+       float chord = LocalFrame::distance(local[a], local[c]);
+       MapHandle kept = Adjacency::edgeOf(first), gone = Adjacency::edgeOf(second);
+       float walk = store.getWeight(kept) + store.getWeight(gone);
+       if (chord > MAP_SIMPLIFY_MAX_EDGE ||
+           walk * walk - chord * chord > 4 * MAP_SIMPLIFY_TOLERANCE * MAP_SIMPLIFY_TOLERANCE) {
+         return false;
+       }
+       
+       unindex(kept);
+       unindex(gone);
+       store.setEdge(kept, a, c, walk);
+       if (store.getTraverseCount(gone) > store.getTraverseCount(kept)) {
+         store.setTraverseCount(kept, store.getTraverseCount(gone));
+       }
+       if (store.getLastTraversed(gone) > store.getLastTraversed(kept)) {
+         store.setLastTraversed(kept, store.getLastTraversed(gone));
+       }
+       adjacency.add(kept, a, c);
+       store.freeEdge(gone);
+       
+       grid.remove(node);
+       store.freeNode(node);
+       changed.edgeChanged(kept);
+       changed.edgeChanged(gone);
+       changed.nodeChanged(node);
+       dropped++;
+       return true;
+     }
+     
+   public:
+     MapSimplifier(Store& store, Grid& grid, Adjacency& adjacency, const LocalPoint* local)
+       : store(store), grid(grid), adjacency(adjacency), local(local) {
+       cursor = 0;
+       pinned = MAP_NO_HANDLE;
+       fused = 0;
+       dropped = 0;
+     }
+     
+     // A node that must stay, such as the one the user is at
+     void pin(MapHandle node) { pinned = node; }
+     
+     // Examine up to budget nodes. listener.nodeChanged(handle) and
+     // edgeChanged(handle) hear of every record changed or freed.
+     // Returns the number of nodes removed.
+     template <typename Listener>
+     int step(Listener& changed, int budget) {
+       int removed = 0;
+       for (int i = 0; i < budget && store.getNodeCount() > 0; i++) {
+         if (cursor >= store.getNodeCount()) {
+           cursor = 0;
+         }
+         MapHandle node = cursor++;
+         if (isCandidate(node) && (fuseDuplicate(node, changed) || dropFromChain(node, changed))) {
+           removed++;
+         }
+       }
+       return removed;
+     }
+     
+     uint32_t getFusedCount() const { return fused; }
+     uint32_t getDroppedCount() const { return dropped; }
+ };
+ 
+ #endif
\ No newline at end of file
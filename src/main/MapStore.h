@@ -0,0 +1,216 @@
+/*
+ * MapStore.h
+ *
+ * Node and edge storage for the learned map. Records are addressed by
+ * dense 32-bit handles (their slot number) and kept as parallel arrays,
+ * so a scan over coordinates or types only touches those arrays and a
+ * node costs 17 bytes instead of a struct full of Strings. Timestamps
+ * are passed in by the caller. Removed records leave a free slot that
+ * keeps the other handles stable and is reused by allocNode/allocEdge.
+ * No Arduino dependencies.
+ */
+
+ #ifndef MAP_STORE_H
+ #define MAP_STORE_H
+ 
+ #include <stdint.h>
+ #include "ObstacleTypes.h"
+ 
+ typedef int32_t MapHandle;
+ #define MAP_NO_HANDLE -1
+ 
+ // Node flag bits
+ #define NODE_FLAG_NAMED 0x01      // Has an entry in the landmark name table
+ #define NODE_FLAG_FREE 0x02       // Removed; the slot is waiting for reuse
+ 
+ template <int MAX_NODES, int MAX_EDGES>
+ class MapStore {
+   private:
+     // Nodes
+     float nodeLat[MAX_NODES];
+     float nodeLng[MAX_NODES];
+     NodeType nodeType[MAX_NODES];
+     ObstacleType nodeObstacle[MAX_NODES];
+     uint8_t nodeFlags[MAX_NODES];
+     uint16_t nodeVisits[MAX_NODES];
+     uint32_t nodeSeen[MAX_NODES];
+     int32_t nodeCount;
+     
+     // Edges, walkable in both directions
+     MapHandle edgeSource[MAX_EDGES];
+     MapHandle edgeTarget[MAX_EDGES];
+     float edgeWeight[MAX_EDGES];
+     uint16_t edgeTraversals[MAX_EDGES];
+     uint32_t edgeTraversed[MAX_EDGES];
+     int32_t edgeCount;
+     
+     // Free slots, and the lowest slot that may be free
+     int32_t freeNodes;
+     int32_t freeEdges;
+     MapHandle freeNodeHint;
+     MapHandle freeEdgeHint;
+     
+     static uint16_t saturatingIncrement(uint16_t count) { return count == UINT16_MAX ? count : count + 1; }
+     
+   public:
+     static const int NODE_CAPACITY = MAX_NODES;
+     static const int EDGE_CAPACITY = MAX_EDGES;
+     
+     MapStore() {
+       clear();
+     }
+     
+     void clear() {
+       nodeCount = 0;
+       edgeCount = 0;
+       freeNodes = 0;
+       freeEdges = 0;
+       freeNodeHint = 0;
+       freeEdgeHint = 0;
+     }
+     
+     // Returns the new node's handle, or MAP_NO_HANDLE if the store is full
+     MapHandle addNode(float lat, float lng, NodeType type, uint32_t now) {
+       if (nodeCount >= MAX_NODES) {
+         return MAP_NO_HANDLE;
+       }
+       
+       MapHandle node = nodeCount++;
+       nodeLat[node] = lat;
+       nodeLng[node] = lng;
+       nodeType[node] = type;
+       nodeObstacle[node] = ObstacleType::UNKNOWN;
+       nodeFlags[node] = 0;
+       nodeVisits[node] = 1;
+       nodeSeen[node] = now;
+       return node;
+     }
+     
+     // Returns the new edge's handle, or MAP_NO_HANDLE if the store is full.
+     // An edge from MAP_NO_HANDLE to MAP_NO_HANDLE is a free slot.
+     MapHandle addEdge(MapHandle source, MapHandle target, float weight, uint32_t now) {
+       if (edgeCount >= MAX_EDGES) {
+         return MAP_NO_HANDLE;
+       }
+       
+       MapHandle edge = edgeCount++;
+       edgeSource[edge] = 0;  // Counted as in use until setEdge says otherwise
+       setEdge(edge, source, target, weight);
+       edgeTraversals[edge] = 1;
+       edgeTraversed[edge] = now;
+       return edge;
+     }
+     
+     // Like addNode/addEdge, but filling a free slot first
+     MapHandle allocNode(float lat, float lng, NodeType type, uint32_t now) {
+       if (freeNodes == 0) {
+         return addNode(lat, lng, type, now);
+       }
+       while (!isFree(freeNodeHint)) {
+         freeNodeHint++;
+       }
+       MapHandle node = freeNodeHint;
+       setFlags(node, 0);
+       nodeLat[node] = lat;
+       nodeLng[node] = lng;
+       nodeType[node] = type;
+       nodeObstacle[node] = ObstacleType::UNKNOWN;
+       nodeVisits[node] = 1;
+       nodeSeen[node] = now;
+       return node;
+     }
+     
+     MapHandle allocEdge(MapHandle source, MapHandle target, float weight, uint32_t now) {
+       if (freeEdges == 0) {
+         return addEdge(source, target, weight, now);
+       }
+       while (!isFreeEdge(freeEdgeHint)) {
+         freeEdgeHint++;
+       }
+       MapHandle edge = freeEdgeHint;
+       setEdge(edge, source, target, weight);
+       edgeTraversals[edge] = 1;
+       edgeTraversed[edge] = now;
+       return edge;
+     }
+     
+     // The caller removes the edges of a node before freeing it
+     void freeNode(MapHandle node) { setFlags(node, NODE_FLAG_FREE); }
+     void freeEdge(MapHandle edge) { setEdge(edge, MAP_NO_HANDLE, MAP_NO_HANDLE, 0); }
+     
+     // Seen again: refresh the timestamp and count the visit
+     void visitNode(MapHandle node, uint32_t now) {
+       nodeSeen[node] = now;
+       nodeVisits[node] = saturatingIncrement(nodeVisits[node]);
+     }
+     
+     void traverseEdge(MapHandle edge, uint32_t now) {
+       edgeTraversed[edge] = now;
+       edgeTraversals[edge] = saturatingIncrement(edgeTraversals[edge]);
+     }
+     
+     // Counts include free slots; handles run from 0 to the count
+     int32_t getNodeCount() const { return nodeCount; }
+     int32_t getEdgeCount() const { return edgeCount; }
+     int32_t getLiveNodeCount() const { return nodeCount - freeNodes; }
+     int32_t getLiveEdgeCount() const { return edgeCount - freeEdges; }
+     bool isNode(MapHandle node) const { return node >= 0 && node < nodeCount; }
+     bool isFree(MapHandle node) const { return (nodeFlags[node] & NODE_FLAG_FREE) != 0; }
+     bool isFreeEdge(MapHandle edge) const { return edgeSource[edge] == MAP_NO_HANDLE; }
+     
+     float getLat(MapHandle node) const { return nodeLat[node]; }
+     float getLng(MapHandle node) const { return nodeLng[node]; }
+     NodeType getType(MapHandle node) const { return nodeType[node]; }
+     bool isObstacle(MapHandle node) const { return nodeType[node] == NodeType::OBSTACLE; }
+     ObstacleType getObstacleType(MapHandle node) const { return nodeObstacle[node]; }
+     bool hasFlag(MapHandle node, uint8_t flag) const { return (nodeFlags[node] & flag) != 0; }
+     uint8_t getFlags(MapHandle node) const { return nodeFlags[node]; }
+     uint16_t getVisitCount(MapHandle node) const { return nodeVisits[node]; }
+     uint32_t getLastSeen(MapHandle node) const { return nodeSeen[node]; }
+     
+     void setObstacleType(MapHandle node, ObstacleType type) { nodeObstacle[node] = type; }
+     void setFlag(MapHandle node, uint8_t flag) { nodeFlags[node] |= flag; }
+     void setPosition(MapHandle node, float lat, float lng) {
+       nodeLat[node] = lat;
+       nodeLng[node] = lng;
+     }
+     void setType(MapHandle node, NodeType type) { nodeType[node] = type; }
+     
+     // All flags at once, keeping count of the free slots
+     void setFlags(MapHandle node, uint8_t flags) {
+       bool wasFree = isFree(node);
+       nodeFlags[node] = flags;
+       if (wasFree != isFree(node)) {
+         freeNodes += wasFree ? -1 : 1;
+         if (!wasFree && node < freeNodeHint) {
+           freeNodeHint = node;
+         }
+       }
+     }
+     void setVisitCount(MapHandle node, uint16_t visits) { nodeVisits[node] = visits; }
+     void setLastSeen(MapHandle node, uint32_t time) { nodeSeen[node] = time; }
+     
+     MapHandle getSource(MapHandle edge) const { return edgeSource[edge]; }
+     MapHandle getTarget(MapHandle edge) const { return edgeTarget[edge]; }
+     float getWeight(MapHandle edge) const { return edgeWeight[edge]; }
+     uint16_t getTraverseCount(MapHandle edge) const { return edgeTraversals[edge]; }
+     uint32_t getLastTraversed(MapHandle edge) const { return edgeTraversed[edge]; }
+     
+     // Endpoints and weight at once, keeping count of the free slots
+     void setEdge(MapHandle edge, MapHandle source, MapHandle target, float weight) {
+       bool wasFree = isFreeEdge(edge);
+       edgeSource[edge] = source;
+       edgeTarget[edge] = target;
+       edgeWeight[edge] = weight;
+       if (wasFree != isFreeEdge(edge)) {
+         freeEdges += wasFree ? -1 : 1;
+         if (!wasFree && edge < freeEdgeHint) {
+           freeEdgeHint = edge;
+         }
+       }
+     }
+     void setTraverseCount(MapHandle edge, uint16_t count) { edgeTraversals[edge] = count; }
+     void setLastTraversed(MapHandle edge, uint32_t time) { edgeTraversed[edge] = time; }
+ };
+ 
+ #endif
\ No newline at end of file
@@ -10,18 +10,24 @@
  #include <ArduinoJson.h>
  
  // Constants
- #define EARTH_RADIUS_M 6371000.0
- #define DEG_TO_RAD 0.017453292519943295 // PI/180
- #define MAP_FILENAME "/map_data.json"
+ #define MAP_JSON_FILENAME "/map_data.json"   // Format used before the binary file
+ #define MAP_TILES_FILENAME "/map_tiles.bin"  // Optional base map archive
  #define NODE_PROXIMITY_THRESHOLD 5.0  // meters
  #define PATH_NODE_DISTANCE 10.0       // meters
  
- MapSystem::MapSystem() {
-   nodeCount = 0;
-   edgeCount = 0;
+ MapSystem::MapSystem() : simplifier(store, grid, adjacency, nodeLocal), journal(SD) {
    isFirstPosition = true;
-   currentNodeId = "";
+   currentNode = MAP_NO_HANDLE;
    sdAvailable = false;
+   unloggedVisit = MAP_NO_HANDLE;
+   unloggedObstacle = MAP_NO_HANDLE;
+   routeLandmarksStale = true;
+   hasRoute = false;
+   pathCursor = 0;
+   tileRoute = false;
+   clockSet = false;
+   clockSeconds = 0;
+   clockMillis = 0;
  }
  
  bool MapSystem::begin() {
@@ -34,14 +40,39 @@
      sdAvailable = true;
      // Try to load existing map
      loadMap();
+ 
+ #ifdef SMARTGUIDE_BASE_MAP
+     // Attach the base map, if one was copied to the card
+     if (SD.exists(MAP_TILES_FILENAME)) {
+       tileFile = SD.open(MAP_TILES_FILENAME, FILE_READ);
+       if (tileFile && tiles.attach(tileFile)) {
+         Serial.println("Base map with " + String(tiles.getTileCount()) + " tiles");
+       }
+     }
+ #else
+     if (SD.exists(MAP_TILES_FILENAME)) {
+       Serial.println("Base map ignored, built without SMARTGUIDE_BASE_MAP");
+     }
+ #endif
    }
    
-   Serial.println("Map System initialized with " + String(nodeCount) + " nodes and " + 
-                 String(edgeCount) + " edges");
+   Serial.println("Map System initialized with " + String(getNodeCount()) + " nodes and " + 
+                 String(getEdgeCount()) + " edges");
    return true;
  }
  
  void MapSystem::updateCurrentPosition(float lat, float lng) {
+   // Write a few chunks of a pending snapshot, if the journal asked for one
+   journal.compactStep(store, names);
+   
+   // Forget obstacles not seen for their type's lifetime
+   expireObstacles();
+   
+   // Thin out a few nodes walked over before
+   if (!isFirstPosition) {
+     simplifyStep();
+   }
+   
    // Store previous position
    if (!isFirstPosition) {
      prevLat = currentLat;
@@ -52,255 +83,327 @@
    currentLat = lat;
    currentLng = lng;
    
+   // Keep the local frame centred within a couple of kilometres of the user
+   if (!frame.isSet() || !frame.isInside(frame.toLocal(lat, lng))) {
+     recentreFrame(lat, lng);
+   }
+   
    // If first position, just record it
    if (isFirstPosition) {
      isFirstPosition = false;
      
      // Create initial node
-     MapNode node;
-     node.id = generateNodeId();
-     node.lat = lat;
-     node.lng = lng;
-     node.type = "path";
-     node.isObstacle = false;
-     node.lastSeen = millis();
-     node.visitCount = 1;
-     
-     if (nodeCount < MAX_MAP_NODES) {
-       nodes[nodeCount] = node;
-       currentNodeId = node.id;
-       nodeCount++;
+     currentNode = appendNode(lat, lng, NodeType::PATH);
+     if (currentNode != MAP_NO_HANDLE) {
+       journal.logNode(store, currentNode);
      }
-     
      return;
    }
    
    // Check if we're still near the current node
-   int currentNodeIndex = findNodeIndex(currentNodeId);
-   if (currentNodeIndex >= 0) {
-     float distToCurrent = calculateDistance(lat, lng, 
-                                           nodes[currentNodeIndex].lat, 
-                                           nodes[currentNodeIndex].lng);
-     
-     if (distToCurrent <= NODE_PROXIMITY_THRESHOLD) {
-       // Still at the same node, just update last seen and visit count
-       nodes[currentNodeIndex].lastSeen = millis();
-       nodes[currentNodeIndex].visitCount++;
+   if (currentNode != MAP_NO_HANDLE) {
+     if (LocalFrame::isWithin(frame.toLocal(lat, lng), nodeLocal[currentNode], NODE_PROXIMITY_THRESHOLD)) {
+       // Still at the same node, just update last seen and visit count.
+       // Journaled once we leave, not on every fix.
+       store.visitNode(currentNode, now());
+       unloggedVisit = currentNode;
        return;
      }
    }
    
+   if (unloggedVisit != MAP_NO_HANDLE) {
+     journal.logNode(store, unloggedVisit);
+     unloggedVisit = MAP_NO_HANDLE;
+   }
+   if (unloggedObstacle != MAP_NO_HANDLE) {
+     journal.logNode(store, unloggedObstacle);
+     unloggedObstacle = MAP_NO_HANDLE;
+   }
+   
    // We've moved away from the current node
    // Check if we're near an existing node
-   int nearestNodeIndex = findNearestNodeIndex(lat, lng, NODE_PROXIMITY_THRESHOLD);
+   MapHandle nearestNode = findNearestNode(lat, lng, NODE_PROXIMITY_THRESHOLD);
+   
+   // Along an edge the map already has: follow it rather than laying new
+   // nodes beside it, joining it at its nearer end if we came from elsewhere
+   if (nearestNode == MAP_NO_HANDLE) {
+     MapHandle edge = findNearestEdge(lat, lng, NODE_PROXIMITY_THRESHOLD);
+     if (edge != MAP_NO_HANDLE) {
+       MapHandle source = store.getSource(edge);
+       MapHandle target = store.getTarget(edge);
+       if (currentNode == source || currentNode == target) {
+         return;
+       }
+       LocalPoint here = frame.toLocal(lat, lng);
+       nearestNode = LocalFrame::distanceSquared(here, nodeLocal[source]) <=
+                     LocalFrame::distanceSquared(here, nodeLocal[target]) ? source : target;
+     }
+   }
    
-   if (nearestNodeIndex >= 0) {
+   if (nearestNode != MAP_NO_HANDLE) {
      // We're near an existing node
-     // Update node
-     nodes[nearestNodeIndex].lastSeen = millis();
-     nodes[nearestNodeIndex].visitCount++;
+     store.visitNode(nearestNode, now());
+     journal.logNode(store, nearestNode);
      
      // Create edge between current node and this node if it doesn't exist
-     if (currentNodeIndex >= 0) {
-       // Check if edge already exists
-       bool edgeExists = false;
-       for (int i = 0; i < edgeCount; i++) {
-         if ((edges[i].sourceId == currentNodeId && 
-              edges[i].targetId == nodes[nearestNodeIndex].id) ||
-             (edges[i].sourceId == nodes[nearestNodeIndex].id && 
-              edges[i].targetId == currentNodeId)) {
-           // Edge exists, update it
-           edges[i].lastTraversed = millis();
-           edges[i].traverseCount++;
-           edgeExists = true;
-           break;
-         }
+     if (currentNode != MAP_NO_HANDLE) {
+       MapHandle edge = adjacency.find(currentNode, nearestNode);
+       if (edge != EDGE_NONE) {
+         // Edge exists, update it
+         store.traverseEdge(edge, now());
+       } else {
+         edge = appendEdge(currentNode, nearestNode);
        }
-       
-       // Create new edge if it doesn't exist
-       if (!edgeExists && edgeCount < MAX_MAP_EDGES) {
-         MapEdge edge;
-         edge.id = generateEdgeId();
-         edge.sourceId = currentNodeId;
-         edge.targetId = nodes[nearestNodeIndex].id;
-         edge.weight = calculateDistance(nodes[currentNodeIndex].lat, nodes[currentNodeIndex].lng,
-                                        nodes[nearestNodeIndex].lat, nodes[nearestNodeIndex].lng);
-         edge.lastTraversed = millis();
-         edge.traverseCount = 1;
-         
-         edges[edgeCount] = edge;
-         edgeCount++;
+       if (edge != MAP_NO_HANDLE) {
+         journal.logEdge(store, edge);
        }
      }
      
-     currentNodeId = nodes[nearestNodeIndex].id;
+     currentNode = nearestNode;
    } else {
      // Create new node
-     MapNode node;
-     node.id = generateNodeId();
-     node.lat = lat;
-     node.lng = lng;
-     node.type = "path";
-     node.isObstacle = false;
-     node.lastSeen = millis();
-     node.visitCount = 1;
-     
-     if (nodeCount < MAX_MAP_NODES) {
-       nodes[nodeCount] = node;
+     MapHandle newNode = appendNode(lat, lng, NodeType::PATH);
+     if (newNode != MAP_NO_HANDLE) {
+       journal.logNode(store, newNode);
        
        // Create edge between current node and new node
-       if (currentNodeIndex >= 0 && edgeCount < MAX_MAP_EDGES) {
-         MapEdge edge;
-         edge.id = generateEdgeId();
-         edge.sourceId = currentNodeId;
-         edge.targetId = node.id;
-         edge.weight = calculateDistance(nodes[currentNodeIndex].lat, nodes[currentNodeIndex].lng,
-                                       node.lat, node.lng);
-         edge.lastTraversed = millis();
-         edge.traverseCount = 1;
-         
-         edges[edgeCount] = edge;
-         edgeCount++;
+       if (currentNode != MAP_NO_HANDLE) {
+         MapHandle edge = appendEdge(currentNode, newNode);
+         if (edge != MAP_NO_HANDLE) {
+           journal.logEdge(store, edge);
+         }
        }
        
-       currentNodeId = node.id;
-       nodeCount++;
+       currentNode = newNode;
      }
    }
-   
-   // Save map occasionally (every 10 minutes)
-   static unsigned long lastSaveTime = 0;
-   if (millis() - lastSaveTime > 600000) {
-     saveMap();
-     lastSaveTime = millis();
+ }
+ 
+ void MapSystem::updateMotion(float heading, float speed) {
+ #ifdef SMARTGUIDE_BASE_MAP
+   // Load the base map tiles ahead before a query needs them
+   if (!isFirstPosition) {
+     tiles.prefetch(currentLat, currentLng, heading, speed);
    }
+ #else
+   (void)heading;
+   (void)speed;
+ #endif
  }
  
- void MapSystem::addObstacle(float lat, float lng, String type) {
+ void MapSystem::addObstacle(float lat, float lng, ObstacleType type) {
    // Check if there's already an obstacle node nearby
-   int nearestNodeIndex = findNearestNodeIndex(lat, lng, NODE_PROXIMITY_THRESHOLD);
+   MapHandle nearestNode = findNearestNode(lat, lng, NODE_PROXIMITY_THRESHOLD);
    
-   if (nearestNodeIndex >= 0 && nodes[nearestNodeIndex].isObstacle) {
+   if (nearestNode != MAP_NO_HANDLE && store.isObstacle(nearestNode)) {
      // Update existing obstacle
-     nodes[nearestNodeIndex].lastSeen = millis();
-     nodes[nearestNodeIndex].visitCount++;
-     nodes[nearestNodeIndex].type = type; // Update type in case it changed
+     bool retyped = store.getObstacleType(nearestNode) != type;
+     store.visitNode(nearestNode, now());
+     store.setObstacleType(nearestNode, type); // Update type in case it changed
+     scheduleExpiry(nearestNode);
+     
+     // Seen again on every detection while in range, so a refresh is
+     // journaled once we leave or another obstacle is seen. A new type
+     // is journaled right away.
+     if (retyped) {
+       journal.logNode(store, nearestNode);
+       if (unloggedObstacle == nearestNode) {
+         unloggedObstacle = MAP_NO_HANDLE;
+       }
+     } else if (unloggedObstacle != nearestNode) {
+       if (unloggedObstacle != MAP_NO_HANDLE) {
+         journal.logNode(store, unloggedObstacle);
+       }
+       unloggedObstacle = nearestNode;
+     }
+     updateRouteCosts(lat, lng);
      return;
    }
    
    // Create new obstacle node
-   MapNode node;
-   node.id = generateNodeId();
-   node.lat = lat;
-   node.lng = lng;
-   node.type = type;
-   node.isObstacle = true;
-   node.lastSeen = millis();
-   node.visitCount = 1;
-   
-   if (nodeCount < MAX_MAP_NODES) {
-     nodes[nodeCount] = node;
-     nodeCount++;
+   MapHandle node = appendNode(lat, lng, NodeType::OBSTACLE);
+   if (node != MAP_NO_HANDLE) {
+     store.setObstacleType(node, type);
+     scheduleExpiry(node);
+     journal.logNode(store, node);
+     updateRouteCosts(lat, lng);
    }
  }
  
- void MapSystem::addLandmark(float lat, float lng, String type, String name) {
+ void MapSystem::addLandmark(float lat, float lng, NodeType type, const char* name) {
    // Create new landmark node (basically a special type of node)
-   MapNode node;
-   node.id = name + "_" + generateNodeId(); // Use name as part of ID
-   node.lat = lat;
-   node.lng = lng;
-   node.type = type;
-   node.isObstacle = false;
-   node.lastSeen = millis();
-   node.visitCount = 1;
-   
-   if (nodeCount < MAX_MAP_NODES) {
-     nodes[nodeCount] = node;
-     nodeCount++;
+   MapHandle node = appendNode(lat, lng, type);
+   if (node == MAP_NO_HANDLE) {
+     return;
+   }
+   if (names.setName(node, name)) {
+     store.setFlag(node, NODE_FLAG_NAMED);
+     routeLandmarksStale = true;
+   }
+   journal.logNode(store, node);
+   if (store.hasFlag(node, NODE_FLAG_NAMED)) {
+     journal.logName(node, name);
    }
  }
  
  bool MapSystem::isObstacleNearby(float lat, float lng, float radius) {
-   for (int i = 0; i < nodeCount; i++) {
-     if (nodes[i].isObstacle) {
-       float dist = calculateDistance(lat, lng, nodes[i].lat, nodes[i].lng);
-       if (dist <= radius) {
-         return true;
+   expireObstacles();
+   
+   struct ObstacleSearch {
+     MapSystem* map;
+     LocalPoint centre;
+     int64_t radiusSquared;
+     bool found;
+     
+     bool operator()(MapHandle node) {
+       if (map->store.isObstacle(node) &&
+           LocalFrame::distanceSquared(centre, map->nodeLocal[node]) <= radiusSquared) {
+         found = true;
+         return false;
        }
+       return true;
      }
+   } search = {this, localOf(lat, lng), LocalFrame::radiusSquared(radius), false};
+   
+   grid.forEachNear(lat, lng, radius, search);
+   if (search.found) {
+     return true;
    }
+ 
+ #ifdef SMARTGUIDE_BASE_MAP
+   // Obstacles the base map knows about
+   struct TileObstacleSearch {
+     MapSystem* map;
+     LocalPoint centre;
+     int64_t radiusSquared;
+     bool found;
+     
+     bool operator()(const TileRef&, float nodeLat, float nodeLng, NodeType type, ObstacleType) {
+       if (type == NodeType::OBSTACLE &&
+           LocalFrame::distanceSquared(centre, map->frame.toLocal(nodeLat, nodeLng)) <= radiusSquared) {
+         found = true;
+         return false;
+       }
+       return true;
+     }
+   } tileSearch = {this, search.centre, search.radiusSquared, false};
+   
+   tiles.forEachNear(lat, lng, radius, tileSearch);
+   return tileSearch.found;
+ #else
    return false;
+ #endif
  }
  
- String MapSystem::getAreaType(float lat, float lng, float radius) {
+ NodeType MapSystem::getAreaType(float lat, float lng, float radius) {
    // Count node types in the area to determine predominant type
-   int typeCount[5] = {0, 0, 0, 0, 0}; // path, door, room, street, other
+   struct TypeCount {
+     MapSystem* map;
+     LocalPoint centre;
+     int64_t radiusSquared;
+     int count[(int)NodeType::COUNT];
+     
+     bool operator()(MapHandle node) {
+       if (LocalFrame::distanceSquared(centre, map->nodeLocal[node]) <= radiusSquared) {
+         count[(int)map->store.getType(node)]++;
+       }
+       return true;
+     }
+   } area = {this, localOf(lat, lng), LocalFrame::radiusSquared(radius), {0}};
    
-   for (int i = 0; i < nodeCount; i++) {
-     float dist = calculateDistance(lat, lng, nodes[i].lat, nodes[i].lng);
-     if (dist <= radius) {
-       if (nodes[i].type == "path") typeCount[0]++;
-       else if (nodes[i].type == "door") typeCount[1]++;
-       else if (nodes[i].type == "room") typeCount[2]++;
-       else if (nodes[i].type == "street") typeCount[3]++;
-       else typeCount[4]++;
+   grid.forEachNear(lat, lng, radius, area);
+   int* typeCount = area.count;
+ 
+ #ifdef SMARTGUIDE_BASE_MAP
+   // Base map nodes count as well
+   struct TileTypeCount {
+     MapSystem* map;
+     LocalPoint centre;
+     int64_t radiusSquared;
+     int* count;
+     
+     bool operator()(const TileRef&, float nodeLat, float nodeLng, NodeType type, ObstacleType) {
+       if (LocalFrame::distanceSquared(centre, map->frame.toLocal(nodeLat, nodeLng)) <= radiusSquared) {
+         count[(int)type]++;
+       }
+       return true;
      }
-   }
+   } tileArea = {this, area.centre, area.radiusSquared, typeCount};
+   
+   tiles.forEachNear(lat, lng, radius, tileArea);
+ #endif
+   
+   // Obstacles don't describe the area
+   typeCount[(int)NodeType::OTHER] += typeCount[(int)NodeType::OBSTACLE];
+   typeCount[(int)NodeType::OBSTACLE] = 0;
    
    // Find max
    int maxIndex = 0;
-   for (int i = 1; i < 5; i++) {
+   for (int i = 1; i < (int)NodeType::COUNT; i++) {
      if (typeCount[i] > typeCount[maxIndex]) {
        maxIndex = i;
      }
    }
    
    // Return predominant type
-   switch (maxIndex) {
-     case 0: return "path";
-     case 1: return "door";
-     case 2: return "room";
-     case 3: return "street";
-     default: return "unknown";
-   }
+   return (NodeType)maxIndex;
  }
  
+ // Write a full snapshot now; changes are otherwise journaled as they happen
  bool MapSystem::saveMap() {
    if (!sdAvailable) {
      return false;
    }
    
-   // Create JSON document
-   // Note: in a real implementation, this would need to be more memory efficient
-   // using streaming or chunked writes for large maps
+   if (!journal.saveAll(store, names)) {
+     Serial.println("Failed to write map file");
+     return false;
+   }
+   return true;
+ }
+ 
+ bool MapSystem::exportJson(const char* path) {
+   if (!sdAvailable) {
+     return false;
+   }
+   
+   // Create JSON document. Only for export; saveMap streams the binary format instead
    DynamicJsonDocument doc(50000); // Adjust size as needed
    
-   // Add nodes
+   // Add nodes, identified by their handle
    JsonArray nodesArray = doc.createNestedArray("nodes");
-   for (int i = 0; i < nodeCount; i++) {
+   for (MapHandle i = 0; i < store.getNodeCount(); i++) {
+     if (store.isFree(i)) {
+       continue;
+     }
      JsonObject nodeObj = nodesArray.createNestedObject();
-     nodeObj["id"] = nodes[i].id;
-     nodeObj["lat"] = nodes[i].lat;
-     nodeObj["lng"] = nodes[i].lng;
-     nodeObj["type"] = nodes[i].type;
-     nodeObj["isObstacle"] = nodes[i].isObstacle;
-     nodeObj["visitCount"] = nodes[i].visitCount;
+     nodeObj["id"] = i;
+     nodeObj["lat"] = store.getLat(i);
+     nodeObj["lng"] = store.getLng(i);
+     nodeObj["type"] = store.isObstacle(i) ? obstacleTypeLabel(store.getObstacleType(i)) : nodeTypeLabel(store.getType(i));
+     nodeObj["isObstacle"] = store.isObstacle(i);
+     nodeObj["visitCount"] = store.getVisitCount(i);
+     nodeObj["lastSeen"] = store.getLastSeen(i);
+     if (store.hasFlag(i, NODE_FLAG_NAMED)) {
+       nodeObj["name"] = names.nameOf(i);
+     }
    }
    
    // Add edges
    JsonArray edgesArray = doc.createNestedArray("edges");
-   for (int i = 0; i < edgeCount; i++) {
+   for (MapHandle i = 0; i < store.getEdgeCount(); i++) {
+     if (store.isFreeEdge(i)) {
+       continue;
+     }
      JsonObject edgeObj = edgesArray.createNestedObject();
-     edgeObj["id"] = edges[i].id;
-     edgeObj["sourceId"] = edges[i].sourceId;
-     edgeObj["targetId"] = edges[i].targetId;
-     edgeObj["weight"] = edges[i].weight;
-     edgeObj["traverseCount"] = edges[i].traverseCount;
+     edgeObj["sourceId"] = store.getSource(i);
+     edgeObj["targetId"] = store.getTarget(i);
+     edgeObj["weight"] = store.getWeight(i);
+     edgeObj["traverseCount"] = store.getTraverseCount(i);
    }
    
    // Open file for writing
-   File mapFile = SD.open(MAP_FILENAME, FILE_WRITE);
+   File mapFile = SD.open(path, FILE_WRITE);
    if (!mapFile) {
      return false;
    }
@@ -312,18 +415,61 @@
    return true;
  }
  
+ // Files written before handles used "n_<millis>_<random>" string ids,
+ // with the landmark name in front. Find the node such an id refers to.
+ static MapHandle findLegacyNode(JsonArray nodesArray, const char* id) {
+   MapHandle position = 0;
+   for (JsonObject nodeObj : nodesArray) {
+     const char* nodeId = nodeObj["id"];
+     if (nodeId && strcmp(nodeId, id) == 0) {
+       return position;
+     }
+     position++;
+   }
+   return MAP_NO_HANDLE;
+ }
+ 
+ // Position of the node with a numeric id, for files whose ids have gaps
+ static MapHandle findNumberedNode(JsonArray nodesArray, MapHandle id) {
+   MapHandle position = 0;
+   for (JsonObject nodeObj : nodesArray) {
+     if (nodeObj["id"].is<int>() && (nodeObj["id"] | MAP_NO_HANDLE) == id) {
+       return position;
+     }
+     position++;
+   }
+   return MAP_NO_HANDLE;
+ }
+ 
  bool MapSystem::loadMap() {
    if (!sdAvailable) {
      return false;
    }
    
-   // Check if file exists
-   if (!SD.exists(MAP_FILENAME)) {
+   // Snapshot plus journal, straight into the store
+   resetIndexes();
+   bool loaded = journal.recover(store, names);
+   if (loaded) {
+     rebuildIndexes();
+   } else if (SD.exists(MAP_JSON_FILENAME)) {
+     // Convert a map saved before the binary format
+     loaded = importJson(MAP_JSON_FILENAME);
+   }
+   
+   // Start a fresh journal after a power cut, a conversion or on a new card
+   if (!journal.isReady()) {
+     saveMap();
+   }
+   return loaded;
+ }
+ 
+ bool MapSystem::importJson(const char* path) {
+   if (!sdAvailable || !SD.exists(path)) {
      return false;
    }
    
    // Open file for reading
-   File mapFile = SD.open(MAP_FILENAME, FILE_READ);
+   File mapFile = SD.open(path, FILE_READ);
    if (!mapFile) {
      return false;
    }
@@ -339,89 +485,563 @@
    }
    
    // Clear existing data
-   nodeCount = 0;
-   edgeCount = 0;
+   store.clear();
+   names.clear();
+   resetIndexes();
    
-   // Load nodes
+   // Load nodes, in order, so a node's handle is its position in the file.
+   // Exported ids are the handles, which skip free slots.
    JsonArray nodesArray = doc["nodes"];
+   bool idsArePositions = true;
    for (JsonObject nodeObj : nodesArray) {
-     if (nodeCount < MAX_MAP_NODES) {
-       MapNode node;
-       node.id = nodeObj["id"].as<String>();
-       node.lat = nodeObj["lat"];
-       node.lng = nodeObj["lng"];
-       node.type = nodeObj["type"].as<String>();
-       node.isObstacle = nodeObj["isObstacle"];
-       node.visitCount = nodeObj["visitCount"];
-       node.lastSeen = millis(); // Reset last seen to now
-       
-       nodes[nodeCount] = node;
-       nodeCount++;
+     if (nodeObj["id"].is<int>() && (nodeObj["id"] | MAP_NO_HANDLE) != store.getNodeCount()) {
+       idsArePositions = false;
+     }
+     
+     // Obstacle nodes store the obstacle label as their type
+     bool isObstacle = nodeObj["isObstacle"];
+     const char* type = nodeObj["type"];
+     MapHandle node = appendNode(nodeObj["lat"], nodeObj["lng"],
+                                 isObstacle ? NodeType::OBSTACLE : nodeTypeFromLabel(type));
+     if (node == MAP_NO_HANDLE) {
+       break;
+     }
+     
+     if (isObstacle) {
+       store.setObstacleType(node, obstacleTypeFromLabel(type));
+     }
+     store.setVisitCount(node, nodeObj["visitCount"]);
+     store.setLastSeen(node, nodeObj["lastSeen"] | store.getLastSeen(node));
+     scheduleExpiry(node);
+     
+     // Old landmark ids carry the name: "<name>_n_<millis>_<random>"
+     const char* name = nodeObj["name"];
+     const char* legacyId = nodeObj["id"];
+     const char* legacyEnd = legacyId ? strstr(legacyId, "_n_") : 0;
+     char legacyName[32];
+     if (!name && legacyEnd && legacyEnd - legacyId < (int)sizeof(legacyName)) {
+       memcpy(legacyName, legacyId, legacyEnd - legacyId);
+       legacyName[legacyEnd - legacyId] = '\0';
+       name = legacyName;
+     }
+     if (name && names.setName(node, name)) {
+       store.setFlag(node, NODE_FLAG_NAMED);
      }
    }
    
    // Load edges
    JsonArray edgesArray = doc["edges"];
    for (JsonObject edgeObj : edgesArray) {
-     if (edgeCount < MAX_MAP_EDGES) {
-       MapEdge edge;
-       edge.id = edgeObj["id"].as<String>();
-       edge.sourceId = edgeObj["sourceId"].as<String>();
-       edge.targetId = edgeObj["targetId"].as<String>();
-       edge.weight = edgeObj["weight"];
-       edge.traverseCount = edgeObj["traverseCount"];
-       edge.lastTraversed = millis(); // Reset last traversed to now
-       
-       edges[edgeCount] = edge;
-       edgeCount++;
+     MapHandle source, target;
+     if (edgeObj["sourceId"].is<const char*>()) {
+       source = findLegacyNode(nodesArray, edgeObj["sourceId"]);
+       target = findLegacyNode(nodesArray, edgeObj["targetId"]);
+     } else if (!idsArePositions) {
+       source = findNumberedNode(nodesArray, edgeObj["sourceId"] | MAP_NO_HANDLE);
+       target = findNumberedNode(nodesArray, edgeObj["targetId"] | MAP_NO_HANDLE);
+     } else {
+       source = edgeObj["sourceId"] | MAP_NO_HANDLE;
+       target = edgeObj["targetId"] | MAP_NO_HANDLE;
+     }
+     
+     // Skip edges to nodes that did not fit or are missing
+     if (!store.isNode(source) || !store.isNode(target)) {
+       continue;
+     }
+     
+     MapHandle edge = store.addEdge(source, target, edgeObj["weight"], now());
+     if (edge == MAP_NO_HANDLE) {
+       break;
      }
+     store.setTraverseCount(edge, edgeObj["traverseCount"]);
+     adjacency.add(edge, source, target);
    }
    
    return true;
  }
  
  void MapSystem::clearMap() {
-   nodeCount = 0;
-   edgeCount = 0;
+   store.clear();
+   names.clear();
+   resetIndexes();
    isFirstPosition = true;
-   currentNodeId = "";
    
-   // Delete map file if it exists
-   if (sdAvailable && SD.exists(MAP_FILENAME)) {
-     SD.remove(MAP_FILENAME);
+   // Delete map files, including an old JSON map that would be imported again,
+   // and start over with an empty snapshot
+   if (sdAvailable) {
+     journal.clear();
+     if (SD.exists(MAP_JSON_FILENAME)) {
+       SD.remove(MAP_JSON_FILENAME);
+     }
+     saveMap();
+   }
+ }
+ 
+ // Forget everything derived from the old map contents
+ void MapSystem::resetIndexes() {
+   grid.clear();
+   adjacency.clear();
+   obstacleExpiry.clear(now());
+   routeLandmarks.clear();
+   routeLandmarksStale = true;
+   hasRoute = false;
+   currentNode = MAP_NO_HANDLE;
+   unloggedVisit = MAP_NO_HANDLE;
+   unloggedObstacle = MAP_NO_HANDLE;
+ }
+ 
+ // Index every node and edge of a map loaded straight into the store
+ void MapSystem::rebuildIndexes() {
+   for (MapHandle node = 0; node < store.getNodeCount(); node++) {
+     if (!store.isFree(node)) {
+       grid.insert(node, store.getLat(node), store.getLng(node));
+     }
+   }
+   if (frame.isSet()) {
+     recentreFrame(frame.getOriginLat(), frame.getOriginLng());
+   }
+   for (MapHandle edge = 0; edge < store.getEdgeCount(); edge++) {
+     if (!store.isFreeEdge(edge)) {
+       adjacency.add(edge, store.getSource(edge), store.getTarget(edge));
+     }
+   }
+   scheduleAllObstacles();
+ }
+ 
+ bool MapSystem::findPath(float startLat, float startLng, float endLat, float endLng) {
+   hasRoute = false;
+   tileRoute = false;
+   
+   // Prefer the learned map; fall back to the base map when either end is off it
+   MapHandle start = findNearestNode(startLat, startLng, PATH_NODE_DISTANCE);
+   MapHandle goal = findNearestNode(endLat, endLng, PATH_NODE_DISTANCE);
+   if (start == MAP_NO_HANDLE || goal == MAP_NO_HANDLE) {
+ #ifdef SMARTGUIDE_BASE_MAP
+     TileRef tileStart, tileGoal;
+     if (!findNearestTileNode(startLat, startLng, PATH_NODE_DISTANCE, tileStart) ||
+         !findNearestTileNode(endLat, endLng, PATH_NODE_DISTANCE, tileGoal)) {
+       return false;
+     }
+     if (tileRouter.findPath(tiles, tileStart, tileGoal) != TileRouteStatus::FOUND) {
+       return false;
+     }
+     hasRoute = true;
+     tileRoute = true;
+     pathCursor = 0;
+     return true;
+ #else
+     return false;
+ #endif
+   }
+   
+   if (routeLandmarksStale && store.getLiveNodeCount() >= ROUTE_LANDMARK_MIN_NODES) {
+     RouteGraph graph = {this};
+     routeLandmarks.build(store.getNodeCount(), graph);
+     routeLandmarksStale = false;
+   }
+   
+   penaliseObstacleEdges();
+   RouteCostGraph graph = {this};
+   StraightLine heuristic = {this};
+   if (!planner.plan(start, goal, graph, heuristic)) {
+     return false;
+   }
+   
+   hasRoute = true;
+   pathCursor = 0;
+   return true;
+ }
+ 
+ bool MapSystem::getNextPathNode(float &lat, float &lng) {
+   if (!hasRoute) {
+     return false;
+   }
+ 
+ #ifdef SMARTGUIDE_BASE_MAP
+   if (tileRoute) {
+     // Skip the route nodes already reached, faulting in their tiles
+     const TileRef* path = tileRouter.getPath();
+     while (pathCursor < tileRouter.getPathLength()) {
+       if (!tiles.getNode(path[pathCursor], lat, lng)) {
+         hasRoute = false;  // Base map went away under the route
+         return false;
+       }
+       if (!LocalFrame::isWithin(localOf(currentLat, currentLng), frame.toLocal(lat, lng), NODE_PROXIMITY_THRESHOLD)) {
+         return true;
+       }
+       pathCursor++;
+     }
+     hasRoute = false;  // Destination reached
+     return false;
+   }
+ #endif
+   
+   // Skip the route nodes already reached
+   const MapHandle* path = planner.getPath();
+   LocalPoint here = localOf(currentLat, currentLng);
+   while (pathCursor < planner.getPathLength() &&
+          LocalFrame::isWithin(here, nodeLocal[path[pathCursor]], NODE_PROXIMITY_THRESHOLD)) {
+     pathCursor++;
+   }
+   
+   if (pathCursor >= planner.getPathLength()) {
+     hasRoute = false;  // Destination reached
+     return false;
+   }
+   
+   lat = store.getLat(path[pathCursor]);
+   lng = store.getLng(path[pathCursor]);
+   return true;
+ }
+ 
+ // Mark the edges around every obstacle, before a route is planned
+ void MapSystem::penaliseObstacleEdges() {
+   struct EdgeMarker {
+     MapSystem* map;
+     LocalPoint point;
+     
+     bool operator()(MapHandle node) {
+       for (int32_t h = map->adjacency.first(node); h != EDGE_NONE; h = map->adjacency.next(h)) {
+         MapHandle edge = map->adjacency.edgeOf(h);
+         if (LocalFrame::segmentDistance(point, map->nodeLocal[map->store.getSource(edge)],
+                                         map->nodeLocal[map->store.getTarget(edge)]) <= ROUTE_BLOCK_RADIUS_M) {
+           map->setPenalised(edge, true);
+         }
+       }
+       return true;
+     }
+   };
+   
+   for (int i = 0; i < (MAX_MAP_EDGES + 31) / 32; i++) {
+     penalisedEdges[i] = 0;
+   }
+   for (MapHandle node = 0; node < store.getNodeCount(); node++) {
+     if (!store.isFree(node) && store.isObstacle(node)) {
+       EdgeMarker marker = {this, nodeLocal[node]};
+       grid.forEachNear(store.getLat(node), store.getLng(node), ROUTE_BLOCK_RADIUS_M + MAP_SIMPLIFY_MAX_EDGE / 2, marker);
+     }
+   }
+ }
+ 
+ // Returns whether the edge's mark changed
+ bool MapSystem::setPenalised(MapHandle edge, bool penalised) {
+   if (isPenalised(edge) == penalised) {
+     return false;
+   }
+   penalisedEdges[edge >> 5] ^= 1u << (edge & 31);
+   return true;
+ }
+ 
+ // Whether an obstacle stands within ROUTE_BLOCK_RADIUS_M of an edge
+ bool MapSystem::isEdgeBlocked(MapHandle edge) {
+   struct ObstacleSearch {
+     MapSystem* map;
+     LocalPoint a;
+     LocalPoint b;
+     bool found;
+     
+     bool operator()(MapHandle node) {
+       if (map->store.isObstacle(node) &&
+           LocalFrame::segmentDistance(map->nodeLocal[node], a, b) <= ROUTE_BLOCK_RADIUS_M) {
+         found = true;
+         return false;
+       }
+       return true;
+     }
+   } search = {this, nodeLocal[store.getSource(edge)], nodeLocal[store.getTarget(edge)], false};
+   
+   float lat = (store.getLat(store.getSource(edge)) + store.getLat(store.getTarget(edge))) / 2;
+   float lng = (store.getLng(store.getSource(edge)) + store.getLng(store.getTarget(edge))) / 2;
+   grid.forEachNear(lat, lng, LocalFrame::distance(search.a, search.b) / 2 + ROUTE_BLOCK_RADIUS_M, search);
+   return search.found;
+ }
+ 
+ // An obstacle appeared or went at a position: penalise or clear the route
+ // edges around it and repair the route from the last node reached. Only
+ // the part of the search the change affects is expanded again.
+ void MapSystem::updateRouteCosts(float lat, float lng) {
+   if (!hasRoute || tileRoute || !planner.isPlanned()) {
+     return;
+   }
+   
+   // The keys of the repair are relative to where the user is
+   RouteCostGraph graph = {this};
+   StraightLine heuristic = {this};
+   const int32_t* path = planner.getPath();
+   MapHandle heading = pathCursor < planner.getPathLength() ? path[pathCursor] : MAP_NO_HANDLE;
+   planner.setStart(path[pathCursor > 0 ? pathCursor - 1 : 0], heuristic);
+   
+   struct EdgeCosts {
+     MapSystem* map;
+     RouteCostGraph* graph;
+     StraightLine* heuristic;
+     LocalPoint point;
+     int changed;
+     
+     bool operator()(MapHandle node) {
+       for (int32_t h = map->adjacency.first(node); h != EDGE_NONE; h = map->adjacency.next(h)) {
+         MapHandle edge = map->adjacency.edgeOf(h);
+         MapHandle source = map->store.getSource(edge);
+         MapHandle target = map->store.getTarget(edge);
+         if (LocalFrame::segmentDistance(point, map->nodeLocal[source], map->nodeLocal[target]) > ROUTE_BLOCK_RADIUS_M) {
+           continue;
+         }
+         if (map->setPenalised(edge, map->isEdgeBlocked(edge))) {
+           map->planner.updateEdge(source, target, *graph, *heuristic);
+           changed++;
+         }
+       }
+       return true;
+     }
+   } costs = {this, &graph, &heuristic, localOf(lat, lng), 0};
+   
+   grid.forEachNear(lat, lng, ROUTE_BLOCK_RADIUS_M + MAP_SIMPLIFY_MAX_EDGE / 2, costs);
+   if (costs.changed == 0) {
+     return;
+   }
+   
+   if (!planner.replan(graph, heuristic)) {
+     hasRoute = false;
+     return;
+   }
+   
+   // Keep heading for the same node if the new route still goes there
+   pathCursor = planner.getPathLength() > 1 && planner.getPath()[1] == heading ? 1 : 0;
+ }
+ 
+ // Let the simplifier look at a few nodes, journaling what it changes
+ void MapSystem::simplifyStep() {
+   // A planned route holds node handles
+   if (hasRoute && !tileRoute) {
+     return;
+   }
+   
+   struct Journaled {
+     MapSystem* map;
+     
+     void nodeChanged(MapHandle node) { map->journal.logNode(map->store, node); }
+     void edgeChanged(MapHandle edge) {
+       map->journal.logEdge(map->store, edge);
+       if (!map->store.isFreeEdge(edge)) {
+         RouteGraph graph = {map};
+         map->routeLandmarks.addEdge(map->store.getSource(edge), map->store.getTarget(edge),
+                                     map->store.getWeight(edge), graph);
+       }
+     }
+   } changed = {this};
+   
+   simplifier.pin(currentNode);
+   simplifier.step(changed, MAP_SIMPLIFY_NODES_PER_STEP);
+ }
+ 
+ // Set the wall clock from GPS time. The first time, stamps written before
+ // there was a clock become now, and obstacle lifetimes start counting.
+ void MapSystem::setTime(uint32_t unixSeconds) {
+   bool first = !clockSet;
+   clockSet = true;
+   clockSeconds = unixSeconds;
+   clockMillis = millis();
+   if (!first) {
+     return;
+   }
+   
+   uint32_t time = now();
+   for (MapHandle node = 0; node < store.getNodeCount(); node++) {
+     if (!store.isFree(node) && store.getLastSeen(node) < MAP_TIME_VALID_FROM) {
+       store.setLastSeen(node, time);
+       if (store.isObstacle(node)) {
+         journal.logNode(store, node);
+       }
+     }
    }
+   for (MapHandle edge = 0; edge < store.getEdgeCount(); edge++) {
+     if (store.getLastTraversed(edge) < MAP_TIME_VALID_FROM) {
+       store.setLastTraversed(edge, time);
+     }
+   }
+   scheduleAllObstacles();
  }
  
- String MapSystem::generateNodeId() {
-   // Generate a simple unique ID based on timestamp and random number
-   return "n_" + String(millis()) + "_" + String(random(1000, 9999));
+ // Unix seconds, or 0 until GPS time is known
+ uint32_t MapSystem::now() {
+   if (!clockSet) {
+     return 0;
+   }
+   return clockSeconds + (millis() - clockMillis) / 1000;
  }
  
- String MapSystem::generateEdgeId() {
-   // Generate a simple unique ID based on timestamp and random number
-   return "e_" + String(millis()) + "_" + String(random(1000, 9999));
+ // Put an obstacle in the expiry wheel by its type and when it was last seen
+ void MapSystem::scheduleExpiry(MapHandle node) {
+   uint32_t ttl = obstacleTtl(store.getObstacleType(node));
+   if (!clockSet || !store.isObstacle(node) || ttl == OBSTACLE_TTL_PERMANENT) {
+     obstacleExpiry.cancel(node);
+     return;
+   }
+   obstacleExpiry.schedule(node, store.getLastSeen(node) + ttl);
  }
  
- int MapSystem::findNodeIndex(String nodeId) {
-   for (int i = 0; i < nodeCount; i++) {
-     if (nodes[i].id == nodeId) {
-       return i;
+ void MapSystem::scheduleAllObstacles() {
+   obstacleExpiry.clear(now());
+   for (MapHandle node = 0; node < store.getNodeCount(); node++) {
+     if (!store.isFree(node) && store.isObstacle(node)) {
+       scheduleExpiry(node);
      }
    }
-   return -1; // Not found
  }
  
- int MapSystem::findNearestNodeIndex(float lat, float lng, float maxDistance) {
-   int nearestIndex = -1;
-   float minDistance = maxDistance + 1.0; // Initialize above threshold
+ // Cheap when nothing is due: the wheel only looks at its next slot
+ void MapSystem::expireObstacles() {
+   if (!clockSet) {
+     return;
+   }
+   
+   struct Expired {
+     MapSystem* map;
+     
+     void operator()(int node) { map->forgetObstacle(node); }
+   } expired = {this};
    
-   for (int i = 0; i < nodeCount; i++) {
-     float dist = calculateDistance(lat, lng, nodes[i].lat, nodes[i].lng);
-     if (dist < minDistance && dist <= maxDistance) {
-       minDistance = dist;
-       nearestIndex = i;
+   obstacleExpiry.advance(now(), expired);
+ }
+ 
+ // An obstacle walked through stays as a path node; any other is removed
+ void MapSystem::forgetObstacle(MapHandle node) {
+   if (store.isFree(node) || !store.isObstacle(node)) {
+     return;
+   }
+   if (adjacency.first(node) != EDGE_NONE || node == currentNode) {
+     store.setType(node, NodeType::PATH);
+     store.setObstacleType(node, ObstacleType::UNKNOWN);
+   } else {
+     grid.remove(node);
+     store.freeNode(node);
+   }
+   journal.logNode(store, node);
+   if (unloggedObstacle == node) {
+     unloggedObstacle = MAP_NO_HANDLE;
+   }
+   updateRouteCosts(store.getLat(node), store.getLng(node));
+ }
+ 
+ // Store a node and index it, returns its handle or MAP_NO_HANDLE if the map is full
+ MapHandle MapSystem::appendNode(float lat, float lng, NodeType type) {
+   MapHandle node = store.allocNode(lat, lng, type, now());
+   if (node != MAP_NO_HANDLE) {
+     grid.insert(node, lat, lng);
+     nodeLocal[node] = localOf(lat, lng);
+     routeLandmarks.addNode(node);
+   }
+   return node;
+ }
+ 
+ // Join two nodes and index the edge, returns its handle or MAP_NO_HANDLE if the map is full
+ MapHandle MapSystem::appendEdge(MapHandle source, MapHandle target) {
+   float weight = LocalFrame::distance(nodeLocal[source], nodeLocal[target]);
+   MapHandle edge = store.allocEdge(source, target, weight, now());
+   if (edge != MAP_NO_HANDLE) {
+     adjacency.add(edge, source, target);
+     RouteGraph graph = {this};
+     routeLandmarks.addEdge(source, target, weight, graph);
+     
+     // A held route can take the new edge at its next repair
+     if (hasRoute && !tileRoute) {
+       setPenalised(edge, isEdgeBlocked(edge));
+       RouteCostGraph costGraph = {this};
+       StraightLine heuristic = {this};
+       planner.updateEdge(source, target, costGraph, heuristic);
      }
    }
+   return edge;
+ }
+ 
+ MapHandle MapSystem::findNearestNode(float lat, float lng, float maxDistance) {
+   // Only nodes in the grid cells around the position can be in range
+   struct NearestSearch {
+     MapSystem* map;
+     LocalPoint centre;
+     MapHandle nearestNode;
+     int64_t minDistance;
+     
+     bool operator()(MapHandle node) {
+       int64_t dist = LocalFrame::distanceSquared(centre, map->nodeLocal[node]);
+       if (dist <= minDistance) {
+         minDistance = dist;
+         nearestNode = node;
+       }
+       return true;
+     }
+   } search = {this, localOf(lat, lng), MAP_NO_HANDLE, LocalFrame::radiusSquared(maxDistance)};
+   
+   grid.forEachNear(lat, lng, maxDistance, search);
+   return search.nearestNode;
+ }
+ 
+ // Edge passing within maxDistance of a position, or MAP_NO_HANDLE. Walked
+ // edges are at most MAP_SIMPLIFY_MAX_EDGE long, so an end is within reach.
+ MapHandle MapSystem::findNearestEdge(float lat, float lng, float maxDistance) {
+   struct EdgeSearch {
+     MapSystem* map;
+     LocalPoint point;
+     MapHandle nearestEdge;
+     float minDistance;
+     
+     bool operator()(MapHandle node) {
+       for (int32_t h = map->adjacency.first(node); h != EDGE_NONE; h = map->adjacency.next(h)) {
+         MapHandle edge = map->adjacency.edgeOf(h);
+         float dist = LocalFrame::segmentDistance(point, map->nodeLocal[map->store.getSource(edge)],
+                                                  map->nodeLocal[map->store.getTarget(edge)]);
+         if (dist <= minDistance) {
+           minDistance = dist;
+           nearestEdge = edge;
+         }
+       }
+       return true;
+     }
+   } search = {this, localOf(lat, lng), MAP_NO_HANDLE, maxDistance};
    
-   return nearestIndex;
+   grid.forEachNear(lat, lng, maxDistance + MAP_SIMPLIFY_MAX_EDGE / 2, search);
+   return search.nearestEdge;
+ }
+ 
+ #ifdef SMARTGUIDE_BASE_MAP
+ bool MapSystem::findNearestTileNode(float lat, float lng, float maxDistance, TileRef& node) {
+   struct NearestTileSearch {
+     MapSystem* map;
+     LocalPoint centre;
+     TileRef nearestNode;
+     int64_t minDistance;
+     bool found;
+     
+     bool operator()(const TileRef& node, float nodeLat, float nodeLng, NodeType type, ObstacleType) {
+       int64_t dist = LocalFrame::distanceSquared(centre, map->frame.toLocal(nodeLat, nodeLng));
+       if (type != NodeType::OBSTACLE && dist <= minDistance) {
+         minDistance = dist;
+         nearestNode = node;
+         found = true;
+       }
+       return true;
+     }
+   } search = {this, localOf(lat, lng), {0, 0, 0}, LocalFrame::radiusSquared(maxDistance), false};
+   
+   tiles.forEachNear(lat, lng, maxDistance, search);
+   node = search.nearestNode;
+   return search.found;
+ }
+ #endif
+ 
+ // Position in the local frame, centring the frame there if it has no origin yet
+ LocalPoint MapSystem::localOf(float lat, float lng) {
+   if (!frame.isSet()) {
+     recentreFrame(lat, lng);
+   }
+   return frame.toLocal(lat, lng);
+ }
+ 
+ // Move the frame origin and convert every node again. Runs when the user
+ // walks out of the frame, so the distances near them stay accurate.
+ void MapSystem::recentreFrame(float lat, float lng) {
+   frame.setOrigin(lat, lng);
+   for (MapHandle node = 0; node < store.getNodeCount(); node++) {
+     nodeLocal[node] = frame.toLocal(store.getLat(node), store.getLng(node));
+   }
  }
\ No newline at end of file
@@ -1,6 +1,6 @@
 /*
  * MapSystem.h
- * 
+ *
  * Handles mapping and spatial memory features
  */
 
@@ -10,39 +10,139 @@
  #include <Arduino.h>
  #include <SD.h>
  #include <ArduinoJson.h>
+ #include "ObstacleTypes.h"
+ #include "MapStore.h"
+ #include "NameTable.h"
+ #include "SpatialGrid.h"
+ #include "RouteReplanner.h"
+ #include "LandmarkHeuristic.h"
+ #include "EdgeIndex.h"
+ #include "MapJournal.h"
+ #include "LocalFrame.h"
+ #include "MapSimplifier.h"
+ #include "TimingWheel.h"
+ #include "TileStore.h"
  
- // Maximum number of map nodes and edges
- #define MAX_MAP_NODES 500
- #define MAX_MAP_EDGES 1000
+ // Maximum number of map nodes and edges. Boards with PSRAM keep the
+ // map object there (see SmartGuide.ino) and can hold eight times more.
+ // Without PSRAM it is static data in internal RAM, about 140 bytes per
+ // node, and must stay within MAP_RAM_BUDGET.
+ #ifndef MAX_MAP_NODES
+ #ifdef BOARD_HAS_PSRAM
+ #define MAX_MAP_NODES 5000
+ #define MAP_GRID_BUCKETS 2048
+ #else
+ #define MAX_MAP_NODES 600
+ #define MAP_GRID_BUCKETS 256
+ #endif
+ #endif
+ #ifndef MAP_RAM_BUDGET
+ #define MAP_RAM_BUDGET (96 * 1024)  // Leaves the rest of DRAM to the sketch and radio stacks
+ #endif
+ #ifndef MAX_MAP_EDGES
+ #define MAX_MAP_EDGES (MAX_MAP_NODES * 3 / 2)  // Walked maps are mostly chains
+ #endif
+ #ifndef MAP_GRID_BUCKETS
+ #define MAP_GRID_BUCKETS 512  // Power of two, about half the node capacity
+ #endif
  
- // Node structure for map
- struct MapNode {
-   String id;
-   float lat;
-   float lng;
-   String type;
-   bool isObstacle;
-   unsigned long lastSeen;
-   int visitCount;
- };
+ // Base map tiles paged in from the SD card, and route search entries
+ // over them. Each slot holds one tile of MAP_TILE_NODES nodes. Without
+ // PSRAM the tile cache would crowd out the learned map, so the base map
+ // is only built in when SMARTGUIDE_BASE_MAP is defined, and then takes
+ // MAX_MAP_NODES down to about 400.
+ #if defined(BOARD_HAS_PSRAM) && !defined(SMARTGUIDE_BASE_MAP)
+ #define SMARTGUIDE_BASE_MAP
+ #endif
+ #ifdef SMARTGUIDE_BASE_MAP
+ #ifndef MAP_TILE_SLOTS
+ #ifdef BOARD_HAS_PSRAM
+ #define MAP_TILE_SLOTS 16
+ #define MAP_TILE_NODES 256
+ #define MAP_TILE_EDGES 512
+ #define MAP_TILE_SEARCH 8192
+ #else
+ #define MAP_TILE_SLOTS 4
+ #define MAP_TILE_NODES 128
+ #define MAP_TILE_EDGES 256
+ #define MAP_TILE_SEARCH 256
+ #define TILE_ROUTE_MAX_PATH 256
+ #endif
+ #endif
+ #include "TileRouter.h"
+ #endif
  
- // Edge structure for map
- struct MapEdge {
-   String id;
-   String sourceId;
-   String targetId;
-   float weight;
-   unsigned long lastTraversed;
-   int traverseCount;
- };
+ // Landmark names
+ #define MAX_MAP_LANDMARKS 64
+ #define MAP_NAME_POOL_BYTES 1024
+ 
+ // An obstacle this close to an edge makes it count as this much longer,
+ // so routes go around unless the detour is longer still
+ #define ROUTE_BLOCK_RADIUS_M 2.0f
+ #define ROUTE_OBSTACLE_PENALTY_M 50.0f
+ 
+ // Walked distances from a few landmark nodes tighten the route search
+ // once the map is big enough for it to matter
+ #ifndef ROUTE_LANDMARKS
+ #ifdef BOARD_HAS_PSRAM
+ #define ROUTE_LANDMARKS 8
+ #else
+ #define ROUTE_LANDMARKS 4
+ #endif
+ #endif
+ #define ROUTE_LANDMARK_MIN_NODES 200
+ 
+ // Nodes the simplifier examines per position update
+ #define MAP_SIMPLIFY_NODES_PER_STEP 16
+ 
+ // Map timestamps are Unix seconds from GPS time. Earlier values were
+ // written before the clock was set, or by versions that stored millis().
+ #define MAP_TIME_VALID_FROM 1577836800UL  // 2020-01-01
  
  class MapSystem {
    private:
      // Map data storage
-     MapNode nodes[MAX_MAP_NODES];
-     MapEdge edges[MAX_MAP_EDGES];
-     int nodeCount;
-     int edgeCount;
+     MapStore<MAX_MAP_NODES, MAX_MAP_EDGES> store;
+     NameTable<MAP_NAME_POOL_BYTES, MAX_MAP_LANDMARKS> names;
+     
+     // Node handles bucketed by grid cell for radius queries
+     SpatialGrid<MAX_MAP_NODES, MAP_GRID_BUCKETS> grid;
+     
+     // Node positions in centimetres around a nearby origin, for trig-free
+     // distance checks. Converted again whenever the origin moves.
+     LocalFrame frame;
+     LocalPoint nodeLocal[MAX_MAP_NODES];
+     
+     // Fuses duplicate nodes and thins straight chains, a few nodes per update
+     MapSimplifier<MapStore<MAX_MAP_NODES, MAX_MAP_EDGES>, SpatialGrid<MAX_MAP_NODES, MAP_GRID_BUCKETS>,
+                   EdgeIndex<MAX_MAP_NODES, MAX_MAP_EDGES> > simplifier;
+     
+     // Edges of each node, to find the edge between two nodes
+     EdgeIndex<MAX_MAP_NODES, MAX_MAP_EDGES> adjacency;
+     
+     // Obstacle nodes by the time they are forgotten, see OBSTACLE_TTL_S
+     TimingWheel<MAX_MAP_NODES> obstacleExpiry;
+     
+     // Wall clock, from GPS time plus millis() since it was last set
+     bool clockSet;
+     uint32_t clockSeconds;
+     unsigned long clockMillis;
+     
+     // Route search over the adjacency, repaired in place when obstacles
+     // close or reopen an edge
+     RouteReplanner<MAX_MAP_NODES> planner;
+     
+     // Edges within ROUTE_BLOCK_RADIUS_M of an obstacle, one bit each: the
+     // only costs the route search sees changed. Marked when a route is
+     // planned and kept up to date while it is held.
+     uint32_t penalisedEdges[(MAX_MAP_EDGES + 31) / 32];
+     
+     // Route heuristic tables, patched as edges are added and chosen
+     // again when a map is loaded or a place is named
+     LandmarkHeuristic<MAX_MAP_NODES, ROUTE_LANDMARKS> routeLandmarks;
+     bool routeLandmarksStale;
+     bool hasRoute;
+     int pathCursor;             // Next route node to walk to
      
      // Current location and movement tracking
      float prevLat;
@@ -50,20 +150,79 @@
      float currentLat;
      float currentLng;
      bool isFirstPosition;
-     String currentNodeId;
+     MapHandle currentNode;      // MAP_NO_HANDLE until the first node is recorded
      
-     // SD card file handling
-     File mapFile;
+     // SD card file handling: snapshot plus journal of changes
+     MapJournal<decltype(SD)> journal;
      bool sdAvailable;
+     MapHandle unloggedVisit;    // Node visited again since its last journal record
+     MapHandle unloggedObstacle; // Obstacle seen again since its last journal record
+     
+     // Read-only base map, used where the learned map has no nodes
+ #ifdef SMARTGUIDE_BASE_MAP
+     File tileFile;
+     TileStore<File, MAP_TILE_SLOTS, MAP_TILE_NODES, MAP_TILE_EDGES> tiles;
+     TileRouter<MAP_TILE_SEARCH> tileRouter;
+ #endif
+     bool tileRoute;             // Current route is over the base map
+     
+     // Neither the straight line nor the landmark bound overestimates the
+     // walked distance, so the larger of the two is the better estimate
+     struct StraightLine {
+       MapSystem* map;
+       
+       float operator()(MapHandle a, MapHandle b) {
+         return fmaxf(LocalFrame::distance(map->nodeLocal[a], map->nodeLocal[b]), map->routeLandmarks.estimate(a, b));
+       }
+     };
+     
+     // The map edges as the landmark tables walk them
+     struct RouteGraph {
+       MapSystem* map;
+       
+       int32_t first(MapHandle node) { return map->adjacency.first(node); }
+       int32_t next(int32_t half) { return map->adjacency.next(half); }
+       MapHandle neighbourOf(int32_t half) { return map->adjacency.neighbourOf(half); }
+       float weight(int32_t half) { return map->store.getWeight(map->adjacency.edgeOf(half)); }
+       bool isPreferred(MapHandle node) { return map->store.hasFlag(node, NODE_FLAG_NAMED); }
+     };
+     
+     // The same edges at the cost the route search pays
+     struct RouteCostGraph {
+       MapSystem* map;
+       
+       int32_t first(MapHandle node) { return map->adjacency.first(node); }
+       int32_t next(int32_t half) { return map->adjacency.next(half); }
+       MapHandle neighbourOf(int32_t half) { return map->adjacency.neighbourOf(half); }
+       float weight(int32_t half) {
+         MapHandle edge = map->adjacency.edgeOf(half);
+         return map->store.getWeight(edge) + (map->isPenalised(edge) ? ROUTE_OBSTACLE_PENALTY_M : 0);
+       }
+     };
      
      // Helper methods
-     String generateNodeId();
-     String generateEdgeId();
-     int findNodeIndex(String nodeId);
-     int findNearestNodeIndex(float lat, float lng, float maxDistance);
-     float calculateDistance(float lat1, float lon1, float lat2, float lon2);
-     void saveMapToSD();
-     bool loadMapFromSD();
+     MapHandle appendNode(float lat, float lng, NodeType type);
+     MapHandle appendEdge(MapHandle source, MapHandle target);
+     MapHandle findNearestNode(float lat, float lng, float maxDistance);
+     MapHandle findNearestEdge(float lat, float lng, float maxDistance);
+     void simplifyStep();
+     uint32_t now();
+     void scheduleExpiry(MapHandle node);
+     void scheduleAllObstacles();
+     void expireObstacles();
+     void forgetObstacle(MapHandle node);
+ #ifdef SMARTGUIDE_BASE_MAP
+     bool findNearestTileNode(float lat, float lng, float maxDistance, TileRef& node);
+ #endif
+     LocalPoint localOf(float lat, float lng);
+     void recentreFrame(float lat, float lng);
+     bool isEdgeBlocked(MapHandle edge);
+     bool isPenalised(MapHandle edge) const { return penalisedEdges[edge >> 5] & (1u << (edge & 31)); }
+     bool setPenalised(MapHandle edge, bool penalised);
+     void penaliseObstacleEdges();
+     void updateRouteCosts(float lat, float lng);
+     void resetIndexes();
+     void rebuildIndexes();
      
    public:
      MapSystem();
@@ -72,24 +231,31 @@
      bool begin();
      
      // Map management
+     void setTime(uint32_t unixSeconds);
      void updateCurrentPosition(float lat, float lng);
-     void addObstacle(float lat, float lng, String type);
-     void addLandmark(float lat, float lng, String type, String name);
+     void updateMotion(float heading, float speed);
+     void addObstacle(float lat, float lng, ObstacleType type);
+     void addLandmark(float lat, float lng, NodeType type, const char* name);
      
      // Path finding
      bool findPath(float startLat, float startLng, float endLat, float endLng);
      bool getNextPathNode(float &lat, float &lng);
      
      // Map information
-     int getNodeCount() { return nodeCount; }
-     int getEdgeCount() { return edgeCount; }
+     int getNodeCount() { return store.getLiveNodeCount(); }
+     int getEdgeCount() { return store.getLiveEdgeCount(); }
      bool isObstacleNearby(float lat, float lng, float radius);
-     String getAreaType(float lat, float lng, float radius);
+     NodeType getAreaType(float lat, float lng, float radius);
+     const char* getLandmarkName(MapHandle node) { return names.nameOf(node); }
      
      // Map persistence
      bool saveMap();
      bool loadMap();
      void clearMap();
+     
+     // JSON import/export, for old map files and for inspecting a map
+     bool importJson(const char* path);
+     bool exportJson(const char* path);
  };
  
  #endif
\ No newline at end of file
@@ -0,0 +1,128 @@
+/*
+ * NameTable.h
+ *
+ * Names for the few map nodes that have one (landmarks). Names are
+ * interned into a single character pool, so repeated names are stored
+ * once, and looked up through a short node-to-name list instead of a
+ * String in every node. No Arduino dependencies.
+ */
+
+ #ifndef NAME_TABLE_H
+ #define NAME_TABLE_H
+ 
+ #include <stdint.h>
+ #include <string.h>
+ 
+ #define NAME_NONE 0xFFFF
+ 
+ template <int POOL_BYTES, int MAX_NAMED>
+ class NameTable {
+   static_assert(POOL_BYTES < NAME_NONE, "Pool offsets are 16-bit");
+   
+   private:
+     char pool[POOL_BYTES];        // NUL-terminated names back to back
+     uint16_t poolUsed;
+     
+     int32_t namedNode[MAX_NAMED];
+     uint16_t nameOffset[MAX_NAMED];
+     int namedCount;
+     
+     int findEntry(int32_t node) const {
+       for (int i = 0; i < namedCount; i++) {
+         if (namedNode[i] == node) {
+           return i;
+         }
+       }
+       return -1;
+     }
+     
+   public:
+     NameTable() {
+       clear();
+     }
+     
+     void clear() {
+       poolUsed = 0;
+       namedCount = 0;
+     }
+     
+     // Offset of the name in the pool, adding it if new. NAME_NONE if full.
+     uint16_t intern(const char* name) {
+       for (uint16_t offset = 0; offset < poolUsed; offset += strlen(pool + offset) + 1) {
+         if (strcmp(pool + offset, name) == 0) {
+           return offset;
+         }
+       }
+       
+       size_t length = strlen(name) + 1;
+       if (poolUsed + length > POOL_BYTES) {
+         return NAME_NONE;
+       }
+       memcpy(pool + poolUsed, name, length);
+       poolUsed += length;
+       return poolUsed - length;
+     }
+     
+     // Name a node, replacing any earlier name. False if a table is full.
+     bool setName(int32_t node, const char* name) {
+       uint16_t offset = intern(name);
+       if (offset == NAME_NONE) {
+         return false;
+       }
+       
+       int entry = findEntry(node);
+       if (entry < 0) {
+         if (namedCount >= MAX_NAMED) {
+           return false;
+         }
+         entry = namedCount++;
+         namedNode[entry] = node;
+       }
+       nameOffset[entry] = offset;
+       return true;
+     }
+     
+     // Name of a node, or null if it has none
+     const char* nameOf(int32_t node) const {
+       int entry = findEntry(node);
+       return entry < 0 ? 0 : pool + nameOffset[entry];
+     }
+     
+     // First node with the given name, or -1
+     int32_t findNode(const char* name) const {
+       for (int i = 0; i < namedCount; i++) {
+         if (strcmp(pool + nameOffset[i], name) == 0) {
+           return namedNode[i];
+         }
+       }
+       return -1;
+     }
+     
+     int getNamedCount() const { return namedCount; }
+     int32_t getNamedNode(int entry) const { return namedNode[entry]; }
+     const char* getEntryName(int entry) const { return pool + nameOffset[entry]; }
+     uint16_t getEntryOffset(int entry) const { return nameOffset[entry]; }
+     const char* getPool() const { return pool; }
+     int getPoolUsed() const { return poolUsed; }
+     
+     // Rebuild a saved table: raw pool bytes first, then the entries
+     bool appendPool(const char* data, int length) {
+       if (poolUsed + length > POOL_BYTES) {
+         return false;
+       }
+       memcpy(pool + poolUsed, data, length);
+       poolUsed += length;
+       return true;
+     }
+     
+     bool restoreEntry(int32_t node, uint16_t offset) {
+       if (offset >= poolUsed || namedCount >= MAX_NAMED || pool[poolUsed - 1] != '\0') {
+         return false;
+       }
+       namedNode[namedCount] = node;
+       nameOffset[namedCount++] = offset;
+       return true;
+     }
+ };
+ 
+ #endif
\ No newline at end of file
@@ -18,8 +18,18 @@
    currentLat = 0.0;
    currentLng = 0.0;
    currentHeading = 0.0;
+   currentSpeed = 0.0;
    hasValidFix = false;
    
+   // Initialize GPS input
+   gpsSerial = NULL;
+   gpsParseTask = NULL;
+   gpsInBackground = false;
+   hasFix = false;
+   fixLatencyUs = 0;
+   maxFixLatencyUs = 0;
+   lateFixes = 0;
+   
    // Initialize navigation variables
    destLat = 0.0;
    destLng = 0.0;
@@ -38,45 +48,109 @@
  }
  
  void NavigationSystem::begin() {
-   // Initialize GPS (assuming Serial1 for GPS module)
-   gpsSerial = &Serial1;
-   Serial1.begin(9600);
+   // Initialize GPS (Serial1 unless setGpsSerial() chose another stream).
+   // Bytes are taken from the UART receive event, so a busy loop() cannot
+   // overflow the driver.
+   if (!gpsSerial) {
+     gpsSerial = &Serial1;
+     Serial1.setRxBufferSize(GPS_UART_BUFFER);
+     Serial1.begin(GPS_BAUD);
+     Serial1.setRxFIFOFull(GPS_UART_FIFO_FULL);
+     if (xTaskCreate(gpsParseLoop, "gps", GPS_TASK_STACK, this, GPS_TASK_PRIORITY, &gpsParseTask) == pdPASS) {
+       Serial1.onReceive([this]() { captureGps(); });
+       gpsInBackground = true;
+     }
+   }
    
    Serial.println("GPS Navigation System initialized");
  }
  
+ // UART receive event: copy the bytes out and wake the parse task
+ void NavigationSystem::captureGps() {
+   uint8_t chunk[GPS_CHUNK_BYTES];
+   size_t count;
+   while ((count = Serial1.read(chunk, sizeof(chunk))) > 0) {
+     gpsReceiver.capture(chunk, count, micros());
+   }
+   xTaskNotifyGive(gpsParseTask);
+ }
+ 
+ // Parse stage, woken by each receive event
+ void NavigationSystem::gpsParseLoop(void* self) {
+   NavigationSystem* nav = (NavigationSystem*)self;
+   while (true) {
+     ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+     nav->gpsReceiver.parse(micros());
+   }
+ }
+ 
  bool NavigationSystem::updateGpsLocation() {
-   // Read data from GPS
-   while (gpsSerial->available() > 0) {
-     gps.encode(gpsSerial->read());
+   // Without the parse task, drain and parse here
+   if (!gpsInBackground && gpsSerial) {
+     uint8_t chunk[GPS_CHUNK_BYTES];
+     size_t count;
+     do {
+       count = 0;
+       while (count < sizeof(chunk) && gpsSerial->available() > 0) {
+         chunk[count++] = gpsSerial->read();
+       }
+       gpsReceiver.capture(chunk, count, micros());
+     } while (count == sizeof(chunk));
+     gpsReceiver.parse(micros());
    }
    
-   // Check if we have new position data
-   if (gps.location.isUpdated()) {
-     currentLat = gps.location.lat();
-     currentLng = gps.location.lng();
-     
-     // Get heading if moving (speed > 1 km/h)
-     if (gps.speed.kmph() > 1.0) {
-       currentHeading = gps.course.deg();
+   GpsFix fix;
+   if (!gpsReceiver.readFix(fix)) {
+     // If no data for 5 seconds, consider fix lost
+     if (millis() > GPS_SILENT_MS && gpsReceiver.getCapturedBytes() < 10) {
+       hasValidFix = false;
      }
-     
-     hasValidFix = true;
-     
-     // If actively navigating, update navigation status
-     if (isActivelyNavigating) {
-       updateNavigationStatus();
-     }
-     
-     return true;
+     return false;
+   }
+   
+   fixLatencyUs = micros() - fix.lineEndUs;
+   if (fixLatencyUs > maxFixLatencyUs) {
+     maxFixLatencyUs = fixLatencyUs;
+   }
+   if (fixLatencyUs > GPS_FIX_LATENCY_BUDGET_US) {
+     lateFixes++;
    }
+   lastFix = fix;
+   hasFix = true;
    
-   // If no data for 5 seconds, consider fix lost
-   if (millis() > 5000 && gps.charsProcessed() < 10) {
+   // The receiver reports when it loses the fix
+   if (!fix.valid) {
      hasValidFix = false;
+     return false;
    }
    
-   return false;
+   currentLat = fix.lat;
+   currentLng = fix.lng;
+   currentSpeed = fix.speedMps;
+   
+   // Get heading if moving (speed > 1 km/h)
+   if (fix.speedMps * 3.6 > 1.0) {
+     currentHeading = fix.courseDeg;
+   }
+   
+   hasValidFix = true;
+   
+   // If actively navigating, update navigation status
+   if (isActivelyNavigating) {
+     updateNavigationStatus();
+   }
+   
+   return true;
+ }
+ 
+ // Current UTC time from the GPS, in Unix seconds. False until the receiver
+ // has a date (see NMEA_YEAR_MIN).
+ bool NavigationSystem::getUnixTime(uint32_t& seconds) {
+   if (!hasFix || lastFix.unixTime == 0) {
+     return false;
+   }
+   seconds = lastFix.unixTime + (micros() - lastFix.lineEndUs) / 1000000UL;  // Time since the sentence arrived
+   return true;
  }
  
  bool NavigationSystem::setWaypoint(String name, String type) {
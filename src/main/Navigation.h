@@ -8,7 +8,16 @@
  #define NAVIGATION_H
  
  #include <Arduino.h>
- #include <TinyGPS++.h>
+ #include "GpsReceiver.h"
+ 
+ #define GPS_BAUD 9600
+ #define GPS_UART_BUFFER 1024          // Driver buffer between receive events
+ #define GPS_UART_FIFO_FULL 16         // Receive event every 16 bytes at most
+ #define GPS_CHUNK_BYTES 64
+ #define GPS_TASK_STACK 3072
+ #define GPS_TASK_PRIORITY 2           // Above loop() so fixes never wait on it
+ #define GPS_FIX_LATENCY_BUDGET_US 100000  // Sentence end to getCurrentLat()
+ #define GPS_SILENT_MS 5000            // No bytes this long after boot: no receiver
  
  // Waypoint structure
  struct Waypoint {
@@ -21,13 +30,23 @@
  
  class NavigationSystem {
    private:
-     // GPS instance
-     TinyGPSPlus gps;
+     // GPS capture, parse stage and latest fix
+     GpsReceiver gpsReceiver;
+     TaskHandle_t gpsParseTask;
+     bool gpsInBackground;       // Serial1 receive events feed the parse task
+     GpsFix lastFix;
+     bool hasFix;
+     
+     // Time from a sentence's last byte to its fix reaching the loop
+     uint32_t fixLatencyUs;
+     uint32_t maxFixLatencyUs;
+     uint32_t lateFixes;
      
      // Current location data
      float currentLat;
      float currentLng;
      float currentHeading;
+     float currentSpeed;         // Meters per second
      bool hasValidFix;
      
      // Destination data
@@ -56,16 +75,32 @@
      float calculateBearing(float lat1, float lon1, float lat2, float lon2);
      String bearingToDirection(float bearing);
      void updateNavigationStatus();
+     void captureGps();
+     static void gpsParseLoop(void* self);
      
    public:
      NavigationSystem();
      
      // Initialization
      void begin();
-     void setGpsSerial(Stream* serial) { gpsSerial = serial; }
+     // Another stream, drained and parsed from updateGpsLocation(). Set it
+     // before begin(): once the receive event and parse task own the GPS
+     // rings, the loop must not feed them too, so the call is refused.
+     bool setGpsSerial(Stream* serial) {
+       if (gpsInBackground) {
+         return false;
+       }
+       gpsSerial = serial;
+       return true;
+     }
      
-     // GPS update
+     // GPS update, cheap enough to call on every loop
      bool updateGpsLocation();
+     bool getUnixTime(uint32_t& seconds);
+     uint32_t getFixLatencyUs() { return fixLatencyUs; }
+     uint32_t getMaxFixLatencyUs() { return maxFixLatencyUs; }
+     uint32_t getLateFixes() { return lateFixes; }
+     uint16_t getDroppedGpsBytes() { return gpsReceiver.getDroppedBytes(); }
      
      // Waypoint management
      bool setWaypoint(String name, String type);
@@ -84,6 +119,8 @@
      // Status getters
      float getCurrentLat() { return currentLat; }
      float getCurrentLng() { return currentLng; }
+     float getCurrentHeading() { return currentHeading; }
+     float getCurrentSpeed() { return currentSpeed; }
      float getDestLat() { return destLat; }
      float getDestLng() { return destLng; }
      String getDestName() { return destName; }
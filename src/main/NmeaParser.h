@@ -0,0 +1,174 @@
+/*
+ * NmeaParser.h
+ *
+ * Incremental NMEA 0183 parser for the GPS receiver. Bytes are fed one
+ * at a time; each checksummed RMC sentence (position, speed, course and
+ * UTC date) updates the fix. Other sentences are skipped.
+ * No Arduino dependencies so it can be tested on the host.
+ */
+
+ #ifndef NMEA_PARSER_H
+ #define NMEA_PARSER_H
+ 
+ #include <stdint.h>
+ #include <stdlib.h>
+ #include <string.h>
+ 
+ #define NMEA_MAX_SENTENCE 82   // Longest sentence the standard allows
+ #define NMEA_MAX_FIELDS 20
+ #define NMEA_KNOTS_TO_MPS 0.514444
+ #define NMEA_YEAR_MIN 2020     // Before its almanac arrives the receiver
+ #define NMEA_YEAR_MAX 2099     // reports years like 2000
+ 
+ struct GpsFix {
+   double lat;
+   double lng;
+   float speedMps;
+   float courseDeg;
+   uint32_t unixTime;   // UTC seconds, 0 until the receiver has a date
+   uint32_t lineEndUs;  // When the sentence's last byte arrived
+   bool valid;          // False while the receiver has no position
+ };
+ 
+ // Days from 1970-01-01 to a date in the Gregorian calendar
+ inline int32_t daysFromCivil(int year, int month, int day) {
+   year -= month <= 2;
+   int era = year / 400;
+   int yearOfEra = year - era * 400;
+   int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+   int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+   return era * 146097 + dayOfEra - 719468;
+ }
+ 
+ class NmeaParser {
+   private:
+     char line[NMEA_MAX_SENTENCE + 1];
+     uint8_t length;
+     bool inSentence;
+     bool overlong;
+     
+     GpsFix fix;
+     uint32_t sentences;
+     uint32_t checksumErrors;
+     
+     static int hexValue(char c) {
+       if (c >= '0' && c <= '9') return c - '0';
+       if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+       if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+       return -1;
+     }
+     
+     static int twoDigits(const char* text) {
+       return (text[0] - '0') * 10 + (text[1] - '0');
+     }
+     
+     // ddmm.mmmm (or dddmm.mmmm) and a hemisphere letter to degrees
+     static double toDegrees(const char* value, const char* hemisphere) {
+       double raw = atof(value);
+       int degrees = (int)(raw / 100);
+       double result = degrees + (raw - degrees * 100) / 60.0;
+       return (hemisphere[0] == 'S' || hemisphere[0] == 'W') ? -result : result;
+     }
+     
+     // Checks the "*hh" checksum and cuts it off
+     bool verify() {
+       char* star = strchr(line, '*');
+       if (!star || star + 3 != line + length) {
+         return false;
+       }
+       int high = hexValue(star[1]);
+       int low = hexValue(star[2]);
+       uint8_t sum = 0;
+       for (char* c = line; c < star; c++) {
+         sum ^= (uint8_t)*c;
+       }
+       *star = '\0';
+       return high >= 0 && low >= 0 && sum == (uint8_t)(high * 16 + low);
+     }
+     
+     bool finish() {
+       line[length] = '\0';
+       if (!verify()) {
+         checksumErrors++;
+         return false;
+       }
+       sentences++;
+       
+       // Split in place; empty fields stay as empty strings
+       char* fields[NMEA_MAX_FIELDS];
+       int count = 0;
+       char* at = line;
+       fields[count++] = at;
+       while ((at = strchr(at, ',')) != NULL && count < NMEA_MAX_FIELDS) {
+         *at++ = '\0';
+         fields[count++] = at;
+       }
+       
+       // Any talker: GPRMC, GNRMC, GLRMC...
+       if (strlen(fields[0]) != 5 || strcmp(fields[0] + 2, "RMC") != 0 || count < 10) {
+         return false;
+       }
+       const char* time = fields[1];
+       const char* status = fields[2];
+       const char* date = fields[9];
+       
+       fix.valid = status[0] == 'A' && fields[3][0] && fields[5][0];
+       if (fix.valid) {
+         fix.lat = toDegrees(fields[3], fields[4]);
+         fix.lng = toDegrees(fields[5], fields[6]);
+         fix.speedMps = atof(fields[7]) * NMEA_KNOTS_TO_MPS;
+         if (fields[8][0]) {
+           fix.courseDeg = atof(fields[8]);
+         }
+       }
+       
+       fix.unixTime = 0;
+       if (strlen(time) >= 6 && strlen(date) == 6) {
+         int year = 2000 + twoDigits(date + 4);
+         if (year >= NMEA_YEAR_MIN && year <= NMEA_YEAR_MAX) {
+           int32_t days = daysFromCivil(year, twoDigits(date + 2), twoDigits(date));
+           fix.unixTime = (uint32_t)days * 86400UL + twoDigits(time) * 3600UL + twoDigits(time + 2) * 60UL +
+                          twoDigits(time + 4);
+         }
+       }
+       return true;
+     }
+     
+   public:
+     NmeaParser() : length(0), inSentence(false), overlong(false), sentences(0), checksumErrors(0) {
+       memset(&fix, 0, sizeof(fix));
+     }
+     
+     // Feed one byte. True when it completed an RMC sentence, valid or not.
+     bool encode(char c) {
+       if (c == '$') {
+         inSentence = true;
+         length = 0;
+         overlong = false;
+         return false;
+       }
+       if (!inSentence || c == '\r') {
+         return false;
+       }
+       if (c == '\n') {
+         inSentence = false;
+         if (overlong) {
+           checksumErrors++;
+           return false;
+         }
+         return finish();
+       }
+       if (length >= NMEA_MAX_SENTENCE) {
+         overlong = true;
+         return false;
+       }
+       line[length++] = c;
+       return false;
+     }
+     
+     const GpsFix& getFix() const { return fix; }
+     uint32_t getSentences() const { return sentences; }
+     uint32_t getChecksumErrors() const { return checksumErrors; }
+ };
+ 
+ #endif
\ No newline at end of file
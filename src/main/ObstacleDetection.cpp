@@ -7,116 +7,168 @@
  #include "ObstacleDetection.h"
  #include <Arduino.h>
  
+ // Fills a pin table from the compile-time sensor layout
+ struct SensorPinLoader {
+   SensorPins* pins;
+   
+   template <typename Config>
+   void operator()(int index, Config) {
+     pins[index].trigPin = Config::trigPin;
+     pins[index].echoPin = Config::echoPin;
+   }
+ };
+ 
  ObstacleDetection::ObstacleDetection() {
-   lastLowerDistance = 400.0; // Initialize with max range
-   lastUpperDistance = 400.0;
+   sensorCount = 0;
+   currentHeading = 0;
+   sweepYaw = 0;
+   
+   for (int i = 0; i < CaneSensors::COUNT; i++) {
+     latestSamples[i].timestampUs = 0;
+     latestSamples[i].distanceCm = RANGER_MAX_DISTANCE_CM; // Initialize with max range
+     latestSamples[i].timedOut = true;
+     rawSamples[i] = latestSamples[i];
+   }
+ }
+ 
+ void ObstacleDetection::begin() {
+   SensorPins pins[CaneSensors::COUNT];
+   SensorPinLoader loader = {pins};
+   CaneSensors::forEach(loader);
+   begin(pins, CaneSensors::COUNT);
  }
  
  void ObstacleDetection::begin(int trigLow, int echoLow, int trigUp, int echoUp) {
-   trigPinLower = trigLow;
-   echoPinLower = echoLow;
-   trigPinUpper = trigUp;
-   echoPinUpper = echoUp;
-   
-   // Set pin modes
-   pinMode(trigPinLower, OUTPUT);
-   pinMode(echoPinLower, INPUT);
-   pinMode(trigPinUpper, OUTPUT);
-   pinMode(echoPinUpper, INPUT);
+   SensorPins pins[2] = {
+     {trigLow, echoLow},
+     {trigUp, echoUp}
+   };
+   begin(pins, 2);
  }
  
- float ObstacleDetection::calculateDistance(int trigPin, int echoPin) {
-   // Clear the trigger pin
-   digitalWrite(trigPin, LOW);
-   delayMicroseconds(2);
+ bool ObstacleDetection::begin(const SensorPins* pins, int count) {
+   if (count <= 0 || count > CaneSensors::COUNT) {
+     return false;
+   }
+   sensorCount = count;
    
-   // Set the trigger pin HIGH for 10 microseconds
-   digitalWrite(trigPin, HIGH);
-   delayMicroseconds(10);
-   digitalWrite(trigPin, LOW);
+   for (int i = 0; i < sensorCount; i++) {
+     channels[i].trigPin = pins[i].trigPin;
+     channels[i].echoPin = pins[i].echoPin;
+     
+     // Set pin modes
+     pinMode(channels[i].trigPin, OUTPUT);
+     pinMode(channels[i].echoPin, INPUT);
+     digitalWrite(channels[i].trigPin, LOW);
+     
+     // Timestamp echo edges in the background
+     attachInterruptArg(digitalPinToInterrupt(channels[i].echoPin), echoInterrupt, &channels[i], CHANGE);
+   }
    
-   // Read the echo pin, convert to distance in cm
-   long duration = pulseIn(echoPin, HIGH, 23200); // Timeout for ~4m range
+   return setScanTiming(SCAN_DEFAULT_RANGE_CM, SCAN_DEFAULT_QUIET_US);
+ }
+ 
+ bool ObstacleDetection::setScanTiming(float maxRangeCm, unsigned long quietUs) {
+   if (!scheduler.configure(sensorCount, maxRangeCm, quietUs)) {
+     return false;
+   }
    
-   // If timeout occurred, return max range
-   if (duration == 0) {
-     return 400.0;
+   // Echoes beyond the scan range are reported as max range
+   for (int i = 0; i < sensorCount; i++) {
+     channels[i].ranger.setEchoTimeout(scheduler.getListenUs());
    }
+   return true;
+ }
+ 
+ void IRAM_ATTR ObstacleDetection::echoInterrupt(void* arg) {
+   SensorChannel* channel = (SensorChannel*)arg;
+   channel->ranger.onEchoEdge(digitalRead(channel->echoPin) == HIGH, micros());
+ }
+ 
+ void ObstacleDetection::update() {
+   unsigned long now = micros();
+   bool busy = false;
    
-   float distance = duration * 0.034 / 2;
+   for (int i = 0; i < sensorCount; i++) {
+     channels[i].ranger.poll(now);
+     busy = busy || channels[i].ranger.isBusy();
+     readLatest(i);
+   }
+   
+   // Only one sensor listens at a time so echoes can't cross over
+   int sensor = scheduler.nextDue(now, busy);
+   if (sensor < 0) {
+     return;
+   }
    
-   // Limit to reasonable range
-   if (distance > 400.0) {
-     distance = 400.0;
+   if (channels[sensor].ranger.startPing(now)) {
+     firePing(channels[sensor]);
    }
    
-   return distance;
+   // Advance the plan even if the sensor was still holding its echo line
+   scheduler.markFired(sensor, now);
+ }
+ 
+ void ObstacleDetection::firePing(SensorChannel& channel) {
+   // 10 microsecond trigger pulse, the echo is timed by the interrupt
+   digitalWrite(channel.trigPin, HIGH);
+   delayMicroseconds(10);
+   digitalWrite(channel.trigPin, LOW);
+ }
+ 
+ void ObstacleDetection::readLatest(int sensor) {
+   RangeSample sample;
+   while (channels[sensor].ranger.readSample(sample)) {
+     rawSamples[sensor] = sample;
+     
+     // Spikes and spurious timeouts are smoothed out before anyone sees them
+     FilterSample filtered = {toFixed(sample.distanceCm), sample.timestampUs, true, false};
+     filters[sensor].process(filtered);
+     sample.distanceCm = fromFixed(filtered.distance);
+     
+     latestSamples[sensor] = sample;
+     freeSpace.addReading(sample.timestampUs, currentHeading + sweepYaw, CaneSensors::yawsDeg[sensor],
+                          sample.distanceCm);
+   }
  }
  
  float ObstacleDetection::getLowerDistance() {
-   lastLowerDistance = calculateDistance(trigPinLower, echoPinLower);
-   return lastLowerDistance;
+   return getDistance(SENSOR_LOWER);
  }
  
  float ObstacleDetection::getUpperDistance() {
-   lastUpperDistance = calculateDistance(trigPinUpper, echoPinUpper);
-   return lastUpperDistance;
+   return getDistance(SENSOR_UPPER);
  }
  
- int ObstacleDetection::suggestDirection(float distLower, float distUpper) {
-   // If both sensors detect nearby obstacles
-   if (distLower < warningThreshold && distUpper < warningThreshold) {
-     // Use historical data to determine best direction
-     // This is a simplified algorithm - in a real implementation, 
-     // this would use more sophisticated path planning
-     
-     // For now, just suggest the direction with more space
-     
-     // Take 3 readings on the left
-     digitalWrite(trigPinLower, LOW);
-     delay(50);
-     float leftSum = 0;
-     for (int i = 0; i < 3; i++) {
-       // Turn slightly left (this would be handled by user in reality)
-       // In a real implementation, this would use servo motors or instruct the user
-       leftSum += calculateDistance(trigPinLower, echoPinLower);
-       delay(10);
-     }
-     float leftAvg = leftSum / 3;
-     
-     // Take 3 readings on the right
-     digitalWrite(trigPinLower, LOW);
-     delay(50);
-     float rightSum = 0;
-     for (int i = 0; i < 3; i++) {
-       // Turn slightly right (this would be handled by user in reality)
-       rightSum += calculateDistance(trigPinLower, echoPinLower);
-       delay(10);
-     }
-     float rightAvg = rightSum / 3;
-     
-     // Compare and suggest direction
-     if (leftAvg > rightAvg * 1.25) {
-       return -1; // Suggest left
-     } else if (rightAvg > leftAvg * 1.25) {
-       return 1;  // Suggest right
-     } else {
-       return 0;  // Suggest stop/wait
-     }
+ float ObstacleDetection::getDistance(int sensor) {
+   return getLatestSample(sensor).distanceCm;
+ }
+ 
+ RangeSample ObstacleDetection::getLatestSample(int sensor) {
+   if (sensor < 0 || sensor >= sensorCount) {
+     RangeSample none = {0, RANGER_MAX_DISTANCE_CM, true};
+     return none;
    }
-   
-   // If just lower sensor detects an obstacle
-   else if (distLower < warningThreshold) {
-     // Simple left/right detection based on previous readings
-     // In a real implementation, this would be more sophisticated
-     return random(-1, 2); // Simplified random suggestion for prototype
+   readLatest(sensor);
+   return latestSamples[sensor];
+ }
+ 
+ RangeSample ObstacleDetection::getRawSample(int sensor) {
+   if (sensor < 0 || sensor >= sensorCount) {
+     RangeSample none = {0, RANGER_MAX_DISTANCE_CM, true};
+     return none;
    }
-   
-   // If just upper sensor detects an obstacle
-   else if (distUpper < warningThreshold) {
-     // For head-height obstacles, suggest ducking or moving around
-     return random(-1, 2); // Simplified random suggestion for prototype
+   readLatest(sensor);
+   return rawSamples[sensor];
+ }
+ 
+ int ObstacleDetection::suggestDirection(float distLower, float distUpper) {
+   // No immediate obstacle, keep going
+   if (distLower >= getWarningThreshold(SENSOR_LOWER) && distUpper >= getWarningThreshold(SENSOR_UPPER)) {
+     return 0;
    }
    
-   return 0; // No immediate obstacle, keep going
+   // Suggest the side with more space, judged from readings the sensors took
+   // at other headings while the user walked and swept the cane
+   return freeSpace.recommend(micros(), currentHeading);
  }
\ No newline at end of file
@@ -1,45 +1,118 @@
 /*
  * ObstacleDetection.h
- * 
+ *
  * Handles ultrasonic sensor operations for detecting obstacles
  */
 
  #ifndef OBSTACLE_DETECTION_H
  #define OBSTACLE_DETECTION_H
  
+ #include "UltrasonicRanger.h"
+ #include "ScanScheduler.h"
+ #include "SensorConfig.h"
+ #include "FreeSpaceEstimator.h"
+ #include "DistanceFilter.h"
+ 
+ static_assert(CaneSensors::COUNT <= SCAN_MAX_SENSORS, "Too many sensors for the scan scheduler");
+ static_assert(SCAN_ECHO_RANGE_CM >= RANGER_MAX_DISTANCE_CM, "Scan slots must outlast the farthest echo");
+ static_assert((SCAN_BURST_US + SCAN_ECHO_RANGE_CM * 2 / 0.034) * FREESPACE_MAX_READING_RATE >= 1000000,
+               "Free-space history is too short for the scan rate");
+ 
+ // Pin assignment for one HC-SR04
+ struct SensorPins {
+   int trigPin;
+   int echoPin;
+ };
+ 
  class ObstacleDetection {
    private:
-     int trigPinLower;
-     int echoPinLower;
-     int trigPinUpper;
-     int echoPinUpper;
+     // One ultrasonic sensor and its ranging state machine
+     struct SensorChannel {
+       int trigPin;
+       int echoPin;
+       UltrasonicRanger ranger;
+     };
+     
+     SensorChannel channels[CaneSensors::COUNT];
+     int sensorCount;
+     
+     // Staggered ping time plan
+     ScanScheduler scheduler;
+     
+     // Latest completed measurement per sensor, filtered and raw
+     RangeSample latestSamples[CaneSensors::COUNT];
+     RangeSample rawSamples[CaneSensors::COUNT];
+     
+     // Median, rate gate and Kalman filter per sensor
+     DistanceFilter filters[CaneSensors::COUNT];
+     
+     // History of readings for direction suggestions
+     FreeSpaceEstimator freeSpace;
+     float currentHeading;
+     float sweepYaw;
+     
+     // Fire the trigger pulse for a channel
+     void firePing(SensorChannel& channel);
      
-     // Distance thresholds (in cm)
-     const int warningThreshold = 150;
-     const int dangerThreshold = 50;
+     // Drain completed measurements for a sensor into the latest sample and history
+     void readLatest(int sensor);
      
-     // Last measured distances
-     float lastLowerDistance;
-     float lastUpperDistance;
+     // Echo pin-change interrupt handler
+     static void echoInterrupt(void* arg);
      
-     // Calculate distance from sensor readings
-     float calculateDistance(int trigPin, int echoPin);
+     // Keep a sensor index inside the compile-time layout tables
+     static int clampSensor(int sensor) {
+       return sensor < 0 ? 0 : (sensor >= CaneSensors::COUNT ? CaneSensors::COUNT - 1 : sensor);
+     }
      
    public:
      ObstacleDetection();
      
+     // Initialize with the compile-time sensor layout
+     void begin();
+     
      // Initialize with pin assignments
      void begin(int trigPinLower, int echoPinLower, int trigPinUpper, int echoPinUpper);
+     bool begin(const SensorPins* pins, int count);
+     
+     // Shorter range gives shorter slots and a higher per-sensor rate
+     bool setScanTiming(float maxRangeCm, unsigned long quietUs);
+     
+     // Custom time plan (sensor index per slot)
+     bool setScanPlan(const uint8_t* order, uint8_t count) { return scheduler.setPlan(order, count); }
      
-     // Get distance measurements
+     // Drive the ranging engine, call on every loop iteration
+     void update();
+     
+     // Get latest distance measurements (non-blocking)
      float getLowerDistance();
      float getUpperDistance();
+     float getDistance(int sensor);
+     
+     // Latest measurement including its timestamp
+     RangeSample getLatestSample(int sensor);
+     
+     // Latest unfiltered measurement, for diagnostics
+     RangeSample getRawSample(int sensor);
+     
+     int getSensorCount() { return sensorCount; }
+     float getScanRateHz(int sensor) { return scheduler.getSensorRateHz(sensor); }
+     
+     // Get thresholds (in cm); out-of-range sensors use the nearest one
+     int getWarningThreshold(int sensor = SENSOR_LOWER) { return CaneSensors::warningsCm[clampSensor(sensor)]; }
+     int getDangerThreshold(int sensor = SENSOR_LOWER) { return CaneSensors::dangersCm[clampSensor(sensor)]; }
+     
+     // Walking heading (degrees) used to place readings in the history
+     void setHeading(float headingDeg) { currentHeading = headingDeg; }
      
-     // Get thresholds
-     int getWarningThreshold() { return warningThreshold; }
-     int getDangerThreshold() { return dangerThreshold; }
+     // Cane sweep angle (degrees, left negative) relative to the walking
+     // heading, from an IMU if the build has one
+     void setSweepYaw(float yawDeg) { sweepYaw = yawDeg; }
      
-     // Suggest direction to move (-1 for left, 0 for stop, 1 for right)
+     // Suggest direction to move (-1 for left, 0 for stop, 1 for right), non-blocking.
+     // Side readings come from sensors mounted with a yaw (four- and six-sensor
+     // builds) or from setSweepYaw(). The stock two-sensor build has neither, as
+     // GPS course follows the walk and not the sweep, so there it always answers 0.
      int suggestDirection(float distLower, float distUpper);
  };
  
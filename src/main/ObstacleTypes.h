@@ -0,0 +1,93 @@
+/*
+ * ObstacleTypes.h
+ *
+ * Compact obstacle and map node types with constexpr label tables.
+ * Labels are only needed for speech and map files. Obstacles also carry
+ * how long the map remembers them after they were last seen.
+ * No Arduino dependencies.
+ */
+
+ #ifndef OBSTACLE_TYPES_H
+ #define OBSTACLE_TYPES_H
+ 
+ #include <stdint.h>
+ #include <string.h>
+ 
+ // Classifier output, in the order of the model's output tensor
+ enum class ObstacleType : uint8_t {
+   WALL,
+   PERSON,
+   CHAIR,
+   TABLE,
+   STAIRS,
+   DOOR,
+   POLE,
+   UNKNOWN,
+   COUNT
+ };
+ 
+ // What a map node stands for
+ enum class NodeType : uint8_t {
+   PATH,
+   DOOR,
+   ROOM,
+   STREET,
+   OBSTACLE,
+   OTHER,
+   COUNT
+ };
+ 
+ constexpr const char* OBSTACLE_TYPE_LABELS[] = {
+   "wall", "person", "chair", "table", "stairs",
+   "door", "pole", "unknown"
+ };
+ 
+ constexpr const char* NODE_TYPE_LABELS[] = {
+   "path", "door", "room", "street", "obstacle", "unknown"
+ };
+ 
+ // Seconds an obstacle stays on the map after it was last seen; people
+ // walk off, furniture gets moved, walls and stairs stay
+ #define OBSTACLE_TTL_PERMANENT 0
+ 
+ constexpr uint32_t OBSTACLE_TTL_S[] = {
+   OBSTACLE_TTL_PERMANENT, 120, 6 * 3600, 7 * 24 * 3600, OBSTACLE_TTL_PERMANENT,
+   3600, OBSTACLE_TTL_PERMANENT, 600
+ };
+ 
+ static_assert(sizeof(OBSTACLE_TYPE_LABELS) / sizeof(OBSTACLE_TYPE_LABELS[0]) == (int)ObstacleType::COUNT, "Missing obstacle label");
+ static_assert(sizeof(OBSTACLE_TTL_S) / sizeof(OBSTACLE_TTL_S[0]) == (int)ObstacleType::COUNT, "Missing obstacle lifetime");
+ static_assert(sizeof(NODE_TYPE_LABELS) / sizeof(NODE_TYPE_LABELS[0]) == (int)NodeType::COUNT, "Missing node label");
+ 
+ constexpr const char* obstacleTypeLabel(ObstacleType type) {
+   return type < ObstacleType::COUNT ? OBSTACLE_TYPE_LABELS[(int)type] : "unknown";
+ }
+ 
+ constexpr uint32_t obstacleTtl(ObstacleType type) {
+   return type < ObstacleType::COUNT ? OBSTACLE_TTL_S[(int)type] : OBSTACLE_TTL_S[(int)ObstacleType::UNKNOWN];
+ }
+ 
+ constexpr const char* nodeTypeLabel(NodeType type) {
+   return type < NodeType::COUNT ? NODE_TYPE_LABELS[(int)type] : "unknown";
+ }
+ 
+ // Parse a label from a map file, unrecognized labels map to UNKNOWN/OTHER
+ inline ObstacleType obstacleTypeFromLabel(const char* label) {
+   for (int i = 0; i < (int)ObstacleType::COUNT; i++) {
+     if (label && strcmp(label, OBSTACLE_TYPE_LABELS[i]) == 0) {
+       return (ObstacleType)i;
+     }
+   }
+   return ObstacleType::UNKNOWN;
+ }
+ 
+ inline NodeType nodeTypeFromLabel(const char* label) {
+   for (int i = 0; i < (int)NodeType::COUNT; i++) {
+     if (label && strcmp(label, NODE_TYPE_LABELS[i]) == 0) {
+       return (NodeType)i;
+     }
+   }
+   return NodeType::OTHER;
+ }
+ 
+ #endif
\ No newline at end of file
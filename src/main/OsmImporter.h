@@ -0,0 +1,501 @@
+/*
+ * OsmImporter.h
+ *
+ * Turns an OpenStreetMap XML extract into a base map tile archive (see
+ * TileStore.h) for the SD card, so places never walked before still have
+ * a map. Host side: it uses the C++ standard library and is not built
+ * into the sketch; tools/osm2tiles.cpp is the command-line front end.
+ *
+ * The extract is streamed twice through OsmReader. The first pass keeps
+ * the node lists of the ways a pedestrian can use, the second the
+ * coordinates and tags of just those nodes, so memory follows the size
+ * of the footpath network rather than of the extract. Steps become
+ * STAIRS obstacles, doors and entrances DOOR nodes, crossings and roads
+ * STREET nodes, and everything else walkable PATH nodes. Plain nodes
+ * along a way are then thinned within the on-device simplifier's
+ * tolerance, and the tile size is halved until every tile fits the
+ * device's tile slots.
+ */
+
+ #ifndef OSM_IMPORTER_H
+ #define OSM_IMPORTER_H
+ 
+ #include <stdint.h>
+ #include <string.h>
+ #include <math.h>
+ #include <vector>
+ #include <algorithm>
+ #include "OsmReader.h"
+ #include "TileStore.h"
+ #include "MapSimplifier.h"
+ 
+ #define OSM_READ_BUFFER 65536
+ #define OSM_TILE_DEG_E7_MAX 64000   // 0.0064 degrees, about 700 m
+ #define OSM_TILE_DEG_E7_MIN 1000    // 0.0001 degrees, about 11 m
+ #define OSM_MAX_TILE_STEP 127       // Edge records reach this many tiles away
+ 
+ struct OsmImportStats {
+   uint64_t bytesRead;         // Over both passes
+   uint32_t osmNodes;
+   uint32_t osmWays;
+   uint32_t keptWays;
+   uint32_t missingNodes;      // On a kept way but not in the extract
+   uint32_t thinnedNodes;
+   uint32_t nodes;             // Written to the archive
+   uint32_t edges;
+   uint32_t tiles;
+   uint32_t tileDegE7;
+   uint32_t fullestTileNodes;
+   uint32_t fullestTileEdges;  // Edge records, one at each end
+   uint32_t oversizedTiles;    // Over the limits even at the smallest tile size
+   uint32_t droppedEdges;      // Too long for an edge record
+ };
+ 
+ class OsmImporter {
+   private:
+     // What a node is on, and what its own tags say
+     static const uint8_t ON_FOOTWAY = 0x01;
+     static const uint8_t ON_STREET = 0x02;
+     static const uint8_t ON_STEPS = 0x04;
+     static const uint8_t ON_CROSSING = 0x08;
+     static const uint8_t TAG_DOOR = 0x10;
+     static const uint8_t TAG_CROSSING = 0x20;
+     static const int32_t MISSING = INT32_MIN;
+     
+     struct Edge {
+       int32_t a;
+       int32_t b;
+       float weight;
+     };
+     
+     uint32_t tileNodes;
+     uint32_t tileEdges;
+     
+     // Kept ways as runs of node ids, then of node indices into wanted
+     std::vector<int64_t> wayRefs;
+     std::vector<int32_t> wayNodes;
+     std::vector<uint32_t> wayStart;
+     std::vector<uint8_t> wayKind;
+     std::vector<int64_t> wanted;      // Sorted ids of every node on a kept way
+     
+     // Per wanted node: 1e-7 degree coordinates (MISSING until read) and flags
+     std::vector<int32_t> nodeLat;
+     std::vector<int32_t> nodeLng;
+     std::vector<uint8_t> nodeFlags;
+     
+     std::vector<Edge> edges;
+     std::vector<std::vector<int32_t> > nodeEdges;   // Live edges at each node
+     
+     // Archive layout: tile key and index within the tile of each node
+     std::vector<int32_t> tileX;
+     std::vector<int32_t> tileY;
+     std::vector<uint16_t> tileIndex;
+     std::vector<int32_t> order;       // Nodes in archive order
+     
+     OsmImportStats stats;
+     
+     static bool is(const char* text, const char* other) { return strcmp(text, other) == 0; }
+     
+     // Walking allowed unless the tags say otherwise
+     struct WayTags {
+       char highway[OSM_TEXT_BYTES];
+       char footway[OSM_TEXT_BYTES];
+       bool footYes;
+       bool footNo;
+       bool accessNo;
+     };
+     
+     static uint8_t kindOf(const WayTags& tags) {
+       const char* h = tags.highway;
+       if (!h[0] || tags.footNo || (tags.accessNo && !tags.footYes)) {
+         return 0;
+       }
+       if (is(h, "steps")) {
+         return ON_STEPS;
+       }
+       if (is(h, "footway") && is(tags.footway, "crossing")) {
+         return ON_CROSSING;
+       }
+       if (is(h, "footway") || is(h, "path") || is(h, "pedestrian") || is(h, "living_street") ||
+           is(h, "track") || is(h, "bridleway") || is(h, "corridor") || is(h, "platform") ||
+           (is(h, "cycleway") && tags.footYes)) {
+         return ON_FOOTWAY;
+       }
+       if (is(h, "residential") || is(h, "service") || is(h, "unclassified") || is(h, "road") ||
+           is(h, "tertiary") || is(h, "tertiary_link") || is(h, "secondary") || is(h, "secondary_link") ||
+           is(h, "primary") || is(h, "primary_link") || ((is(h, "trunk") || is(h, "cycleway")) && tags.footYes)) {
+         return ON_STREET;
+       }
+       return 0;  // Motorways, construction, and the like
+     }
+     
+     void readWayTag(const char* key, const char* value, WayTags& tags) {
+       if (is(key, "highway")) {
+         strcpy(tags.highway, value);
+       } else if (is(key, "footway")) {
+         strcpy(tags.footway, value);
+       } else if (is(key, "foot")) {
+         tags.footYes = is(value, "yes") || is(value, "designated") || is(value, "permissive");
+         tags.footNo = is(value, "no") || is(value, "private");
+       } else if (is(key, "access")) {
+         tags.accessNo = is(value, "no") || is(value, "private");
+       }
+     }
+     
+     static uint8_t nodeTagOf(const char* key, const char* value) {
+       if ((is(key, "entrance") || is(key, "door")) && !is(value, "no")) {
+         return TAG_DOOR;
+       }
+       if ((is(key, "highway") && is(value, "crossing")) || (is(key, "crossing") && !is(value, "no"))) {
+         return TAG_CROSSING;
+       }
+       return 0;
+     }
+     
+     int32_t indexOf(int64_t id) const {
+       std::vector<int64_t>::const_iterator it = std::lower_bound(wanted.begin(), wanted.end(), id);
+       return it != wanted.end() && *it == id ? (int32_t)(it - wanted.begin()) : -1;
+     }
+     
+     // Meters between two nodes, on the same sphere as the tiles
+     double metersBetween(int32_t a, int32_t b) const {
+       double dLat = ((double)nodeLat[b] - nodeLat[a]) / MAPFILE_COORD_SCALE;
+       double dLng = ((double)nodeLng[b] - nodeLng[a]) / MAPFILE_COORD_SCALE;
+       double cosLat = cos(((double)nodeLat[a] + nodeLat[b]) / 2 / MAPFILE_COORD_SCALE * M_PI / 180);
+       return TILE_METERS_PER_DEG * sqrt(dLat * dLat + dLng * cosLat * dLng * cosLat);
+     }
+     
+     // How far b lies from the line from a to c, in meters
+     double offLine(int32_t a, int32_t b, int32_t c) const {
+       double cosLat = cos(nodeLat[b] / MAPFILE_COORD_SCALE * M_PI / 180);
+       double bx = ((double)nodeLng[b] - nodeLng[a]) * cosLat, by = (double)nodeLat[b] - nodeLat[a];
+       double cx = ((double)nodeLng[c] - nodeLng[a]) * cosLat, cy = (double)nodeLat[c] - nodeLat[a];
+       double length = sqrt(cx * cx + cy * cy);
+       double off = length > 0 ? fabs(bx * cy - by * cx) / length : sqrt(bx * bx + by * by);
+       return off / MAPFILE_COORD_SCALE * TILE_METERS_PER_DEG;
+     }
+     
+     NodeType typeOf(int32_t node, ObstacleType& obstacle) const {
+       uint8_t flags = nodeFlags[node];
+       obstacle = ObstacleType::UNKNOWN;
+       if (flags & ON_STEPS) {
+         obstacle = ObstacleType::STAIRS;
+         return NodeType::OBSTACLE;
+       }
+       if (flags & TAG_DOOR) {
+         return NodeType::DOOR;
+       }
+       if (flags & (TAG_CROSSING | ON_CROSSING)) {
+         return NodeType::STREET;
+       }
+       return flags & ON_FOOTWAY ? NodeType::PATH : NodeType::STREET;
+     }
+     
+     int32_t otherEnd(int32_t edge, int32_t node) const {
+       return edges[edge].a == node ? edges[edge].b : edges[edge].a;
+     }
+     
+     bool joined(int32_t a, int32_t b) const {
+       for (size_t i = 0; i < nodeEdges[a].size(); i++) {
+         if (otherEnd(nodeEdges[a][i], a) == b) {
+           return true;
+         }
+       }
+       return false;
+     }
+     
+     void replaceEdge(int32_t node, int32_t from, int32_t to) {
+       std::replace(nodeEdges[node].begin(), nodeEdges[node].end(), from, to);
+     }
+     
+     // Join consecutive way nodes that were both in the extract, once each
+     void buildEdges() {
+       nodeEdges.assign(wanted.size(), std::vector<int32_t>());
+       for (size_t w = 0; w < wayKind.size(); w++) {
+         for (uint32_t i = wayStart[w]; i + 1 < wayStart[w + 1]; i++) {
+           int32_t a = wayNodes[i], b = wayNodes[i + 1];
+           if (a == b || nodeLat[a] == MISSING || nodeLat[b] == MISSING || joined(a, b)) {
+             continue;
+           }
+           Edge edge = {a, b, (float)metersBetween(a, b)};
+           nodeEdges[a].push_back(edges.size());
+           nodeEdges[b].push_back(edges.size());
+           edges.push_back(edge);
+         }
+       }
+       std::vector<int32_t>().swap(wayNodes);
+       std::vector<uint32_t>().swap(wayStart);
+       std::vector<uint8_t>().swap(wayKind);
+     }
+     
+     // Drop plain nodes in the middle of a chain where the walk around
+     // them stays within the simplifier's tolerance, keeping the length
+     void thin() {
+       for (int32_t b = 0; b < (int32_t)wanted.size(); b++) {
+         if (nodeEdges[b].size() != 2 || (nodeFlags[b] & (TAG_DOOR | TAG_CROSSING | ON_STEPS))) {
+           continue;
+         }
+         int32_t kept = nodeEdges[b][0], gone = nodeEdges[b][1];
+         int32_t a = otherEnd(kept, b), c = otherEnd(gone, b);
+         float walk = edges[kept].weight + edges[gone].weight;
+         if (a == c || walk > MAP_SIMPLIFY_MAX_EDGE || offLine(a, b, c) > MAP_SIMPLIFY_TOLERANCE || joined(a, c)) {
+           continue;
+         }
+         edges[kept].a = a;
+         edges[kept].b = c;
+         edges[kept].weight = walk;
+         edges[gone].a = edges[gone].b = -1;
+         replaceEdge(c, gone, kept);
+         nodeEdges[b].clear();
+         stats.thinnedNodes++;
+       }
+     }
+     
+     bool hasEdges(int32_t node) const { return !nodeEdges[node].empty(); }
+     
+     // Tile every node with edges at the given size, in archive order
+     void layOut(uint32_t degE7) {
+       double deg = degE7 / MAPFILE_COORD_SCALE;
+       tileX.resize(wanted.size());
+       tileY.resize(wanted.size());
+       tileIndex.resize(wanted.size());
+       order.clear();
+       for (int32_t n = 0; n < (int32_t)wanted.size(); n++) {
+         if (hasEdges(n)) {
+           tileX[n] = (int32_t)floor((nodeLng[n] / MAPFILE_COORD_SCALE + 180.0) / deg);
+           tileY[n] = (int32_t)floor((nodeLat[n] / MAPFILE_COORD_SCALE + 90.0) / deg);
+           order.push_back(n);
+         }
+       }
+       std::stable_sort(order.begin(), order.end(), TileOrder(this));
+       for (size_t i = 0; i < order.size(); i++) {
+         bool sameTile = i > 0 && tileX[order[i]] == tileX[order[i - 1]] && tileY[order[i]] == tileY[order[i - 1]];
+         tileIndex[order[i]] = sameTile ? tileIndex[order[i - 1]] + 1 : 0;
+       }
+     }
+     
+     struct TileOrder {
+       const OsmImporter* importer;
+       TileOrder(const OsmImporter* owner) : importer(owner) {}
+       bool operator()(int32_t a, int32_t b) const {
+         const std::vector<int32_t>& x = importer->tileX;
+         const std::vector<int32_t>& y = importer->tileY;
+         return x[a] < x[b] || (x[a] == x[b] && y[a] < y[b]);
+       }
+     };
+     
+     bool reachable(int32_t edge) const {
+       const Edge& e = edges[edge];
+       return abs(tileX[e.b] - tileX[e.a]) <= OSM_MAX_TILE_STEP && abs(tileY[e.b] - tileY[e.a]) <= OSM_MAX_TILE_STEP;
+     }
+     
+     // Nodes and edge records of the tile starting at order[first]
+     size_t tileEnd(size_t first, uint32_t& records) const {
+       records = 0;
+       size_t i = first;
+       for (; i < order.size() && tileX[order[i]] == tileX[order[first]] && tileY[order[i]] == tileY[order[first]]; i++) {
+         const std::vector<int32_t>& at = nodeEdges[order[i]];
+         for (size_t k = 0; k < at.size(); k++) {
+           records += reachable(at[k]);
+         }
+       }
+       return i;
+     }
+     
+     // Tiles over the limits at the current layout, and the fullest tile
+     uint32_t oversized(uint32_t& fullestNodes, uint32_t& fullestEdges, uint32_t& tiles) const {
+       uint32_t over = 0;
+       fullestNodes = fullestEdges = tiles = 0;
+       for (size_t first = 0; first < order.size(); ) {
+         uint32_t records;
+         size_t end = tileEnd(first, records);
+         uint32_t nodes = end - first;
+         fullestNodes = std::max(fullestNodes, nodes);
+         fullestEdges = std::max(fullestEdges, records);
+         over += nodes > tileNodes || records > tileEdges;
+         tiles++;
+         first = end;
+       }
+       return over;
+     }
+     
+   public:
+     // Tiles are made small enough for TILE_NODES and TILE_EDGES of the
+     // TileStore that will read them
+     OsmImporter(uint32_t maxTileNodes, uint32_t maxTileEdges) {
+       tileNodes = maxTileNodes;
+       tileEdges = maxTileEdges;
+       memset(&stats, 0, sizeof(stats));
+       wayStart.push_back(0);
+     }
+     
+     // First pass: the ways a pedestrian can use
+     template <typename Input>
+     bool readWays(Input& in) {
+       OsmReader<Input, OSM_READ_BUFFER> reader(in);
+       std::vector<int64_t> refs;
+       WayTags tags;
+       OsmEvent event;
+       while ((event = reader.next()) != OsmEvent::DONE) {
+         if (event == OsmEvent::WAY) {
+           refs.clear();
+           memset(&tags, 0, sizeof(tags));
+           stats.osmWays++;
+         } else if (event == OsmEvent::ND) {
+           refs.push_back(reader.getRef());
+         } else if (event == OsmEvent::TAG) {
+           readWayTag(reader.getKey(), reader.getValue(), tags);
+         } else if (event == OsmEvent::END && refs.size() >= 2) {
+           uint8_t kind = kindOf(tags);
+           if (kind) {
+             wayRefs.insert(wayRefs.end(), refs.begin(), refs.end());
+             wayStart.push_back(wayRefs.size());
+             wayKind.push_back(kind);
+             stats.keptWays++;
+           }
+           refs.clear();
+         }
+       }
+       stats.bytesRead += reader.getBytesRead();
+       
+       // Ids become indices into the sorted list of wanted nodes
+       wanted = wayRefs;
+       std::sort(wanted.begin(), wanted.end());
+       wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+       wayNodes.resize(wayRefs.size());
+       for (size_t i = 0; i < wayRefs.size(); i++) {
+         wayNodes[i] = indexOf(wayRefs[i]);
+       }
+       std::vector<int64_t>().swap(wayRefs);
+       
+       nodeLat.assign(wanted.size(), (int32_t)MISSING);
+       nodeLng.assign(wanted.size(), (int32_t)MISSING);
+       nodeFlags.assign(wanted.size(), 0);
+       for (size_t w = 0; w < wayKind.size(); w++) {
+         for (uint32_t i = wayStart[w]; i < wayStart[w + 1]; i++) {
+           nodeFlags[wayNodes[i]] |= wayKind[w];
+         }
+       }
+       return stats.osmWays > 0;
+     }
+     
+     // Second pass: where those ways' nodes are, and which are doors or crossings
+     template <typename Input>
+     bool readNodes(Input& in) {
+       OsmReader<Input, OSM_READ_BUFFER> reader(in);
+       int32_t node = -1;
+       OsmEvent event;
+       while ((event = reader.next()) != OsmEvent::DONE) {
+         if (event == OsmEvent::NODE) {
+           stats.osmNodes++;
+           node = indexOf(reader.getId());
+           if (node >= 0) {
+             nodeLat[node] = MapFile::toFixed(reader.getLat());
+             nodeLng[node] = MapFile::toFixed(reader.getLng());
+           }
+         } else if (event == OsmEvent::TAG && node >= 0) {
+           nodeFlags[node] |= nodeTagOf(reader.getKey(), reader.getValue());
+         } else if (event == OsmEvent::END) {
+           node = -1;
+         } else if (event == OsmEvent::WAY) {
+           break;  // Ways follow the nodes in an extract
+         }
+       }
+       stats.bytesRead += reader.getBytesRead();
+       for (size_t n = 0; n < wanted.size(); n++) {
+         stats.missingNodes += nodeLat[n] == MISSING;
+       }
+       
+       buildEdges();
+       thin();
+       return true;
+     }
+     
+     // Write the archive, at the largest tile size whose tiles all fit
+     template <typename Output>
+     bool write(Output& out) {
+       uint32_t degE7 = OSM_TILE_DEG_E7_MAX;
+       uint32_t fullestNodes, fullestEdges, tiles;
+       while (true) {
+         layOut(degE7);
+         stats.oversizedTiles = oversized(fullestNodes, fullestEdges, tiles);
+         if (stats.oversizedTiles == 0 || degE7 / 2 < OSM_TILE_DEG_E7_MIN) {
+           break;
+         }
+         degE7 /= 2;
+       }
+       stats.tileDegE7 = degE7;
+       stats.tiles = tiles;
+       stats.fullestTileNodes = fullestNodes;
+       stats.fullestTileEdges = fullestEdges;
+       stats.nodes = order.size();
+       stats.edges = stats.droppedEdges = 0;
+       for (size_t e = 0; e < edges.size(); e++) {
+         if (edges[e].a < 0) {
+           continue;
+         }
+         if (reachable(e)) {
+           stats.edges++;
+         } else {
+           stats.droppedEdges++;
+         }
+       }
+       
+       TileWriter writer;
+       if (!writer.writeHeader(out, tiles, degE7)) {
+         return false;
+       }
+       for (size_t first = 0; first < order.size(); ) {
+         uint32_t records;
+         size_t end = tileEnd(first, records);
+         TileKey key = {tileX[order[first]], tileY[order[first]]};
+         if (!writer.writeIndex(out, key, end - first, records)) {
+           return false;
+         }
+         first = end;
+       }
+       for (size_t first = 0; first < order.size(); ) {
+         uint32_t records;
+         size_t end = tileEnd(first, records);
+         bool ok = writer.beginTile(out, end - first, records);
+         for (size_t i = first; i < end && ok; i++) {
+           ObstacleType obstacle;
+           NodeType type = typeOf(order[i], obstacle);
+           ok = writer.writeNode(out, MapFile::fromFixed(nodeLat[order[i]]), MapFile::fromFixed(nodeLng[order[i]]),
+                                 type, obstacle);
+         }
+         for (size_t i = first; i < end && ok; i++) {
+           int32_t node = order[i];
+           for (size_t k = 0; k < nodeEdges[node].size() && ok; k++) {
+             int32_t edge = nodeEdges[node][k];
+             int32_t target = otherEnd(edge, node);
+             if (reachable(edge)) {
+               ok = writer.writeEdge(out, tileIndex[node], tileIndex[target], tileX[target] - tileX[node],
+                                     tileY[target] - tileY[node], edges[edge].weight);
+             }
+           }
+         }
+         if (!ok || !writer.endTile(out)) {
+           return false;
+         }
+         first = end;
+       }
+       return true;
+     }
+     
+     const OsmImportStats& getStats() const { return stats; }
+     
+     // Heap memory held now, for checking how the import scales
+     size_t getMemoryBytes() const {
+       size_t bytes = wayRefs.capacity() * 8 + wayNodes.capacity() * 4 + wayStart.capacity() * 4 +
+                      wayKind.capacity() + wanted.capacity() * 8 + nodeLat.capacity() * 4 +
+                      nodeLng.capacity() * 4 + nodeFlags.capacity() + edges.capacity() * sizeof(Edge) +
+                      tileX.capacity() * 4 + tileY.capacity() * 4 + tileIndex.capacity() * 2 + order.capacity() * 4;
+       for (size_t n = 0; n < nodeEdges.size(); n++) {
+         bytes += sizeof(std::vector<int32_t>) + nodeEdges[n].capacity() * 4;
+       }
+       return bytes;
+     }
+ };
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,248 @@
+/*
+ * OsmReader.h
+ *
+ * Streaming reader for OpenStreetMap XML extracts (.osm). It pulls the
+ * file through one fixed buffer and hands out one element at a time, so
+ * any extract size needs the same memory:
+ *   NODE  <node> with its id, lat and lon
+ *   WAY   <way> with its id
+ *   ND    <nd> of the current way, with its ref
+ *   TAG   <tag> of the current node or way, with k and v
+ *   END   end of the current node or way
+ * Relations, changesets and everything else are skipped. Tag keys and
+ * values are cut to OSM_TEXT_BYTES - 1 characters, and XML entities are
+ * left as they are. PBF extracts need converting first, e.g. with osmium.
+ *
+ * Works with any Input offering read(uint8_t*, size_t), such as an SD
+ * File. No Arduino dependencies.
+ */
+
+ #ifndef OSM_READER_H
+ #define OSM_READER_H
+ 
+ #include <stdint.h>
+ #include <stdlib.h>
+ #include <string.h>
+ 
+ #define OSM_TEXT_BYTES 64
+ #define OSM_NAME_BYTES 16
+ 
+ enum class OsmEvent : uint8_t {
+   NODE,
+   WAY,
+   ND,
+   TAG,
+   END,
+   DONE      // End of the file
+ };
+ 
+ template <typename Input, int BUFFER_BYTES>
+ class OsmReader {
+   private:
+     enum class Inside : uint8_t { NONE, NODE, WAY, OTHER };
+     
+     Input* input;
+     uint8_t buffer[BUFFER_BYTES];
+     int fill;
+     int pos;
+     uint64_t bytesRead;
+     
+     Inside inside;
+     bool endPending;           // A self-closing node or way ends at once
+     
+     int64_t id;
+     int64_t ref;
+     double lat;
+     double lng;
+     char key[OSM_TEXT_BYTES];
+     char value[OSM_TEXT_BYTES];
+     char name[OSM_NAME_BYTES];
+     char attribute[OSM_NAME_BYTES];
+     char text[OSM_TEXT_BYTES];
+     
+     int peek() {
+       if (pos == fill) {
+         int count = (int)input->read(buffer, BUFFER_BYTES);
+         if (count <= 0) {
+           return -1;
+         }
+         fill = count;
+         pos = 0;
+         bytesRead += count;
+       }
+       return buffer[pos];
+     }
+     
+     int get() {
+       int c = peek();
+       if (c >= 0) {
+         pos++;
+       }
+       return c;
+     }
+     
+     static bool isSpace(int c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+     
+     // Read characters up to a stop character, keeping what fits
+     int readUntil(char* out, int size, const char* stops) {
+       int length = 0;
+       int c;
+       while ((c = peek()) >= 0 && !strchr(stops, c)) {
+         if (length < size - 1) {
+           out[length++] = (char)c;
+         }
+         pos++;
+       }
+       out[length] = '\0';
+       return c;
+     }
+     
+     // Skip past a terminator such as "-->" or ">"
+     bool skipPast(const char* end) {
+       size_t matched = 0, length = strlen(end);
+       int c;
+       while ((c = get()) >= 0) {
+         matched = c == end[matched] ? matched + 1 : (c == end[0] ? 1 : 0);
+         if (matched == length) {
+           return true;
+         }
+       }
+       return false;
+     }
+     
+     void keep(const char* element) {
+       if (strcmp(element, "node") == 0 || strcmp(element, "nd") == 0) {
+         if (strcmp(attribute, "id") == 0) id = strtoll(text, 0, 10);
+         else if (strcmp(attribute, "lat") == 0) lat = strtod(text, 0);
+         else if (strcmp(attribute, "lon") == 0) lng = strtod(text, 0);
+         else if (strcmp(attribute, "ref") == 0) ref = strtoll(text, 0, 10);
+       } else if (strcmp(element, "way") == 0) {
+         if (strcmp(attribute, "id") == 0) id = strtoll(text, 0, 10);
+       } else if (strcmp(element, "tag") == 0) {
+         if (strcmp(attribute, "k") == 0) strcpy(key, text);
+         else if (strcmp(attribute, "v") == 0) strcpy(value, text);
+       }
+     }
+     
+     // Read the attributes of a start tag; false at the end of the file
+     bool readAttributes(bool& selfClosing) {
+       selfClosing = false;
+       while (true) {
+         int c = peek();
+         if (c < 0) {
+           return false;
+         }
+         if (isSpace(c)) {
+           pos++;
+         } else if (c == '/') {
+           pos++;
+           selfClosing = true;
+         } else if (c == '>') {
+           pos++;
+           return true;
+         } else {
+           readUntil(attribute, OSM_NAME_BYTES, "= \t\r\n/>");
+           // Past '=' and any spaces to the opening quote
+           do {
+             c = get();
+           } while (c >= 0 && c != '"' && c != '\'');
+           char quote[2] = {(char)c, '\0'};
+           if (c < 0 || readUntil(text, OSM_TEXT_BYTES, quote) < 0) {
+             return false;
+           }
+           pos++;
+           keep(name);
+         }
+       }
+     }
+     
+   public:
+     OsmReader(Input& in) {
+       input = &in;
+       fill = 0;
+       pos = 0;
+       bytesRead = 0;
+       inside = Inside::NONE;
+       endPending = false;
+       id = ref = 0;
+       lat = lng = 0;
+       key[0] = value[0] = '\0';
+     }
+     
+     OsmEvent next() {
+       if (endPending) {
+         endPending = false;
+         return OsmEvent::END;
+       }
+       while (true) {
+         int c = get();
+         if (c < 0) {
+           return OsmEvent::DONE;
+         }
+         if (c != '<') {
+           continue;  // Text between elements
+         }
+         
+         c = peek();
+         if (c == '?' || c == '!') {
+           pos++;
+           if (c == '!' && peek() == '-') {
+             skipPast("-->");
+           } else {
+             skipPast(">");
+           }
+           continue;
+         }
+         if (c == '/') {
+           pos++;
+           readUntil(name, OSM_NAME_BYTES, "> \t\r\n");
+           skipPast(">");
+           bool ends = (inside == Inside::NODE && strcmp(name, "node") == 0) ||
+                       (inside == Inside::WAY && strcmp(name, "way") == 0);
+           if (ends || (inside == Inside::OTHER && strcmp(name, "relation") == 0)) {
+             inside = Inside::NONE;
+           }
+           if (ends) {
+             return OsmEvent::END;
+           }
+           continue;
+         }
+         
+         readUntil(name, OSM_NAME_BYTES, "> \t\r\n/");
+         bool selfClosing;
+         key[0] = value[0] = '\0';
+         if (!readAttributes(selfClosing)) {
+           return OsmEvent::DONE;
+         }
+         if (strcmp(name, "node") == 0 && inside == Inside::NONE) {
+           inside = selfClosing ? Inside::NONE : Inside::NODE;
+           endPending = selfClosing;
+           return OsmEvent::NODE;
+         }
+         if (strcmp(name, "way") == 0 && inside == Inside::NONE) {
+           inside = selfClosing ? Inside::NONE : Inside::WAY;
+           endPending = selfClosing;
+           return OsmEvent::WAY;
+         }
+         if (strcmp(name, "nd") == 0 && inside == Inside::WAY) {
+           return OsmEvent::ND;
+         }
+         if (strcmp(name, "tag") == 0 && (inside == Inside::NODE || inside == Inside::WAY)) {
+           return OsmEvent::TAG;
+         }
+         if (strcmp(name, "relation") == 0 && !selfClosing) {
+           inside = Inside::OTHER;
+         }
+       }
+     }
+     
+     int64_t getId() const { return id; }
+     double getLat() const { return lat; }
+     double getLng() const { return lng; }
+     int64_t getRef() const { return ref; }
+     const char* getKey() const { return key; }
+     const char* getValue() const { return value; }
+     uint64_t getBytesRead() const { return bytesRead; }
+ };
+ 
+ #endif
\ No newline at end of file
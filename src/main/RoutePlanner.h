@@ -0,0 +1,224 @@
+/*
+ * RoutePlanner.h
+ *
+ * A* route search over the learned map. Edges are packed once into a
+ * compressed adjacency (CSR) layout, walkable in both directions, and
+ * the open set is an indexed binary heap with decrease-key. Search state
+ * is stamped per run, so nothing is cleared between searches, and the
+ * route is written into a fixed buffer owned by the planner. The caller
+ * supplies the heuristic. No Arduino dependencies.
+ */
+
+ #ifndef ROUTE_PLANNER_H
+ #define ROUTE_PLANNER_H
+ 
+ #include <stdint.h>
+ 
+ #define ROUTE_NONE -1
+ 
+ template <int MAX_NODES, int MAX_EDGES>
+ class RoutePlanner {
+   private:
+     // Compressed adjacency: neighbours of n are adjacent[offsets[n] .. offsets[n + 1])
+     int32_t offsets[MAX_NODES + 1];
+     int32_t adjacent[2 * MAX_EDGES];
+     float cost[2 * MAX_EDGES];
+     int graphNodes;
+     
+     // Per-node search state, valid while seen[n] == searchId
+     float g[MAX_NODES];
+     int32_t parent[MAX_NODES];
+     int32_t heapPos[MAX_NODES];   // Position in the heap, or CLOSED
+     uint32_t seen[MAX_NODES];
+     uint32_t searchId;
+     
+     // Open set ordered by f = g + h
+     int32_t heap[MAX_NODES];
+     float heapKey[MAX_NODES];
+     int heapSize;
+     
+     int32_t path[MAX_NODES];
+     int pathLength;
+     uint32_t expanded;
+     
+     static const int32_t CLOSED = -2;
+     
+     void place(int pos, int32_t node, float key) {
+       heap[pos] = node;
+       heapKey[pos] = key;
+       heapPos[node] = pos;
+     }
+     
+     void siftUp(int pos) {
+       int32_t node = heap[pos];
+       float key = heapKey[pos];
+       while (pos > 0) {
+         int up = (pos - 1) / 2;
+         if (heapKey[up] <= key) {
+           break;
+         }
+         place(pos, heap[up], heapKey[up]);
+         pos = up;
+       }
+       place(pos, node, key);
+     }
+     
+     void siftDown(int pos) {
+       int32_t node = heap[pos];
+       float key = heapKey[pos];
+       while (true) {
+         int child = 2 * pos + 1;
+         if (child >= heapSize) {
+           break;
+         }
+         if (child + 1 < heapSize && heapKey[child + 1] < heapKey[child]) {
+           child++;
+         }
+         if (key <= heapKey[child]) {
+           break;
+         }
+         place(pos, heap[child], heapKey[child]);
+         pos = child;
+       }
+       place(pos, node, key);
+     }
+     
+     int32_t popMin() {
+       int32_t best = heap[0];
+       heapSize--;
+       if (heapSize > 0) {
+         place(0, heap[heapSize], heapKey[heapSize]);
+         siftDown(0);
+       }
+       heapPos[best] = CLOSED;
+       return best;
+     }
+     
+   public:
+     RoutePlanner() {
+       graphNodes = 0;
+       offsets[0] = 0;
+       searchId = 0;
+       pathLength = 0;
+       expanded = 0;
+       for (int n = 0; n < MAX_NODES; n++) {
+         seen[n] = 0;
+       }
+     }
+     
+     // Pack the edge list into adjacency form. readEdge(i, source,
+     // target, weight) fills in edge i and returns false to leave it out.
+     template <typename EdgeReader>
+     void build(int nodeCount, int edgeCount, EdgeReader& readEdge) {
+       graphNodes = nodeCount;
+       for (int n = 0; n <= nodeCount; n++) {
+         offsets[n] = 0;
+       }
+       
+       // Count degrees, shifted by one so the prefix sum gives the starts
+       int32_t source, target;
+       float weight;
+       for (int i = 0; i < edgeCount; i++) {
+         if (readEdge(i, source, target, weight)) {
+           offsets[source + 1]++;
+           offsets[target + 1]++;
+         }
+       }
+       for (int n = 0; n < nodeCount; n++) {
+         offsets[n + 1] += offsets[n];
+       }
+       
+       // Fill, using parent[] as the per-node write cursor
+       for (int n = 0; n < nodeCount; n++) {
+         parent[n] = offsets[n];
+       }
+       for (int i = 0; i < edgeCount; i++) {
+         if (readEdge(i, source, target, weight)) {
+           adjacent[parent[source]] = target;
+           cost[parent[source]++] = weight;
+           adjacent[parent[target]] = source;
+           cost[parent[target]++] = weight;
+         }
+       }
+       
+       pathLength = 0;
+     }
+     
+     // A* from start to goal. heuristic(n) must not overestimate the cost
+     // from n to the goal. On success the route is in getPath().
+     template <typename Heuristic>
+     bool findPath(int32_t start, int32_t goal, Heuristic& heuristic) {
+       pathLength = 0;
+       expanded = 0;
+       if (start < 0 || goal < 0 || start >= graphNodes || goal >= graphNodes) {
+         return false;
+       }
+       
+       // A new stamp invalidates every node's state at once
+       if (++searchId == 0) {
+         for (int n = 0; n < MAX_NODES; n++) {
+           seen[n] = 0;
+         }
+         searchId = 1;
+       }
+       
+       heapSize = 0;
+       seen[start] = searchId;
+       g[start] = 0;
+       parent[start] = ROUTE_NONE;
+       place(heapSize++, start, heuristic(start));
+       
+       while (heapSize > 0) {
+         int32_t node = popMin();
+         expanded++;
+         if (node == goal) {
+           break;
+         }
+         
+         for (int32_t e = offsets[node]; e < offsets[node + 1]; e++) {
+           int32_t next = adjacent[e];
+           float tentative = g[node] + cost[e];
+           
+           if (seen[next] != searchId) {
+             seen[next] = searchId;
+             g[next] = tentative;
+             parent[next] = node;
+             place(heapSize, next, tentative + heuristic(next));
+             siftUp(heapSize++);
+           } else if (heapPos[next] != CLOSED && tentative < g[next]) {
+             // Decrease-key: the heuristic part of the key is unchanged
+             float h = heapKey[heapPos[next]] - g[next];
+             g[next] = tentative;
+             parent[next] = node;
+             heapKey[heapPos[next]] = tentative + h;
+             siftUp(heapPos[next]);
+           }
+         }
+       }
+       
+       if (seen[goal] != searchId || heapPos[goal] != CLOSED) {
+         return false;
+       }
+       
+       // Walk back from the goal, then reverse into start-to-goal order
+       for (int32_t n = goal; n != ROUTE_NONE; n = parent[n]) {
+         path[pathLength++] = n;
+       }
+       for (int i = 0, j = pathLength - 1; i < j; i++, j--) {
+         int32_t swap = path[i];
+         path[i] = path[j];
+         path[j] = swap;
+       }
+       return true;
+     }
+     
+     const int32_t* getPath() const { return path; }
+     int getPathLength() const { return pathLength; }
+     float getPathCost() const { return pathLength > 0 ? g[path[pathLength - 1]] : 0; }
+     uint32_t getExpandedCount() const { return expanded; }
+     
+     int getNodeCount() const { return graphNodes; }
+     int getDegree(int32_t node) const { return offsets[node + 1] - offsets[node]; }
+ };
+ 
+ #endif
\ No newline at end of file
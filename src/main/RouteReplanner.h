@@ -0,0 +1,308 @@
+/*
+ * RouteReplanner.h
+ *
+ * D* Lite route search over the learned map, for rerouting while the
+ * user walks. The search runs backwards from the goal, so when an edge
+ * cost changes only the nodes whose distance to the goal it changed are
+ * expanded again, and the start can move along the route without
+ * starting over. Only per-node search state is kept here: the edges are
+ * walked through the caller's graph (first/next/neighbourOf/weight, as
+ * for LandmarkHeuristic), whose weight() is the cost currently in
+ * effect; ROUTE_BLOCKED closes an edge. After a cost changes, or an edge
+ * appears or goes, the caller reports its ends with updateEdge(). The
+ * caller supplies the heuristic, which must be consistent.
+ * No Arduino dependencies.
+ */
+
+ #ifndef ROUTE_REPLANNER_H
+ #define ROUTE_REPLANNER_H
+ 
+ #include <stdint.h>
+ #include <math.h>
+ 
+ #ifndef ROUTE_NONE
+ #define ROUTE_NONE -1
+ #endif
+ #define ROUTE_BLOCKED INFINITY
+ 
+ template <int MAX_NODES>
+ class RouteReplanner {
+   static_assert(MAX_NODES <= INT16_MAX, "The open set holds 16-bit nodes");
+   
+   private:
+     // Per-node distance to the goal and its one-step lookahead, valid
+     // while seen[n] == searchId
+     float g[MAX_NODES];
+     float rhs[MAX_NODES];
+     int16_t heapPos[MAX_NODES];   // Position in the heap, or NOT_QUEUED
+     uint16_t seen[MAX_NODES];
+     uint16_t searchId;
+     
+     // Open set ordered by the key pair (min(g, rhs) + h + km, min(g, rhs))
+     int16_t heap[MAX_NODES];
+     float heapKey[MAX_NODES];
+     float heapTie[MAX_NODES];
+     int heapSize;
+     
+     int32_t start;
+     int32_t goal;
+     int32_t lastStart;            // Start the keys were computed from
+     float km;                     // Heuristic drift since then
+     bool planned;
+     
+     int32_t path[MAX_NODES];
+     int pathLength;
+     uint32_t expanded;
+     
+     static const int16_t NOT_QUEUED = -2;
+     
+     static bool before(float key, float tie, float otherKey, float otherTie) {
+       return key < otherKey || (key == otherKey && tie < otherTie);
+     }
+     
+     float distanceOf(int32_t node) const { return seen[node] == searchId ? g[node] : INFINITY; }
+     
+     void touch(int32_t node) {
+       if (seen[node] != searchId) {
+         seen[node] = searchId;
+         g[node] = INFINITY;
+         rhs[node] = INFINITY;
+         heapPos[node] = NOT_QUEUED;
+       }
+     }
+     
+     void place(int pos, int16_t node, float key, float tie) {
+       heap[pos] = node;
+       heapKey[pos] = key;
+       heapTie[pos] = tie;
+       heapPos[node] = pos;
+     }
+     
+     void siftUp(int pos) {
+       int16_t node = heap[pos];
+       float key = heapKey[pos], tie = heapTie[pos];
+       while (pos > 0) {
+         int up = (pos - 1) / 2;
+         if (!before(key, tie, heapKey[up], heapTie[up])) {
+           break;
+         }
+         place(pos, heap[up], heapKey[up], heapTie[up]);
+         pos = up;
+       }
+       place(pos, node, key, tie);
+     }
+     
+     void siftDown(int pos) {
+       int16_t node = heap[pos];
+       float key = heapKey[pos], tie = heapTie[pos];
+       while (true) {
+         int child = 2 * pos + 1;
+         if (child >= heapSize) {
+           break;
+         }
+         if (child + 1 < heapSize && before(heapKey[child + 1], heapTie[child + 1], heapKey[child], heapTie[child])) {
+           child++;
+         }
+         if (!before(heapKey[child], heapTie[child], key, tie)) {
+           break;
+         }
+         place(pos, heap[child], heapKey[child], heapTie[child]);
+         pos = child;
+       }
+       place(pos, node, key, tie);
+     }
+     
+     // Insert, or move a queued node to its new key
+     void queue(int32_t node, float key, float tie) {
+       int pos = heapPos[node];
+       if (pos == NOT_QUEUED) {
+         pos = heapSize++;
+       }
+       place(pos, node, key, tie);
+       siftUp(pos);
+       siftDown(heapPos[node]);
+     }
+     
+     void dequeue(int32_t node) {
+       int pos = heapPos[node];
+       heapPos[node] = NOT_QUEUED;
+       heapSize--;
+       if (pos < heapSize) {
+         int16_t moved = heap[heapSize];
+         place(pos, moved, heapKey[heapSize], heapTie[heapSize]);
+         siftUp(pos);
+         siftDown(heapPos[moved]);
+       }
+     }
+     
+     // Recompute the lookahead of a node and queue it if inconsistent
+     template <typename Graph, typename Heuristic>
+     void updateNode(int32_t node, Graph& graph, Heuristic& heuristic) {
+       touch(node);
+       if (node != goal) {
+         float best = INFINITY;
+         for (int32_t h = graph.first(node); h >= 0; h = graph.next(h)) {
+           float through = graph.weight(h) + distanceOf(graph.neighbourOf(h));
+           if (through < best) {
+             best = through;
+           }
+         }
+         rhs[node] = best;
+       }
+       if (g[node] != rhs[node]) {
+         float m = fminf(g[node], rhs[node]);
+         queue(node, m + heuristic(start, node) + km, m);
+       } else if (heapPos[node] != NOT_QUEUED) {
+         dequeue(node);
+       }
+     }
+     
+     template <typename Graph, typename Heuristic>
+     void computeShortestPath(Graph& graph, Heuristic& heuristic) {
+       touch(start);
+       while (heapSize > 0) {
+         float startTie = fminf(g[start], rhs[start]);
+         float startKey = startTie + heuristic(start, start) + km;
+         if (!before(heapKey[0], heapTie[0], startKey, startTie) && g[start] == rhs[start]) {
+           break;
+         }
+         
+         int32_t node = heap[0];
+         float oldKey = heapKey[0], oldTie = heapTie[0];
+         float tie = fminf(g[node], rhs[node]);
+         float key = tie + heuristic(start, node) + km;
+         expanded++;
+         if (before(oldKey, oldTie, key, tie)) {
+           // Queued before the start moved: only the key is stale
+           queue(node, key, tie);
+         } else if (g[node] > rhs[node]) {
+           g[node] = rhs[node];
+           dequeue(node);
+           for (int32_t h = graph.first(node); h >= 0; h = graph.next(h)) {
+             updateNode(graph.neighbourOf(h), graph, heuristic);
+           }
+         } else {
+           g[node] = INFINITY;
+           updateNode(node, graph, heuristic);
+           for (int32_t h = graph.first(node); h >= 0; h = graph.next(h)) {
+             updateNode(graph.neighbourOf(h), graph, heuristic);
+           }
+         }
+       }
+     }
+     
+     // Follow the cheapest edges from the start down to the goal
+     template <typename Graph>
+     bool extractPath(Graph& graph) {
+       pathLength = 0;
+       if (distanceOf(start) == INFINITY) {
+         return false;
+       }
+       int32_t node = start;
+       path[pathLength++] = node;
+       while (node != goal && pathLength < MAX_NODES) {
+         int32_t next = ROUTE_NONE;
+         float best = INFINITY;
+         for (int32_t h = graph.first(node); h >= 0; h = graph.next(h)) {
+           int32_t other = graph.neighbourOf(h);
+           float through = graph.weight(h) + distanceOf(other);
+           if (through < best) {
+             best = through;
+             next = other;
+           }
+         }
+         if (next == ROUTE_NONE) {
+           pathLength = 0;
+           return false;
+         }
+         node = next;
+         path[pathLength++] = node;
+       }
+       return node == goal;
+     }
+     
+   public:
+     RouteReplanner() {
+       searchId = 0;
+       heapSize = 0;
+       planned = false;
+       pathLength = 0;
+       expanded = 0;
+       for (int n = 0; n < MAX_NODES; n++) {
+         seen[n] = 0;
+       }
+     }
+     
+     // Search from start to goal over the graph's current costs.
+     // heuristic(a, b) estimates the cost between two nodes and must be
+     // consistent. The route is in getPath().
+     template <typename Graph, typename Heuristic>
+     bool plan(int32_t from, int32_t to, Graph& graph, Heuristic& heuristic) {
+       planned = false;
+       pathLength = 0;
+       expanded = 0;
+       if (from < 0 || to < 0 || from >= MAX_NODES || to >= MAX_NODES) {
+         return false;
+       }
+       
+       // A new stamp invalidates every node's state at once
+       if (++searchId == 0) {
+         for (int n = 0; n < MAX_NODES; n++) {
+           seen[n] = 0;
+         }
+         searchId = 1;
+       }
+       
+       start = lastStart = from;
+       goal = to;
+       km = 0;
+       heapSize = 0;
+       touch(goal);
+       rhs[goal] = 0;
+       queue(goal, heuristic(start, goal), 0);
+       planned = true;
+       
+       computeShortestPath(graph, heuristic);
+       return extractPath(graph);
+     }
+     
+     // The user has walked on to another node of the graph
+     template <typename Heuristic>
+     void setStart(int32_t node, Heuristic& heuristic) {
+       if (!planned || node < 0 || node >= MAX_NODES || node == start) {
+         return;
+       }
+       km += heuristic(lastStart, node);
+       lastStart = start = node;
+     }
+     
+     // The edge between a and b changed its cost (e.g. to ROUTE_BLOCKED),
+     // appeared or went; repaired by replan()
+     template <typename Graph, typename Heuristic>
+     void updateEdge(int32_t a, int32_t b, Graph& graph, Heuristic& heuristic) {
+       if (planned) {
+         updateNode(a, graph, heuristic);
+         updateNode(b, graph, heuristic);
+       }
+     }
+     
+     // Bring the plan up to date after setStart/updateEdge, expanding
+     // only the nodes the changes affect
+     template <typename Graph, typename Heuristic>
+     bool replan(Graph& graph, Heuristic& heuristic) {
+       expanded = 0;
+       if (!planned) {
+         return false;
+       }
+       computeShortestPath(graph, heuristic);
+       return extractPath(graph);
+     }
+     
+     const int32_t* getPath() const { return path; }
+     int getPathLength() const { return pathLength; }
+     float getPathCost() const { return pathLength > 0 ? distanceOf(start) : 0; }
+     uint32_t getExpandedCount() const { return expanded; }
+     bool isPlanned() const { return planned; }
+ };
+ 
+ #endif
\ No newline at end of file
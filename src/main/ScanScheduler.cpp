@@ -0,0 +1,137 @@
+/*
+ * ScanScheduler.cpp
+ *
+ * Implementation of the staggered multi-sensor ping scheduler
+ */
+
+ #include "ScanScheduler.h"
+ 
+ ScanScheduler::ScanScheduler() {
+   slotCount = 0;
+   sensorCount = 0;
+   nextSlot = 0;
+   listenUs = 0;
+   quietUs = 0;
+   slotUs = 0;
+   lastFireUs = 0;
+   anyFired = false;
+   
+   for (int i = 0; i < SCAN_MAX_SENSORS; i++) {
+     sensorQuietUs[i] = 0;
+     lastSensorFireUs[i] = 0;
+     sensorFired[i] = false;
+   }
+ }
+ 
+ bool ScanScheduler::configure(uint8_t count, float maxRangeCm, uint32_t quiet) {
+   if (count == 0 || count > SCAN_MAX_SENSORS || count > SCAN_MAX_SLOTS) {
+     return false;
+   }
+   
+   sensorCount = count;
+   listenUs = rangeToListenUs(maxRangeCm);
+   
+   // Echoes the listen window cuts off are still in the air
+   uint32_t echoUs = rangeToListenUs(SCAN_ECHO_RANGE_CM);
+   quietUs = (listenUs + quiet >= echoUs) ? quiet : echoUs - listenUs;
+   updateSlotLength();
+   
+   // Default plan: each sensor once per frame, in order
+   for (uint8_t i = 0; i < count; i++) {
+     plan[i] = i;
+     sensorQuietUs[i] = 0;
+   }
+   slotCount = count;
+   nextSlot = 0;
+   
+   return true;
+ }
+ 
+ bool ScanScheduler::setPlan(const uint8_t* order, uint8_t count) {
+   if (count == 0 || count > SCAN_MAX_SLOTS) {
+     return false;
+   }
+   
+   // Every slot must name a configured sensor and every sensor must get a slot
+   bool used[SCAN_MAX_SENSORS] = {false};
+   for (uint8_t i = 0; i < count; i++) {
+     if (order[i] >= sensorCount) {
+       return false;
+     }
+     used[order[i]] = true;
+   }
+   for (uint8_t i = 0; i < sensorCount; i++) {
+     if (!used[i]) {
+       return false;
+     }
+   }
+   
+   for (uint8_t i = 0; i < count; i++) {
+     plan[i] = order[i];
+   }
+   slotCount = count;
+   nextSlot = 0;
+   
+   return true;
+ }
+ 
+ void ScanScheduler::setSensorQuiet(uint8_t sensor, uint32_t quiet) {
+   if (sensor < SCAN_MAX_SENSORS) {
+     sensorQuietUs[sensor] = quiet;
+   }
+ }
+ 
+ int ScanScheduler::nextDue(uint32_t nowUs, bool channelBusy) const {
+   if (slotCount == 0 || channelBusy) {
+     return -1;
+   }
+   
+   // The previous slot owns the air until its listen and quiet windows have passed.
+   // Slots start when they actually fire, so a late loop never causes a burst of pings.
+   if (anyFired && (uint32_t)(nowUs - lastFireUs) < slotUs) {
+     return -1;
+   }
+   
+   uint8_t sensor = plan[nextSlot];
+   if (sensorFired[sensor] && (uint32_t)(nowUs - lastSensorFireUs[sensor]) < sensorQuietUs[sensor]) {
+     return -1;
+   }
+   
+   return sensor;
+ }
+ 
+ void ScanScheduler::markFired(uint8_t sensor, uint32_t nowUs) {
+   lastFireUs = nowUs;
+   anyFired = true;
+   
+   if (sensor < SCAN_MAX_SENSORS) {
+     lastSensorFireUs[sensor] = nowUs;
+     sensorFired[sensor] = true;
+   }
+   
+   nextSlot = (nextSlot + 1) % slotCount;
+ }
+ 
+ float ScanScheduler::getSensorRateHz(uint8_t sensor) const {
+   if (slotCount == 0 || slotUs == 0) {
+     return 0;
+   }
+   
+   int slots = 0;
+   for (uint8_t i = 0; i < slotCount; i++) {
+     if (plan[i] == sensor) {
+       slots++;
+     }
+   }
+   
+   return slots * 1000000.0f / getFrameUs();
+ }
+ 
+ void ScanScheduler::updateSlotLength() {
+   slotUs = SCAN_BURST_US + listenUs + quietUs;
+ }
+ 
+ uint32_t ScanScheduler::rangeToListenUs(float rangeCm) {
+   // Sound travels ~0.034 cm/us and has to go there and back
+   return (uint32_t)(rangeCm * 2 / 0.034f);
+ }
\ No newline at end of file
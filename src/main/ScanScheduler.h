@@ -0,0 +1,78 @@
+/*
+ * ScanScheduler.h
+ *
+ * Staggers ultrasonic pings across several sensors so that only one is
+ * listening at a time. The time plan is a repeating sequence of slots,
+ * each long enough for a full echo round trip plus a quiet window for
+ * reverberation to die out. The quiet window also lets echoes from beyond
+ * the listen range arrive before the next sensor listens, or they would
+ * read as close obstacles there. No Arduino dependencies.
+ */
+
+ #ifndef SCAN_SCHEDULER_H
+ #define SCAN_SCHEDULER_H
+ 
+ #include <stdint.h>
+ 
+ #define SCAN_MAX_SENSORS 8
+ #define SCAN_MAX_SLOTS 16
+ #define SCAN_BURST_US 460          // Trigger to echo rise on the HC-SR04
+ #define SCAN_DEFAULT_RANGE_CM 300.0
+ #define SCAN_DEFAULT_QUIET_US 2000
+ #define SCAN_ECHO_RANGE_CM 400.0   // Farthest echo a sensor still hears (RANGER_MAX_DISTANCE_CM)
+ 
+ class ScanScheduler {
+   private:
+     // Time plan: sensor index for each slot of a frame
+     uint8_t plan[SCAN_MAX_SLOTS];
+     uint8_t slotCount;
+     uint8_t sensorCount;
+     uint8_t nextSlot;
+     
+     // Slot timing
+     uint32_t listenUs;
+     uint32_t quietUs;
+     uint32_t slotUs;
+     
+     // Per-sensor minimum spacing between its own pings
+     uint32_t sensorQuietUs[SCAN_MAX_SENSORS];
+     uint32_t lastSensorFireUs[SCAN_MAX_SENSORS];
+     bool sensorFired[SCAN_MAX_SENSORS];
+     
+     uint32_t lastFireUs;
+     bool anyFired;
+     
+     void updateSlotLength();
+     
+   public:
+     ScanScheduler();
+     
+     // Round-robin plan over sensorCount sensors. The quiet window is
+     // lengthened to cover echoes out to SCAN_ECHO_RANGE_CM.
+     bool configure(uint8_t sensorCount, float maxRangeCm, uint32_t quietUs);
+     
+     // Custom plan, e.g. {0, 1, 0, 2} to ping sensor 0 twice as often
+     bool setPlan(const uint8_t* order, uint8_t count);
+     
+     // Extra spacing before a sensor may fire again (0 = one slot)
+     void setSensorQuiet(uint8_t sensor, uint32_t quietUs);
+     
+     // Sensor whose slot is due now, or -1. channelBusy: a ping is still in flight.
+     int nextDue(uint32_t nowUs, bool channelBusy) const;
+     
+     // Record that the due sensor was fired and advance the plan
+     void markFired(uint8_t sensor, uint32_t nowUs);
+     
+     // Plan information
+     uint32_t getListenUs() const { return listenUs; }
+     uint32_t getQuietUs() const { return quietUs; }
+     uint32_t getSlotUs() const { return slotUs; }
+     uint32_t getFrameUs() const { return slotUs * slotCount; }
+     uint8_t getSensorCount() const { return sensorCount; }
+     float getSensorRateHz(uint8_t sensor) const;
+     
+     // Echo round trip for a range
+     static uint32_t rangeToListenUs(float rangeCm);
+ };
+ 
+ #endif
\ No newline at end of file
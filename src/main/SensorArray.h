@@ -0,0 +1,90 @@
+/*
+ * SensorArray.h
+ *
+ * Compile-time description of the ultrasonic sensor array. Pin
+ * assignments, mounting geometry and thresholds are template parameters,
+ * so array sizes, per-sensor loops and the classifier feature layout
+ * are all fixed by the compiler for a given cane build.
+ */
+
+ #ifndef SENSOR_ARRAY_H
+ #define SENSOR_ARRAY_H
+ 
+ // Spectral energy bands per sensor in the classifier features
+ #ifndef SPECTRAL_BANDS
+ #define SPECTRAL_BANDS 4
+ #endif
+ 
+ // One HC-SR04: pins, mounting height above ground, yaw (negative = left)
+ // and alert thresholds
+ template <int TRIG, int ECHO, int HEIGHT_CM, int YAW_DEG, int WARNING_CM, int DANGER_CM>
+ struct SensorPinConfig {
+   static constexpr int trigPin = TRIG;
+   static constexpr int echoPin = ECHO;
+   static constexpr int heightCm = HEIGHT_CM;
+   static constexpr int yawDeg = YAW_DEG;
+   static constexpr int warningCm = WARNING_CM;
+   static constexpr int dangerCm = DANGER_CM;
+   
+   static_assert(DANGER_CM < WARNING_CM, "Danger threshold must be inside the warning threshold");
+ };
+ 
+ // Unrolls a functor call over every sensor config at compile time
+ template <int INDEX, typename... Configs>
+ struct SensorForEach;
+ 
+ template <int INDEX>
+ struct SensorForEach<INDEX> {
+   template <typename F>
+   static void apply(F&) {}
+ };
+ 
+ template <int INDEX, typename Config, typename... Rest>
+ struct SensorForEach<INDEX, Config, Rest...> {
+   template <typename F>
+   static void apply(F& f) {
+     f(INDEX, Config());
+     SensorForEach<INDEX + 1, Rest...>::apply(f);
+   }
+ };
+ 
+ template <int N, typename... PinConfig>
+ struct SensorArray {
+   static_assert(N == sizeof...(PinConfig), "SensorArray needs exactly N pin configs");
+   static_assert(N >= 2, "SensorArray needs at least a lower and an upper sensor");
+   
+   static constexpr int COUNT = N;
+   
+   static constexpr int trigPins[N] = { PinConfig::trigPin... };
+   static constexpr int echoPins[N] = { PinConfig::echoPin... };
+   static constexpr int heightsCm[N] = { PinConfig::heightCm... };
+   static constexpr int yawsDeg[N] = { PinConfig::yawDeg... };
+   static constexpr int warningsCm[N] = { PinConfig::warningCm... };
+   static constexpr int dangersCm[N] = { PinConfig::dangerCm... };
+   
+   // Classifier features per time step:
+   // [distance x N][height difference x N-1][average][rate of change x N][variance x N][frequency x N]
+   // [band energy x SPECTRAL_BANDS, per sensor]
+   static constexpr int FEATURE_COUNT = (5 + SPECTRAL_BANDS) * N;
+   static constexpr int distanceFeature(int sensor) { return sensor; }
+   static constexpr int heightDiffFeature(int pair) { return N + pair; }
+   static constexpr int averageFeature() { return 2 * N - 1; }
+   static constexpr int rateFeature(int sensor) { return 2 * N + sensor; }
+   static constexpr int varianceFeature(int sensor) { return 3 * N + sensor; }
+   static constexpr int frequencyFeature(int sensor) { return 4 * N + sensor; }
+   static constexpr int bandFeature(int sensor, int band) { return 5 * N + sensor * SPECTRAL_BANDS + band; }
+   
+   // Call f(index, PinConfig()) for every sensor, unrolled at compile time
+   template <typename F>
+   static void forEach(F& f) { SensorForEach<0, PinConfig...>::apply(f); }
+ };
+ 
+ // Out-of-class definitions for the constexpr tables (needed before C++17)
+ template <int N, typename... P> constexpr int SensorArray<N, P...>::trigPins[N];
+ template <int N, typename... P> constexpr int SensorArray<N, P...>::echoPins[N];
+ template <int N, typename... P> constexpr int SensorArray<N, P...>::heightsCm[N];
+ template <int N, typename... P> constexpr int SensorArray<N, P...>::yawsDeg[N];
+ template <int N, typename... P> constexpr int SensorArray<N, P...>::warningsCm[N];
+ template <int N, typename... P> constexpr int SensorArray<N, P...>::dangersCm[N];
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,43 @@
+/*
+ * SensorConfig.h
+ *
+ * Ultrasonic sensor layout of the cane build. Sensor 0 is always the
+ * forward lower sensor and sensor 1 the forward upper sensor; extra
+ * sensors look to the sides. Select a larger build with
+ * -DSMARTGUIDE_FOUR_SENSORS or -DSMARTGUIDE_SIX_SENSORS.
+ */
+
+ #ifndef SENSOR_CONFIG_H
+ #define SENSOR_CONFIG_H
+ 
+ #include "SensorArray.h"
+ 
+ // Roles of the first two sensors in every build
+ #define SENSOR_LOWER 0
+ #define SENSOR_UPPER 1
+ 
+ //                      trig echo height yaw warning danger
+ #if defined(SMARTGUIDE_SIX_SENSORS)
+ typedef SensorArray<6,
+   SensorPinConfig<12, 13,  30,   0, 150, 50>,  // Lower, forward
+   SensorPinConfig<14, 15, 110,   0, 150, 50>,  // Upper, head height
+   SensorPinConfig<16, 17,  30, -35, 100, 40>,  // Lower, left
+   SensorPinConfig<18, 19,  30,  35, 100, 40>,  // Lower, right
+   SensorPinConfig<25, 26, 110, -35, 100, 40>,  // Upper, left
+   SensorPinConfig<27, 32, 110,  35, 100, 40>   // Upper, right
+ > CaneSensors;
+ #elif defined(SMARTGUIDE_FOUR_SENSORS)
+ typedef SensorArray<4,
+   SensorPinConfig<12, 13,  30,   0, 150, 50>,  // Lower, forward
+   SensorPinConfig<14, 15, 110,   0, 150, 50>,  // Upper, head height
+   SensorPinConfig<16, 17,  30, -35, 100, 40>,  // Lower, left
+   SensorPinConfig<18, 19,  30,  35, 100, 40>   // Lower, right
+ > CaneSensors;
+ #else
+ typedef SensorArray<2,
+   SensorPinConfig<12, 13,  30,   0, 150, 50>,  // Lower, forward
+   SensorPinConfig<14, 15, 110,   0, 150, 50>   // Upper, head height
+ > CaneSensors;
+ #endif
+ 
+ #endif
\ No newline at end of file
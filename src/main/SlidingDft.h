@@ -0,0 +1,146 @@
+/*
+ * SlidingDft.h
+ *
+ * Sliding DFT over the last WINDOW samples for the lowest BINS
+ * non-DC frequency bins. Each sample updates every bin in O(BINS),
+ * independent of the window length. The bins are recomputed exactly
+ * every few windows to cancel float drift. No Arduino dependencies.
+ */
+
+ #ifndef SLIDING_DFT_H
+ #define SLIDING_DFT_H
+ 
+ #include <stdint.h>
+ #include <math.h>
+ 
+ #define SDFT_RESYNC_WINDOWS 4       // Exact recomputation every 4 windows
+ #define SDFT_MIN_POWER 0.25         // Below this (about 1 cm amplitude) there is no dominant frequency
+ 
+ template <int WINDOW, int BINS>
+ class SlidingDft {
+   static_assert(BINS >= 1 && BINS <= WINDOW / 2, "Bins must be below Nyquist");
+   static_assert(WINDOW <= 1024, "Window too long");
+   
+   private:
+     float samples[WINDOW];
+     uint16_t head;              // Oldest sample once the window is full
+     uint16_t count;
+     uint16_t stepsSinceResync;
+     
+     // Bin k+1 for index k
+     float re[BINS];
+     float im[BINS];
+     
+     // e^(j*2*pi*n/WINDOW), shared by all bins
+     float cosTable[WINDOW];
+     float sinTable[WINDOW];
+     
+     void resync() {
+       for (int k = 0; k < BINS; k++) {
+         float sumRe = 0;
+         float sumIm = 0;
+         int step = head;
+         for (int m = 0; m < WINDOW; m++) {
+           int phase = ((k + 1) * m) % WINDOW;
+           sumRe += samples[step] * cosTable[phase];
+           sumIm -= samples[step] * sinTable[phase];
+           step = step + 1 == WINDOW ? 0 : step + 1;
+         }
+         re[k] = sumRe;
+         im[k] = sumIm;
+       }
+       stepsSinceResync = 0;
+     }
+     
+   public:
+     static const int LENGTH = WINDOW;
+     
+     SlidingDft() {
+       for (int n = 0; n < WINDOW; n++) {
+         cosTable[n] = cos(2 * M_PI * n / WINDOW);
+         sinTable[n] = sin(2 * M_PI * n / WINDOW);
+       }
+       clear();
+     }
+     
+     void clear() {
+       for (int n = 0; n < WINDOW; n++) {
+         samples[n] = 0;
+       }
+       for (int k = 0; k < BINS; k++) {
+         re[k] = 0;
+         im[k] = 0;
+       }
+       head = 0;
+       count = 0;
+       stepsSinceResync = 0;
+     }
+     
+     // Slide the window by one sample. The window starts out filled with
+     // the first sample so the distance offset does not show up as a step.
+     void push(float x) {
+       if (count == 0) {
+         for (int n = 0; n < WINDOW; n++) {
+           samples[n] = x;
+         }
+       }
+       
+       float delta = x - samples[head];
+       samples[head] = x;
+       head = head + 1 == WINDOW ? 0 : head + 1;
+       if (count < WINDOW) {
+         count++;
+       }
+       
+       // X_k = (X_k + x_new - x_old) * e^(j*2*pi*k/N)
+       for (int k = 0; k < BINS; k++) {
+         float r = re[k] + delta;
+         float i = im[k];
+         float c = cosTable[k + 1];
+         float s = sinTable[k + 1];
+         re[k] = r * c - i * s;
+         im[k] = r * s + i * c;
+       }
+       
+       if (++stepsSinceResync >= SDFT_RESYNC_WINDOWS * WINDOW) {
+         resync();
+       }
+     }
+     
+     // Mean power of a bin (bin 0 is the first non-DC bin), in input units squared
+     float power(int bin) const {
+       float r = re[bin] / WINDOW;
+       float i = im[bin] / WINDOW;
+       return r * r + i * i;
+     }
+     
+     // Sum of bin powers in [firstBin, lastBin]
+     float bandEnergy(int firstBin, int lastBin) const {
+       float energy = 0;
+       for (int k = firstBin; k <= lastBin && k < BINS; k++) {
+         energy += power(k);
+       }
+       return energy;
+     }
+     
+     static float binFrequency(int bin, float sampleHz) { return (bin + 1) * sampleHz / WINDOW; }
+     
+     // Frequency of the strongest bin in Hz, 0 when nothing stands out
+     float dominantFrequency(float sampleHz) const {
+       int best = -1;
+       float bestPower = SDFT_MIN_POWER;
+       for (int k = 0; k < BINS; k++) {
+         float p = power(k);
+         if (p > bestPower) {
+           bestPower = p;
+           best = k;
+         }
+       }
+       return best < 0 ? 0 : binFrequency(best, sampleHz);
+     }
+     
+     int size() const { return count; }
+     bool isFull() const { return count == WINDOW; }
+ };
+ 
+ #endif
\ No newline at end of file
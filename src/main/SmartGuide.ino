@@ -3,11 +3,7 @@
  #include "AIClassifier.h"
  #include "MapSystem.h"
  
- // Pin Definitions
- const int TRIG_PIN_LOWER = 12;
- const int ECHO_PIN_LOWER = 13;
- const int TRIG_PIN_UPPER = 14;
- const int ECHO_PIN_UPPER = 15;
+ // Pin Definitions (ultrasonic sensor pins are in SensorConfig.h)
  const int VIBRATE_LEFT = 5;
  const int VIBRATE_RIGHT = 6;
  const int VIBRATE_WARNING = 7;
@@ -19,14 +15,17 @@
  ObstacleDetection obstacleDetector;
  AIClassifier aiClassifier;
  NavigationSystem navSystem;
+ #ifdef BOARD_HAS_PSRAM
+ EXT_RAM_BSS_ATTR MapSystem mapSystem;  // Large map, kept out of internal RAM
+ #else
  MapSystem mapSystem;
+ static_assert(sizeof(MapSystem) <= MAP_RAM_BUDGET, "Map does not fit internal RAM, lower MAX_MAP_NODES");
+ #endif
  
  // Timing variables
  unsigned long lastSensorRead = 0;
- unsigned long lastGpsUpdate = 0;
  unsigned long lastFeedbackUpdate = 0;
  const int SENSOR_INTERVAL = 100;  // 10Hz
- const int GPS_INTERVAL = 1000;    // 1Hz
  const int FEEDBACK_INTERVAL = 250;  // 4Hz
  
  void setup() {
@@ -34,7 +33,7 @@
    Serial.println("SmartGuide Initializing...");
    
    // Initialize subsystems
-   obstacleDetector.begin(TRIG_PIN_LOWER, ECHO_PIN_LOWER, TRIG_PIN_UPPER, ECHO_PIN_UPPER);
+   obstacleDetector.begin();
    
    // Initialize feedback pins
    pinMode(VIBRATE_LEFT, OUTPUT);
@@ -65,14 +64,21 @@
  }
  
  void loop() {
+   // Keep the ultrasonic ranging engine running (non-blocking)
+   obstacleDetector.update();
+   
    // Read sensors at specified interval
    if (millis() - lastSensorRead >= SENSOR_INTERVAL) {
-     // Get distance readings from ultrasonic sensors
-     float distLower = obstacleDetector.getLowerDistance();
-     float distUpper = obstacleDetector.getUpperDistance();
+     // Get latest distance readings from ultrasonic sensors
+     float distances[CaneSensors::COUNT];
+     for (int i = 0; i < CaneSensors::COUNT; i++) {
+       distances[i] = obstacleDetector.getDistance(i);
+     }
+     float distLower = distances[SENSOR_LOWER];
+     float distUpper = distances[SENSOR_UPPER];
      
      // Update AI classifier with new readings
-     aiClassifier.updateReadings(distLower, distUpper);
+     aiClassifier.updateReadings(distances);
      
      // Process obstacle detection
      processObstacles(distLower, distUpper);
@@ -80,15 +86,20 @@
      lastSensorRead = millis();
    }
    
-   // Update GPS and navigation at specified interval
-   if (millis() - lastGpsUpdate >= GPS_INTERVAL) {
-     // Update GPS location
-     if (navSystem.updateGpsLocation()) {
-       // Update map with new location
-       mapSystem.updateCurrentPosition(navSystem.getCurrentLat(), navSystem.getCurrentLng());
+   // Take each GPS fix as soon as the parse task publishes it (1Hz)
+   if (navSystem.updateGpsLocation()) {
+     // Readings are placed in the free-space history by walking heading
+     obstacleDetector.setHeading(navSystem.getCurrentHeading());
+     
+     // Map timestamps are wall-clock time, so obstacles age across reboots
+     uint32_t unixTime;
+     if (navSystem.getUnixTime(unixTime)) {
+       mapSystem.setTime(unixTime);
      }
      
-     lastGpsUpdate = millis();
+     // Update map with new location
+     mapSystem.updateCurrentPosition(navSystem.getCurrentLat(), navSystem.getCurrentLng());
+     mapSystem.updateMotion(navSystem.getCurrentHeading(), navSystem.getCurrentSpeed());
    }
    
    // Update feedback system at specified interval
@@ -114,11 +125,13 @@
      digitalWrite(VIBRATE_WARNING, HIGH);
      
      // Get obstacle classification
-     String obstacleType = aiClassifier.classifyObstacle();
+     ObstacleType obstacleType = aiClassifier.classifyObstacle();
      
      // Provide audio feedback with obstacle type
-     if (obstacleType != "unknown") {
-       speakMessage(obstacleType + " ahead");
+     if (obstacleType != ObstacleType::UNKNOWN) {
+       char message[32];
+       snprintf(message, sizeof(message), "%s ahead", obstacleTypeLabel(obstacleType));
+       speakMessage(message);
      } else {
        speakMessage("Obstacle ahead");
      }
@@ -135,7 +148,7 @@
    }
    
    // Process upper sensor data (for head-height obstacles)
-   if (distUpper < obstacleDetector.getWarningThreshold()) {
+   if (distUpper < obstacleDetector.getWarningThreshold(SENSOR_UPPER)) {
      // Upper obstacle detected
      digitalWrite(VIBRATE_WARNING, HIGH);
      speakMessage("Head-height obstacle");
@@ -146,7 +159,7 @@
    // If obstacle detected, suggest direction and update map
    if (obstacleDetected) {
      // Update map with obstacle
-     String obstacleType = aiClassifier.getLastObstacleType();
+     ObstacleType obstacleType = aiClassifier.getLastObstacleType();
      mapSystem.addObstacle(navSystem.getCurrentLat(), navSystem.getCurrentLng(), obstacleType);
      
      // Get suggested direction
@@ -176,7 +189,7 @@
    
    // Announce if it's a new instruction
    if (navSystem.isNewInstruction()) {
-     speakMessage(instruction);
+     speakMessage(instruction.c_str());
    }
    
    // Provide haptic feedback for direction
@@ -245,8 +258,9 @@
  }
  
  // Function to output spoken messages
- void speakMessage(String message) {
-   Serial.println("SPEECH: " + message);
+ void speakMessage(const char* message) {
+   Serial.print("SPEECH: ");
+   Serial.println(message);
    // In a real implementation, this would use text-to-speech
    // or pre-recorded audio messages
  }
\ No newline at end of file
@@ -0,0 +1,157 @@
+/*
+ * SpatialGrid.h
+ *
+ * Uniform grid over latitude/longitude for map radius queries. Entries
+ * are the caller's node indices, chained per hash bucket, so inserting
+ * and removing are O(1) and O(bucket) and a query only walks the cells
+ * its bounding box touches. The grid only narrows the candidates; the
+ * caller still checks the exact distance. No Arduino dependencies.
+ */
+
+ #ifndef SPATIAL_GRID_H
+ #define SPATIAL_GRID_H
+ 
+ #include <stdint.h>
+ #include <math.h>
+ 
+ #define GRID_CELL_M 10.0              // Cell edge, twice the node proximity threshold
+ #define GRID_METERS_PER_DEG 111194.93  // One degree of a great circle on the 6371 km sphere
+ #define GRID_MIN_COS_LAT 0.01         // Keeps longitude cells finite near the poles
+ #define GRID_CELL_LIMIT 32767         // Cells further from the origin share the edge cells
+ 
+ template <int CAPACITY, int BUCKETS>
+ class SpatialGrid {
+   static_assert(BUCKETS > 0 && (BUCKETS & (BUCKETS - 1)) == 0, "Bucket count must be a power of two");
+   
+   private:
+     int32_t head[BUCKETS];      // First entry per bucket, -1 if empty
+     int32_t next[CAPACITY];     // Next entry in the same bucket
+     int16_t cellX[CAPACITY];    // Cell of each entry relative to the origin cell
+     int16_t cellY[CAPACITY];
+     int count;
+     
+     // Longitude cells are sized at the latitude of the first entry
+     bool hasOrigin;
+     int32_t originX;
+     int32_t originY;
+     double degPerCellLat;
+     double degPerCellLng;
+     
+     static double cosLat(float lat) {
+       double c = cos(lat * M_PI / 180.0);
+       return c < GRID_MIN_COS_LAT ? GRID_MIN_COS_LAT : c;
+     }
+     
+     static int16_t clampCell(double absolute, int32_t origin) {
+       double cell = floor(absolute) - origin;
+       if (cell > GRID_CELL_LIMIT) return GRID_CELL_LIMIT;
+       if (cell < -GRID_CELL_LIMIT) return -GRID_CELL_LIMIT;
+       return (int16_t)cell;
+     }
+     
+     int16_t toCellX(double lng) const { return clampCell(lng / degPerCellLng, originX); }
+     int16_t toCellY(double lat) const { return clampCell(lat / degPerCellLat, originY); }
+     
+     static uint32_t bucketOf(int x, int y) {
+       return (((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u)) & (BUCKETS - 1);
+     }
+     
+   public:
+     SpatialGrid() {
+       clear();
+     }
+     
+     void clear() {
+       for (int b = 0; b < BUCKETS; b++) {
+         head[b] = -1;
+       }
+       count = 0;
+       hasOrigin = false;
+     }
+     
+     void insert(int index, float lat, float lng) {
+       if (!hasOrigin) {
+         degPerCellLat = GRID_CELL_M / GRID_METERS_PER_DEG;
+         degPerCellLng = degPerCellLat / cosLat(lat);
+         originX = (int32_t)floor(lng / degPerCellLng);
+         originY = (int32_t)floor(lat / degPerCellLat);
+         hasOrigin = true;
+       }
+       
+       cellX[index] = toCellX(lng);
+       cellY[index] = toCellY(lat);
+       uint32_t b = bucketOf(cellX[index], cellY[index]);
+       next[index] = head[b];
+       head[b] = index;
+       count++;
+     }
+     
+     // Returns false if the index was not in the grid
+     bool remove(int index) {
+       if (count == 0) {
+         return false;
+       }
+       
+       int32_t* link = &head[bucketOf(cellX[index], cellY[index])];
+       while (*link >= 0) {
+         if (*link == index) {
+           *link = next[index];
+           count--;
+           return true;
+         }
+         link = &next[*link];
+       }
+       return false;
+     }
+     
+     void move(int index, float lat, float lng) {
+       if (remove(index)) {
+         insert(index, lat, lng);
+       }
+     }
+     
+     // Call visit(index) once for every entry in a cell overlapping the
+     // square of the given radius around (lat, lng). Stops early if
+     // visit returns false.
+     template <typename Visitor>
+     void forEachNear(float lat, float lng, float radius, Visitor& visit) const {
+       if (count == 0) {
+         return;
+       }
+       
+       double dLat = radius / GRID_METERS_PER_DEG;
+       // Widest at the poleward edge of the box
+       double dLng = dLat / cosLat(fabs(lat) + dLat);
+       int x0 = toCellX(lng - dLng);
+       int x1 = toCellX(lng + dLng);
+       int y0 = toCellY(lat - dLat);
+       int y1 = toCellY(lat + dLat);
+       
+       // Large areas are cheaper to find by walking every bucket once
+       if ((long)(x1 - x0 + 1) * (y1 - y0 + 1) >= BUCKETS) {
+         for (int b = 0; b < BUCKETS; b++) {
+           for (int32_t i = head[b]; i >= 0; i = next[i]) {
+             if (cellX[i] >= x0 && cellX[i] <= x1 && cellY[i] >= y0 && cellY[i] <= y1 && !visit(i)) {
+               return;
+             }
+           }
+         }
+         return;
+       }
+       
+       // Buckets are shared by distant cells, so filter on the exact cell
+       for (int y = y0; y <= y1; y++) {
+         for (int x = x0; x <= x1; x++) {
+           for (int32_t i = head[bucketOf(x, y)]; i >= 0; i = next[i]) {
+             if (cellX[i] == x && cellY[i] == y && !visit(i)) {
+               return;
+             }
+           }
+         }
+       }
+     }
+     
+     int size() const { return count; }
+ };
+ 
+ #endif
\ No newline at end of file
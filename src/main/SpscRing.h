@@ -0,0 +1,58 @@
+/*
+ * SpscRing.h
+ *
+ * Lock-free single-producer/single-consumer ring buffer used to hand
+ * data from interrupt context to the main loop, or between tasks
+ */
+
+ #ifndef SPSC_RING_H
+ #define SPSC_RING_H
+ 
+ #include <stdint.h>
+ #include <atomic>
+ 
+ template <typename T, uint16_t SIZE>
+ class SpscRing {
+   static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "SpscRing size must be a power of two");
+   
+   private:
+     T items[SIZE];
+     std::atomic<uint16_t> head; // Next slot to write (owned by producer)
+     std::atomic<uint16_t> tail; // Next slot to read (owned by consumer)
+     std::atomic<uint16_t> overruns;
+     
+   public:
+     SpscRing() : head(0), tail(0), overruns(0) {}
+     
+     // Producer side, safe to call from an ISR. Drops the item if full.
+     bool push(const T& item) {
+       uint16_t h = head.load(std::memory_order_relaxed);
+       uint16_t next = (h + 1) & (SIZE - 1);
+       if (next == tail.load(std::memory_order_acquire)) {
+         overruns.fetch_add(1, std::memory_order_relaxed);
+         return false;
+       }
+       items[h] = item;
+       head.store(next, std::memory_order_release);
+       return true;
+     }
+     
+     // Consumer side
+     bool pop(T& item) {
+       uint16_t t = tail.load(std::memory_order_relaxed);
+       if (t == head.load(std::memory_order_acquire)) {
+         return false;
+       }
+       item = items[t];
+       tail.store((t + 1) & (SIZE - 1), std::memory_order_release);
+       return true;
+     }
+     
+     bool isEmpty() const {
+       return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+     }
+     
+     uint16_t getOverruns() const { return overruns.load(std::memory_order_relaxed); }
+ };
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,54 @@
+/*
+ * SpscSlot.h
+ *
+ * Lock-free single-producer/single-consumer slot holding the latest value
+ * (a triple buffer). The producer never waits and the consumer always
+ * reads a whole value; values it did not get to in time are replaced.
+ */
+
+ #ifndef SPSC_SLOT_H
+ #define SPSC_SLOT_H
+ 
+ #include <stdint.h>
+ #include <atomic>
+ 
+ template <typename T>
+ class SpscSlot {
+   private:
+     static const uint8_t INDEX_MASK = 0x03;
+     static const uint8_t FRESH = 0x04;  // Middle buffer not read yet
+     
+     T buffers[3];
+     std::atomic<uint8_t> middle;  // Buffer handed between the two sides
+     uint8_t back;                 // Written by the producer
+     uint8_t front;                // Read by the consumer
+     std::atomic<uint16_t> replaced;
+     
+   public:
+     SpscSlot() : middle(1), back(0), front(2), replaced(0) {}
+     
+     // Producer side
+     void publish(const T& value) {
+       buffers[back] = value;
+       uint8_t previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+       back = previous & INDEX_MASK;
+       if (previous & FRESH) {
+         replaced.fetch_add(1, std::memory_order_relaxed);
+       }
+     }
+     
+     // Consumer side. False if nothing new was published since the last read.
+     bool read(T& value) {
+       if (!(middle.load(std::memory_order_acquire) & FRESH)) {
+         return false;
+       }
+       uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+       front = previous & INDEX_MASK;
+       value = buffers[front];
+       return true;
+     }
+     
+     uint16_t getReplaced() const { return replaced.load(std::memory_order_relaxed); }
+ };
+ 
+ #endif
\ No newline at end of file
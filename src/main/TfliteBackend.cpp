@@ -0,0 +1,139 @@
+/*
+ * TfliteBackend.cpp
+ *
+ * Implementation of the TensorFlow Lite Micro inference backend
+ */
+
+ #include "TfliteBackend.h"
+ 
+ #ifdef SMARTGUIDE_USE_TFLITE
+ 
+ #include <new>
+ #include "tensorflow/lite/micro/micro_interpreter.h"
+ #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+ #include "tensorflow/lite/schema/schema_generated.h"
+ #include "model_data.h"
+ #include "model_ops.h"
+ 
+ // Ops listed by export_model.py from the exported flatbuffer
+ #define ADD_MODEL_OP(name) if (opResolver.Add##name() != kTfLiteOk) { status = ModelStatus::BAD_OPS; return false; }
+ 
+ namespace {
+   alignas(16) uint8_t tensorArena[CLASSIFIER_ARENA_BYTES];
+   alignas(alignof(tflite::MicroInterpreter)) uint8_t interpreterStorage[sizeof(tflite::MicroInterpreter)];
+   tflite::MicroMutableOpResolver<MODEL_OP_COUNT> opResolver;
+   bool opsAdded = false;
+ }
+ 
+ #endif
+ 
+ TfliteBackend::TfliteBackend() {
+   interpreter = 0;
+   input = 0;
+   inputBytes = 0;
+   inputScale = 1.0;
+   inputZeroPoint = 0;
+   output = 0;
+   outputCount = 0;
+   outputScale = 1.0;
+   outputZeroPoint = 0;
+   arenaUsed = 0;
+   status = ModelStatus::NOT_BUILT;
+ }
+ 
+ const char* TfliteBackend::getStatusText() const {
+   switch (status) {
+     case ModelStatus::READY: return "ready";
+     case ModelStatus::NOT_BUILT: return "built without TFLite Micro";
+     case ModelStatus::BAD_VERSION: return "model schema version mismatch";
+     case ModelStatus::BAD_OPS: return "op resolver refused a model op";
+     case ModelStatus::ALLOCATE_FAILED: return "tensor allocation failed";
+     case ModelStatus::BAD_TENSORS: return "unexpected input or output tensor";
+   }
+   return "unknown";
+ }
+ 
+ #ifdef SMARTGUIDE_USE_TFLITE
+ 
+ bool TfliteBackend::begin(int expectedInputs) {
+   if (interpreter) {
+     return true;
+   }
+   
+   const tflite::Model* model = tflite::GetModel(g_model_data);
+   if (model->version() != TFLITE_SCHEMA_VERSION) {
+     status = ModelStatus::BAD_VERSION;
+     return false;
+   }
+   
+   // Only the ops the model needs, keeps the binary small. A model that
+   // uses anything else fails AllocateTensors below.
+   if (!opsAdded) {
+     MODEL_OPS(ADD_MODEL_OP)
+     opsAdded = true;
+   }
+   
+   tflite::MicroInterpreter* micro = new (interpreterStorage)
+     tflite::MicroInterpreter(model, opResolver, tensorArena, CLASSIFIER_ARENA_BYTES);
+   if (micro->AllocateTensors() != kTfLiteOk) {
+     micro->~MicroInterpreter();
+     status = ModelStatus::ALLOCATE_FAILED;
+     return false;
+   }
+   
+   TfLiteTensor* in = micro->input(0);
+   TfLiteTensor* out = micro->output(0);
+   if (in->type != kTfLiteInt8 || out->type != kTfLiteInt8 || (int)in->bytes != expectedInputs) {
+     micro->~MicroInterpreter();
+     status = ModelStatus::BAD_TENSORS;
+     return false;
+   }
+   
+   input = in->data.int8;
+   inputBytes = in->bytes;
+   inputScale = in->params.scale;
+   inputZeroPoint = in->params.zero_point;
+   output = out->data.int8;
+   outputCount = out->bytes;
+   outputScale = out->params.scale;
+   outputZeroPoint = out->params.zero_point;
+   arenaUsed = micro->arena_used_bytes();
+   
+   interpreter = micro;
+   status = ModelStatus::READY;
+   return true;
+ }
+ 
+ bool TfliteBackend::invoke(int& bestClass, float& confidence) {
+   if (!interpreter) {
+     return false;
+   }
+   
+   tflite::MicroInterpreter* micro = (tflite::MicroInterpreter*)interpreter;
+   if (micro->Invoke() != kTfLiteOk) {
+     return false;
+   }
+   
+   // Argmax on the quantized scores, only the winner is dequantized
+   bestClass = 0;
+   for (int i = 1; i < outputCount; i++) {
+     if (output[i] > output[bestClass]) {
+       bestClass = i;
+     }
+   }
+   confidence = (output[bestClass] - outputZeroPoint) * outputScale;
+   return true;
+ }
+ 
+ #else
+ 
+ bool TfliteBackend::begin(int) {
+   // Built without TensorFlow Lite Micro
+   return false;
+ }
+ 
+ bool TfliteBackend::invoke(int&, float&) {
+   return false;
+ }
+ 
+ #endif
\ No newline at end of file
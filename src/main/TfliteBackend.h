@@ -0,0 +1,73 @@
+/*
+ * TfliteBackend.h
+ *
+ * TensorFlow Lite for Microcontrollers inference for the obstacle
+ * classifier: int8 model from model_data.h, statically sized tensor
+ * arena and an op resolver holding only the ops the model uses, as
+ * listed in the generated model_ops.h.
+ * Compiled in when SMARTGUIDE_USE_TFLITE is defined, otherwise begin()
+ * fails and the classifier keeps its heuristic rules; getStatus() says
+ * why. No Arduino dependencies, so it also builds on Linux against the
+ * reference kernels.
+ */
+
+ #ifndef TFLITE_BACKEND_H
+ #define TFLITE_BACKEND_H
+ 
+ #include <stdint.h>
+ #include <stddef.h>
+ 
+ // Tensor arena, sized for the two-layer int8 classifier with headroom
+ #ifndef CLASSIFIER_ARENA_BYTES
+ #define CLASSIFIER_ARENA_BYTES (16 * 1024)
+ #endif
+ 
+ enum class ModelStatus : uint8_t {
+   READY,
+   NOT_BUILT,        // Compiled without SMARTGUIDE_USE_TFLITE
+   BAD_VERSION,      // Flatbuffer schema version is not the one TFLM reads
+   BAD_OPS,          // The op resolver refused an op from model_ops.h
+   ALLOCATE_FAILED,  // Arena too small, or the model uses an op not registered
+   BAD_TENSORS       // Input or output is not int8, or not the expected size
+ };
+ 
+ class TfliteBackend {
+   private:
+     void* interpreter;       // tflite::MicroInterpreter, kept out of this header
+     int8_t* input;
+     int inputBytes;
+     float inputScale;
+     int inputZeroPoint;
+     const int8_t* output;
+     int outputCount;
+     float outputScale;
+     int outputZeroPoint;
+     size_t arenaUsed;
+     ModelStatus status;
+     
+   public:
+     TfliteBackend();
+     
+     // Load the model and allocate tensors. Fails if the model is missing,
+     // does not fit the arena or its input is not expectedInputs int8 values.
+     bool begin(int expectedInputs);
+     bool isReady() const { return interpreter != 0; }
+     ModelStatus getStatus() const { return status; }
+     const char* getStatusText() const;
+     
+     // Quantized input tensor, filled directly by the caller
+     int8_t* getInput() { return input; }
+     float getInputScale() const { return inputScale; }
+     int getInputZeroPoint() const { return inputZeroPoint; }
+     
+     // Run the model, returns the most likely class and its probability
+     bool invoke(int& bestClass, float& confidence);
+     
+     int getClassCount() const { return outputCount; }
+     
+     // Arena high-water mark after tensor allocation
+     size_t getArenaUsedBytes() const { return arenaUsed; }
+     size_t getArenaBytes() const { return CLASSIFIER_ARENA_BYTES; }
+ };
+ 
+ #endif
\ No newline at end of file
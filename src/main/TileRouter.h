@@ -0,0 +1,255 @@
+/*
+ * TileRouter.h
+ *
+ * A* route search over a paged TileStore. Nodes are named by TileRef and
+ * their tiles are faulted in as the search reaches them, so a route may
+ * cross more tiles than fit in memory at once. Search state lives in a
+ * fixed table of MAX_SEARCH entries found through an open-addressing
+ * hash; a search that needs more entries fails rather than allocating.
+ * No Arduino dependencies.
+ */
+
+ #ifndef TILE_ROUTER_H
+ #define TILE_ROUTER_H
+ 
+ #include <stdint.h>
+ #include <math.h>
+ #include "TileStore.h"
+ 
+ #ifndef TILE_ROUTE_MAX_PATH
+ #define TILE_ROUTE_MAX_PATH 512
+ #endif
+ #define TILE_ROUTE_HEURISTIC_SCALE 0.999f   // Keeps the flat-earth estimate below the haversine cost
+ 
+ enum class TileRouteStatus : uint8_t {
+   FOUND,
+   NO_ROUTE,
+   SEARCH_FULL,    // Ran out of search entries before reaching the goal
+   PATH_TOO_LONG,  // Route has more than TILE_ROUTE_MAX_PATH nodes
+   NOT_FOUND       // Start or goal is not a node of the archive
+ };
+ 
+ template <int MAX_SEARCH>
+ class TileRouter {
+   static_assert((MAX_SEARCH & (MAX_SEARCH - 1)) == 0, "MAX_SEARCH must be a power of two");
+   
+   private:
+     static const int HASH_SIZE = 2 * MAX_SEARCH;
+     static const int32_t EMPTY = -1;
+     static const int32_t CLOSED = -2;
+     
+     // Search entries, one per node reached
+     TileRef ref[MAX_SEARCH];
+     float g[MAX_SEARCH];
+     int32_t parent[MAX_SEARCH];
+     int32_t heapPos[MAX_SEARCH];
+     int32_t entryCount;
+     int32_t bucket[HASH_SIZE];
+     
+     // Open set ordered by f = g + h
+     int32_t heap[MAX_SEARCH];
+     float heapKey[MAX_SEARCH];
+     int heapSize;
+     
+     TileRef path[TILE_ROUTE_MAX_PATH];
+     int pathLength;
+     float pathCost;
+     uint32_t expanded;
+     
+     // Goal position for the heuristic
+     float goalLat, goalLng, goalCos;
+     
+     static uint32_t hashOf(const TileRef& node) {
+       uint32_t h = (uint32_t)node.x * 73856093u ^ (uint32_t)node.y * 19349663u ^ (uint32_t)node.index * 83492791u;
+       return h ^ (h >> 15);
+     }
+     
+     // Entry of a node, adding it if new. EMPTY if the table is full.
+     int32_t entryOf(const TileRef& node, bool& added) {
+       added = false;
+       for (uint32_t slot = hashOf(node) & (HASH_SIZE - 1); ; slot = (slot + 1) & (HASH_SIZE - 1)) {
+         int32_t entry = bucket[slot];
+         if (entry == EMPTY) {
+           if (entryCount >= MAX_SEARCH) {
+             return EMPTY;
+           }
+           entry = entryCount++;
+           bucket[slot] = entry;
+           ref[entry] = node;
+           added = true;
+           return entry;
+         }
+         if (ref[entry] == node) {
+           return entry;
+         }
+       }
+     }
+     
+     // Flat-earth distance, measuring longitude at the more poleward end
+     float heuristic(float lat, float lng) const {
+       float north = (lat - goalLat) * TILE_METERS_PER_DEG;
+       float cosLat = fabsf(lat) > fabsf(goalLat) ? cosf(lat * (float)M_PI / 180.0f) : goalCos;
+       float east = (lng - goalLng) * TILE_METERS_PER_DEG * cosLat;
+       return sqrtf(north * north + east * east) * TILE_ROUTE_HEURISTIC_SCALE;
+     }
+     
+     void place(int pos, int32_t entry, float key) {
+       heap[pos] = entry;
+       heapKey[pos] = key;
+       heapPos[entry] = pos;
+     }
+     
+     void siftUp(int pos) {
+       int32_t entry = heap[pos];
+       float key = heapKey[pos];
+       while (pos > 0) {
+         int up = (pos - 1) / 2;
+         if (heapKey[up] <= key) {
+           break;
+         }
+         place(pos, heap[up], heapKey[up]);
+         pos = up;
+       }
+       place(pos, entry, key);
+     }
+     
+     void siftDown(int pos) {
+       int32_t entry = heap[pos];
+       float key = heapKey[pos];
+       while (true) {
+         int child = 2 * pos + 1;
+         if (child >= heapSize) {
+           break;
+         }
+         if (child + 1 < heapSize && heapKey[child + 1] < heapKey[child]) {
+           child++;
+         }
+         if (key <= heapKey[child]) {
+           break;
+         }
+         place(pos, heap[child], heapKey[child]);
+         pos = child;
+       }
+       place(pos, entry, key);
+     }
+     
+     int32_t popMin() {
+       int32_t best = heap[0];
+       heapSize--;
+       if (heapSize > 0) {
+         place(0, heap[heapSize], heapKey[heapSize]);
+         siftDown(0);
+       }
+       heapPos[best] = CLOSED;
+       return best;
+     }
+     
+     // Relaxes the edges of one expanded node
+     template <typename Tiles>
+     struct Relax {
+       TileRouter* router;
+       Tiles* tiles;
+       int32_t from;
+       bool full;
+       
+       void operator()(const TileRef& target, float weight) {
+         bool added;
+         int32_t next = router->entryOf(target, added);
+         if (next == EMPTY) {
+           full = true;
+           return;
+         }
+         float tentative = router->g[from] + weight;
+         if (added) {
+           float lat, lng;
+           if (!tiles->getNode(target, lat, lng)) {
+             router->heapPos[next] = CLOSED;  // Dangling edge, never expand it
+             return;
+           }
+           router->g[next] = tentative;
+           router->parent[next] = from;
+           router->place(router->heapSize, next, tentative + router->heuristic(lat, lng));
+           router->siftUp(router->heapSize++);
+         } else if (router->heapPos[next] != CLOSED && tentative < router->g[next]) {
+           float h = router->heapKey[router->heapPos[next]] - router->g[next];
+           router->g[next] = tentative;
+           router->parent[next] = from;
+           router->heapKey[router->heapPos[next]] = tentative + h;
+           router->siftUp(router->heapPos[next]);
+         }
+       }
+     };
+     
+   public:
+     TileRouter() {
+       pathLength = 0;
+       pathCost = 0;
+       expanded = 0;
+     }
+     
+     template <typename Tiles>
+     TileRouteStatus findPath(Tiles& tiles, const TileRef& start, const TileRef& goal) {
+       pathLength = 0;
+       pathCost = 0;
+       expanded = 0;
+       
+       float startLat, startLng;
+       if (!tiles.getNode(goal, goalLat, goalLng) || !tiles.getNode(start, startLat, startLng)) {
+         return TileRouteStatus::NOT_FOUND;
+       }
+       goalCos = cosf(goalLat * (float)M_PI / 180.0f);
+       
+       entryCount = 0;
+       for (int i = 0; i < HASH_SIZE; i++) {
+         bucket[i] = EMPTY;
+       }
+       heapSize = 0;
+       
+       bool added;
+       int32_t first = entryOf(start, added);
+       g[first] = 0;
+       parent[first] = EMPTY;
+       place(heapSize++, first, heuristic(startLat, startLng));
+       
+       Relax<Tiles> relax = {this, &tiles, EMPTY, false};
+       int32_t reached = EMPTY;
+       while (heapSize > 0 && !relax.full) {
+         int32_t entry = popMin();
+         expanded++;
+         if (ref[entry] == goal) {
+           reached = entry;
+           break;
+         }
+         relax.from = entry;
+         tiles.forEachEdge(ref[entry], relax);
+       }
+       
+       if (reached == EMPTY) {
+         return relax.full ? TileRouteStatus::SEARCH_FULL : TileRouteStatus::NO_ROUTE;
+       }
+       
+       // Walk back from the goal, then reverse into start-to-goal order
+       for (int32_t e = reached; e != EMPTY; e = parent[e]) {
+         if (pathLength >= TILE_ROUTE_MAX_PATH) {
+           pathLength = 0;
+           return TileRouteStatus::PATH_TOO_LONG;
+         }
+         path[pathLength++] = ref[e];
+       }
+       for (int i = 0, j = pathLength - 1; i < j; i++, j--) {
+         TileRef swap = path[i];
+         path[i] = path[j];
+         path[j] = swap;
+       }
+       pathCost = g[reached];
+       return TileRouteStatus::FOUND;
+     }
+     
+     const TileRef* getPath() const { return path; }
+     int getPathLength() const { return pathLength; }
+     float getPathCost() const { return pathCost; }
+     uint32_t getExpandedCount() const { return expanded; }
+     int getSearchUsed() const { return entryCount; }
+ };
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,461 @@
+/*
+ * TileStore.h
+ *
+ * Pages a large, read-only map (for example an imported street map)
+ * from a tile archive on the SD card. The archive cuts the map into
+ * square tiles of a fixed size in degrees. Only SLOTS tiles are held in
+ * memory, and a slot is reused least-recently-used first. Queries fault
+ * in the tiles they touch, and prefetch() loads the tiles the user is
+ * walking towards before they are needed.
+ *
+ * Archive layout (little-endian):
+ *   header  32 bytes: "SGTA", version, header size, tile count, tile
+ *           size in 1e-7 degrees, reserved, CRC-32 of the rest
+ *   index   16 bytes per tile, sorted by (x, y): tile x, tile y, offset
+ *           and size of its data
+ *   tiles   node count, edge count, 12-byte nodes (lat/lng in 1e-7
+ *           degrees, type, obstacle type), 12-byte edges sorted by
+ *           source (source, target, target tile offset, weight), CRC-32
+ *
+ * Edges are stored at both ends, so a tile lists every way out of its
+ * nodes. TileWriter produces archives; reading needs seek() and read()
+ * like an SD File. No Arduino dependencies.
+ */
+
+ #ifndef TILE_STORE_H
+ #define TILE_STORE_H
+ 
+ #include <stdint.h>
+ #include <string.h>
+ #include <math.h>
+ #include "Crc32.h"
+ #include "MapFile.h"
+ #include "ObstacleTypes.h"
+ 
+ #define TILE_VERSION 1
+ #define TILE_HEADER_BYTES 32
+ #define TILE_INDEX_BYTES 16
+ #define TILE_RECORD_BYTES 12          // Node and edge records alike
+ #define TILE_MAX_DEGREE 16            // Edges per node a query hands out
+ #define TILE_METERS_PER_DEG 111194.93 // Same sphere as the haversine distances
+ #define TILE_MIN_COS_LAT 0.01
+ #define TILE_PREFETCH_SECONDS 60.0    // How far ahead to load, in walking time
+ #define TILE_PREFETCH_MIN_M 50.0
+ 
+ // A tile, and a node within one
+ struct TileKey {
+   int32_t x;
+   int32_t y;
+ };
+ 
+ struct TileRef {
+   int32_t x;
+   int32_t y;
+   uint16_t index;
+   
+   bool operator==(const TileRef& other) const { return x == other.x && y == other.y && index == other.index; }
+   bool operator!=(const TileRef& other) const { return !(*this == other); }
+ };
+ 
+ // Writes an archive in three passes over the tiles, all in (x, y) order:
+ // writeHeader, writeIndex for each tile, then each tile's nodes and edges.
+ class TileWriter {
+   private:
+     uint8_t record[TILE_HEADER_BYTES];
+     uint32_t nextOffset;
+     uint32_t crc;
+     
+     template <typename Output>
+     bool put(Output& out, const uint8_t* data, size_t length) {
+       crc = crc32Update(crc, data, length);
+       return (size_t)out.write(data, length) == length;
+     }
+     
+   public:
+     static uint32_t tileBytes(uint16_t nodes, uint16_t edges) {
+       return 4 + (uint32_t)(nodes + edges) * TILE_RECORD_BYTES + 4;
+     }
+     
+     template <typename Output>
+     bool writeHeader(Output& out, uint32_t tileCount, uint32_t tileDegE7) {
+       memset(record, 0, TILE_HEADER_BYTES);
+       memcpy(record, "SGTA", 4);
+       MapFile::put16(record + 4, TILE_VERSION);
+       MapFile::put16(record + 6, TILE_HEADER_BYTES);
+       MapFile::put32(record + 8, tileCount);
+       MapFile::put32(record + 12, tileDegE7);
+       MapFile::put32(record + 28, crc32(record, 28));
+       nextOffset = TILE_HEADER_BYTES + tileCount * TILE_INDEX_BYTES;
+       return (size_t)out.write(record, TILE_HEADER_BYTES) == TILE_HEADER_BYTES;
+     }
+     
+     template <typename Output>
+     bool writeIndex(Output& out, TileKey key, uint16_t nodes, uint16_t edges) {
+       MapFile::put32(record, key.x);
+       MapFile::put32(record + 4, key.y);
+       MapFile::put32(record + 8, nextOffset);
+       MapFile::put32(record + 12, tileBytes(nodes, edges));
+       nextOffset += tileBytes(nodes, edges);
+       return (size_t)out.write(record, TILE_INDEX_BYTES) == TILE_INDEX_BYTES;
+     }
+     
+     template <typename Output>
+     bool beginTile(Output& out, uint16_t nodes, uint16_t edges) {
+       crc = CRC32_INITIAL;
+       MapFile::put16(record, nodes);
+       MapFile::put16(record + 2, edges);
+       return put(out, record, 4);
+     }
+     
+     template <typename Output>
+     bool writeNode(Output& out, float lat, float lng, NodeType type, ObstacleType obstacle) {
+       MapFile::put32(record, MapFile::toFixed(lat));
+       MapFile::put32(record + 4, MapFile::toFixed(lng));
+       record[8] = (uint8_t)type;
+       record[9] = (uint8_t)obstacle;
+       MapFile::put16(record + 10, 0);
+       return put(out, record, TILE_RECORD_BYTES);
+     }
+     
+     // Target is a node of this tile, or of the tile dx, dy tiles away
+     template <typename Output>
+     bool writeEdge(Output& out, uint16_t source, uint16_t target, int8_t dx, int8_t dy, float weight) {
+       MapFile::put16(record, source);
+       MapFile::put16(record + 2, target);
+       record[4] = (uint8_t)dx;
+       record[5] = (uint8_t)dy;
+       MapFile::put16(record + 6, 0);
+       MapFile::put32(record + 8, MapFile::floatBits(weight));
+       return put(out, record, TILE_RECORD_BYTES);
+     }
+     
+     template <typename Output>
+     bool endTile(Output& out) {
+       MapFile::put32(record, crc32Final(crc));
+       return (size_t)out.write(record, 4) == 4;
+     }
+ };
+ 
+ template <typename FileT, int SLOTS, int TILE_NODES, int TILE_EDGES>
+ class TileStore {
+   static_assert(TILE_NODES < 65536 && TILE_EDGES < 65536, "Tile records use 16-bit indexes");
+   
+   private:
+     FileT* archive;
+     uint32_t tileCount;
+     double tileDeg;
+     
+     // Resident tiles. A slot with slotUsed == 0 is free.
+     int32_t slotX[SLOTS];
+     int32_t slotY[SLOTS];
+     uint32_t slotUsed[SLOTS];
+     uint16_t slotNodes[SLOTS];
+     
+     int32_t nodeLat[SLOTS][TILE_NODES];   // 1e-7 degrees
+     int32_t nodeLng[SLOTS][TILE_NODES];
+     uint8_t nodeType[SLOTS][TILE_NODES];
+     uint8_t nodeObstacle[SLOTS][TILE_NODES];
+     uint16_t firstEdge[SLOTS][TILE_NODES + 1];   // Edges of n: firstEdge[n] .. firstEdge[n + 1]
+     
+     uint16_t edgeTarget[SLOTS][TILE_EDGES];
+     int8_t edgeDx[SLOTS][TILE_EDGES];
+     int8_t edgeDy[SLOTS][TILE_EDGES];
+     float edgeWeight[SLOTS][TILE_EDGES];
+     
+     uint32_t useTick;
+     uint32_t faults;
+     uint32_t hits;
+     uint32_t truncatedTiles;
+     
+     uint8_t buffer[16 * TILE_RECORD_BYTES];
+     
+     bool readAt(uint32_t offset, uint8_t* data, size_t length) {
+       return archive->seek(offset) && (size_t)archive->read(data, length) == length;
+     }
+     
+     // Binary search of the index for a tile's data
+     bool findTile(int32_t x, int32_t y, uint32_t& offset, uint32_t& bytes) {
+       int32_t low = 0, high = (int32_t)tileCount - 1;
+       while (low <= high) {
+         int32_t middle = (low + high) / 2;
+         if (!readAt(TILE_HEADER_BYTES + middle * TILE_INDEX_BYTES, buffer, TILE_INDEX_BYTES)) {
+           return false;
+         }
+         int32_t mx = MapFile::get32(buffer);
+         int32_t my = MapFile::get32(buffer + 4);
+         if (mx == x && my == y) {
+           offset = MapFile::get32(buffer + 8);
+           bytes = MapFile::get32(buffer + 12);
+           return true;
+         }
+         if (mx < x || (mx == x && my < y)) {
+           low = middle + 1;
+         } else {
+           high = middle - 1;
+         }
+       }
+       return false;
+     }
+     
+     // Read a tile into a slot. Tiles missing from the archive, or that
+     // fail their CRC, become empty so they are not looked up again.
+     void readTile(int slot, int32_t x, int32_t y) {
+       slotNodes[slot] = 0;
+       
+       uint32_t offset, bytes;
+       if (!findTile(x, y, offset, bytes) || !readAt(offset, buffer, 4)) {
+         return;
+       }
+       uint16_t nodes = MapFile::get16(buffer);
+       uint16_t edges = MapFile::get16(buffer + 2);
+       if (TileWriter::tileBytes(nodes, edges) != bytes) {
+         return;
+       }
+       uint32_t crc = crc32Update(CRC32_INITIAL, buffer, 4);
+       
+       // Keep what fits; the CRC still covers the whole tile. firstEdge
+       // counts edges per node until the end.
+       uint16_t keptNodes = nodes < TILE_NODES ? nodes : TILE_NODES;
+       uint16_t keptEdges = 0;
+       uint16_t lastSource = 0;
+       uint16_t* counts = firstEdge[slot];
+       memset(counts, 0, sizeof(firstEdge[slot]));
+       
+       uint32_t records = nodes + edges;
+       for (uint32_t r = 0; r < records; ) {
+         uint32_t batch = records - r < 16 ? records - r : 16;
+         if ((size_t)archive->read(buffer, batch * TILE_RECORD_BYTES) != batch * TILE_RECORD_BYTES) {
+           return;
+         }
+         crc = crc32Update(crc, buffer, batch * TILE_RECORD_BYTES);
+         
+         for (uint32_t i = 0; i < batch; i++, r++) {
+           const uint8_t* p = buffer + i * TILE_RECORD_BYTES;
+           if (r < nodes) {
+             if (r < keptNodes) {
+               nodeLat[slot][r] = MapFile::get32(p);
+               nodeLng[slot][r] = MapFile::get32(p + 4);
+               nodeType[slot][r] = p[8];
+               nodeObstacle[slot][r] = p[9];
+             }
+             continue;
+           }
+           uint16_t source = MapFile::get16(p);
+           uint16_t target = MapFile::get16(p + 2);
+           if (source < lastSource) {
+             return;  // Not sorted by source
+           }
+           lastSource = source;
+           int8_t dx = (int8_t)p[4];
+           int8_t dy = (int8_t)p[5];
+           bool local = dx == 0 && dy == 0;
+           if (source < keptNodes && (!local || target < keptNodes) && keptEdges < TILE_EDGES) {
+             edgeTarget[slot][keptEdges] = target;
+             edgeDx[slot][keptEdges] = dx;
+             edgeDy[slot][keptEdges] = dy;
+             edgeWeight[slot][keptEdges++] = MapFile::bitsFloat(MapFile::get32(p + 8));
+             counts[source + 1]++;
+           }
+         }
+       }
+       
+       if ((size_t)archive->read(buffer, 4) != 4 || MapFile::get32(buffer) != crc32Final(crc)) {
+         return;
+       }
+       if (keptNodes < nodes || keptEdges < edges) {
+         truncatedTiles++;
+       }
+       
+       // Edges arrive sorted by source, so the running counts give each node's range
+       for (uint16_t n = 0; n < keptNodes; n++) {
+         counts[n + 1] += counts[n];
+       }
+       slotNodes[slot] = keptNodes;
+     }
+     
+     // Slot holding a tile, reading it into the least recently used slot if needed
+     int slotFor(int32_t x, int32_t y) {
+       int oldest = 0;
+       for (int s = 0; s < SLOTS; s++) {
+         if (slotUsed[s] != 0 && slotX[s] == x && slotY[s] == y) {
+           slotUsed[s] = ++useTick;
+           hits++;
+           return s;
+         }
+         if (slotUsed[s] < slotUsed[oldest]) {
+           oldest = s;
+         }
+       }
+       
+       faults++;
+       slotX[oldest] = x;
+       slotY[oldest] = y;
+       slotUsed[oldest] = ++useTick;
+       readTile(oldest, x, y);
+       return oldest;
+     }
+     
+     static float toDegrees(int32_t fixed) { return MapFile::fromFixed(fixed); }
+     
+   public:
+     TileStore() {
+       detach();
+     }
+     
+     // Use an open archive file. False if it is not a tile archive.
+     bool attach(FileT& file) {
+       detach();
+       archive = &file;
+       uint8_t* header = buffer;
+       if (!readAt(0, header, TILE_HEADER_BYTES) || memcmp(header, "SGTA", 4) != 0 ||
+           MapFile::get32(header + 28) != crc32(header, 28) ||
+           MapFile::get16(header + 4) != TILE_VERSION || MapFile::get32(header + 12) == 0) {
+         archive = 0;
+         return false;
+       }
+       tileCount = MapFile::get32(header + 8);
+       tileDeg = MapFile::get32(header + 12) / MAPFILE_COORD_SCALE;
+       return true;
+     }
+     
+     void detach() {
+       archive = 0;
+       tileCount = 0;
+       tileDeg = 1;
+       useTick = 0;
+       faults = 0;
+       hits = 0;
+       truncatedTiles = 0;
+       for (int s = 0; s < SLOTS; s++) {
+         slotUsed[s] = 0;
+       }
+     }
+     
+     bool isAttached() const { return archive != 0; }
+     
+     TileKey keyOf(float lat, float lng) const {
+       TileKey key = {(int32_t)floor((lng + 180.0) / tileDeg), (int32_t)floor((lat + 90.0) / tileDeg)};
+       return key;
+     }
+     
+     // Node coordinates and type, faulting its tile in
+     bool getNode(const TileRef& node, float& lat, float& lng) {
+       if (!archive) {
+         return false;
+       }
+       int slot = slotFor(node.x, node.y);
+       if (node.index >= slotNodes[slot]) {
+         return false;
+       }
+       lat = toDegrees(nodeLat[slot][node.index]);
+       lng = toDegrees(nodeLng[slot][node.index]);
+       return true;
+     }
+     
+     // visit(node, lat, lng, type, obstacleType) for the nodes within the
+     // bounding box of a circle; return false to stop. The visitor must
+     // not query the store.
+     template <typename Visitor>
+     void forEachNear(float lat, float lng, float radius, Visitor& visit) {
+       if (!archive) {
+         return;
+       }
+       double dLat = radius / TILE_METERS_PER_DEG;
+       double cosLat = cos((fabs(lat) + dLat) * M_PI / 180.0);
+       double dLng = radius / (TILE_METERS_PER_DEG * (cosLat > TILE_MIN_COS_LAT ? cosLat : TILE_MIN_COS_LAT));
+       int32_t minLat = MapFile::toFixed(lat - dLat), maxLat = MapFile::toFixed(lat + dLat);
+       int32_t minLng = MapFile::toFixed(lng - dLng), maxLng = MapFile::toFixed(lng + dLng);
+       TileKey low = keyOf(lat - dLat, lng - dLng);
+       TileKey high = keyOf(lat + dLat, lng + dLng);
+       
+       for (int32_t x = low.x; x <= high.x; x++) {
+         for (int32_t y = low.y; y <= high.y; y++) {
+           int slot = slotFor(x, y);
+           for (uint16_t n = 0; n < slotNodes[slot]; n++) {
+             int32_t nLat = nodeLat[slot][n], nLng = nodeLng[slot][n];
+             if (nLat < minLat || nLat > maxLat || nLng < minLng || nLng > maxLng) {
+               continue;
+             }
+             TileRef node = {x, y, n};
+             if (!visit(node, toDegrees(nLat), toDegrees(nLng), (NodeType)nodeType[slot][n],
+                        (ObstacleType)nodeObstacle[slot][n])) {
+               return;
+             }
+           }
+         }
+       }
+     }
+     
+     // visit(target, weight) for each edge out of a node (at most
+     // TILE_MAX_DEGREE). The visitor may query the store.
+     template <typename Visitor>
+     void forEachEdge(const TileRef& node, Visitor& visit) {
+       if (!archive) {
+         return;
+       }
+       int slot = slotFor(node.x, node.y);
+       if (node.index >= slotNodes[slot]) {
+         return;
+       }
+       
+       // Copy first: faulting in a neighbour tile may reuse this slot
+       TileRef targets[TILE_MAX_DEGREE];
+       float weights[TILE_MAX_DEGREE];
+       int degree = 0;
+       for (uint16_t e = firstEdge[slot][node.index]; e < firstEdge[slot][node.index + 1] && degree < TILE_MAX_DEGREE; e++) {
+         TileRef target = {node.x + edgeDx[slot][e], node.y + edgeDy[slot][e], edgeTarget[slot][e]};
+         targets[degree] = target;
+         weights[degree++] = edgeWeight[slot][e];
+       }
+       for (int i = 0; i < degree; i++) {
+         visit(targets[i], weights[i]);
+       }
+     }
+     
+     // Load the tiles along the walking direction, up to half the slots,
+     // then the tile underfoot so it is the last to be evicted
+     void prefetch(float lat, float lng, float headingDeg, float speedMps) {
+       if (!archive) {
+         return;
+       }
+       double tileMeters = tileDeg * TILE_METERS_PER_DEG;
+       double ahead = speedMps * TILE_PREFETCH_SECONDS;
+       if (ahead < TILE_PREFETCH_MIN_M) {
+         ahead = TILE_PREFETCH_MIN_M;
+       }
+       double cosLat = cos(lat * M_PI / 180.0);
+       double north = cos(headingDeg * M_PI / 180.0) / TILE_METERS_PER_DEG;
+       double east = sin(headingDeg * M_PI / 180.0) / (TILE_METERS_PER_DEG * (cosLat > TILE_MIN_COS_LAT ? cosLat : TILE_MIN_COS_LAT));
+       
+       TileKey here = keyOf(lat, lng);
+       TileKey last = here;
+       int loaded = 0;
+       for (double d = tileMeters / 2; d <= ahead + tileMeters / 2 && loaded < SLOTS / 2; d += tileMeters / 2) {
+         double step = d < ahead ? d : ahead;
+         TileKey key = keyOf(lat + north * step, lng + east * step);
+         if (key.x != last.x || key.y != last.y) {
+           slotFor(key.x, key.y);
+           last = key;
+           loaded++;
+         }
+       }
+       slotFor(here.x, here.y);
+     }
+     
+     bool isResident(int32_t x, int32_t y) const {
+       for (int s = 0; s < SLOTS; s++) {
+         if (slotUsed[s] != 0 && slotX[s] == x && slotY[s] == y) {
+           return true;
+         }
+       }
+       return false;
+     }
+     
+     uint32_t getTileCount() const { return tileCount; }
+     float getTileMeters() const { return tileDeg * TILE_METERS_PER_DEG; }
+     uint32_t getFaults() const { return faults; }
+     uint32_t getHits() const { return hits; }
+     uint32_t getTruncatedTiles() const { return truncatedTiles; }
+ };
+ 
+ #endif
\ No newline at end of file
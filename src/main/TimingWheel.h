@@ -0,0 +1,203 @@
+/*
+ * TimingWheel.h
+ *
+ * Hierarchical timing wheel over the caller's entry indices, for expiry
+ * times in whole seconds. Level l has 64 slots of 64^l seconds; an entry
+ * sits in the level of the highest base-64 digit where its expiry differs
+ * from the wheel time, and drops a level each time that digit comes up.
+ * Expiries more than 64^4 seconds (194 days) out wait in an overflow list.
+ *
+ * Scheduling and cancelling are O(1). Advancing finds the next occupied
+ * slot from one bit mask per level, so a jump of days costs no more than
+ * a jump of seconds: every entry is touched at most once per level on its
+ * way to expiring. No Arduino dependencies.
+ */
+
+ #ifndef TIMING_WHEEL_H
+ #define TIMING_WHEEL_H
+ 
+ #include <stdint.h>
+ 
+ #define WHEEL_LEVELS 4
+ #define WHEEL_SLOT_BITS 6
+ #define WHEEL_SLOTS (1 << WHEEL_SLOT_BITS)
+ #define WHEEL_OVERFLOW (WHEEL_LEVELS * WHEEL_SLOTS)  // List past the top level
+ #define WHEEL_DUE (WHEEL_OVERFLOW + 1)               // List of entries already due
+ #define WHEEL_LISTS (WHEEL_DUE + 1)
+ #define WHEEL_NONE -1
+ 
+ template <int CAPACITY>
+ class TimingWheel {
+   static_assert(CAPACITY <= INT16_MAX, "Entries are linked with 16-bit indices");
+   
+   private:
+     uint32_t time;                  // Every expiry up to here has been reported
+     int16_t head[WHEEL_LISTS];
+     uint64_t occupied[WHEEL_LEVELS];
+     int16_t next[CAPACITY];
+     int16_t prev[CAPACITY];
+     int16_t list[CAPACITY];         // WHEEL_NONE when not scheduled
+     uint32_t expiry[CAPACITY];
+     int count;
+     
+     static int lowestBit(uint64_t bits) { return __builtin_ctzll(bits); }
+     
+     void link(int entry, int to) {
+       list[entry] = to;
+       prev[entry] = WHEEL_NONE;
+       next[entry] = head[to];
+       if (head[to] != WHEEL_NONE) {
+         prev[head[to]] = entry;
+       }
+       head[to] = entry;
+       if (to < WHEEL_OVERFLOW) {
+         occupied[to / WHEEL_SLOTS] |= 1ULL << (to % WHEEL_SLOTS);
+       }
+     }
+     
+     void unlink(int entry) {
+       int from = list[entry];
+       if (prev[entry] != WHEEL_NONE) {
+         next[prev[entry]] = next[entry];
+       } else {
+         head[from] = next[entry];
+       }
+       if (next[entry] != WHEEL_NONE) {
+         prev[next[entry]] = prev[entry];
+       }
+       if (head[from] == WHEEL_NONE && from < WHEEL_OVERFLOW) {
+         occupied[from / WHEEL_SLOTS] &= ~(1ULL << (from % WHEEL_SLOTS));
+       }
+       list[entry] = WHEEL_NONE;
+     }
+     
+     // The list for an expiry, from the highest digit that differs from now
+     int listFor(uint32_t at) const {
+       uint32_t differs = at ^ time;
+       if (at <= time) {
+         return WHEEL_DUE;
+       }
+       int level = (31 - __builtin_clz(differs)) / WHEEL_SLOT_BITS;
+       if (level >= WHEEL_LEVELS) {
+         return WHEEL_OVERFLOW;
+       }
+       return level * WHEEL_SLOTS + ((at >> (level * WHEEL_SLOT_BITS)) & (WHEEL_SLOTS - 1));
+     }
+     
+     // Earliest time after now at which a list is due, or 0 if none is
+     uint32_t nextStop() const {
+       for (int level = 0; level < WHEEL_LEVELS; level++) {
+         int shift = level * WHEEL_SLOT_BITS;
+         int digit = (time >> shift) & (WHEEL_SLOTS - 1);
+         uint64_t later = digit == WHEEL_SLOTS - 1 ? 0 : occupied[level] & (~0ULL << (digit + 1));
+         if (later) {
+           uint32_t block = time >> (shift + WHEEL_SLOT_BITS) << (shift + WHEEL_SLOT_BITS);
+           return block | ((uint32_t)lowestBit(later) << shift);
+         }
+       }
+       if (head[WHEEL_OVERFLOW] != WHEEL_NONE) {
+         return ((time >> (WHEEL_LEVELS * WHEEL_SLOT_BITS)) + 1) << (WHEEL_LEVELS * WHEEL_SLOT_BITS);
+       }
+       return 0;
+     }
+     
+     // Place every entry of a list again, relative to the new time
+     void cascade(int from) {
+       int entry = head[from];
+       while (entry != WHEEL_NONE) {
+         int following = next[entry];
+         unlink(entry);
+         link(entry, listFor(expiry[entry]));
+         entry = following;
+       }
+     }
+     
+   public:
+     TimingWheel() {
+       for (int i = 0; i < WHEEL_LISTS; i++) {
+         head[i] = WHEEL_NONE;
+       }
+       for (int i = 0; i < CAPACITY; i++) {
+         list[i] = WHEEL_NONE;
+       }
+       clear(0);
+     }
+     
+     // Forget every entry and start the wheel at the given time
+     void clear(uint32_t now) {
+       for (int i = 0; i < WHEEL_LISTS; i++) {
+         for (int entry = head[i]; entry != WHEEL_NONE; entry = next[entry]) {
+           list[entry] = WHEEL_NONE;
+         }
+         head[i] = WHEEL_NONE;
+       }
+       for (int level = 0; level < WHEEL_LEVELS; level++) {
+         occupied[level] = 0;
+       }
+       time = now;
+       count = 0;
+     }
+     
+     // Report the entry once the wheel reaches the given time, replacing
+     // any earlier schedule. Times already passed are due on the next advance.
+     void schedule(int entry, uint32_t at) {
+       if (list[entry] != WHEEL_NONE) {
+         unlink(entry);
+         count--;
+       }
+       expiry[entry] = at;
+       link(entry, listFor(at));
+       count++;
+     }
+     
+     void cancel(int entry) {
+       if (list[entry] != WHEEL_NONE) {
+         unlink(entry);
+         count--;
+       }
+     }
+     
+     bool isScheduled(int entry) const { return list[entry] != WHEEL_NONE; }
+     uint32_t getExpiry(int entry) const { return expiry[entry]; }
+     uint32_t getTime() const { return time; }
+     int getCount() const { return count; }
+     
+     // Move the wheel to now, calling expired(entry) for every entry due by
+     // then, earliest first. An entry is unscheduled before it is reported,
+     // so the callback may schedule it again. Time never goes backwards.
+     template <typename Callback>
+     int advance(uint32_t now, Callback& expired) {
+       int reported = 0;
+       while (true) {
+         int entry;
+         while ((entry = head[WHEEL_DUE]) != WHEEL_NONE) {
+           unlink(entry);
+           count--;
+           reported++;
+           expired(entry);
+         }
+         uint32_t stop = nextStop();
+         if (stop == 0 || stop > now || stop <= time) {
+           break;
+         }
+         
+         // Lists whose digit comes up now move down, highest level first
+         time = stop;
+         if ((time & ((1UL << (WHEEL_LEVELS * WHEEL_SLOT_BITS)) - 1)) == 0) {
+           cascade(WHEEL_OVERFLOW);
+         }
+         for (int level = WHEEL_LEVELS - 1; level >= 0; level--) {
+           int shift = level * WHEEL_SLOT_BITS;
+           if ((time & ((1UL << shift) - 1)) == 0) {
+             cascade(level * WHEEL_SLOTS + ((time >> shift) & (WHEEL_SLOTS - 1)));
+           }
+         }
+       }
+       if (now > time) {
+         time = now;
+       }
+       return reported;
+     }
+ };
+ 
+ #endif
\ No newline at end of file
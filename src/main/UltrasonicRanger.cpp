@@ -0,0 +1,87 @@
+/*
+ * UltrasonicRanger.cpp
+ *
+ * Implementation of the interrupt-driven ranging state machine
+ */
+
+ #include "UltrasonicRanger.h"
+ 
+ UltrasonicRanger::UltrasonicRanger() : state(IDLE) {
+   echoLevel = false;
+   lastEdgeUs = 0;
+   triggerUs = 0;
+   echoStartUs = 0;
+   echoTimeoutUs = RANGER_ECHO_TIMEOUT_US;
+ }
+ 
+ bool UltrasonicRanger::startPing(uint32_t nowUs) {
+   if (state.load(std::memory_order_acquire) != IDLE) {
+     return false;
+   }
+   
+   // The sensor ignores triggers while its echo line is still high
+   // (e.g. the tail of a pulse we already timed out on)
+   if (echoLevel && (uint32_t)(nowUs - lastEdgeUs) < RANGER_STUCK_ECHO_US) {
+     return false;
+   }
+   
+   triggerUs = nowUs;
+   state.store(TRIGGERED, std::memory_order_release);
+   return true;
+ }
+ 
+ void IRAM_ATTR UltrasonicRanger::onEchoEdge(bool level, uint32_t nowUs) {
+   echoLevel = level;
+   lastEdgeUs = nowUs;
+   
+   if (level) {
+     // Rising edge: start timing the echo
+     uint8_t expected = TRIGGERED;
+     if (state.load(std::memory_order_acquire) == TRIGGERED) {
+       echoStartUs = nowUs;
+       state.compare_exchange_strong(expected, ECHO_HIGH, std::memory_order_acq_rel);
+     }
+   } else if (state.load(std::memory_order_acquire) == ECHO_HIGH) {
+     // Falling edge: pulse width is the round trip time
+     uint32_t start = echoStartUs;
+     publish(ECHO_HIGH, start, durationToDistance(nowUs - start), false);
+   }
+ }
+ 
+ void UltrasonicRanger::poll(uint32_t nowUs) {
+   uint8_t current = state.load(std::memory_order_acquire);
+   
+   if (current == TRIGGERED && (uint32_t)(nowUs - triggerUs) > RANGER_RISE_TIMEOUT_US) {
+     // Sensor never answered; report max range like pulseIn() timeouts did
+     publish(TRIGGERED, triggerUs, RANGER_MAX_DISTANCE_CM, true);
+   } else if (current == ECHO_HIGH && (uint32_t)(nowUs - echoStartUs) > echoTimeoutUs) {
+     // Nothing within range
+     publish(ECHO_HIGH, echoStartUs, RANGER_MAX_DISTANCE_CM, true);
+   }
+ }
+ 
+ void IRAM_ATTR UltrasonicRanger::publish(uint8_t fromState, uint32_t timestampUs, float distance, bool timedOut) {
+   uint8_t expected = fromState;
+   if (!state.compare_exchange_strong(expected, COMPLETING, std::memory_order_acq_rel)) {
+     return; // The other context already completed this ping
+   }
+   
+   RangeSample sample;
+   sample.timestampUs = timestampUs;
+   sample.distanceCm = distance;
+   sample.timedOut = timedOut;
+   samples.push(sample);
+   
+   state.store(IDLE, std::memory_order_release);
+ }
+ 
+ float IRAM_ATTR UltrasonicRanger::durationToDistance(uint32_t durationUs) {
+   float distance = durationUs * 0.034f / 2;
+   
+   // Limit to reasonable range
+   if (distance > RANGER_MAX_DISTANCE_CM) {
+     distance = RANGER_MAX_DISTANCE_CM;
+   }
+   
+   return distance;
+ }
\ No newline at end of file
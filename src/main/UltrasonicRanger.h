@@ -0,0 +1,83 @@
+/*
+ * UltrasonicRanger.h
+ *
+ * Non-blocking HC-SR04 ranging state machine. The owner fires the trigger
+ * pulse, echo edges are timestamped from a pin-change interrupt, and
+ * completed measurements are published to a lock-free ring buffer.
+ * No Arduino dependencies so it can be driven by a simulated clock.
+ */
+
+ #ifndef ULTRASONIC_RANGER_H
+ #define ULTRASONIC_RANGER_H
+ 
+ #include <stdint.h>
+ #include <atomic>
+ #include "SpscRing.h"
+ 
+ #ifndef IRAM_ATTR
+ #define IRAM_ATTR
+ #endif
+ 
+ #define RANGER_MAX_DISTANCE_CM 400.0
+ #define RANGER_ECHO_TIMEOUT_US 23200   // Round trip for ~4m range
+ #define RANGER_RISE_TIMEOUT_US 5000    // Sensor never raised its echo line
+ #define RANGER_STUCK_ECHO_US 250000    // Resync if an echo edge was missed
+ 
+ // One completed measurement
+ struct RangeSample {
+   uint32_t timestampUs; // Start of the echo pulse (or trigger time on timeout)
+   float distanceCm;
+   bool timedOut;
+ };
+ 
+ class UltrasonicRanger {
+   public:
+     enum State : uint8_t {
+       IDLE,        // Ready for a new ping
+       TRIGGERED,   // Trigger fired, waiting for echo to go high
+       ECHO_HIGH,   // Echo pulse in progress
+       COMPLETING   // Owner of the transition is publishing the sample
+     };
+     
+   private:
+     std::atomic<uint8_t> state;
+     volatile bool echoLevel;
+     volatile uint32_t lastEdgeUs;
+     volatile uint32_t triggerUs;
+     volatile uint32_t echoStartUs;
+     uint32_t echoTimeoutUs;
+     
+     SpscRing<RangeSample, 8> samples;
+     
+     // Only the context that wins the state transition publishes, so the
+     // ISR and poll() never push concurrently
+     void publish(uint8_t fromState, uint32_t timestampUs, float distance, bool timedOut);
+     
+   public:
+     UltrasonicRanger();
+     
+     // Limit the echo wait (shorter timeout = shorter range, faster pings)
+     void setEchoTimeout(uint32_t timeoutUs) { echoTimeoutUs = timeoutUs; }
+     uint32_t getEchoTimeout() const { return echoTimeoutUs; }
+     
+     // Arm the state machine. Returns true if the caller should now pulse the trigger pin.
+     bool startPing(uint32_t nowUs);
+     
+     // Called from the echo pin-change interrupt
+     void IRAM_ATTR onEchoEdge(bool level, uint32_t nowUs);
+     
+     // Called from the main loop to expire pings that never completed
+     void poll(uint32_t nowUs);
+     
+     // Non-blocking read of the next completed measurement
+     bool readSample(RangeSample& sample) { return samples.pop(sample); }
+     
+     State getState() const { return (State)state.load(std::memory_order_acquire); }
+     bool isBusy() const { return getState() != IDLE; }
+     uint16_t getDroppedSamples() const { return samples.getOverruns(); }
+     
+     // Convert echo pulse width to distance
+     static float durationToDistance(uint32_t durationUs);
+ };
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,549 @@
+/*
+ * model_data.cpp
+ *
+ * Generated by src/ai_model/export_model.py, do not edit.
+ * 6304 byte int8 model, 18 features x 8 steps, 8 classes.
+ * Trained on 480 simulated traces, int8 test accuracy 95.2%.
+ */
+
+ #ifdef SMARTGUIDE_USE_TFLITE
+ 
+ #include "model_data.h"
+ 
+ alignas(16) const unsigned char g_model_data[] = {
+   0x08, 0x00, 0x00, 0x00, 0x54, 0x46, 0x4c, 0x33, 0x62, 0xff, 0xff, 0xff,
+   0x14, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x24, 0x00, 0x00, 0x00,
+   0x28, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+   0x70, 0x18, 0x00, 0x00, 0x4c, 0x06, 0x00, 0x00, 0xb8, 0x05, 0x00, 0x00,
+   0xa4, 0x04, 0x00, 0x00, 0x70, 0x04, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0x78, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x54, 0x00, 0x00, 0x00,
+   0x34, 0x00, 0x00, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x53, 0x6d, 0x61, 0x72,
+   0x74, 0x47, 0x75, 0x69, 0x64, 0x65, 0x20, 0x6f, 0x62, 0x73, 0x74, 0x61,
+   0x63, 0x6c, 0x65, 0x20, 0x63, 0x6c, 0x61, 0x73, 0x73, 0x69, 0x66, 0x69,
+   0x65, 0x72, 0x00, 0x00, 0x0c, 0x00, 0x10, 0x00, 0x0f, 0x00, 0x00, 0x00,
+   0x08, 0x00, 0x04, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00,
+   0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19, 0x0c, 0x00, 0x0e, 0x00,
+   0x0d, 0x00, 0x00, 0x00, 0x08, 0x00, 0x04, 0x00, 0x0c, 0x00, 0x00, 0x00,
+   0x09, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x09, 0x0e, 0x00,
+   0x18, 0x00, 0x14, 0x00, 0x10, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x04, 0x00,
+   0x0e, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00,
+   0x28, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00,
+   0x04, 0x00, 0x00, 0x00, 0x6d, 0x61, 0x69, 0x6e, 0x00, 0x00, 0x00, 0x00,
+   0x03, 0x00, 0x00, 0x00, 0xb4, 0x00, 0x00, 0x00, 0x74, 0x00, 0x00, 0x00,
+   0x48, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00,
+   0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+   0x4c, 0x03, 0x00, 0x00, 0xe0, 0x02, 0x00, 0x00, 0x7c, 0x02, 0x00, 0x00,
+   0x24, 0x02, 0x00, 0x00, 0xc4, 0x01, 0x00, 0x00, 0x70, 0x01, 0x00, 0x00,
+   0x20, 0x01, 0x00, 0x00, 0xc4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00,
+   0x18, 0x00, 0x14, 0x00, 0x10, 0x00, 0x0c, 0x00, 0x0b, 0x00, 0x04, 0x00,
+   0x0e, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09,
+   0x0c, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0x06, 0x00, 0x00, 0x00, 0xd2, 0xff, 0xff, 0xff, 0x70, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x08, 0x08, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00,
+   0x01, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+   0x03, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x0e, 0x00, 0x14, 0x00, 0x00, 0x00, 0x10, 0x00, 0x0c, 0x00,
+   0x0b, 0x00, 0x04, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x08, 0x08, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00,
+   0x01, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+   0x2e, 0xe9, 0xff, 0xff, 0x00, 0x00, 0x80, 0x3f, 0x04, 0x00, 0x06, 0x00,
+   0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x08, 0x00, 0x07, 0x00,
+   0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xa2, 0xfd, 0xff, 0xff,
+   0x10, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09,
+   0x28, 0x00, 0x00, 0x00, 0x94, 0xfd, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+   0x14, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x80, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x80, 0x3b, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0x08, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x70, 0x72, 0x6f, 0x62,
+   0x61, 0x62, 0x69, 0x6c, 0x69, 0x74, 0x69, 0x65, 0x73, 0x00, 0x00, 0x00,
+   0xfa, 0xfd, 0xff, 0xff, 0x10, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x09, 0x24, 0x00, 0x00, 0x00, 0xec, 0xfd, 0xff, 0xff,
+   0x08, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0xd8, 0x7c, 0x8a, 0x3f, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0x08, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x6c, 0x6f, 0x67, 0x69,
+   0x74, 0x73, 0x00, 0x00, 0xae, 0xfe, 0xff, 0xff, 0x14, 0x00, 0x00, 0x00,
+   0x38, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+   0x24, 0x00, 0x00, 0x00, 0x3c, 0xfe, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+   0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x74, 0x06, 0x0a, 0x3b,
+   0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00,
+   0x6c, 0x6f, 0x67, 0x69, 0x74, 0x73, 0x2f, 0x62, 0x69, 0x61, 0x73, 0x00,
+   0xfe, 0xfe, 0xff, 0xff, 0x14, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00,
+   0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x28, 0x00, 0x00, 0x00,
+   0x8c, 0xfe, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00,
+   0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x63, 0xb3, 0x85, 0x3c,
+   0x02, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00,
+   0x0e, 0x00, 0x00, 0x00, 0x6c, 0x6f, 0x67, 0x69, 0x74, 0x73, 0x2f, 0x77,
+   0x65, 0x69, 0x67, 0x68, 0x74, 0x73, 0x00, 0x00, 0xf2, 0xfe, 0xff, 0xff,
+   0x10, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09,
+   0x28, 0x00, 0x00, 0x00, 0xe4, 0xfe, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00,
+   0x14, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x80, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0xdc, 0x23, 0x04, 0x3e, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0x20, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x64, 0x65, 0x6e, 0x73,
+   0x65, 0x2f, 0x72, 0x65, 0x6c, 0x75, 0x00, 0x00, 0xae, 0xff, 0xff, 0xff,
+   0x14, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x02, 0x24, 0x00, 0x00, 0x00, 0x3c, 0xff, 0xff, 0xff,
+   0x08, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0xc0, 0x68, 0xc8, 0x3a, 0x01, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00,
+   0x0a, 0x00, 0x00, 0x00, 0x64, 0x65, 0x6e, 0x73, 0x65, 0x2f, 0x62, 0x69,
+   0x61, 0x73, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x18, 0x00, 0x14, 0x00,
+   0x13, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x04, 0x00, 0x0e, 0x00, 0x00, 0x00,
+   0x14, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x09, 0x28, 0x00, 0x00, 0x00, 0x9c, 0xff, 0xff, 0xff,
+   0x08, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x01, 0x00, 0x00, 0x00, 0x68, 0x77, 0x57, 0x3c, 0x02, 0x00, 0x00, 0x00,
+   0x20, 0x00, 0x00, 0x00, 0x90, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00,
+   0x64, 0x65, 0x6e, 0x73, 0x65, 0x2f, 0x77, 0x65, 0x69, 0x67, 0x68, 0x74,
+   0x73, 0x00, 0x0e, 0x00, 0x14, 0x00, 0x10, 0x00, 0x0f, 0x00, 0x00, 0x00,
+   0x08, 0x00, 0x04, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00,
+   0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x34, 0x00, 0x00, 0x00,
+   0x0c, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x04, 0x00,
+   0x0c, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00,
+   0x01, 0x00, 0x00, 0x00, 0xc9, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x34, 0x1c, 0xee, 0x3d,
+   0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x90, 0x00, 0x00, 0x00,
+   0x05, 0x00, 0x00, 0x00, 0x69, 0x6e, 0x70, 0x75, 0x74, 0x00, 0x00, 0x00,
+   0x16, 0xec, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00,
+   0x40, 0xfb, 0xff, 0xff, 0xc1, 0x00, 0x00, 0x00, 0xa2, 0x03, 0x00, 0x00,
+   0x5b, 0xff, 0xff, 0xff, 0x8e, 0x01, 0x00, 0x00, 0xd4, 0xff, 0xff, 0xff,
+   0x90, 0xfc, 0xff, 0xff, 0x9f, 0xfe, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+   0x46, 0xec, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+   0xec, 0x57, 0xcc, 0x06, 0xa3, 0x13, 0xcf, 0x0d, 0x14, 0xce, 0xd7, 0xee,
+   0xff, 0xc7, 0x03, 0xfe, 0xdb, 0xf6, 0x63, 0x1d, 0xe5, 0x00, 0x13, 0xdc,
+   0xa0, 0xfd, 0x08, 0xde, 0x0a, 0xfe, 0xfc, 0xef, 0xd5, 0xc7, 0xfc, 0x1a,
+   0x10, 0xef, 0x14, 0x17, 0x16, 0x21, 0x0b, 0x1a, 0xe8, 0x11, 0xd9, 0x13,
+   0xcb, 0x27, 0xf9, 0x1b, 0xcc, 0x05, 0xcb, 0xfb, 0x1c, 0x1f, 0x02, 0xc5,
+   0xca, 0x08, 0xef, 0x1e, 0x17, 0xf0, 0x32, 0xff, 0x19, 0xf9, 0x15, 0xf6,
+   0xef, 0xfd, 0x2c, 0xd9, 0xa6, 0xab, 0x01, 0xed, 0x06, 0x1a, 0xf3, 0xb6,
+   0x19, 0x07, 0xef, 0xfb, 0x0c, 0x1b, 0x03, 0x1a, 0xf7, 0xe1, 0xfd, 0x13,
+   0x09, 0xfd, 0x31, 0xf3, 0xf1, 0xfe, 0x11, 0xd9, 0x07, 0x00, 0xf6, 0x1e,
+   0x45, 0xf8, 0xf8, 0xfc, 0x03, 0xf1, 0xe7, 0xee, 0x19, 0x0a, 0xf5, 0xff,
+   0x0e, 0xf2, 0xf7, 0x1c, 0xf9, 0xda, 0xee, 0x11, 0xee, 0xb6, 0x19, 0x34,
+   0x0e, 0x26, 0xcf, 0xfd, 0xf3, 0x15, 0x11, 0xf2, 0xf4, 0x0c, 0x13, 0xa2,
+   0xd8, 0xf3, 0xca, 0x12, 0x04, 0x9d, 0x14, 0xb0, 0x20, 0xe6, 0xc6, 0x12,
+   0x03, 0x16, 0x19, 0xf2, 0x0f, 0x0a, 0x81, 0x02, 0x0b, 0xbc, 0x37, 0x14,
+   0xd7, 0xda, 0x05, 0xb8, 0x03, 0xf7, 0x21, 0xca, 0x4f, 0x10, 0xdb, 0x10,
+   0xc8, 0x2b, 0x09, 0xd6, 0xca, 0x1b, 0x40, 0xdc, 0xfe, 0x1b, 0x0b, 0xde,
+   0xfe, 0x5e, 0x2c, 0xd7, 0xd4, 0x30, 0xd4, 0xe3, 0x12, 0xd9, 0xf2, 0xf0,
+   0xfc, 0xfc, 0xe9, 0xea, 0x03, 0xac, 0x4a, 0xd1, 0x39, 0x20, 0xfc, 0xea,
+   0xf7, 0xe3, 0xef, 0x1d, 0x26, 0x89, 0xdf, 0xfb, 0xdb, 0x00, 0x05, 0xf8,
+   0xf4, 0xf3, 0x00, 0xcb, 0xf2, 0x12, 0xd7, 0x34, 0x3e, 0x28, 0xf4, 0x2b,
+   0x03, 0xcb, 0xff, 0xfa, 0x02, 0xff, 0xfd, 0x35, 0x1a, 0xe6, 0xeb, 0x02,
+   0xee, 0xfe, 0xc8, 0x04, 0x00, 0x00, 0x00, 0x00, 0x56, 0xed, 0xff, 0xff,
+   0x04, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0xfb, 0x01, 0x00, 0x00,
+   0x80, 0xf7, 0xff, 0xff, 0x44, 0x04, 0x00, 0x00, 0xde, 0x03, 0x00, 0x00,
+   0xae, 0x02, 0x00, 0x00, 0xbd, 0x01, 0x00, 0x00, 0xf1, 0xff, 0xff, 0xff,
+   0x14, 0x02, 0x00, 0x00, 0xfc, 0xfe, 0xff, 0xff, 0x07, 0x01, 0x00, 0x00,
+   0x22, 0x08, 0x00, 0x00, 0x23, 0x01, 0x00, 0x00, 0x2a, 0x00, 0x00, 0x00,
+   0x6f, 0x01, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0xbe, 0xff, 0xff, 0xff,
+   0xca, 0xfe, 0xff, 0xff, 0x87, 0x04, 0x00, 0x00, 0x13, 0xfa, 0xff, 0xff,
+   0xdd, 0xfd, 0xff, 0xff, 0xed, 0x01, 0x00, 0x00, 0x10, 0xfe, 0xff, 0xff,
+   0xec, 0xfd, 0xff, 0xff, 0x1f, 0x01, 0x00, 0x00, 0xb6, 0x01, 0x00, 0x00,
+   0x1a, 0x02, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0xf6, 0x01, 0x00, 0x00,
+   0x9e, 0xfe, 0xff, 0xff, 0x56, 0x03, 0x00, 0x00, 0x07, 0x02, 0x00, 0x00,
+   0x8b, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe6, 0xed, 0xff, 0xff,
+   0x04, 0x00, 0x00, 0x00, 0x00, 0x12, 0x00, 0x00, 0xf1, 0x1a, 0xee, 0x07,
+   0xfc, 0x10, 0xfb, 0xf9, 0x04, 0xdc, 0x06, 0x0a, 0x0d, 0x00, 0x02, 0xfd,
+   0xfd, 0x14, 0xe6, 0x19, 0x00, 0x06, 0xff, 0xf9, 0xf2, 0x0b, 0x09, 0xf6,
+   0x0a, 0x09, 0x07, 0xfc, 0xfe, 0xf4, 0xf2, 0x0b, 0xf2, 0x18, 0xfd, 0x06,
+   0xfb, 0x13, 0xf9, 0xf9, 0x36, 0xfe, 0x00, 0x0c, 0x08, 0xf4, 0x01, 0xfe,
+   0xff, 0x08, 0xf5, 0x16, 0xfc, 0x0b, 0x07, 0xfc, 0xf8, 0x09, 0x21, 0xfd,
+   0x0e, 0x0b, 0x16, 0x00, 0xfd, 0xed, 0xf6, 0x0a, 0xf3, 0x20, 0xfc, 0x0d,
+   0x00, 0x0e, 0x01, 0xfc, 0x28, 0xff, 0x06, 0x0a, 0x01, 0xf9, 0x01, 0xf4,
+   0xfc, 0x06, 0xf8, 0x22, 0x06, 0x16, 0x05, 0xf8, 0xf9, 0xfb, 0x09, 0xf7,
+   0x01, 0x0e, 0x0f, 0xf4, 0xfa, 0xf8, 0xfc, 0x02, 0xfb, 0x1c, 0xf8, 0x14,
+   0xfa, 0xf4, 0x13, 0xfe, 0x09, 0x00, 0x01, 0x08, 0xf5, 0xf2, 0x05, 0xf5,
+   0xfc, 0x09, 0xf2, 0x1f, 0xf8, 0x14, 0x07, 0x06, 0x0f, 0xef, 0xf6, 0xf0,
+   0x01, 0x12, 0xef, 0xfe, 0x00, 0xf0, 0x03, 0x06, 0xe3, 0xf1, 0x19, 0xdc,
+   0x00, 0x04, 0x02, 0xf9, 0xf7, 0x00, 0x03, 0x05, 0xfc, 0x0b, 0x0e, 0x03,
+   0x01, 0x09, 0xdf, 0xe2, 0x14, 0xd9, 0xf6, 0xfc, 0xf8, 0xfd, 0x01, 0x00,
+   0xfe, 0xfc, 0xfc, 0x0e, 0xfe, 0x04, 0x11, 0x06, 0xda, 0xe1, 0x22, 0xd9,
+   0x01, 0xfd, 0x02, 0xf6, 0xf7, 0x03, 0xf8, 0xf5, 0xf8, 0x08, 0x04, 0x00,
+   0x0b, 0xfd, 0xdd, 0xe8, 0x11, 0xd8, 0xfd, 0x06, 0xf7, 0xfe, 0x04, 0x15,
+   0xf9, 0x00, 0xf4, 0x12, 0x02, 0x00, 0x04, 0x02, 0xe7, 0xdd, 0x23, 0xe7,
+   0x0b, 0x00, 0x01, 0x05, 0x0c, 0xfe, 0xef, 0xf6, 0x01, 0x12, 0x06, 0xf7,
+   0x05, 0x01, 0xe1, 0xec, 0x14, 0xde, 0xf6, 0x03, 0xf1, 0x04, 0x06, 0x08,
+   0xf3, 0xfa, 0xf7, 0x11, 0xff, 0x03, 0x08, 0x04, 0xdc, 0xe8, 0x11, 0xda,
+   0x00, 0xf8, 0x10, 0xfa, 0x0a, 0xff, 0xe1, 0xed, 0x07, 0x07, 0xfe, 0xf6,
+   0xfe, 0x06, 0xd6, 0xdf, 0x37, 0xd1, 0x00, 0x02, 0x05, 0x07, 0x03, 0x06,
+   0xdc, 0xf1, 0x02, 0x0f, 0xfc, 0x03, 0x07, 0xfb, 0xbc, 0x2c, 0x23, 0xdb,
+   0xf7, 0xfe, 0xff, 0xf0, 0x07, 0x06, 0xe7, 0x24, 0xf5, 0xf6, 0x0c, 0x1a,
+   0xed, 0x09, 0xbe, 0x33, 0x21, 0xeb, 0xf7, 0x08, 0x08, 0xd4, 0x0b, 0x00,
+   0xe8, 0x1a, 0xf1, 0xe8, 0x05, 0x07, 0xed, 0x0a, 0xc8, 0x38, 0x14, 0xeb,
+   0xfc, 0xe1, 0xfb, 0xdc, 0x03, 0x04, 0xdf, 0x13, 0xfa, 0xf1, 0x02, 0x06,
+   0xf8, 0x03, 0xbd, 0x25, 0x22, 0xef, 0x01, 0x14, 0x05, 0xe4, 0x03, 0x06,
+   0xe7, 0x19, 0xe7, 0xf4, 0x0c, 0xf4, 0xf1, 0xfe, 0xc0, 0x27, 0x18, 0xed,
+   0xfb, 0xf9, 0x05, 0xed, 0x08, 0x00, 0xe3, 0x1e, 0xf5, 0xf0, 0x0c, 0x07,
+   0xfe, 0x10, 0xc1, 0x22, 0x36, 0xeb, 0xff, 0x12, 0x03, 0xee, 0x05, 0xf7,
+   0xe4, 0x1a, 0xef, 0xf3, 0xfe, 0x05, 0xf4, 0x06, 0xc7, 0x20, 0x1c, 0xe9,
+   0xf6, 0x02, 0x10, 0xe7, 0x07, 0xf7, 0xe4, 0x11, 0xfa, 0xf7, 0x09, 0x0e,
+   0xf0, 0x17, 0xcb, 0x1e, 0x24, 0xec, 0xfd, 0x0b, 0x17, 0xdf, 0xff, 0xfe,
+   0xe3, 0x1c, 0xf8, 0xf6, 0xf9, 0xff, 0xfa, 0x06, 0xf6, 0xf2, 0xec, 0xf3,
+   0xfd, 0xec, 0x04, 0x03, 0xeb, 0x05, 0x05, 0xf7, 0x09, 0xf2, 0x03, 0xfe,
+   0x02, 0xfe, 0x03, 0xe6, 0xf2, 0xf5, 0xf5, 0xf8, 0x03, 0xf0, 0xd8, 0x05,
+   0xfe, 0xf6, 0x01, 0xf2, 0x01, 0xf8, 0xf8, 0xfe, 0xfc, 0xf4, 0xec, 0xf5,
+   0xff, 0x03, 0x0b, 0x01, 0xe8, 0x00, 0x06, 0xf9, 0x04, 0xed, 0x01, 0xfd,
+   0x04, 0x05, 0x0a, 0xf8, 0xe1, 0xfc, 0xfe, 0x03, 0xfb, 0x02, 0xd0, 0xfd,
+   0x10, 0xef, 0x05, 0x01, 0xff, 0xf4, 0x04, 0x04, 0x00, 0xea, 0xe7, 0xf2,
+   0x06, 0xf9, 0x00, 0x0b, 0xc1, 0xff, 0x0f, 0xf9, 0xfc, 0x04, 0xff, 0xf4,
+   0x01, 0xff, 0x0c, 0xea, 0xea, 0xfc, 0xf6, 0x04, 0xfe, 0xfc, 0xd1, 0xf1,
+   0x0c, 0xef, 0x0d, 0x00, 0xfa, 0x06, 0x02, 0x06, 0x05, 0xeb, 0xe6, 0xfd,
+   0x02, 0xfc, 0xff, 0x10, 0xbe, 0xfe, 0x13, 0xf3, 0x0a, 0x10, 0xfb, 0xfc,
+   0x00, 0x08, 0x06, 0xf0, 0xf4, 0xf3, 0xfd, 0x06, 0xf6, 0x16, 0xc7, 0xfe,
+   0x1d, 0x00, 0xfd, 0x0b, 0xf7, 0xed, 0x0c, 0xfe, 0x23, 0x14, 0xfd, 0x1d,
+   0x03, 0xfe, 0x0a, 0xf7, 0xfb, 0xf7, 0xfb, 0x02, 0x05, 0x07, 0xfd, 0xfb,
+   0xf4, 0xf2, 0x1e, 0x15, 0xfc, 0x1b, 0xfc, 0x01, 0xf7, 0xfb, 0x02, 0xf3,
+   0xff, 0x01, 0xfd, 0xfd, 0xfc, 0xed, 0xea, 0xe8, 0x19, 0x15, 0xfd, 0x1e,
+   0xff, 0xfb, 0x06, 0xfb, 0x04, 0xed, 0xfd, 0x05, 0x01, 0x09, 0xfc, 0xf1,
+   0xe6, 0xe5, 0x18, 0x16, 0xf7, 0x1a, 0x00, 0x07, 0xf5, 0xfc, 0x02, 0xee,
+   0x07, 0xff, 0xfd, 0x01, 0xfc, 0xef, 0xe7, 0xe2, 0x1a, 0x16, 0xf8, 0x19,
+   0x01, 0xfb, 0x07, 0xfa, 0x02, 0xed, 0x03, 0xff, 0x08, 0x03, 0xfc, 0xf0,
+   0xe6, 0xe8, 0x18, 0x1b, 0x04, 0x1a, 0x0b, 0xfa, 0xf7, 0xfc, 0xf8, 0xf6,
+   0x04, 0xfd, 0x06, 0x03, 0xfc, 0xef, 0xe7, 0xec, 0x0f, 0x16, 0x0d, 0x1a,
+   0x07, 0x04, 0xf2, 0x04, 0xf6, 0xfc, 0x03, 0x04, 0xfc, 0x06, 0xfc, 0xee,
+   0xe5, 0xea, 0x0f, 0x0d, 0x13, 0x10, 0x08, 0x0f, 0xe6, 0x01, 0xf3, 0xee,
+   0x02, 0x03, 0x07, 0xf8, 0xfc, 0xef, 0xe9, 0xe6, 0xaf, 0xf2, 0x09, 0xdb,
+   0xf7, 0xfc, 0xff, 0xfa, 0xfe, 0xf7, 0x03, 0xd7, 0xf6, 0xcf, 0xf9, 0x07,
+   0xff, 0x08, 0xab, 0xf2, 0xfe, 0xdb, 0xf2, 0xfe, 0xf3, 0x06, 0xf4, 0xfa,
+   0x0c, 0xd4, 0xed, 0xca, 0x04, 0x0a, 0x00, 0x04, 0xbb, 0xf8, 0x08, 0xe1,
+   0xe8, 0xff, 0x0e, 0x01, 0x03, 0xf4, 0x12, 0xe4, 0xf5, 0xd5, 0xfc, 0x02,
+   0xf5, 0xf5, 0xd4, 0xf2, 0x04, 0xe8, 0xed, 0x01, 0x03, 0x01, 0xf5, 0xfc,
+   0x0a, 0xe0, 0xeb, 0xc0, 0x01, 0xfa, 0xfc, 0x02, 0xd0, 0xf8, 0x06, 0xe3,
+   0xf9, 0x02, 0x03, 0xfb, 0x05, 0xf8, 0x22, 0xe7, 0xe4, 0xc2, 0x07, 0x10,
+   0x01, 0x04, 0xd1, 0x01, 0xf5, 0xe4, 0xf1, 0x01, 0x07, 0x00, 0xfa, 0xfd,
+   0x1e, 0xe2, 0xe4, 0xc0, 0x06, 0x0e, 0xfc, 0xf8, 0xd0, 0x00, 0xfb, 0xe2,
+   0xfa, 0xfb, 0x06, 0x07, 0x08, 0x07, 0x2a, 0xe2, 0xeb, 0xbc, 0x00, 0x0e,
+   0x05, 0xf3, 0xdb, 0xfb, 0xf7, 0xef, 0xfe, 0x06, 0x00, 0x04, 0xf6, 0x03,
+   0x26, 0xed, 0xe4, 0xc1, 0x06, 0x13, 0x03, 0x07, 0x28, 0x12, 0xf7, 0x20,
+   0x16, 0x02, 0x26, 0x01, 0xce, 0xff, 0xc7, 0x03, 0xf7, 0x06, 0x02, 0x0e,
+   0x0a, 0xff, 0x29, 0x10, 0xf9, 0x18, 0x03, 0x02, 0x18, 0x07, 0xc6, 0x05,
+   0xc7, 0xf6, 0xe7, 0x03, 0x03, 0xff, 0xf9, 0x05, 0x1e, 0x0c, 0xfc, 0x1a,
+   0x06, 0xfb, 0xfe, 0x00, 0xcd, 0xfc, 0xc3, 0xfd, 0xe5, 0x02, 0xfa, 0xfc,
+   0x01, 0xfa, 0x27, 0xff, 0x07, 0x1b, 0x08, 0x07, 0x01, 0x05, 0xdb, 0x03,
+   0xc6, 0xf2, 0xeb, 0x08, 0x09, 0xfb, 0xfc, 0x0b, 0x1b, 0x03, 0x06, 0x11,
+   0x05, 0xff, 0x0c, 0xfd, 0xe4, 0xfc, 0xc2, 0xf6, 0xef, 0x10, 0x02, 0x01,
+   0x04, 0xf3, 0x1a, 0x09, 0x09, 0x0f, 0x02, 0x06, 0xfb, 0x02, 0xf1, 0xfa,
+   0xbb, 0xf9, 0xde, 0x03, 0x02, 0xfb, 0x02, 0xfe, 0x0c, 0x0c, 0x07, 0x19,
+   0x08, 0xf6, 0xf6, 0xf7, 0xfc, 0x03, 0xb1, 0x02, 0xef, 0x0c, 0xfe, 0xfb,
+   0xf3, 0xfe, 0xff, 0x0d, 0x14, 0xfc, 0x09, 0x0c, 0x0e, 0xef, 0xff, 0x04,
+   0xa8, 0xfc, 0xef, 0x0f, 0xfa, 0x0e, 0x05, 0x01, 0xfc, 0xfe, 0xde, 0xf9,
+   0xfd, 0xf9, 0xea, 0xff, 0x08, 0xef, 0xfd, 0x08, 0x07, 0x04, 0xea, 0xf4,
+   0xe8, 0xf3, 0xfe, 0x00, 0xdc, 0xfc, 0x00, 0xfc, 0xec, 0xfe, 0xfe, 0xf8,
+   0x03, 0x06, 0x00, 0x06, 0xea, 0xf3, 0xed, 0xfa, 0xf4, 0xf9, 0xf4, 0xf8,
+   0x09, 0x02, 0xef, 0xfc, 0xfb, 0xeb, 0xff, 0x04, 0x0c, 0x01, 0xea, 0xf1,
+   0xf4, 0xf9, 0xfb, 0xfd, 0xe5, 0xf2, 0x0a, 0x09, 0xfe, 0x04, 0xf2, 0x08,
+   0x03, 0x0d, 0x11, 0x05, 0xeb, 0xf6, 0xf5, 0xfa, 0xfb, 0xf5, 0xeb, 0xef,
+   0x09, 0xfb, 0xfe, 0x01, 0x00, 0xf1, 0x03, 0x06, 0x0a, 0xfe, 0xeb, 0xf4,
+   0xf4, 0xfa, 0xf6, 0xf7, 0xeb, 0xf5, 0x03, 0xf3, 0x01, 0x02, 0xf6, 0xfd,
+   0x05, 0x09, 0x0b, 0x10, 0xf1, 0xf7, 0xf6, 0x05, 0xfd, 0xfd, 0xf0, 0xf8,
+   0x0a, 0xf7, 0x11, 0x07, 0x04, 0xeb, 0x00, 0x06, 0x12, 0x11, 0xf1, 0xfd,
+   0xeb, 0xff, 0xfd, 0xff, 0xc8, 0xfe, 0x03, 0x09, 0x22, 0x09, 0x10, 0x0c,
+   0xff, 0x16, 0x15, 0x0f, 0xf3, 0x03, 0xf4, 0x06, 0xe7, 0xfb, 0x0c, 0xf1,
+   0x09, 0x08, 0xf4, 0x00, 0xee, 0x07, 0xf4, 0x01, 0xf2, 0x08, 0xfc, 0xec,
+   0xef, 0xe3, 0xe8, 0x00, 0x05, 0xef, 0xf7, 0xfb, 0xe9, 0x05, 0xfc, 0x0c,
+   0xed, 0xfd, 0xf8, 0x0b, 0xff, 0xf4, 0xee, 0xec, 0xea, 0xfc, 0x05, 0xf7,
+   0x06, 0x0e, 0x0a, 0xfd, 0xfb, 0x13, 0xec, 0x0a, 0xfb, 0x15, 0xfd, 0xe9,
+   0xeb, 0xef, 0xef, 0xfa, 0x0e, 0xf3, 0xfb, 0xfd, 0xee, 0x04, 0x10, 0x15,
+   0xeb, 0x04, 0x02, 0x0b, 0xff, 0xfb, 0xf7, 0xe9, 0xf1, 0xf8, 0x0b, 0xef,
+   0x03, 0x03, 0x06, 0x02, 0x00, 0x14, 0xf2, 0x11, 0xfb, 0x06, 0xfb, 0xe9,
+   0xf3, 0xed, 0xed, 0xfb, 0x12, 0xf3, 0xfd, 0xff, 0xee, 0x06, 0x08, 0x09,
+   0xf2, 0x0d, 0xf0, 0x04, 0xfe, 0xf6, 0xeb, 0xf0, 0xe7, 0x09, 0x19, 0xf1,
+   0x04, 0x04, 0x0a, 0xf6, 0xf6, 0x0e, 0xf8, 0x0f, 0xfe, 0x09, 0xfd, 0xf3,
+   0xf7, 0xf1, 0xf0, 0xf1, 0x0e, 0xee, 0xf8, 0xff, 0x02, 0xf4, 0xfa, 0x16,
+   0xfe, 0x08, 0xf2, 0x08, 0xfe, 0xf4, 0xf1, 0xee, 0x07, 0x05, 0x16, 0x0e,
+   0xfd, 0x1a, 0x14, 0xf8, 0x09, 0xf4, 0x04, 0xe9, 0xe3, 0xd7, 0xf9, 0xf0,
+   0xf2, 0xf3, 0x09, 0x0d, 0x11, 0x10, 0xfd, 0x02, 0x04, 0x0b, 0x0f, 0xfb,
+   0xf9, 0xe6, 0xdf, 0xd6, 0xf8, 0x02, 0xf4, 0x01, 0x10, 0x05, 0x06, 0x0e,
+   0xf6, 0x0c, 0x02, 0xff, 0x13, 0xf1, 0x06, 0xea, 0xe4, 0xcf, 0xfc, 0xf5,
+   0xf4, 0x06, 0x0d, 0x07, 0x07, 0x0b, 0xfd, 0xf8, 0x07, 0x08, 0x0f, 0xf4,
+   0xff, 0xe2, 0xe3, 0xd0, 0xff, 0x02, 0xfa, 0x07, 0x0e, 0xfc, 0x0a, 0x13,
+   0xff, 0x05, 0xf3, 0x04, 0x24, 0xf0, 0x05, 0xe7, 0xe3, 0xd0, 0xf8, 0xfa,
+   0xee, 0x07, 0x1a, 0x11, 0x12, 0x1c, 0xf1, 0xf8, 0xfe, 0xfd, 0x0e, 0xfa,
+   0x06, 0xe4, 0xe7, 0xd5, 0x04, 0x02, 0xfb, 0x0a, 0x08, 0x06, 0x0c, 0x08,
+   0x12, 0x02, 0xe9, 0x01, 0x14, 0xf7, 0x0b, 0xf0, 0xe9, 0xd6, 0xfa, 0x00,
+   0xff, 0x07, 0x0d, 0x11, 0x06, 0x0b, 0xfb, 0x01, 0xcd, 0xfd, 0x08, 0x00,
+   0x08, 0xe2, 0xd7, 0xd0, 0xfe, 0xfc, 0xf8, 0x11, 0xf8, 0xfd, 0xfd, 0xf7,
+   0xf8, 0x03, 0x08, 0xf7, 0xfb, 0x08, 0xf7, 0xf4, 0xf6, 0x0e, 0x06, 0x09,
+   0x05, 0x0e, 0xf8, 0xfc, 0xff, 0xf6, 0xfb, 0x0b, 0x04, 0xed, 0xff, 0x06,
+   0xf5, 0xfa, 0xef, 0x0c, 0x05, 0x0a, 0x09, 0xff, 0xf3, 0x01, 0xf6, 0xfc,
+   0x05, 0xf9, 0x01, 0x02, 0xfd, 0xfc, 0xf6, 0xf8, 0xf7, 0x0e, 0x01, 0x06,
+   0x10, 0xfd, 0xf8, 0x01, 0x00, 0xfd, 0xfc, 0xfc, 0xf9, 0xf6, 0xfe, 0x07,
+   0xf3, 0xff, 0xf9, 0x10, 0x07, 0x01, 0x04, 0x0d, 0xf8, 0xfd, 0xf4, 0xf9,
+   0xff, 0x0f, 0xfe, 0x05, 0x09, 0xfb, 0xf2, 0x01, 0xfb, 0x06, 0x05, 0x00,
+   0x08, 0x02, 0xfc, 0x01, 0x05, 0x00, 0xfe, 0xf4, 0xfb, 0xfd, 0xff, 0x05,
+   0xeb, 0xf6, 0xf7, 0x04, 0xfe, 0x08, 0x08, 0xfc, 0xf6, 0xfd, 0xfa, 0xf7,
+   0xfe, 0x07, 0xfd, 0xfc, 0x01, 0xf7, 0xef, 0xfe, 0xfd, 0x09, 0xfe, 0x0c,
+   0x0b, 0x07, 0xf4, 0xfb, 0x13, 0xf3, 0x01, 0x02, 0xf9, 0x01, 0xfd, 0x04,
+   0xef, 0xfe, 0xf8, 0x02, 0x04, 0x02, 0x08, 0x01, 0x1e, 0x1c, 0x22, 0x1e,
+   0x0c, 0x06, 0x0b, 0xff, 0x12, 0xf5, 0xff, 0xfb, 0x00, 0x01, 0x0b, 0xf1,
+   0x12, 0x11, 0x16, 0x19, 0x1b, 0x20, 0x00, 0x0a, 0x02, 0xff, 0x08, 0x01,
+   0xff, 0xf9, 0x05, 0x06, 0x08, 0xf5, 0x06, 0x0b, 0x1f, 0x17, 0x1a, 0x21,
+   0xfd, 0xfc, 0x01, 0xfe, 0x08, 0xf2, 0xff, 0xfd, 0x00, 0x04, 0x06, 0xee,
+   0x07, 0x0d, 0x1e, 0x13, 0x19, 0x1a, 0xfd, 0x09, 0xff, 0xf8, 0x03, 0xfe,
+   0xff, 0xfc, 0x01, 0x03, 0x06, 0xf0, 0x09, 0x09, 0x1d, 0x17, 0x1c, 0x1d,
+   0xfe, 0xf9, 0xf9, 0xf5, 0x07, 0xf3, 0x00, 0xfd, 0xfb, 0x07, 0x0a, 0xed,
+   0x09, 0x05, 0x1b, 0x14, 0x1c, 0x1a, 0x01, 0x06, 0x06, 0xf7, 0xfe, 0x03,
+   0x01, 0xfd, 0xfb, 0x05, 0x0a, 0xee, 0x0b, 0x10, 0x19, 0x21, 0x25, 0x1e,
+   0x06, 0xf7, 0xdb, 0xe4, 0x06, 0xf5, 0x02, 0xfa, 0xfe, 0x0b, 0x08, 0xed,
+   0x14, 0x0b, 0x12, 0x11, 0x1c, 0x14, 0x02, 0x0e, 0xcf, 0xd3, 0x08, 0xf7,
+   0x00, 0xfe, 0xfc, 0xfe, 0x0d, 0xf8, 0x11, 0x07, 0x08, 0x1a, 0x3d, 0x1a,
+   0x0a, 0x0e, 0xf9, 0x04, 0x05, 0x08, 0x05, 0x05, 0xfb, 0x09, 0xff, 0x00,
+   0xff, 0x04, 0x01, 0x1c, 0x37, 0x0f, 0x06, 0x04, 0xfc, 0x00, 0x06, 0xfc,
+   0x03, 0x03, 0xfa, 0xfd, 0xfe, 0xfd, 0xf9, 0x00, 0x07, 0x15, 0x3d, 0x11,
+   0x05, 0x00, 0xfc, 0xfa, 0x01, 0x06, 0x02, 0x03, 0xfd, 0x01, 0xfe, 0xfe,
+   0xf8, 0x00, 0x02, 0x18, 0x42, 0x0a, 0x02, 0x00, 0x00, 0xff, 0x03, 0x06,
+   0x05, 0xfe, 0xff, 0x02, 0xfd, 0xfc, 0xf6, 0xfe, 0x00, 0x16, 0x38, 0x0d,
+   0x00, 0xfc, 0xff, 0xf7, 0xfd, 0x07, 0x01, 0x06, 0x02, 0xff, 0xfd, 0xfc,
+   0xfb, 0x00, 0xfd, 0x17, 0x3e, 0x0b, 0x06, 0x00, 0xf8, 0xf9, 0x02, 0xfd,
+   0xff, 0x03, 0x07, 0x02, 0xfd, 0xfa, 0xfc, 0x00, 0xfe, 0x11, 0x34, 0x05,
+   0xff, 0x0a, 0xf1, 0xd9, 0x06, 0x07, 0xfa, 0x07, 0xff, 0x01, 0xfd, 0xfc,
+   0xfc, 0xfe, 0xf5, 0x11, 0x3d, 0x01, 0x02, 0x0c, 0xe0, 0xc6, 0x05, 0x04,
+   0xff, 0x0b, 0x00, 0xf7, 0xfc, 0xf9, 0xf8, 0xfd, 0x3a, 0xd5, 0xf0, 0x0d,
+   0x10, 0xff, 0x08, 0xf6, 0xf8, 0x0b, 0xf5, 0x07, 0xe1, 0x0a, 0xff, 0xef,
+   0xfd, 0xf1, 0x35, 0xd6, 0xe9, 0x10, 0x05, 0x02, 0xfa, 0xfd, 0x02, 0x12,
+   0xfb, 0x02, 0xe5, 0x04, 0x00, 0xf1, 0x05, 0xf4, 0x3b, 0xce, 0xfb, 0x06,
+   0x0d, 0x00, 0x05, 0xfa, 0x08, 0x06, 0xf7, 0x06, 0xed, 0x0e, 0xfd, 0xea,
+   0xfa, 0xf7, 0x2f, 0xdd, 0xea, 0x06, 0xfb, 0xfe, 0xfe, 0xfe, 0x07, 0x12,
+   0xef, 0x04, 0xec, 0x03, 0x00, 0xf6, 0xfe, 0xf3, 0x2f, 0xd7, 0xf1, 0x03,
+   0xff, 0xfb, 0x08, 0xff, 0x0f, 0xfd, 0xf3, 0x04, 0xf3, 0x04, 0xfc, 0xfa,
+   0xf9, 0xf4, 0x30, 0xe3, 0xf2, 0x0c, 0xf9, 0x05, 0xf8, 0x09, 0x13, 0x12,
+   0xf7, 0x07, 0xf2, 0xfd, 0xff, 0x05, 0x09, 0xf6, 0x2f, 0xdf, 0xea, 0x03,
+   0x02, 0xf8, 0xf4, 0x08, 0x0d, 0x00, 0xf6, 0xf4, 0xfa, 0xfe, 0xfc, 0x02,
+   0x01, 0xfb, 0x2a, 0xe3, 0xe3, 0x0f, 0xfd, 0xf6, 0xe5, 0x13, 0x0a, 0x23,
+   0xef, 0x05, 0xee, 0xfc, 0xfc, 0x0e, 0xfa, 0xf6, 0x0e, 0xf8, 0xde, 0x01,
+   0x05, 0xef, 0xe9, 0xf2, 0x0d, 0xdb, 0x0e, 0x0a, 0x0d, 0x10, 0x00, 0x0a,
+   0x0e, 0x0c, 0x02, 0xf1, 0xe6, 0xfd, 0x02, 0x01, 0xfc, 0x04, 0x04, 0xe1,
+   0x08, 0xfe, 0x14, 0x10, 0xfb, 0x03, 0x03, 0x09, 0x0d, 0xf6, 0xf1, 0x02,
+   0x06, 0xf7, 0x01, 0xfd, 0xf0, 0xbc, 0x0c, 0x01, 0xfa, 0x00, 0xfe, 0xfd,
+   0x06, 0xfb, 0x0d, 0xff, 0xe8, 0x06, 0x01, 0x0d, 0xf3, 0x03, 0xf4, 0xb6,
+   0x0b, 0x02, 0xfc, 0x0c, 0xfb, 0xf6, 0xfd, 0xfa, 0x0f, 0xff, 0xe8, 0x04,
+   0xff, 0xf7, 0xf8, 0x06, 0xf7, 0xc1, 0xf9, 0xf4, 0xf6, 0xff, 0x04, 0xf9,
+   0x06, 0xfb, 0x1b, 0xf4, 0xea, 0x0e, 0xf3, 0x0b, 0xfd, 0x0f, 0x04, 0xdf,
+   0x0b, 0xfd, 0x01, 0x13, 0xfd, 0x00, 0x08, 0xf1, 0x16, 0xee, 0xd9, 0xfc,
+   0xfc, 0x0c, 0x04, 0x0a, 0x09, 0xe8, 0xf1, 0xf6, 0xec, 0x10, 0xfa, 0x01,
+   0x13, 0xfd, 0x1a, 0xfc, 0xed, 0x04, 0xfa, 0xf3, 0x07, 0x06, 0x0a, 0xd0,
+   0xf6, 0xf8, 0xf7, 0x0a, 0xf8, 0x00, 0x09, 0xf1, 0x2a, 0x21, 0x1a, 0x29,
+   0x0b, 0x0d, 0x04, 0xf8, 0x13, 0x02, 0x15, 0xf6, 0x0e, 0xfc, 0x00, 0xf7,
+   0xfe, 0xf3, 0x27, 0x1b, 0x18, 0x25, 0x04, 0x0a, 0x0a, 0x04, 0x0c, 0xfc,
+   0x1a, 0xfb, 0x09, 0xf8, 0xff, 0xf9, 0xfc, 0xf1, 0x2c, 0x1b, 0x16, 0x24,
+   0xf6, 0x07, 0xf4, 0xfa, 0x0d, 0xf4, 0x17, 0x03, 0x08, 0x05, 0xfe, 0xf5,
+   0xfb, 0xed, 0x22, 0x16, 0x11, 0x21, 0x06, 0x06, 0x10, 0x07, 0x04, 0xf7,
+   0x13, 0xfe, 0x02, 0x01, 0xff, 0xf8, 0xfe, 0xf6, 0x27, 0x17, 0x0a, 0x20,
+   0x01, 0x05, 0xef, 0xfd, 0xfd, 0xf3, 0x16, 0xf5, 0x04, 0x08, 0xfe, 0xf6,
+   0xfc, 0xef, 0x21, 0x10, 0x0f, 0x1c, 0x06, 0x07, 0x11, 0xfa, 0x05, 0xfd,
+   0x19, 0xfb, 0xfa, 0x01, 0xff, 0xfe, 0xff, 0xfa, 0x20, 0x0d, 0x0a, 0x19,
+   0x06, 0x02, 0xd2, 0xdc, 0x0a, 0xfc, 0x21, 0xfc, 0x03, 0x0e, 0xfd, 0xf5,
+   0xf9, 0xf2, 0x21, 0x16, 0x04, 0x1f, 0x02, 0xfb, 0xc7, 0xd3, 0x05, 0xfe,
+   0x13, 0xfd, 0x02, 0x08, 0xff, 0xfb, 0x04, 0xf7, 0x16, 0x07, 0x1a, 0x0d,
+   0x17, 0x09, 0xfc, 0xfa, 0xed, 0xfd, 0x1c, 0x09, 0xca, 0x18, 0x04, 0x07,
+   0xf7, 0xf6, 0x15, 0x01, 0x18, 0x14, 0x05, 0x05, 0x02, 0x01, 0xf1, 0xe7,
+   0x18, 0x09, 0xcf, 0x0d, 0x02, 0x00, 0x00, 0x06, 0x16, 0x01, 0x1a, 0x0e,
+   0x0d, 0x07, 0xfd, 0xf9, 0xe1, 0x07, 0x0b, 0xfb, 0xce, 0x0d, 0x00, 0x06,
+   0x03, 0xf8, 0x13, 0x06, 0x15, 0x09, 0x0c, 0x04, 0x04, 0x08, 0xd3, 0xf7,
+   0x0b, 0x00, 0xd7, 0x10, 0x05, 0x06, 0xf9, 0x00, 0x05, 0x0b, 0x17, 0x07,
+   0x07, 0x03, 0xfb, 0xff, 0xdd, 0x06, 0x06, 0x04, 0xe1, 0x13, 0x07, 0x02,
+   0x06, 0x00, 0x05, 0x03, 0x15, 0x01, 0x08, 0x05, 0xf0, 0x04, 0xba, 0xff,
+   0xff, 0xf6, 0xdf, 0x0f, 0x00, 0xfc, 0xf6, 0x04, 0xfe, 0xfe, 0x11, 0x02,
+   0x11, 0x02, 0xd3, 0xf7, 0xa5, 0x00, 0x03, 0xf7, 0xe3, 0x14, 0x0d, 0xff,
+   0x07, 0x06, 0x04, 0x06, 0x12, 0x01, 0x09, 0x0b, 0xd8, 0xf4, 0x85, 0xfc,
+   0xf8, 0xfb, 0xd5, 0x09, 0x0a, 0xf5, 0xf3, 0x02, 0xff, 0x01, 0xfb, 0x06,
+   0x02, 0xf8, 0xff, 0xfb, 0x22, 0x0b, 0xd2, 0x07, 0xfc, 0x09, 0x05, 0xef,
+   0xf4, 0x0c, 0xfb, 0x05, 0xf5, 0xf7, 0x05, 0xfa, 0xfd, 0x0c, 0xf6, 0xfe,
+   0xd3, 0x06, 0x00, 0x0a, 0xf2, 0xfa, 0x09, 0x02, 0x05, 0xfb, 0xf4, 0x0a,
+   0x08, 0x0b, 0x07, 0xf7, 0x0f, 0x06, 0xd2, 0xfd, 0x06, 0x0a, 0x04, 0x0a,
+   0x07, 0xf6, 0x05, 0x07, 0xfa, 0x07, 0x01, 0xfc, 0x04, 0x06, 0xfa, 0x06,
+   0xd5, 0x01, 0xf5, 0x0b, 0x01, 0x02, 0x04, 0x00, 0x0b, 0xfe, 0x07, 0x0d,
+   0x05, 0xfb, 0x04, 0x06, 0x05, 0xf9, 0xcf, 0xf4, 0xfe, 0x0a, 0xf7, 0xfc,
+   0x02, 0xfe, 0x00, 0xf5, 0xe8, 0xf7, 0xfd, 0x04, 0xf4, 0x0f, 0x03, 0x0c,
+   0xc3, 0xfb, 0x00, 0x02, 0x02, 0xf9, 0xf1, 0x04, 0xfc, 0x03, 0xf3, 0x00,
+   0xff, 0x00, 0x02, 0xf7, 0x16, 0x04, 0xb8, 0xff, 0xf5, 0x08, 0xfb, 0xf4,
+   0x03, 0xf8, 0xf9, 0xfd, 0xf3, 0x00, 0x02, 0xf1, 0x08, 0xfc, 0x13, 0x08,
+   0xaa, 0xf8, 0xfc, 0x09, 0xfe, 0xf6, 0xfd, 0xf1, 0xa8, 0xff, 0x05, 0xd2,
+   0xea, 0xf7, 0x06, 0xfe, 0x0a, 0x0a, 0xfb, 0x0e, 0xec, 0x01, 0xe2, 0x06,
+   0xed, 0xfd, 0xac, 0xfd, 0xfd, 0xcf, 0xf7, 0xfd, 0x00, 0xff, 0xf9, 0xfe,
+   0x08, 0x01, 0x01, 0xf8, 0xe9, 0xfe, 0xfe, 0xf5, 0xb1, 0x01, 0xfc, 0xda,
+   0xf9, 0xf9, 0x00, 0xfc, 0x0d, 0x03, 0x01, 0x04, 0x01, 0xfb, 0xe9, 0xff,
+   0xf9, 0x02, 0xb3, 0xff, 0xfb, 0xd7, 0xfe, 0xfd, 0x02, 0x05, 0xf8, 0xf6,
+   0x06, 0x07, 0xf1, 0xfb, 0xe6, 0x0f, 0xfc, 0x03, 0xb2, 0xfd, 0xfe, 0xdb,
+   0xf5, 0xff, 0x04, 0xf9, 0x05, 0x05, 0xfe, 0x06, 0x00, 0x02, 0xe2, 0x09,
+   0xf3, 0x05, 0xb9, 0x08, 0xfe, 0xdd, 0xfd, 0x05, 0xff, 0x0b, 0xf5, 0xf7,
+   0x04, 0x02, 0xf9, 0x02, 0xeb, 0x02, 0xfd, 0xfa, 0xb5, 0xf2, 0x09, 0xd8,
+   0xfd, 0xfd, 0x1b, 0x07, 0x04, 0xfb, 0x01, 0x0a, 0xf9, 0x03, 0xe6, 0x0f,
+   0xff, 0x0b, 0xc4, 0x01, 0x0a, 0xe2, 0xfa, 0x02, 0x3c, 0x06, 0xff, 0xfc,
+   0x03, 0x05, 0xff, 0x03, 0xf0, 0x0a, 0xf8, 0xfe, 0x0d, 0xc7, 0xde, 0xe9,
+   0xfd, 0xf9, 0xff, 0xfc, 0x00, 0x03, 0xfb, 0xf7, 0x16, 0xe9, 0x05, 0xf2,
+   0x02, 0xf7, 0x15, 0xdf, 0xbe, 0xf5, 0x00, 0xf7, 0x02, 0xf7, 0x08, 0xff,
+   0xfa, 0x06, 0x08, 0xf4, 0xfe, 0x01, 0x03, 0xf9, 0x17, 0xca, 0xe0, 0xf1,
+   0x0c, 0x05, 0x02, 0xf8, 0x10, 0xf7, 0xf6, 0xfe, 0x08, 0xf4, 0x02, 0x05,
+   0x06, 0xfd, 0x0b, 0xd0, 0xd9, 0xe5, 0x02, 0xfb, 0xf6, 0xf9, 0x0a, 0xfb,
+   0xf8, 0x06, 0x09, 0xf5, 0x01, 0x07, 0x0a, 0x03, 0x1b, 0xd0, 0xdd, 0xeb,
+   0x00, 0x06, 0x01, 0x03, 0xfd, 0xfe, 0xfc, 0x01, 0x11, 0x01, 0x08, 0x02,
+   0x08, 0xf5, 0x17, 0xd3, 0xd7, 0xf5, 0xf4, 0xea, 0xfb, 0x0a, 0x04, 0x04,
+   0x0a, 0xfb, 0x06, 0xfa, 0x04, 0x01, 0x06, 0x02, 0x10, 0xd9, 0xd9, 0xea,
+   0xf8, 0x02, 0x09, 0x20, 0xff, 0xf6, 0x05, 0x08, 0x0c, 0x00, 0x03, 0x0e,
+   0xfa, 0x09, 0x18, 0xe6, 0xbe, 0xf7, 0xf5, 0xeb, 0x0e, 0x3b, 0xf4, 0xfc,
+   0x0b, 0xfa, 0xfd, 0x08, 0x07, 0x04, 0x09, 0x07, 0xca, 0x20, 0x04, 0xec,
+   0xee, 0x0e, 0xfa, 0x04, 0x0e, 0xfc, 0xff, 0xfb, 0xff, 0x16, 0xf9, 0xf7,
+   0x10, 0xf9, 0xca, 0x2b, 0x1e, 0xf5, 0xfc, 0xfd, 0xff, 0x04, 0xf9, 0x0c,
+   0xfb, 0x06, 0x03, 0x06, 0xfc, 0xf7, 0x05, 0x01, 0xca, 0x0d, 0x0c, 0xea,
+   0xf9, 0x08, 0xf0, 0x00, 0x0d, 0x0a, 0x06, 0xfc, 0x10, 0x08, 0xfc, 0x01,
+   0x19, 0xf0, 0xc5, 0x1e, 0x31, 0xec, 0x07, 0xfa, 0x00, 0x03, 0xfa, 0x0c,
+   0xff, 0xfc, 0x01, 0x02, 0x05, 0xf4, 0x06, 0xfe, 0xc1, 0x16, 0x12, 0xea,
+   0xfc, 0xfd, 0xfc, 0x00, 0x08, 0x07, 0x03, 0xf3, 0xfd, 0xf8, 0x00, 0x05,
+   0x15, 0xf9, 0xbf, 0x1c, 0x2b, 0xee, 0x00, 0x02, 0x07, 0xfd, 0xfe, 0x17,
+   0x02, 0xf1, 0x1a, 0xff, 0x00, 0xf0, 0x0c, 0xff, 0xb5, 0x12, 0x24, 0xe1,
+   0x02, 0x0f, 0x0b, 0xf6, 0x01, 0x0b, 0xf6, 0xf8, 0xfe, 0xfb, 0x05, 0xff,
+   0x15, 0x01, 0xbd, 0x14, 0x35, 0xe8, 0xfc, 0xf6, 0x12, 0xec, 0xff, 0x16,
+   0x08, 0xf0, 0x12, 0x06, 0x05, 0xf4, 0x06, 0xfc, 0xf2, 0x05, 0x14, 0xff,
+   0xf9, 0x0a, 0x04, 0xfe, 0xdd, 0xf7, 0xb5, 0xff, 0x14, 0x19, 0x04, 0x08,
+   0x01, 0xf7, 0xff, 0x02, 0x02, 0xff, 0xf7, 0xfc, 0x0f, 0x09, 0xea, 0x09,
+   0xb8, 0xfd, 0x08, 0x07, 0x08, 0x04, 0x05, 0xf9, 0xf9, 0xfd, 0x09, 0xfc,
+   0xf7, 0x04, 0xf6, 0x02, 0xe1, 0x01, 0xae, 0xf8, 0x0b, 0x0b, 0x03, 0xfb,
+   0xfb, 0xfc, 0xfd, 0x0a, 0x16, 0xf2, 0x03, 0x03, 0x0d, 0xfe, 0xec, 0x02,
+   0xa5, 0x03, 0x09, 0x0f, 0x06, 0x06, 0xfe, 0x07, 0x01, 0xfe, 0x0f, 0xfd,
+   0x05, 0x03, 0x00, 0xfe, 0xd8, 0xfd, 0xa7, 0xff, 0x08, 0x14, 0x0a, 0x07,
+   0xff, 0xfd, 0xf7, 0xfa, 0x0f, 0xf7, 0x01, 0xfd, 0x04, 0xf5, 0xdb, 0x0d,
+   0x9b, 0x04, 0x15, 0x08, 0x0a, 0x0c, 0x07, 0xf4, 0xea, 0xf3, 0x12, 0xf1,
+   0x0c, 0x0b, 0xf0, 0xff, 0xca, 0xfe, 0x91, 0x07, 0x04, 0x07, 0xf8, 0x09,
+   0xf8, 0x01, 0xd8, 0x04, 0x0b, 0xeb, 0x1b, 0x04, 0xf7, 0x01, 0xb7, 0x02,
+   0x81, 0xfc, 0x0e, 0x16, 0x05, 0x0e, 0x05, 0x08, 0xec, 0xf8, 0xf8, 0xeb,
+   0xea, 0x07, 0xe7, 0xf4, 0xd1, 0x17, 0xfd, 0xf1, 0x06, 0xfd, 0x07, 0xf8,
+   0xff, 0x06, 0xeb, 0xf6, 0x03, 0xf0, 0xfd, 0xfe, 0xf1, 0xeb, 0xed, 0x2f,
+   0xfc, 0xe8, 0x0b, 0xfd, 0x08, 0x0b, 0x04, 0x11, 0xea, 0xeb, 0xf1, 0xe9,
+   0x07, 0x0b, 0xf6, 0x0c, 0xd7, 0x13, 0xfa, 0xec, 0x01, 0xfe, 0x09, 0xfa,
+   0xfe, 0x10, 0xee, 0xf9, 0xf9, 0xf3, 0x05, 0xe7, 0xfa, 0xf2, 0xe9, 0x27,
+   0x01, 0xf0, 0x03, 0x02, 0x0f, 0x00, 0xf9, 0x10, 0xed, 0xea, 0xf0, 0xed,
+   0x07, 0xfd, 0xfc, 0x0b, 0xdd, 0x02, 0x03, 0xeb, 0xfc, 0xfe, 0xfa, 0xf5,
+   0x02, 0x05, 0xf3, 0xfa, 0x08, 0x04, 0xfc, 0xe8, 0x0f, 0xf5, 0xf6, 0x2d,
+   0x07, 0xf1, 0x04, 0x08, 0x0b, 0xfa, 0xea, 0x17, 0xf5, 0xfe, 0xf4, 0xf2,
+   0x06, 0x0a, 0x02, 0x1b, 0xe3, 0x19, 0x09, 0xec, 0x03, 0x07, 0xfe, 0xf7,
+   0x02, 0x04, 0xfc, 0xf8, 0xfd, 0xff, 0x04, 0xf8, 0x0a, 0x18, 0xe1, 0x05,
+   0x0c, 0xe0, 0x05, 0x0d, 0x03, 0xe8, 0xfa, 0x00, 0x3f, 0xfd, 0x03, 0x26,
+   0x17, 0x02, 0xf7, 0xfb, 0xe8, 0x1c, 0xfe, 0xec, 0x00, 0xf8, 0xf8, 0xef,
+   0xf3, 0x08, 0x31, 0x08, 0x01, 0x22, 0x0e, 0xff, 0xf7, 0xfc, 0xe4, 0x13,
+   0xfe, 0xf1, 0x01, 0xfa, 0xf8, 0xf1, 0xfb, 0xff, 0x38, 0xfd, 0xf8, 0x1d,
+   0x02, 0x01, 0xea, 0xff, 0xe2, 0x0e, 0xfa, 0xed, 0xfd, 0xfa, 0xf9, 0xee,
+   0xfe, 0x07, 0x32, 0x06, 0x0c, 0x18, 0x0a, 0xfd, 0xef, 0xf7, 0xe0, 0x08,
+   0xfa, 0xf3, 0xfc, 0xfe, 0xfb, 0xf5, 0xf9, 0x05, 0x31, 0xfe, 0xfd, 0x15,
+   0x07, 0x0c, 0xe4, 0xfd, 0xe4, 0x0f, 0xfa, 0xf3, 0x05, 0xfe, 0xfa, 0xf3,
+   0xf9, 0x0b, 0x29, 0x04, 0x11, 0x1c, 0xf2, 0xfb, 0xf0, 0xf3, 0xe8, 0x0b,
+   0xf9, 0xfe, 0x02, 0x0c, 0xfd, 0xfa, 0x07, 0x0c, 0x21, 0xfc, 0xf3, 0x11,
+   0x16, 0x0d, 0xd1, 0xed, 0xea, 0x09, 0xf5, 0xff, 0x01, 0x00, 0xfb, 0xfd,
+   0x04, 0x0d, 0x17, 0xff, 0xef, 0x0c, 0x15, 0xfe, 0xbf, 0xf1, 0xe5, 0x0f,
+   0xee, 0xfd, 0x01, 0x01, 0xfe, 0x07, 0x10, 0x0b, 0x01, 0x1a, 0x27, 0x19,
+   0xe4, 0x09, 0x06, 0xfe, 0xf2, 0xf5, 0x0a, 0xeb, 0xe3, 0xd9, 0xf4, 0xfc,
+   0xf5, 0xf7, 0x0e, 0x07, 0x15, 0x0f, 0xf7, 0xfe, 0x06, 0x05, 0xf5, 0x05,
+   0x0a, 0xea, 0xdf, 0xd6, 0xfd, 0x06, 0xf7, 0xfd, 0x13, 0x0f, 0x16, 0x12,
+   0xf1, 0x03, 0x13, 0x00, 0x05, 0xf7, 0x04, 0xdd, 0xde, 0xd0, 0x00, 0x04,
+   0xfe, 0xff, 0x12, 0x08, 0x16, 0x13, 0x0a, 0x06, 0x11, 0xfb, 0x0a, 0x0e,
+   0x00, 0xdd, 0xcb, 0xc2, 0xfe, 0xfd, 0xf8, 0x04, 0x13, 0x09, 0x14, 0x0c,
+   0xf4, 0x01, 0xef, 0x02, 0x1e, 0xff, 0x0e, 0xdd, 0xd0, 0xd2, 0x01, 0x0f,
+   0xf9, 0x00, 0x17, 0x01, 0xff, 0x10, 0x0a, 0x02, 0xe6, 0xff, 0x1e, 0x07,
+   0x04, 0xe6, 0xd0, 0xc9, 0x05, 0xfc, 0xf8, 0xfe, 0x27, 0x05, 0x16, 0x14,
+   0xe6, 0x04, 0xd3, 0xf0, 0x29, 0xf5, 0x10, 0xe5, 0xd1, 0xcf, 0xfc, 0x02,
+   0x0c, 0x09, 0x26, 0xf9, 0x0c, 0x14, 0x02, 0x01, 0xce, 0xd5, 0x07, 0xf9,
+   0x1d, 0xe0, 0xd1, 0xcb, 0x03, 0x05, 0x07, 0x01, 0x0d, 0xfa, 0xf5, 0xfe,
+   0x03, 0xf7, 0xff, 0x02, 0x19, 0x0d, 0xcf, 0x13, 0xfe, 0x09, 0x00, 0xff,
+   0xfa, 0xff, 0x17, 0xf5, 0xf5, 0xfd, 0x04, 0x01, 0xf9, 0x05, 0x1d, 0x0a,
+   0xcc, 0x02, 0x07, 0x05, 0x01, 0xf5, 0x04, 0x04, 0x16, 0xfb, 0x07, 0x09,
+   0xfc, 0xfc, 0xf2, 0xfa, 0xf8, 0x0b, 0xcc, 0xff, 0xfe, 0x08, 0x07, 0xfc,
+   0xe7, 0x0e, 0x15, 0x03, 0xfc, 0x08, 0x07, 0x09, 0xfd, 0x03, 0x0c, 0x02,
+   0xc9, 0xf4, 0xfe, 0x0a, 0x05, 0x00, 0xfd, 0x08, 0x11, 0xfa, 0xff, 0xff,
+   0x01, 0xf8, 0xfe, 0xf1, 0xfe, 0x12, 0xc3, 0xee, 0xf9, 0x03, 0xf9, 0x05,
+   0xf3, 0x04, 0x13, 0xfb, 0x08, 0x06, 0x03, 0xff, 0xff, 0x04, 0x0d, 0x02,
+   0xbb, 0xe8, 0xfb, 0x0f, 0xff, 0x07, 0x05, 0x00, 0x0e, 0x00, 0xfa, 0x08,
+   0x06, 0xff, 0x08, 0x0e, 0xf9, 0x09, 0xb4, 0xf3, 0xf8, 0x05, 0x03, 0x0a,
+   0xfd, 0x0b, 0x0d, 0xfc, 0xfa, 0x04, 0x04, 0x03, 0x1a, 0x00, 0x02, 0x08,
+   0xaf, 0xf4, 0xef, 0xfd, 0x02, 0x17, 0x0e, 0x0f, 0x22, 0xd9, 0xd7, 0xee,
+   0x05, 0xf5, 0xf6, 0xf1, 0xf1, 0x02, 0xc9, 0xe3, 0xba, 0x06, 0x04, 0xf2,
+   0xfb, 0x04, 0x1b, 0xe6, 0xe0, 0xe9, 0x1e, 0x02, 0x08, 0xfa, 0x0c, 0x06,
+   0xc8, 0xe4, 0xc7, 0xfb, 0xfb, 0xfb, 0xfe, 0xfe, 0x05, 0xe1, 0xd9, 0x02,
+   0x16, 0xff, 0xfe, 0x00, 0xff, 0x00, 0xb4, 0xde, 0xc2, 0xec, 0x07, 0x0e,
+   0x01, 0xfa, 0x01, 0xe1, 0xd2, 0xe4, 0x13, 0xf4, 0x01, 0x02, 0x04, 0x02,
+   0xb6, 0xd7, 0xcf, 0xf0, 0x09, 0x01, 0x0b, 0xff, 0xf3, 0xde, 0xd0, 0xe5,
+   0x0f, 0xfc, 0xff, 0xfe, 0xf8, 0x00, 0xa1, 0xdc, 0xdd, 0xf5, 0x07, 0xff,
+   0x09, 0x02, 0xf4, 0xf6, 0xd5, 0xf3, 0x09, 0xff, 0x00, 0x07, 0x09, 0xfe,
+   0xa1, 0xd5, 0xea, 0x05, 0x0c, 0x00, 0x0d, 0xfa, 0xf6, 0xe4, 0xd8, 0xed,
+   0xf8, 0xf9, 0xed, 0x17, 0xf4, 0xfd, 0x9b, 0xe0, 0xea, 0x0b, 0x08, 0xfe,
+   0x04, 0x00, 0x09, 0xe9, 0xf4, 0xf0, 0xf4, 0x03, 0xfb, 0x1f, 0x18, 0x00,
+   0x96, 0xe7, 0xf4, 0x18, 0x06, 0xfb, 0x0c, 0x05, 0xd8, 0x13, 0x37, 0xfb,
+   0x06, 0x1b, 0x00, 0x07, 0xf9, 0xf2, 0xef, 0xf2, 0x0b, 0x03, 0xfa, 0x0f,
+   0xf8, 0xee, 0xe0, 0x13, 0x32, 0xfa, 0xfb, 0xf4, 0xfa, 0x05, 0x09, 0xe6,
+   0xe8, 0xf8, 0xfe, 0xf4, 0xf6, 0x00, 0xf1, 0xeb, 0xe5, 0x13, 0x1a, 0xf2,
+   0xf9, 0x06, 0xff, 0x01, 0xf9, 0xf3, 0xf0, 0xfa, 0x08, 0x14, 0xfe, 0x09,
+   0xfa, 0xee, 0xe2, 0x20, 0x28, 0xfe, 0xfc, 0x05, 0x0c, 0x00, 0x1b, 0xea,
+   0xea, 0xfe, 0x05, 0x01, 0xfd, 0x01, 0x05, 0xf2, 0xe3, 0x12, 0x1d, 0xf3,
+   0xf4, 0x02, 0x09, 0x12, 0xfe, 0xf1, 0xf3, 0x12, 0x04, 0x0c, 0x04, 0x08,
+   0xf5, 0xf2, 0xe2, 0x16, 0x24, 0xf7, 0x01, 0xf7, 0xf2, 0xee, 0x11, 0xe0,
+   0xef, 0xf7, 0x09, 0x10, 0xfd, 0x0c, 0xfa, 0xfc, 0xdb, 0x0e, 0x13, 0xf3,
+   0xfe, 0x09, 0x13, 0xfa, 0xfe, 0xef, 0xf8, 0x07, 0x0b, 0x18, 0x00, 0x14,
+   0xf1, 0xef, 0xd5, 0x13, 0x1a, 0xef, 0x06, 0x06, 0xee, 0xea, 0xfa, 0xea,
+   0xfc, 0xf4, 0x13, 0x0e, 0xfb, 0x16, 0xf1, 0xef, 0xe0, 0xfa, 0x11, 0xee,
+   0xe8, 0xfc, 0xf5, 0xf2, 0x08, 0xe9, 0xfe, 0x08, 0xff, 0x05, 0x04, 0xff,
+   0xf9, 0x04, 0xe9, 0xf3, 0x20, 0xe6, 0xfb, 0x08, 0xf1, 0xef, 0x16, 0xde,
+   0xfd, 0x07, 0x00, 0x05, 0x00, 0xfe, 0xf5, 0x04, 0xf2, 0xfb, 0x19, 0xec,
+   0xfd, 0x00, 0xfb, 0x01, 0xfb, 0xe8, 0x02, 0x05, 0x0e, 0x02, 0x05, 0xff,
+   0xf5, 0x05, 0xed, 0xf7, 0x12, 0xeb, 0xf4, 0x08, 0xf3, 0xfa, 0x09, 0xcd,
+   0xff, 0x13, 0xfb, 0x08, 0xfe, 0xf3, 0xf4, 0xfb, 0xf5, 0xfd, 0x10, 0xf2,
+   0xf9, 0xfc, 0xf9, 0xed, 0xf2, 0xde, 0x00, 0x01, 0xfb, 0xfd, 0x01, 0xf6,
+   0xee, 0xfc, 0xf9, 0xff, 0x12, 0xf2, 0xfc, 0xfe, 0x06, 0xf5, 0x07, 0xd1,
+   0xfe, 0x0a, 0xfc, 0x00, 0x04, 0xef, 0xf2, 0xfa, 0xfa, 0x0e, 0x17, 0x02,
+   0xf1, 0xe6, 0x12, 0xfc, 0x02, 0xe9, 0xff, 0x0f, 0xf6, 0xfe, 0xff, 0xf2,
+   0xf3, 0x04, 0x01, 0x05, 0x10, 0x04, 0xf6, 0x18, 0x0a, 0x00, 0x09, 0xe0,
+   0x02, 0x07, 0xf6, 0x0a, 0x01, 0xfa, 0xff, 0xfb, 0x15, 0xde, 0xd3, 0xee,
+   0xfe, 0xfd, 0x03, 0xff, 0xf4, 0xfe, 0xe9, 0x09, 0xff, 0x05, 0xff, 0x05,
+   0xfb, 0x08, 0x18, 0xe4, 0xd0, 0xf3, 0x00, 0xf9, 0xf5, 0xfb, 0x07, 0xff,
+   0xec, 0x09, 0x11, 0x06, 0xfd, 0x03, 0xf5, 0x00, 0x0b, 0xdf, 0xcf, 0xf9,
+   0xfa, 0x06, 0xfd, 0x00, 0xf1, 0x03, 0xeb, 0x05, 0xfd, 0x05, 0x04, 0x06,
+   0x03, 0x04, 0x17, 0xd9, 0xd1, 0xfa, 0xfe, 0xfe, 0x05, 0xfa, 0x12, 0x07,
+   0xea, 0x07, 0xfe, 0x0f, 0x01, 0x0b, 0xfd, 0x04, 0x12, 0xd8, 0xd3, 0xf4,
+   0xfb, 0xff, 0x03, 0x04, 0xfa, 0x03, 0xe9, 0x0a, 0xf0, 0x0f, 0x04, 0x06,
+   0xfc, 0x09, 0x15, 0xd7, 0xbf, 0xed, 0xfc, 0x02, 0x0b, 0xf8, 0x13, 0xf4,
+   0xe9, 0x01, 0xfe, 0x08, 0x08, 0x01, 0xf3, 0xfe, 0x16, 0xdc, 0xd1, 0xf4,
+   0x0d, 0xee, 0xf7, 0x13, 0x00, 0xf8, 0xea, 0x0a, 0xf0, 0x1b, 0xf7, 0x10,
+   0x00, 0x0c, 0x0f, 0xec, 0xc8, 0xfc, 0x00, 0xef, 0x0c, 0x28, 0x01, 0xed,
+   0xeb, 0x07, 0xfa, 0x13, 0xfd, 0xf9, 0xf4, 0x08, 0xf6, 0xff, 0xec, 0xf3,
+   0xe6, 0x07, 0xea, 0x0d, 0xf0, 0xf0, 0x04, 0x06, 0xf9, 0x16, 0x01, 0xfe,
+   0x0a, 0x05, 0xec, 0x0a, 0xe1, 0xee, 0xfe, 0xfb, 0xff, 0xfa, 0xf4, 0x07,
+   0x03, 0xf8, 0xfe, 0x13, 0x01, 0x05, 0x06, 0xff, 0xf9, 0x09, 0xf5, 0x05,
+   0xf2, 0xf3, 0xf1, 0x08, 0xe2, 0x02, 0x0d, 0x04, 0xf1, 0x17, 0x01, 0xfc,
+   0x07, 0x01, 0xeb, 0x14, 0xf6, 0x01, 0x0c, 0xfd, 0xfd, 0xf1, 0xf4, 0x12,
+   0x09, 0xfc, 0xf6, 0x0d, 0x00, 0x05, 0xff, 0x07, 0xf4, 0x13, 0xea, 0x01,
+   0xf6, 0xfd, 0xfa, 0xfd, 0xd8, 0x1a, 0x02, 0xf4, 0xe5, 0x07, 0x03, 0xfb,
+   0x13, 0x06, 0xea, 0x14, 0xf4, 0x01, 0x0f, 0x00, 0x0c, 0xf5, 0xe7, 0x1e,
+   0x02, 0xfa, 0xf9, 0x05, 0x05, 0xf8, 0x00, 0x0c, 0xf4, 0x0f, 0xfd, 0xfb,
+   0xf8, 0xff, 0x06, 0x03, 0xc7, 0x1b, 0x0d, 0xfe, 0xe7, 0x0e, 0x04, 0xfb,
+   0x07, 0x00, 0xec, 0x0e, 0xfc, 0xf8, 0x0e, 0x05, 0x0b, 0x08, 0xc8, 0x1a,
+   0x0e, 0xf6, 0xec, 0x0f, 0xfe, 0xf0, 0x06, 0x0d, 0xee, 0x00, 0x16, 0xfc,
+   0xfb, 0x15, 0xed, 0xfa, 0xef, 0x04, 0xf3, 0x04, 0x03, 0x04, 0xf5, 0x1e,
+   0xf8, 0xed, 0xf5, 0x06, 0x15, 0xf6, 0xf7, 0x05, 0xe0, 0x02, 0xf6, 0xf9,
+   0x07, 0x03, 0xff, 0x06, 0xed, 0x14, 0xf1, 0xfb, 0xf2, 0xfe, 0x10, 0xf9,
+   0x05, 0x0d, 0xfa, 0xfd, 0xf8, 0xfe, 0x13, 0x03, 0x0b, 0x11, 0xe6, 0x17,
+   0xec, 0xfc, 0xf7, 0xf8, 0x0e, 0xf4, 0xff, 0x00, 0xdd, 0x04, 0xf8, 0xfd,
+   0xfb, 0x05, 0x02, 0x00, 0xe1, 0x16, 0xef, 0xeb, 0xf6, 0xf7, 0x02, 0xf4,
+   0x08, 0x09, 0xf2, 0xfd, 0x04, 0xfe, 0xf5, 0x10, 0x17, 0x12, 0xd7, 0x11,
+   0xeb, 0xf3, 0xf7, 0xf8, 0x1c, 0xfa, 0xfc, 0xf4, 0xe6, 0xfd, 0x02, 0x06,
+   0xfb, 0x00, 0x0c, 0xf9, 0xdc, 0x13, 0xf7, 0xfd, 0xee, 0x04, 0x08, 0xf3,
+   0x05, 0xfb, 0xf5, 0xfe, 0x01, 0x04, 0x0b, 0x14, 0x0c, 0xfb, 0xd4, 0x1b,
+   0xe7, 0xfd, 0xf3, 0x02, 0x1a, 0xf4, 0xf6, 0x11, 0xef, 0xf3, 0x0d, 0xfc,
+   0x07, 0x07, 0x09, 0xed, 0xd7, 0x21, 0xec, 0xf4, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00,
+   0x08, 0x00, 0x04, 0x00, 0x06, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00,
+ };
+ const unsigned int g_model_data_len = 6304;
+ 
+ const int g_model_feature_count = 18;
+ const int g_model_window = 8;
+ 
+ const float g_feature_mean[] = { 94.056435f, 133.643050f, 61.320205f, 113.849743f, -0.007551f, -0.009117f, 977.024650f, 677.027475f, 0.572153f, 0.667537f, 92.371669f, 60.730898f, 61.515049f, 58.796920f, 61.087373f, 43.173184f, 43.081774f, 41.427203f };
+ const float g_feature_std[] = { 88.260482f, 84.961667f, 73.126465f, 74.960402f, 47.017004f, 39.387556f, 3465.275555f, 2641.760601f, 0.726495f, 0.810486f, 385.778800f, 91.152365f, 94.602914f, 88.368474f, 417.126787f, 73.645832f, 70.880702f, 68.009472f };
+ 
+ #endif
\ No newline at end of file
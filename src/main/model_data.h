@@ -0,0 +1,25 @@
+/*
+ * model_data.h
+ *
+ * Int8 obstacle classifier. model_data.cpp and model_ops.h are written
+ * by src/ai_model/export_model.py: the TFLite flatbuffer, the feature
+ * scaler it was trained with and the ops it uses. Only needed when
+ * SMARTGUIDE_USE_TFLITE is defined.
+ */
+
+ #ifndef MODEL_DATA_H
+ #define MODEL_DATA_H
+ 
+ // Flatbuffer, aligned for in-place use by the interpreter
+ extern const unsigned char g_model_data[];
+ extern const unsigned int g_model_data_len;
+ 
+ // Input layout the model was trained on, checked at startup
+ extern const int g_model_feature_count;
+ extern const int g_model_window;
+ 
+ // Per-feature normalization in firmware units (cm, cm per step, ...)
+ extern const float g_feature_mean[];
+ extern const float g_feature_std[];
+ 
+ #endif
\ No newline at end of file
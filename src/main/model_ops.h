@@ -0,0 +1,15 @@
+/*
+ * model_ops.h
+ *
+ * Generated by src/ai_model/export_model.py, do not edit.
+ * TFLite Micro ops of the model in model_data.cpp, in the order of
+ * its operator codes.
+ */
+
+ #ifndef MODEL_OPS_H
+ #define MODEL_OPS_H
+ 
+ #define MODEL_OP_COUNT 2
+ #define MODEL_OPS(OP) OP(FullyConnected) OP(Softmax)
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+/*
+ * test_classification_gate.cpp
+ *
+ * Host unit tests for lazy classification and label hysteresis
+ */
+
+ #include <unity.h>
+ #include "../src/main/ClassificationGate.h"
+ #include "../src/main/ObstacleTypes.h"
+ 
+ typedef ClassificationGate<ObstacleType, 2> Gate;
+ 
+ // Test that the first request always runs
+ void test_first_request_runs() {
+   Gate gate(ObstacleType::UNKNOWN);
+   float fingerprint[2] = {100, 5};
+   
+   TEST_ASSERT_TRUE(gate.shouldRun(fingerprint, 0));
+   TEST_ASSERT_TRUE(gate.update(fingerprint, 0, ObstacleType::WALL, 0.92));
+   TEST_ASSERT_EQUAL((int)ObstacleType::WALL, (int)gate.getLabel());
+   TEST_ASSERT_EQUAL(1, gate.getRunCount());
+ }
+ 
+ // Test that steady features skip inference until they drift or age out
+ void test_skips_until_drift_or_age() {
+   Gate gate(ObstacleType::UNKNOWN);
+   float fingerprint[2] = {100, 5};
+   gate.update(fingerprint, 0, ObstacleType::WALL, 0.92);
+   
+   fingerprint[0] = 105;
+   TEST_ASSERT_FALSE(gate.shouldRun(fingerprint, 100));
+   fingerprint[1] = 14;
+   TEST_ASSERT_FALSE(gate.shouldRun(fingerprint, 200));
+   TEST_ASSERT_EQUAL(2, gate.getSkipCount());
+   
+   // Drift past the threshold in any element
+   fingerprint[0] = 89;
+   TEST_ASSERT_TRUE(gate.shouldRun(fingerprint, 300));
+   
+   // Too old
+   fingerprint[0] = 100;
+   fingerprint[1] = 5;
+   TEST_ASSERT_TRUE(gate.shouldRun(fingerprint, GATE_MAX_AGE_MS));
+   TEST_ASSERT_EQUAL(2, gate.getSkipCount());
+ }
+ 
+ // Test that lazy mode can be turned off
+ void test_eager_mode() {
+   Gate gate(ObstacleType::UNKNOWN);
+   float fingerprint[2] = {100, 5};
+   gate.update(fingerprint, 0, ObstacleType::WALL, 0.92);
+   gate.setLazy(false);
+   
+   TEST_ASSERT_TRUE(gate.shouldRun(fingerprint, 1));
+   TEST_ASSERT_EQUAL(0, gate.getSkipCount());
+ }
+ 
+ // Test that a single contradicting result does not flip the label
+ void test_hysteresis_holds_label() {
+   Gate gate(ObstacleType::UNKNOWN);
+   float fingerprint[2] = {0, 0};
+   gate.update(fingerprint, 0, ObstacleType::WALL, 0.92);
+   
+   // Alternating results around a boundary
+   TEST_ASSERT_FALSE(gate.update(fingerprint, 1, ObstacleType::DOOR, 0.72));
+   TEST_ASSERT_FALSE(gate.update(fingerprint, 2, ObstacleType::WALL, 0.92));
+   TEST_ASSERT_FALSE(gate.update(fingerprint, 3, ObstacleType::DOOR, 0.72));
+   TEST_ASSERT_EQUAL((int)ObstacleType::WALL, (int)gate.getLabel());
+   TEST_ASSERT_EQUAL(2, gate.getHeldCount());
+ }
+ 
+ // Test that a consistent new label wins after a few runs
+ void test_consistent_change_switches() {
+   Gate gate(ObstacleType::UNKNOWN);
+   float fingerprint[2] = {0, 0};
+   gate.update(fingerprint, 0, ObstacleType::WALL, 0.92);
+   
+   TEST_ASSERT_FALSE(gate.update(fingerprint, 1, ObstacleType::DOOR, 0.72));
+   TEST_ASSERT_FALSE(gate.update(fingerprint, 2, ObstacleType::DOOR, 0.72));
+   TEST_ASSERT_TRUE(gate.update(fingerprint, 3, ObstacleType::DOOR, 0.72));
+   TEST_ASSERT_EQUAL((int)ObstacleType::DOOR, (int)gate.getLabel());
+   TEST_ASSERT_FLOAT_WITHIN(0.001, 0.72, gate.getConfidence());
+   
+   // A much more confident result switches at once
+   TEST_ASSERT_TRUE(gate.update(fingerprint, 4, ObstacleType::STAIRS, 0.89));
+ }
+ 
+ // Test that low-confidence results are ignored
+ void test_low_confidence_ignored() {
+   Gate gate(ObstacleType::UNKNOWN);
+   float fingerprint[2] = {0, 0};
+   
+   TEST_ASSERT_FALSE(gate.update(fingerprint, 0, ObstacleType::PERSON, 0.6));
+   TEST_ASSERT_EQUAL((int)ObstacleType::UNKNOWN, (int)gate.getLabel());
+   TEST_ASSERT_EQUAL(1, gate.getRunCount());
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_first_request_runs);
+   RUN_TEST(test_skips_until_drift_or_age);
+   RUN_TEST(test_eager_mode);
+   RUN_TEST(test_hysteresis_holds_label);
+   RUN_TEST(test_consistent_change_switches);
+   RUN_TEST(test_low_confidence_ignored);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,275 @@
+/*
+ * test_distance_filter.cpp
+ *
+ * Host replay tests for the fixed-point distance filter pipeline
+ */
+
+ #include <unity.h>
+ #include <math.h>
+ #include "../src/main/DistanceFilter.h"
+ #include "test_random.h"
+ 
+ #define SAMPLE_PERIOD_US 40000   // 25 Hz per sensor
+ 
+ float gaussianNoise(float stdDev) {
+   // Sum of uniforms is close enough to normal for a replay
+   float sum = 0;
+   for (int i = 0; i < 12; i++) {
+     sum += nextUniform();
+   }
+   return (sum - 6) * stdDev;
+ }
+ 
+ // Push one raw reading through a pipeline and return the output in cm
+ template <typename Pipeline>
+ float feed(Pipeline& pipeline, float distanceCm, uint32_t timestampUs) {
+   FilterSample sample = {toFixed(distanceCm), timestampUs, true};
+   pipeline.process(sample);
+   return fromFixed(sample.distance);
+ }
+ 
+ // Test that the median removes an isolated spike
+ void test_median_removes_spike() {
+   FilterPipeline<MedianStage<3> > median;
+   
+   feed(median, 100, 0);
+   feed(median, 101, 1);
+   TEST_ASSERT_FLOAT_WITHIN(0.01, 101, feed(median, 400, 2));
+   TEST_ASSERT_FLOAT_WITHIN(0.01, 101, feed(median, 99, 3));
+   TEST_ASSERT_FLOAT_WITHIN(0.01, 99, feed(median, 98, 4));
+ }
+ 
+ // Test that the gate rejects impossible jumps and relocks on a real step
+ void test_rate_gate_relocks() {
+   RateGateStage gate;
+   gate.configure(500, 10, 2);
+   
+   FilterSample sample = {toFixed(200), 0, true};
+   gate.process(sample);
+   TEST_ASSERT_TRUE(sample.valid);
+   
+   // 200 to 80 cm in 40 ms is far faster than 500 cm/s
+   sample = {toFixed(80), SAMPLE_PERIOD_US, true};
+   gate.process(sample);
+   TEST_ASSERT_FALSE(sample.valid);
+   sample = {toFixed(80), 2 * SAMPLE_PERIOD_US, true};
+   gate.process(sample);
+   TEST_ASSERT_FALSE(sample.valid);
+   
+   // Still there after two rejections, accept it
+   sample = {toFixed(80), 3 * SAMPLE_PERIOD_US, true};
+   gate.process(sample);
+   TEST_ASSERT_TRUE(sample.valid);
+   TEST_ASSERT_EQUAL(2, gate.getRejectedCount());
+   
+   // Small moves are always fine
+   sample = {toFixed(85), 4 * SAMPLE_PERIOD_US, true};
+   gate.process(sample);
+   TEST_ASSERT_TRUE(sample.valid);
+ }
+ 
+ // Replay a static obstacle with noise, multipath spikes and spurious timeouts
+ void test_noisy_static_stream() {
+   DistanceFilter filter;
+   noiseState = 12345;
+   
+   const float truth = 150;
+   double rawSquared = 0;
+   double filteredSquared = 0;
+   float worstError = 0;
+   int samples = 0;
+   
+   for (int i = 0; i < 500; i++) {
+     float raw = truth + gaussianNoise(3);
+     float roll = nextUniform();
+     if (roll < 0.04f) {
+       raw = 400;                   // Spurious timeout
+     } else if (roll < 0.08f) {
+       raw = truth * 0.5f;          // Multipath
+     }
+     
+     float out = feed(filter, raw, i * SAMPLE_PERIOD_US);
+     if (i < 10) {
+       continue;                    // Settling
+     }
+     
+     rawSquared += (raw - truth) * (raw - truth);
+     filteredSquared += (out - truth) * (out - truth);
+     if (fabs(out - truth) > worstError) {
+       worstError = fabs(out - truth);
+     }
+     samples++;
+   }
+   
+   float rawRms = sqrt(rawSquared / samples);
+   float filteredRms = sqrt(filteredSquared / samples);
+   TEST_ASSERT_LESS_THAN(rawRms / 10, filteredRms);
+   TEST_ASSERT_LESS_THAN(3, filteredRms);
+   TEST_ASSERT_LESS_THAN(10, worstError);
+ }
+ 
+ // Replay walking towards a wall and check tracking lag and velocity
+ void test_tracks_approach() {
+   DistanceFilter filter;
+   noiseState = 777;
+   
+   float out = 0;
+   float worstError = 0;
+   for (int i = 0; i < 60; i++) {
+     float truth = 300 - 100.0f * i * SAMPLE_PERIOD_US / 1000000; // 1 m/s
+     out = feed(filter, truth + gaussianNoise(2), i * SAMPLE_PERIOD_US);
+     if (i >= 20 && fabs(out - truth) > worstError) {
+       worstError = fabs(out - truth);
+     }
+   }
+   
+   TEST_ASSERT_LESS_THAN(6, worstError);
+   TEST_ASSERT_FLOAT_WITHIN(25, -100, filter.rest().rest().first().getVelocity());
+ }
+ 
+ // Replay someone stepping in front of the cane
+ void test_step_change_latency() {
+   DistanceFilter filter;
+   
+   for (int i = 0; i < 20; i++) {
+     feed(filter, 300, i * SAMPLE_PERIOD_US);
+   }
+   
+   int samplesToReact = -1;
+   for (int i = 0; i < 20; i++) {
+     float out = feed(filter, 80, (20 + i) * SAMPLE_PERIOD_US);
+     if (out < 120) {
+       samplesToReact = i + 1;
+       break;
+     }
+   }
+   
+   // Median delay plus gate relock, about a quarter of a second
+   TEST_ASSERT_TRUE(samplesToReact > 0);
+   TEST_ASSERT_LESS_OR_EQUAL(7, samplesToReact);
+ }
+ 
+ // Replay obstacles appearing at several distances: the output must never
+ // undershoot the new distance (false danger) and must settle quickly
+ void test_step_change_settles() {
+   const float steps[][2] = {{300, 80}, {400, 100}, {400, 40}, {100, 400}, {250, 150}};
+   
+   for (int s = 0; s < 5; s++) {
+     DistanceFilter filter;
+     float from = steps[s][0];
+     float to = steps[s][1];
+     for (int i = 0; i < 20; i++) {
+       feed(filter, from, i * SAMPLE_PERIOD_US);
+     }
+     
+     float lowest = from;
+     float highest = 0;
+     int settled = -1;
+     for (int i = 0; i < 50; i++) {
+       float out = feed(filter, to, (20 + i) * SAMPLE_PERIOD_US);
+       lowest = out < lowest ? out : lowest;
+       highest = out > highest ? out : highest;
+       if (fabs(out - to) > 3) {
+         settled = -1;
+       } else if (settled < 0) {
+         settled = i + 1;
+       }
+     }
+     
+     // Never past the new distance by more than the sensor noise
+     TEST_ASSERT_GREATER_OR_EQUAL((from < to ? from : to) - 4, lowest);
+     TEST_ASSERT_LESS_OR_EQUAL((from > to ? from : to) + 4, highest);
+     
+     // Within 3 cm for good after the median delay and gate relock
+     TEST_ASSERT_TRUE(settled > 0);
+     TEST_ASSERT_LESS_OR_EQUAL(6, settled);
+   }
+ }
+ 
+ // Test that the fixed-point Kalman filter matches a float reference
+ void test_kalman_matches_float() {
+   KalmanStage kalman;
+   kalman.configure(150, 4);
+   noiseState = 99;
+   
+   // Float reference with the same model
+   double d = 0, v = 0, p00 = 16, p01 = 0, p11 = 10000;
+   const double q = 150.0 * 150.0, r = 16;
+   float worstDiff = 0;
+   
+   for (int i = 0; i < 200; i++) {
+     float z = 200 + 50 * sin(i * 0.05) + gaussianNoise(4);
+     FilterSample sample = {toFixed(z), (uint32_t)i * SAMPLE_PERIOD_US, true};
+     kalman.process(sample);
+     
+     if (i == 0) {
+       d = z;
+       continue;
+     }
+     double dt = SAMPLE_PERIOD_US / 1000000.0;
+     d += v * dt;
+     p00 += dt * (2 * p01 + dt * p11) + q * dt * dt * dt * dt / 4;
+     p01 += dt * p11 + q * dt * dt * dt / 2;
+     p11 += q * dt * dt;
+     double s = p00 + r;
+     double k0 = p00 / s, k1 = p01 / s;
+     double y = z - d;
+     d += k0 * y;
+     v += k1 * y;
+     p11 -= k1 * p01;
+     p01 *= 1 - k0;
+     p00 *= 1 - k0;
+     
+     float diff = fabs(fromFixed(sample.distance) - d);
+     if (diff > worstDiff) {
+       worstDiff = diff;
+     }
+   }
+   
+   TEST_ASSERT_LESS_THAN(0.5, worstDiff);
+ }
+ 
+ // Test that rejected samples only advance the prediction
+ void test_kalman_coasts_on_rejected() {
+   DistanceFilter filter;
+   
+   for (int i = 0; i < 30; i++) {
+     feed(filter, 200 - 2.0f * i, i * SAMPLE_PERIOD_US); // 50 cm/s closing
+   }
+   
+   FilterSample sample = {toFixed(400), 30 * SAMPLE_PERIOD_US, false};
+   filter.rest().rest().process(sample);
+   TEST_ASSERT_TRUE(sample.valid);
+   TEST_ASSERT_FLOAT_WITHIN(2, 140, fromFixed(sample.distance));
+ }
+ 
+ // Output always stays inside the sensor's range
+ void test_output_clamped() {
+   DistanceFilter filter;
+   
+   for (int i = 0; i < 30; i++) {
+     feed(filter, 5 - 2.0f * i, i * SAMPLE_PERIOD_US);
+   }
+   TEST_ASSERT_TRUE(feed(filter, 0, 30 * SAMPLE_PERIOD_US) >= 0);
+   
+   filter.reset();
+   for (int i = 0; i < 30; i++) {
+     TEST_ASSERT_TRUE(feed(filter, 400, i * SAMPLE_PERIOD_US) <= FILTER_MAX_DISTANCE_CM);
+   }
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_median_removes_spike);
+   RUN_TEST(test_rate_gate_relocks);
+   RUN_TEST(test_noisy_static_stream);
+   RUN_TEST(test_tracks_approach);
+   RUN_TEST(test_step_change_latency);
+   RUN_TEST(test_step_change_settles);
+   RUN_TEST(test_kalman_matches_float);
+   RUN_TEST(test_kalman_coasts_on_rejected);
+   RUN_TEST(test_output_clamped);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,90 @@
+/*
+ * test_edge_index.cpp
+ *
+ * Host unit tests for the per-node edge adjacency index
+ */
+
+ #include <unity.h>
+ #include "../src/main/EdgeIndex.h"
+ 
+ typedef EdgeIndex<8, 16> Index;
+ 
+ // Test that edges are found from either end
+ void test_find_both_directions() {
+   Index index;
+   index.add(0, 1, 2);
+   index.add(1, 2, 3);
+   index.add(2, 5, 1);
+   
+   TEST_ASSERT_EQUAL(0, index.find(1, 2));
+   TEST_ASSERT_EQUAL(0, index.find(2, 1));
+   TEST_ASSERT_EQUAL(1, index.find(3, 2));
+   TEST_ASSERT_EQUAL(2, index.find(1, 5));
+   TEST_ASSERT_EQUAL(EDGE_NONE, index.find(1, 3));
+   TEST_ASSERT_EQUAL(EDGE_NONE, index.find(4, 0));
+ }
+ 
+ // Test neighbour iteration and degrees
+ void test_neighbours() {
+   Index index;
+   index.add(0, 0, 1);
+   index.add(1, 0, 2);
+   index.add(2, 3, 0);
+   
+   TEST_ASSERT_EQUAL(3, index.degree(0));
+   TEST_ASSERT_EQUAL(1, index.degree(3));
+   TEST_ASSERT_EQUAL(0, index.degree(7));
+   
+   int neighbourSum = 0;
+   int edgeSum = 0;
+   for (int32_t h = index.first(0); h != EDGE_NONE; h = index.next(h)) {
+     neighbourSum += index.neighbourOf(h);
+     edgeSum += Index::edgeOf(h);
+   }
+   TEST_ASSERT_EQUAL(1 + 2 + 3, neighbourSum);
+   TEST_ASSERT_EQUAL(0 + 1 + 2, edgeSum);
+ }
+ 
+ // Test that a removed edge leaves both lists and the others stay
+ void test_remove() {
+   Index index;
+   index.add(0, 0, 1);
+   index.add(1, 0, 2);
+   index.add(2, 2, 1);
+   index.remove(1, 0, 2);
+   
+   TEST_ASSERT_EQUAL(EDGE_NONE, index.find(0, 2));
+   TEST_ASSERT_EQUAL(EDGE_NONE, index.find(2, 0));
+   TEST_ASSERT_EQUAL(1, index.degree(0));
+   TEST_ASSERT_EQUAL(1, index.degree(2));
+   TEST_ASSERT_EQUAL(0, index.find(1, 0));
+   TEST_ASSERT_EQUAL(2, index.find(1, 2));
+   
+   // The slot can index a different edge afterwards
+   index.add(1, 0, 2);
+   TEST_ASSERT_EQUAL(1, index.find(2, 0));
+ }
+ 
+ // Test that clearing forgets every edge
+ void test_clear() {
+   Index index;
+   index.add(0, 1, 2);
+   index.clear();
+   
+   TEST_ASSERT_EQUAL(EDGE_NONE, index.find(1, 2));
+   TEST_ASSERT_EQUAL(0, index.degree(1));
+   
+   index.add(0, 2, 4);
+   TEST_ASSERT_EQUAL(0, index.find(4, 2));
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_find_both_directions);
+   RUN_TEST(test_neighbours);
+   RUN_TEST(test_remove);
+   RUN_TEST(test_clear);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,253 @@
+/*
+ * test_feature_window.cpp
+ *
+ * Host unit tests and per-sample benchmark for the classifier feature window
+ */
+
+ #include <unity.h>
+ #include <math.h>
+ #include <chrono>
+ #include <stdio.h>
+ #include "../src/main/FeatureWindow.h"
+ #include "test_random.h"
+ 
+ #if defined(__x86_64__) || defined(__i386__)
+ #include <x86intrin.h>
+ #define HAVE_CYCLE_COUNTER 1
+ #endif
+ 
+ // Two sensors, same layout as the default cane
+ #define BENCH_ROWS 10
+ #define BENCH_SENSORS 2
+ #define BENCH_STEPS 20000
+ 
+ static float nextValue() {
+   return 50 + nextRandom() % 25000 / 100.0f;
+ }
+ 
+ // Direct two-pass statistics over the last n values of a stream
+ void directStats(const float* stream, int end, int n, float& mean, float& variance) {
+   double sum = 0;
+   for (int i = end - n; i < end; i++) {
+     sum += stream[i];
+   }
+   mean = sum / n;
+   double squares = 0;
+   for (int i = end - n; i < end; i++) {
+     squares += (stream[i] - mean) * (stream[i] - mean);
+   }
+   variance = squares / n;
+ }
+ 
+ // Test that running statistics match a direct computation while filling and sliding
+ void test_statistics_match_direct() {
+   FeatureWindow<3, 16, 2> window;
+   float stream[200];
+   noiseState = 1;
+   
+   for (int i = 0; i < 200; i++) {
+     stream[i] = nextValue();
+     float column[3] = {stream[i], stream[i] * 2, -1};
+     window.push(column);
+     
+     int n = i + 1 < 16 ? i + 1 : 16;
+     float mean, variance;
+     directStats(stream, i + 1, n, mean, variance);
+     TEST_ASSERT_EQUAL(n, window.size());
+     TEST_ASSERT_FLOAT_WITHIN(0.01, mean, window.mean(0));
+     TEST_ASSERT_FLOAT_WITHIN(variance * 1e-3 + 0.01, variance, window.variance(0));
+     TEST_ASSERT_FLOAT_WITHIN(variance * 4e-3 + 0.04, variance * 4, window.variance(1));
+   }
+ }
+ 
+ // Test access by age and late writes to the newest column
+ void test_at_and_latest() {
+   FeatureWindow<2, 4, 1> window;
+   TEST_ASSERT_TRUE(window.isEmpty());
+   
+   for (int i = 1; i <= 6; i++) {
+     float column[2] = {(float)i, 0};
+     window.push(column);
+   }
+   
+   TEST_ASSERT_EQUAL_FLOAT(6, window.at(0, 0));
+   TEST_ASSERT_EQUAL_FLOAT(3, window.at(0, 3));
+   
+   window.latest()[1] = 42;
+   TEST_ASSERT_EQUAL_FLOAT(42, window.at(1, 0));
+   TEST_ASSERT_EQUAL_FLOAT(4.5, window.mean(0));
+   
+   window.clear();
+   TEST_ASSERT_EQUAL(0, window.size());
+   TEST_ASSERT_EQUAL_FLOAT(0, window.variance(0));
+ }
+ 
+ // Test int8 quantization of the whole window, oldest step first
+ void test_quantize_window() {
+   FeatureWindow<2, 3, 1> window;
+   const float scale[2] = {0.5, 100};
+   const float offset[2] = {-10, 0};
+   int8_t input[6];
+   
+   float column[2] = {20, 0.011};
+   window.push(column);
+   TEST_ASSERT_FALSE(window.quantize(input, scale, offset));
+   
+   column[0] = 40;
+   column[1] = -0.026;
+   window.push(column);
+   column[0] = 1000;  // Saturates
+   column[1] = -5;
+   window.push(column);
+   TEST_ASSERT_TRUE(window.quantize(input, scale, offset));
+   
+   TEST_ASSERT_EQUAL(0, input[0]);
+   TEST_ASSERT_EQUAL(1, input[1]);
+   TEST_ASSERT_EQUAL(10, input[2]);
+   TEST_ASSERT_EQUAL(-3, input[3]);
+   TEST_ASSERT_EQUAL(127, input[4]);
+   TEST_ASSERT_EQUAL(-128, input[5]);
+   
+   // After wrapping the oldest step is dropped
+   column[0] = 22;
+   column[1] = 0;
+   window.push(column);
+   TEST_ASSERT_TRUE(window.quantize(input, scale, offset));
+   TEST_ASSERT_EQUAL(10, input[0]);
+   TEST_ASSERT_EQUAL(1, input[4]);
+ }
+ 
+ // Test that a long run does not drift away from the true variance
+ void test_long_run_drift() {
+   FeatureWindow<1, 64, 1> window;
+   static float stream[100000];
+   noiseState = 7;
+   
+   for (int i = 0; i < 100000; i++) {
+     stream[i] = 300 + (nextValue() - 175) / 50;  // Small spread on a large offset
+     window.push(&stream[i]);
+   }
+   
+   float mean, variance;
+   directStats(stream, 100000, 64, mean, variance);
+   TEST_ASSERT_FLOAT_WITHIN(0.001, mean, window.mean(0));
+   TEST_ASSERT_FLOAT_WITHIN(variance * 0.02, variance, window.variance(0));
+ }
+ 
+ // The previous implementation: shift every row, then recompute the
+ // variance of each distance row from scratch
+ template <int WINDOW>
+ struct ShiftWindow {
+   float buffer[BENCH_ROWS][WINDOW];
+   
+   float variance(int row) {
+     float mean = 0;
+     int valid = 0;
+     for (int i = 0; i < WINDOW; i++) {
+       if (buffer[row][i] > 0) {
+         mean += buffer[row][i];
+         valid++;
+       }
+     }
+     if (valid == 0) return 0;
+     mean /= valid;
+     float variance = 0;
+     for (int i = 0; i < WINDOW; i++) {
+       if (buffer[row][i] > 0) {
+         variance += pow(buffer[row][i] - mean, 2);
+       }
+     }
+     return variance / valid;
+   }
+   
+   float push(const float* column) {
+     for (int r = 0; r < BENCH_ROWS; r++) {
+       for (int i = 0; i < WINDOW - 1; i++) {
+         buffer[r][i] = buffer[r][i + 1];
+       }
+       buffer[r][WINDOW - 1] = column[r];
+     }
+     float sink = 0;
+     for (int s = 0; s < BENCH_SENSORS; s++) {
+       sink += variance(s);
+     }
+     return sink;
+   }
+ };
+ 
+ template <int WINDOW>
+ struct RingWindow {
+   FeatureWindow<BENCH_ROWS, WINDOW, BENCH_SENSORS> window;
+   
+   float push(const float* column) {
+     window.push(column);
+     float sink = 0;
+     for (int s = 0; s < BENCH_SENSORS; s++) {
+       sink += window.variance(s);
+     }
+     return sink;
+   }
+ };
+ 
+ // Per-sample cost in nanoseconds, cycles are reported where the host has a counter
+ template <typename Impl>
+ double benchmark(const char* name, int window) {
+   static Impl impl;
+   static float columns[64][BENCH_ROWS];
+   noiseState = 3;
+   for (int c = 0; c < 64; c++) {
+     for (int r = 0; r < BENCH_ROWS; r++) {
+       columns[c][r] = nextValue();
+     }
+   }
+   
+   volatile float sink = 0;
+   auto start = std::chrono::steady_clock::now();
+ #ifdef HAVE_CYCLE_COUNTER
+   uint64_t startCycles = __rdtsc();
+ #endif
+   for (int i = 0; i < BENCH_STEPS; i++) {
+     sink += impl.push(columns[i % 64]);
+   }
+ #ifdef HAVE_CYCLE_COUNTER
+   double cycles = (double)(__rdtsc() - startCycles) / BENCH_STEPS;
+ #else
+   double cycles = 0;
+ #endif
+   auto end = std::chrono::steady_clock::now();
+   double ns = std::chrono::duration<double, std::nano>(end - start).count() / BENCH_STEPS;
+   
+   char message[96];
+   snprintf(message, sizeof(message), "%s window %3d: %8.1f ns/sample, %8.0f cycles/sample", name, window, ns, cycles);
+   TEST_MESSAGE(message);
+   return ns;
+ }
+ 
+ // Compare the shift implementation with the ring buffer at growing window lengths
+ void test_benchmark_shift_vs_ring() {
+   double shift8 = benchmark<ShiftWindow<8> >("shift", 8);
+   double shift32 = benchmark<ShiftWindow<32> >("shift", 32);
+   double shift128 = benchmark<ShiftWindow<128> >("shift", 128);
+   double ring8 = benchmark<RingWindow<8> >("ring ", 8);
+   double ring32 = benchmark<RingWindow<32> >("ring ", 32);
+   double ring128 = benchmark<RingWindow<128> >("ring ", 128);
+   
+   TEST_ASSERT_LESS_THAN(shift8, ring8);
+   TEST_ASSERT_LESS_THAN(shift32, ring32);
+   TEST_ASSERT_LESS_THAN(shift128 / 4, ring128);
+   
+   // Cost must not follow the window length
+   TEST_ASSERT_LESS_THAN(ring8 * 3, ring128);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_statistics_match_direct);
+   RUN_TEST(test_at_and_latest);
+   RUN_TEST(test_quantize_window);
+   RUN_TEST(test_long_run_drift);
+   RUN_TEST(test_benchmark_shift_vs_ring);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
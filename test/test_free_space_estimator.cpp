@@ -0,0 +1,170 @@
+/*
+ * test_free_space_estimator.cpp
+ *
+ * Host unit tests and call timing for the free-space estimator
+ */
+
+ #include <unity.h>
+ #include <chrono>
+ #include <algorithm>
+ #include <stdio.h>
+ #include "../src/main/FreeSpaceEstimator.h"
+ 
+ // Budget for one recommendation on the host
+ #define TIMING_BUDGET_US 20.0
+ #define TIMING_CALLS 20000
+ 
+ // Test that an empty history suggests stopping
+ void test_no_history() {
+   FreeSpaceEstimator estimator;
+   TEST_ASSERT_EQUAL(0, estimator.recommend(0, 0));
+   TEST_ASSERT_EQUAL_FLOAT(0, estimator.getLeftClearance(0, 0));
+ }
+ 
+ // Test that the clearer side is suggested
+ void test_suggests_clear_side() {
+   FreeSpaceEstimator estimator;
+   
+   // User swept left (heading 330) and right (heading 30) with a forward sensor
+   estimator.addReading(1000, 330, 0, 250);
+   estimator.addReading(2000, 30, 0, 60);
+   
+   TEST_ASSERT_EQUAL(-1, estimator.recommend(3000, 0));
+   TEST_ASSERT_FLOAT_WITHIN(1, 250, estimator.getLeftClearance(3000, 0));
+   TEST_ASSERT_FLOAT_WITHIN(1, 60, estimator.getRightClearance(3000, 0));
+   
+   // Turned around, neither reading is to the side any more
+   TEST_ASSERT_EQUAL(0, estimator.recommend(3000, 180));
+ }
+ 
+ // Test side-facing sensors without any heading change
+ void test_side_sensors() {
+   FreeSpaceEstimator estimator;
+   
+   estimator.addReading(1000, 90, -35, 80);   // Left sensor
+   estimator.addReading(1000, 90, 35, 300);   // Right sensor
+   estimator.addReading(1000, 90, 0, 40);     // Forward sensor does not count as a side
+   
+   TEST_ASSERT_EQUAL(1, estimator.recommend(2000, 90));
+ }
+ 
+ // Test that similar clearance on both sides suggests stopping
+ void test_similar_sides_stop() {
+   FreeSpaceEstimator estimator;
+   
+   estimator.addReading(1000, 0, -45, 120);
+   estimator.addReading(1000, 0, 45, 130);
+   
+   TEST_ASSERT_EQUAL(0, estimator.recommend(2000, 0));
+ }
+ 
+ // Test that a sector is as clear as its closest recent reading
+ void test_sector_uses_closest_reading() {
+   FreeSpaceEstimator estimator;
+   
+   estimator.addReading(1000, 0, -30, 300);
+   estimator.addReading(1100, 0, -30, 50);  // Someone stepped in
+   estimator.addReading(1000, 0, 30, 100);
+   
+   TEST_ASSERT_EQUAL(1, estimator.recommend(2000, 0));
+ }
+ 
+ // Test that old readings are forgotten
+ void test_readings_expire() {
+   FreeSpaceEstimator estimator;
+   
+   estimator.addReading(0, 0, -30, 300);
+   estimator.addReading(0, 0, 30, 50);
+   TEST_ASSERT_EQUAL(-1, estimator.recommend(FREESPACE_MAX_AGE_US, 0));
+   TEST_ASSERT_EQUAL(0, estimator.recommend(FREESPACE_MAX_AGE_US + 1, 0));
+ }
+ 
+ // Test bearing wrap-around
+ void test_bearing_wraparound() {
+   TEST_ASSERT_EQUAL(20, FreeSpaceEstimator::relativeBearing(10, 350));
+   TEST_ASSERT_EQUAL(-20, FreeSpaceEstimator::relativeBearing(350, 10));
+   TEST_ASSERT_EQUAL(180, FreeSpaceEstimator::relativeBearing(180, 0));
+   
+   FreeSpaceEstimator estimator;
+   estimator.addReading(0, 350, 30, 200);  // Bearing 20
+   estimator.addReading(0, 350, -30, 50);  // Bearing 320
+   TEST_ASSERT_EQUAL(1, estimator.recommend(10, 355));
+ }
+ 
+ // Test that the ring buffer keeps only the newest readings
+ void test_history_wraps() {
+   FreeSpaceEstimator estimator;
+   
+   estimator.addReading(0, 0, -30, 40);
+   for (int i = 0; i < FREESPACE_HISTORY; i++) {
+     estimator.addReading(i, 0, 30, 40);
+   }
+   TEST_ASSERT_EQUAL(FREESPACE_HISTORY, estimator.getReadingCount());
+   TEST_ASSERT_EQUAL_FLOAT(0, estimator.getLeftClearance(100, 0));
+ }
+ 
+ // Test that a sweep is remembered for the whole age limit at the fastest scan rate
+ void test_history_covers_max_age() {
+   FreeSpaceEstimator estimator;
+   const uint32_t stepUs = 1000000 / FREESPACE_MAX_READING_RATE;
+   uint32_t now = 0;
+   
+   // Swept left and right at the start, then faced an obstacle ahead
+   estimator.addReading(now, 330, 0, 250);
+   now += stepUs;
+   estimator.addReading(now, 30, 0, 60);
+   while (now + stepUs < FREESPACE_MAX_AGE_US) {
+     now += stepUs;
+     estimator.addReading(now, 0, 0, 80);
+   }
+   TEST_ASSERT_EQUAL(-1, estimator.recommend(now, 0));
+ }
+ 
+ // Time single recommendations with a full history. The host OS can preempt
+ // any call, so the budget applies to the 99.9th percentile and the slowest
+ // call is only reported.
+ void test_execution_time() {
+   FreeSpaceEstimator estimator;
+   for (int i = 0; i < FREESPACE_HISTORY; i++) {
+     estimator.addReading(i * 1000, (i * 37) % 360, (i % 3 - 1) * 35, 20 + (i * 53) % 380);
+   }
+   
+   const int calls = TIMING_CALLS;
+   static double times[TIMING_CALLS];
+   double totalUs = 0;
+   volatile int sink = 0;
+   
+   for (int i = 0; i < calls; i++) {
+     auto start = std::chrono::steady_clock::now();
+     sink += estimator.recommend(FREESPACE_HISTORY * 1000, (float)(i % 360));
+     auto end = std::chrono::steady_clock::now();
+     times[i] = std::chrono::duration<double, std::micro>(end - start).count();
+     totalUs += times[i];
+   }
+   std::sort(times, times + calls);
+   double p999 = times[calls * 999 / 1000];
+   
+   char message[128];
+   snprintf(message, sizeof(message), "recommend() with %d readings: mean %.3f us, p99.9 %.3f us, slowest %.3f us",
+            FREESPACE_HISTORY, totalUs / calls, p999, times[calls - 1]);
+   TEST_MESSAGE(message);
+   
+   TEST_ASSERT_LESS_THAN(TIMING_BUDGET_US, p999);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_no_history);
+   RUN_TEST(test_suggests_clear_side);
+   RUN_TEST(test_side_sensors);
+   RUN_TEST(test_similar_sides_stop);
+   RUN_TEST(test_sector_uses_closest_reading);
+   RUN_TEST(test_readings_expire);
+   RUN_TEST(test_bearing_wraparound);
+   RUN_TEST(test_history_wraps);
+   RUN_TEST(test_history_covers_max_age);
+   RUN_TEST(test_execution_time);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
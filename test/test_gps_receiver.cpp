@@ -0,0 +1,375 @@
+/*
+ * test_gps_receiver.cpp
+ *
+ * Host unit tests for the NMEA parser and the staged GPS receiver, driven
+ * by a simulated UART at 9600 baud, plus a stress run on real threads
+ */
+
+ #include <unity.h>
+ #include <stdio.h>
+ #include <string>
+ #include <vector>
+ #include <thread>
+ #include <chrono>
+ #include "../src/main/GpsReceiver.h"
+ 
+ #define BYTE_US 1041          // One character at 9600 baud
+ #define FIFO_FULL 16          // GPS_UART_FIFO_FULL
+ #define RX_TIMEOUT_US 2084    // Receive event after two idle characters
+ #define LOOP_US 10000         // A loop() pass when nothing blocks it
+ 
+ static std::string sentence(const std::string& body) {
+   uint8_t sum = 0;
+   for (size_t i = 0; i < body.size(); i++) {
+     sum ^= (uint8_t)body[i];
+   }
+   char tail[8];
+   snprintf(tail, sizeof(tail), "*%02X\r\n", sum);
+   return "$" + body + tail;
+ }
+ 
+ // RMC for 2026-10-17, the given seconds after 12:34:56 UTC
+ static std::string rmc(int second, double lat, double lng, float knots, bool valid = true) {
+   char body[96];
+   int clock = 12 * 3600 + 34 * 60 + 56 + second;
+   int latDeg = (int)fabs(lat);
+   int lngDeg = (int)fabs(lng);
+   snprintf(body, sizeof(body), "GPRMC,%02d%02d%02d.00,%c,%02d%08.5f,%c,%03d%08.5f,%c,%.3f,%.2f,171026,,,A",
+            clock / 3600, clock / 60 % 60, clock % 60, valid ? 'A' : 'V', latDeg, (fabs(lat) - latDeg) * 60,
+            lat < 0 ? 'S' : 'N', lngDeg, (fabs(lng) - lngDeg) * 60, lng < 0 ? 'W' : 'E', knots, 45.5);
+   return sentence(body);
+ }
+ 
+ // The rest of a NEO-6M's one-second burst
+ static std::string otherSentences() {
+   return sentence("GPVTG,45.50,T,,M,2.000,N,3.704,K,A") +
+          sentence("GPGGA,123456.00,3353.48000,N,00636.12000,W,1,08,1.01,52.3,M,46.9,M,,") +
+          sentence("GPGSA,A,3,05,13,15,18,20,21,24,29,,,,,1.85,1.01,1.55") +
+          sentence("GPGSV,3,1,11,05,42,296,33,13,28,052,30,15,58,100,37,18,21,172,29") +
+          sentence("GPGSV,3,2,11,20,65,249,38,21,13,320,25,24,33,061,31,26,04,217,") +
+          sentence("GPGSV,3,3,11,29,49,146,40,31,02,001,,36,28,137,") +
+          sentence("GPGLL,3353.48000,N,00636.12000,W,123456.00,A,A");
+ }
+ 
+ static void feed(NmeaParser& parser, const std::string& text, int& completed) {
+   for (size_t i = 0; i < text.size(); i++) {
+     completed += parser.encode(text[i]);
+   }
+ }
+ 
+ // Test decoding of a recommended minimum sentence
+ void test_rmc_fix() {
+   NmeaParser parser;
+   int completed = 0;
+   feed(parser, otherSentences(), completed);
+   TEST_ASSERT_EQUAL(0, completed);
+   TEST_ASSERT_EQUAL(7, parser.getSentences());
+   
+   feed(parser, rmc(0, 33.8913, -6.6020, 2.0), completed);
+   TEST_ASSERT_EQUAL(1, completed);
+   const GpsFix& fix = parser.getFix();
+   TEST_ASSERT_TRUE(fix.valid);
+   TEST_ASSERT_TRUE(fabs(fix.lat - 33.8913) < 1e-6);
+   TEST_ASSERT_TRUE(fabs(fix.lng + 6.6020) < 1e-6);
+   TEST_ASSERT_TRUE(fabs(fix.speedMps - 1.0289) < 1e-3);
+   TEST_ASSERT_TRUE(fabs(fix.courseDeg - 45.5) < 1e-3);
+   TEST_ASSERT_EQUAL(1792240496, fix.unixTime);
+   
+   // Southern and eastern hemispheres
+   feed(parser, rmc(1, -12.5, 130.25, 0), completed);
+   TEST_ASSERT_TRUE(fabs(parser.getFix().lat + 12.5) < 1e-6);
+   TEST_ASSERT_TRUE(fabs(parser.getFix().lng - 130.25) < 1e-6);
+   TEST_ASSERT_EQUAL(1792240497, parser.getFix().unixTime);
+ }
+ 
+ // Test that a lost fix and a receiver without a date are reported
+ void test_void_and_undated() {
+   NmeaParser parser;
+   int completed = 0;
+   feed(parser, rmc(0, 33.8913, -6.6020, 2.0), completed);
+   feed(parser, sentence("GPRMC,123457.00,V,,,,,,,171026,,,N"), completed);
+   TEST_ASSERT_EQUAL(2, completed);
+   TEST_ASSERT_FALSE(parser.getFix().valid);
+   TEST_ASSERT_EQUAL(1792240497, parser.getFix().unixTime);
+   
+   // Cold start: the receiver's clock still says 2000
+   feed(parser, sentence("GPRMC,000012.00,V,,,,,,,010100,,,N"), completed);
+   TEST_ASSERT_EQUAL(3, completed);
+   TEST_ASSERT_EQUAL(0, parser.getFix().unixTime);
+ }
+ 
+ // Test resynchronizing on corrupted, truncated and overlong sentences
+ void test_corrupt_input() {
+   NmeaParser parser;
+   int completed = 0;
+   std::string good = rmc(0, 33.8913, -6.6020, 2.0);
+   
+   std::string flipped = good;
+   flipped[20] ^= 0x01;
+   feed(parser, flipped, completed);
+   feed(parser, good.substr(0, 30), completed);  // Cut off by the next '$'
+   feed(parser, "$" + std::string(200, 'x') + "\r\n", completed);
+   feed(parser, "noise without a start\r\n", completed);
+   TEST_ASSERT_EQUAL(0, completed);
+   TEST_ASSERT_EQUAL(2, parser.getChecksumErrors());
+   
+   feed(parser, good, completed);
+   TEST_ASSERT_EQUAL(1, completed);
+   TEST_ASSERT_TRUE(parser.getFix().valid);
+ }
+ 
+ // Test that line ends are stamped at the arrival of their last byte
+ void test_line_end_stamps() {
+   GpsReceiver receiver(9600);
+   std::string text = rmc(0, 33.8913, -6.6020, 2.0);
+   size_t split = text.size() - 5;
+   
+   // The sentence ends two characters before the second chunk was read
+   receiver.capture((const uint8_t*)text.data(), split, 100000);
+   std::string rest = text.substr(split) + "$G";
+   receiver.capture((const uint8_t*)rest.data(), rest.size(), 200000);
+   TEST_ASSERT_EQUAL(1, receiver.parse(250000));
+   
+   GpsFix fix;
+   TEST_ASSERT_TRUE(receiver.readFix(fix));
+   TEST_ASSERT_EQUAL(200000 - 2 * BYTE_US, fix.lineEndUs);
+   TEST_ASSERT_FALSE(receiver.readFix(fix));
+ }
+ 
+ // Test that the reader gets the newest fix, never a backlog
+ void test_latest_fix_only() {
+   GpsReceiver receiver;
+   for (int i = 0; i < 3; i++) {
+     std::string text = rmc(i, 33.0 + i, -6.0, 0);
+     receiver.capture((const uint8_t*)text.data(), text.size(), i * 1000000);
+     receiver.parse(i * 1000000);
+   }
+   GpsFix fix;
+   TEST_ASSERT_TRUE(receiver.readFix(fix));
+   TEST_ASSERT_TRUE(fabs(fix.lat - 35.0) < 1e-6);
+   TEST_ASSERT_EQUAL(2000000, fix.lineEndUs);
+   TEST_ASSERT_EQUAL(2, receiver.getReplacedFixes());
+   TEST_ASSERT_FALSE(receiver.readFix(fix));
+ }
+ 
+ // Test overrun accounting when the parse stage falls behind
+ void test_ring_overrun() {
+   GpsReceiver receiver;
+   std::string burst;
+   while (burst.size() < GPS_RING_BYTES * 2) {
+     burst += rmc(0, 33.8913, -6.6020, 2.0);
+   }
+   receiver.capture((const uint8_t*)burst.data(), burst.size(), 0);
+   TEST_ASSERT_EQUAL(burst.size() - (GPS_RING_BYTES - 1), receiver.getDroppedBytes());
+   
+   // The sentence cut by the overrun fails its checksum; the next one parses
+   receiver.parse(0);
+   std::string next = rmc(1, 34.0, -6.0, 0);
+   receiver.capture((const uint8_t*)next.data(), next.size(), 1000000);
+   receiver.parse(1000000);
+   GpsFix fix;
+   TEST_ASSERT_TRUE(receiver.readFix(fix));
+   TEST_ASSERT_TRUE(fabs(fix.lat - 34.0) < 1e-6);
+   TEST_ASSERT_EQUAL(1000000, fix.lineEndUs);
+ }
+ 
+ // Simulate a minute of 1Hz bursts while loop() is sometimes blocked (button
+ // handling, a slow SD write) and compare with draining a 256-byte driver
+ // buffer once a second from loop(), as before
+ void test_blocked_loop_latency() {
+   const uint32_t SECONDS = 60;
+   GpsReceiver receiver;
+   NmeaParser oldParser;
+   std::string oldBuffer;
+   int oldFixes = 0;
+   int oldDropped = 0;
+   size_t oldPosition = 0;
+   
+   // Byte arrival times and when each RMC's last byte arrived
+   std::string stream;
+   std::vector<uint32_t> arrival;
+   std::vector<uint32_t> rmcEnd;
+   for (uint32_t s = 0; s < SECONDS; s++) {
+     std::string first = rmc(s, 33.8913 + s * 1e-5, -6.6020, 2.0);
+     std::string burst = first + otherSentences();
+     for (size_t i = 0; i < burst.size(); i++) {
+       arrival.push_back(s * 1000000 + 50000 + i * BYTE_US);
+     }
+     rmcEnd.push_back(s * 1000000 + 50000 + (first.size() - 1) * BYTE_US);
+     stream += burst;
+   }
+   
+   // loop() is blocked for 400ms every 7s and for 1.5s once
+   auto blocked = [](uint32_t now) {
+     return (now % 7000000) < 400000 || (now >= 30200000 && now < 31700000);
+   };
+   
+   size_t next = 0;
+   size_t fifo = 0;
+   uint32_t nextLoop = 0;
+   uint32_t lastOldDrain = 0;
+   uint32_t maxLatency = 0;
+   uint32_t maxFreeLatency = 0;
+   uint32_t maxStampError = 0;
+   uint64_t totalLatency = 0;
+   int fixes = 0;
+   size_t lastRmc = 0;
+   for (uint32_t now = 0; now < SECONDS * 1000000; now += 100) {
+     // UART: bytes land in the FIFO; a receive event runs the capture and
+     // parse stages when it fills or the line goes idle
+     size_t start = next - fifo;
+     while (next < arrival.size() && arrival[next] <= now) {
+       next++;
+       fifo++;
+     }
+     bool idle = fifo > 0 && now - arrival[next - 1] >= RX_TIMEOUT_US;
+     if (fifo >= FIFO_FULL || idle) {
+       receiver.capture((const uint8_t*)stream.data() + start, fifo, now);
+       receiver.parse(now);
+       fifo = 0;
+     }
+     
+     // Old path: a 256-byte driver buffer, drained by loop() once a second
+     while (oldPosition < next) {
+       if (oldBuffer.size() < 256) {
+         oldBuffer += stream[oldPosition];
+       } else {
+         oldDropped++;
+       }
+       oldPosition++;
+     }
+     
+     if (now < nextLoop || blocked(now)) {
+       continue;
+     }
+     nextLoop = now + LOOP_US;
+     if (now - lastOldDrain >= 1000000) {
+       feed(oldParser, oldBuffer, oldFixes);
+       oldBuffer.clear();
+       lastOldDrain = now;
+     }
+     
+     GpsFix fix;
+     if (receiver.readFix(fix)) {
+       uint32_t latency = now - fix.lineEndUs;
+       while (lastRmc + 1 < rmcEnd.size() && rmcEnd[lastRmc + 1] <= fix.lineEndUs) {
+         lastRmc++;
+       }
+       uint32_t stampError = fix.lineEndUs - rmcEnd[lastRmc];
+       maxStampError = std::max(maxStampError, stampError);
+       maxLatency = std::max(maxLatency, latency);
+       if (!blocked(fix.lineEndUs)) {
+         maxFreeLatency = std::max(maxFreeLatency, latency);
+       }
+       totalLatency += latency;
+       fixes++;
+     }
+   }
+   
+   char message[200];
+   snprintf(message, sizeof(message),
+            "%d fixes, latency mean %.1f ms, max %.1f ms (%.1f ms when loop free), stamp error <= %.1f ms; "
+            "old path kept %d of %u fixes and dropped %d bytes",
+            fixes, totalLatency / 1000.0 / fixes, maxLatency / 1000.0, maxFreeLatency / 1000.0,
+            maxStampError / 1000.0, oldFixes, SECONDS, oldDropped);
+   TEST_MESSAGE(message);
+   
+   TEST_ASSERT_EQUAL(0, receiver.getDroppedBytes());
+   TEST_ASSERT_EQUAL(0, receiver.getChecksumErrors());
+   TEST_ASSERT_EQUAL(SECONDS * 8, receiver.getSentences());
+   TEST_ASSERT_TRUE(fixes >= (int)SECONDS - 3);  // Blocks long enough to replace a fix
+   TEST_ASSERT_TRUE(maxStampError <= RX_TIMEOUT_US + FIFO_FULL * BYTE_US);
+   TEST_ASSERT_TRUE(maxFreeLatency <= LOOP_US + FIFO_FULL * BYTE_US + RX_TIMEOUT_US);
+   TEST_ASSERT_TRUE(maxLatency <= 1500000 + LOOP_US + FIFO_FULL * BYTE_US + RX_TIMEOUT_US);
+   TEST_ASSERT_TRUE(oldFixes < fixes);
+ }
+ 
+ static uint32_t nowUs() {
+   auto now = std::chrono::steady_clock::now().time_since_epoch();
+   return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+ }
+ 
+ // Capture, parse and read on three threads: every fix read is whole and
+ // newer than the last
+ void test_threaded_stages() {
+   const int SENTENCES = 20000;
+   GpsReceiver receiver;
+   std::atomic<bool> captured(false);
+   std::atomic<bool> parsed(false);
+   
+   std::thread capture([&]() {
+     for (int i = 0; i < SENTENCES; i++) {
+       std::string text = rmc(i % 3600, 10.0 + i * 1e-4, -(10.0 + i * 1e-4), i * 0.01);
+       receiver.capture((const uint8_t*)text.data(), text.size(), nowUs());
+       if (i % 8 == 0) {
+         std::this_thread::yield();
+       }
+     }
+     captured = true;
+   });
+   std::thread parse([&]() {
+     while (true) {
+       bool last = captured.load();
+       if (receiver.parse(nowUs()) == 0) {
+         if (last) {
+           break;
+         }
+         std::this_thread::yield();
+       }
+     }
+     parsed = true;
+   });
+   
+   int reads = 0;
+   int lastIndex = -1;
+   bool ordered = true;
+   bool whole = true;
+   uint32_t maxLatency = 0;
+   while (true) {
+     bool last = parsed.load();
+     GpsFix fix;
+     if (!receiver.readFix(fix)) {
+       if (last) {
+         break;
+       }
+       std::this_thread::yield();
+       continue;
+     }
+     int index = (int)lround((fix.lat - 10.0) / 1e-4);
+     whole = whole && fabs(fix.lng + fix.lat) < 1e-6 && fabs(fix.speedMps - index * 0.01 * NMEA_KNOTS_TO_MPS) < 1e-3;
+     ordered = ordered && index > lastIndex;
+     lastIndex = index;
+     maxLatency = std::max(maxLatency, nowUs() - fix.lineEndUs);
+     reads++;
+   }
+   capture.join();
+   parse.join();
+   
+   char message[160];
+   snprintf(message, sizeof(message), "%d sentences, %d fixes read, %u replaced, %u bytes dropped, max latency %.2f ms",
+            SENTENCES, reads, receiver.getReplacedFixes(), receiver.getDroppedBytes(), maxLatency / 1000.0);
+   TEST_MESSAGE(message);
+   
+   TEST_ASSERT_TRUE(reads > 0);
+   TEST_ASSERT_TRUE(whole);
+   TEST_ASSERT_TRUE(ordered);
+   if (receiver.getDroppedBytes() == 0) {
+     TEST_ASSERT_EQUAL(SENTENCES, receiver.getSentences());
+     TEST_ASSERT_EQUAL(SENTENCES - 1, lastIndex);
+   }
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_rmc_fix);
+   RUN_TEST(test_void_and_undated);
+   RUN_TEST(test_corrupt_input);
+   RUN_TEST(test_line_end_stamps);
+   RUN_TEST(test_latest_fix_only);
+   RUN_TEST(test_ring_overrun);
+   RUN_TEST(test_blocked_loop_latency);
+   RUN_TEST(test_threaded_stages);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
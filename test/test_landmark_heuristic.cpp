@@ -0,0 +1,282 @@
+/*
+ * test_landmark_heuristic.cpp
+ *
+ * Host unit tests for the ALT landmark heuristic: estimates never
+ * overestimate and stay consistent, patched tables match a fresh search,
+ * and routes between saved places expand far fewer nodes than with the
+ * straight line, on synthetic maps with blocks to walk around
+ */
+
+ #include <unity.h>
+ #include <math.h>
+ #include <chrono>
+ #include <queue>
+ #include <vector>
+ #include <stdio.h>
+ #include "../src/main/LandmarkHeuristic.h"
+ #include "../src/main/RouteReplanner.h"
+ 
+ #define GRID_SIDE 100               // Up to 100 x 100 nodes
+ #define GRID_NODES (GRID_SIDE * GRID_SIDE)
+ #define GRID_SPACING_M 10.0f       // As PATH_NODE_DISTANCE
+ #define MAX_TEST_NODES (GRID_NODES + 200)
+ #define MAX_TEST_EDGES (3 * MAX_TEST_NODES)
+ #define TEST_LANDMARKS 8
+ #define WAYPOINTS 4
+ 
+ #include "test_lattice.h"
+ 
+ // Synthetic walked map: the shared lattice with missing edges and whole
+ // blocks cut out, as around buildings, plus the saved places
+ static bool named[MAX_TEST_NODES];
+ 
+ // Blocks of side/8 nodes are missing every third row and column of blocks
+ struct Blocks {
+   int side;
+   
+   bool operator()(int x, int y) const {
+     int block = side / 8;
+     return (x / block) % 3 == 1 && (y / block) % 3 == 1 && x % block != 0 && y % block != 0;
+   }
+ };
+ 
+ static void buildMap(int side, int withheldPercent) {
+   for (int n = 0; n < MAX_TEST_NODES; n++) {
+     named[n] = false;
+   }
+   Blocks blocks = {side};
+   buildLattice(side, GRID_SPACING_M, withheldPercent, 0, blocks);
+ }
+ 
+ struct TestGraph {
+   int32_t first(int32_t node) const { return adjacency.first(node); }
+   int32_t next(int32_t half) const { return adjacency.next(half); }
+   int32_t neighbourOf(int32_t half) const { return adjacency.neighbourOf(half); }
+   float weight(int32_t half) const { return edgeWeight[adjacency.edgeOf(half)]; }
+   bool isPreferred(int32_t node) const { return named[node]; }
+ };
+ 
+ typedef LandmarkHeuristic<MAX_TEST_NODES, TEST_LANDMARKS> Landmarks;
+ static Landmarks landmarks;
+ static TestGraph graph;
+ 
+ // Reference walks from one node, in meters, or in table units
+ // summed as the tables do
+ static std::vector<double> walksFrom(int32_t from, bool inUnits) {
+   std::vector<double> walk(MAX_TEST_NODES, INFINITY);
+   std::priority_queue<std::pair<double, int32_t>, std::vector<std::pair<double, int32_t> >,
+                       std::greater<std::pair<double, int32_t> > > open;
+   walk[from] = 0;
+   open.push(std::make_pair(0.0, from));
+   while (!open.empty()) {
+     std::pair<double, int32_t> top = open.top();
+     open.pop();
+     if (top.first > walk[top.second]) {
+       continue;
+     }
+     for (int32_t h = adjacency.first(top.second); h != EDGE_NONE; h = adjacency.next(h)) {
+       double length = edgeWeight[adjacency.edgeOf(h)];
+       if (inUnits) {
+         length = (uint32_t)(edgeWeight[adjacency.edgeOf(h)] * LANDMARK_UNITS_PER_M);
+       }
+       int32_t other = adjacency.neighbourOf(h);
+       if (top.first + length < walk[other]) {
+         walk[other] = top.first + length;
+         open.push(std::make_pair(walk[other], other));
+       }
+     }
+   }
+   return walk;
+ }
+ 
+ // Every row holds exactly the table units walked from its landmark
+ static void checkRowsExact() {
+   for (int l = 0; l < landmarks.getLandmarkCount(); l++) {
+     std::vector<double> walk = walksFrom(landmarks.getLandmark(l), true);
+     for (int n = 0; n < nodeCount; n++) {
+       uint16_t expected = walk[n] == INFINITY ? LANDMARK_FAR : (uint16_t)walk[n];
+       TEST_ASSERT_EQUAL(expected, landmarks.getWalk(l, n));
+     }
+   }
+ }
+ 
+ // Never more than the walk, and never dropping faster than the walk along an edge
+ static void checkBounds(int targets) {
+   for (int t = 0; t < targets; t++) {
+     int32_t target = nextRandom() % nodeCount;
+     std::vector<double> walk = walksFrom(target, false);
+     for (int n = 0; n < nodeCount; n++) {
+       if (walk[n] != INFINITY) {
+         TEST_ASSERT_TRUE(landmarks.estimate(n, target) <= walk[n] + 1e-3);
+       }
+     }
+     for (int e = 0; e < edgeCount; e++) {
+       if (edgeSource[e] == EDGE_NONE) {
+         continue;
+       }
+       float drop = landmarks.estimate(edgeSource[e], target) - landmarks.estimate(edgeTarget[e], target);
+       TEST_ASSERT_TRUE(fabsf(drop) <= edgeWeight[e] + 1e-3f);
+     }
+   }
+ }
+ 
+ // Test the tables on a small map: named places first, bounds and precision
+ void test_bounds() {
+   buildMap(40, 10);
+   int32_t places[] = {0, 20, 30 * 40 + 30};
+   for (int i = 0; i < 3; i++) {
+     TEST_ASSERT_NOT_EQUAL(EDGE_NONE, adjacency.first(places[i]));
+     named[places[i]] = true;
+   }
+   landmarks.build(nodeCount, graph);
+   
+   // The named places, then the farthest nodes
+   TEST_ASSERT_EQUAL(TEST_LANDMARKS, landmarks.getLandmarkCount());
+   for (int l = 0; l < landmarks.getLandmarkCount(); l++) {
+       TEST_ASSERT_EQUAL(l < 3, named[landmarks.getLandmark(l)]);
+   }
+   checkRowsExact();
+   checkBounds(20);
+   
+   // From a landmark the estimate is the walk, less the rounding
+   int32_t home = landmarks.getLandmark(0);
+   std::vector<double> walk = walksFrom(home, false);
+   for (int n = 0; n < nodeCount; n++) {
+     if (walk[n] != INFINITY) {
+       TEST_ASSERT_TRUE(landmarks.estimate(home, n) >= walk[n] * 0.98 - 0.125);
+     }
+   }
+ }
+ 
+ // Test walking on: new nodes and edges are patched in, removed ones leave valid bounds
+ void test_patching() {
+   buildMap(40, 30);
+   landmarks.build(nodeCount, graph);
+   
+   // Cross the withheld gaps and walk a new path along the bottom edge
+   for (int step = 0; step < 300; step++) {
+     int32_t a = nextRandom() % nodeCount;
+     int32_t b = (a % 40 < 39) && step % 2 ? a + 1 : a + 40;
+     if (b < nodeCount && adjacency.find(a, b) == EDGE_NONE && adjacency.first(a) != EDGE_NONE && adjacency.first(b) != EDGE_NONE) {
+       int e = addEdge(a, b);
+       landmarks.addEdge(a, b, edgeWeight[e], graph);
+     }
+   }
+   int32_t previous = 0;
+   for (int step = 0; step < 100; step++) {
+     int32_t node = nodeCount++;
+     nodeX[node] = step * 2.0f;
+     nodeY[node] = -3.0f;
+     landmarks.addNode(node);
+     int e = addEdge(previous, node);
+     landmarks.addEdge(previous, node, edgeWeight[e], graph);
+     previous = node;
+   }
+   int e = addEdge(previous, 39);
+   landmarks.addEdge(previous, 39, edgeWeight[e], graph);
+   checkRowsExact();
+   
+   // Remove edges without telling the tables: the bounds still hold
+   for (int i = 0; i < 200; i++) {
+     int e = nextRandom() % edgeCount;
+     if (edgeSource[e] != EDGE_NONE) {
+       adjacency.remove(e, edgeSource[e], edgeTarget[e]);
+       edgeSource[e] = edgeTarget[e] = EDGE_NONE;
+     }
+   }
+   checkBounds(10);
+ }
+ 
+ // Routes between saved places and between random nodes on a large map
+ struct StraightLine {
+   float operator()(int32_t a, int32_t b) { return distance(a, b); }
+ };
+ 
+ struct WithLandmarks {
+   float operator()(int32_t a, int32_t b) { return fmaxf(distance(a, b), landmarks.estimate(a, b)); }
+ };
+ 
+ static RouteReplanner<MAX_TEST_NODES> planner;
+ 
+ struct QueryCost {
+   double straightUs, landmarkUs;
+   uint64_t straightExpanded, landmarkExpanded;
+   int routes;
+ };
+ 
+ static void route(int32_t from, int32_t to, QueryCost& cost) {
+   StraightLine straight;
+   WithLandmarks alt;
+   auto t0 = std::chrono::steady_clock::now();
+   bool found = planner.plan(from, to, graph, straight);
+   auto t1 = std::chrono::steady_clock::now();
+   float shortest = planner.getPathCost();
+   uint32_t straightExpanded = planner.getExpandedCount();
+   TEST_ASSERT_EQUAL(found, planner.plan(from, to, graph, alt));
+   auto t2 = std::chrono::steady_clock::now();
+   if (!found) {
+     return;
+   }
+   TEST_ASSERT_FLOAT_WITHIN(shortest * 1e-4f + 1e-3f, shortest, planner.getPathCost());
+   cost.straightUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+   cost.landmarkUs += std::chrono::duration<double, std::micro>(t2 - t1).count();
+   cost.straightExpanded += straightExpanded;
+   cost.landmarkExpanded += planner.getExpandedCount();
+   cost.routes++;
+ }
+ 
+ static void report(const char* what, const QueryCost& cost) {
+   char message[200];
+   snprintf(message, sizeof(message), "%s (%d routes): straight line %6.0f nodes %7.1f us, landmarks %5.0f nodes %6.1f us",
+            what, cost.routes, (double)cost.straightExpanded / cost.routes, cost.straightUs / cost.routes,
+            (double)cost.landmarkExpanded / cost.routes, cost.landmarkUs / cost.routes);
+   TEST_MESSAGE(message);
+ }
+ 
+ void test_benchmark_waypoints() {
+   buildMap(GRID_SIDE, 10);
+   int32_t waypoints[WAYPOINTS] = {5 * GRID_SIDE + 3, 97 * GRID_SIDE + 95, 50 * GRID_SIDE + 2, 8 * GRID_SIDE + 97};
+   for (int i = 0; i < WAYPOINTS; i++) {
+     TEST_ASSERT_NOT_EQUAL(EDGE_NONE, adjacency.first(waypoints[i]));
+     named[waypoints[i]] = true;
+   }
+   
+   auto t0 = std::chrono::steady_clock::now();
+   landmarks.build(nodeCount, graph);
+   auto t1 = std::chrono::steady_clock::now();
+   
+   QueryCost saved = {0, 0, 0, 0, 0};
+   for (int i = 0; i < WAYPOINTS; i++) {
+     for (int j = 0; j < WAYPOINTS; j++) {
+       if (i != j) {
+         route(waypoints[i], waypoints[j], saved);
+       }
+     }
+   }
+   QueryCost random = {0, 0, 0, 0, 0};
+   for (int i = 0; i < 40; i++) {
+     route(nextRandom() % nodeCount, nextRandom() % nodeCount, random);
+   }
+   
+   TEST_ASSERT_EQUAL(WAYPOINTS * (WAYPOINTS - 1), saved.routes);
+   TEST_ASSERT_TRUE(saved.landmarkExpanded * 4 < saved.straightExpanded);
+   TEST_ASSERT_TRUE(random.landmarkExpanded < random.straightExpanded);
+   
+   char message[160];
+   snprintf(message, sizeof(message), "%d nodes, %d landmarks: built in %.0f us, %d bytes of tables",
+            nodeCount, landmarks.getLandmarkCount(), std::chrono::duration<double, std::micro>(t1 - t0).count(),
+            (int)(sizeof(uint16_t) * TEST_LANDMARKS * MAX_TEST_NODES));
+   TEST_MESSAGE(message);
+   report("Saved places", saved);
+   report("Random nodes", random);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_bounds);
+   RUN_TEST(test_patching);
+   RUN_TEST(test_benchmark_waypoints);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,84 @@
+/*
+ * test_lattice.h
+ *
+ * Synthetic walked map shared by the route search tests: a jittered
+ * lattice in meters with some edges withheld, optional diagonals and
+ * optional holes, as around buildings. Define MAX_TEST_NODES and
+ * MAX_TEST_EDGES before including it.
+ */
+
+ #ifndef TEST_LATTICE_H
+ #define TEST_LATTICE_H
+ 
+ #include <math.h>
+ #include "test_random.h"
+ #include "../src/main/EdgeIndex.h"
+ 
+ #if !defined(MAX_TEST_NODES) || !defined(MAX_TEST_EDGES)
+ #error "Define MAX_TEST_NODES and MAX_TEST_EDGES before including test_lattice.h"
+ #endif
+ 
+ static float nodeX[MAX_TEST_NODES];
+ static float nodeY[MAX_TEST_NODES];
+ static int32_t edgeSource[MAX_TEST_EDGES];
+ static int32_t edgeTarget[MAX_TEST_EDGES];
+ static float edgeWeight[MAX_TEST_EDGES];
+ static int nodeCount;
+ static int edgeCount;
+ static EdgeIndex<MAX_TEST_NODES, MAX_TEST_EDGES> adjacency;
+ 
+ static inline float distance(int32_t a, int32_t b) {
+   return sqrtf((nodeX[a] - nodeX[b]) * (nodeX[a] - nodeX[b]) + (nodeY[a] - nodeY[b]) * (nodeY[a] - nodeY[b]));
+ }
+ 
+ // Straight edge between two nodes, returns its index
+ static inline int addEdge(int32_t a, int32_t b) {
+   edgeSource[edgeCount] = a;
+   edgeTarget[edgeCount] = b;
+   edgeWeight[edgeCount] = distance(a, b);
+   adjacency.add(edgeCount, a, b);
+   return edgeCount++;
+ }
+ 
+ struct NoHoles {
+   bool operator()(int, int) const { return false; }
+ };
+ 
+ // side x side nodes spacing meters apart, node y * side + x jittered by
+ // up to a quarter of the spacing. Each edge to the right and down is
+ // withheld withheldPercent of the time and a diagonal added
+ // diagonalPercent of the time; nodes where hole(x, y) stay unconnected.
+ template <typename Holes>
+ static void buildLattice(int side, float spacing, int withheldPercent, int diagonalPercent, Holes hole) {
+   nodeCount = side * side;
+   edgeCount = 0;
+   adjacency.clear();
+   for (int y = 0; y < side; y++) {
+     for (int x = 0; x < side; x++) {
+       int n = y * side + x;
+       nodeX[n] = (x + (nextRandom() % 100) / 400.0f) * spacing;
+       nodeY[n] = (y + (nextRandom() % 100) / 400.0f) * spacing;
+     }
+   }
+   
+   for (int y = 0; y < side; y++) {
+     for (int x = 0; x < side; x++) {
+       int n = y * side + x;
+       if (hole(x, y)) {
+         continue;
+       }
+       if (x + 1 < side && !hole(x + 1, y) && (int)(nextRandom() % 100) >= withheldPercent) addEdge(n, n + 1);
+       if (y + 1 < side && !hole(x, y + 1) && (int)(nextRandom() % 100) >= withheldPercent) addEdge(n, n + side);
+       if (diagonalPercent > 0 && x + 1 < side && y + 1 < side && !hole(x + 1, y + 1) &&
+           (int)(nextRandom() % 100) < diagonalPercent) {
+         addEdge(n, n + side + 1);
+       }
+     }
+   }
+ }
+ 
+ static inline void buildLattice(int side, float spacing, int withheldPercent, int diagonalPercent) {
+   buildLattice(side, spacing, withheldPercent, diagonalPercent, NoHoles());
+ }
+ 
+ #endif
\ No newline at end of file
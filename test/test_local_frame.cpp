@@ -0,0 +1,178 @@
+/*
+ * test_local_frame.cpp
+ *
+ * Host unit tests for the local centimetre frame: distance error against
+ * the great-circle distance, and the cost of proximity checks against the
+ * float haversine the map used before
+ */
+
+ #include <unity.h>
+ #include <math.h>
+ #include <chrono>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include "../src/main/LocalFrame.h"
+ 
+ #define EARTH_RADIUS_M 6371000.0
+ #define DEG_TO_RAD 0.017453292519943295
+ #define PAIRS 20000
+ #define BENCH_NODES 1000
+ #define BENCH_QUERIES 2000
+ 
+ // Reference distance, in double precision
+ static double haversineDouble(double lat1, double lng1, double lat2, double lng2) {
+   double dLat = (lat2 - lat1) * DEG_TO_RAD;
+   double dLng = (lng2 - lng1) * DEG_TO_RAD;
+   double a = sin(dLat / 2) * sin(dLat / 2) +
+              cos(lat1 * DEG_TO_RAD) * cos(lat2 * DEG_TO_RAD) * sin(dLng / 2) * sin(dLng / 2);
+   return EARTH_RADIUS_M * 2 * atan2(sqrt(a), sqrt(1 - a));
+ }
+ 
+ // The float haversine MapSystem ran for every distance check
+ static float haversineFloat(float lat1, float lon1, float lat2, float lon2) {
+   float latRad1 = lat1 * DEG_TO_RAD;
+   float latRad2 = lat2 * DEG_TO_RAD;
+   float deltaLat = (lat2 - lat1) * DEG_TO_RAD;
+   float deltaLon = (lon2 - lon1) * DEG_TO_RAD;
+   float a = sin(deltaLat/2) * sin(deltaLat/2) +
+             cos(latRad1) * cos(latRad2) * sin(deltaLon/2) * sin(deltaLon/2);
+   float c = 2 * atan2(sqrt(a), sqrt(1-a));
+   return EARTH_RADIUS_M * c;
+ }
+ 
+ static float uniform(float low, float high) {
+   return low + (high - low) * (rand() / (float)RAND_MAX);
+ }
+ 
+ // Random position up to the given distance from a point, in meters
+ static void offset(float lat, float lng, float meters, float& outLat, float& outLng) {
+   float north = uniform(-meters, meters) * 0.7071f;
+   float east = uniform(-meters, meters) * 0.7071f;
+   outLat = lat + north / 111194.93f;
+   outLng = lng + east / (111194.93f * cosf(lat * DEG_TO_RAD));
+ }
+ 
+ // Test that distances stay within the documented bound anywhere in the frame
+ void test_error_bound() {
+   float origins[][2] = {{0.0f, 10.0f}, {33.5731f, -7.5898f}, {-45.0f, 170.0f}, {60.0f, 24.9f}};
+   char message[128];
+   srand(7);
+   for (int o = 0; o < 4; o++) {
+     LocalFrame frame;
+     frame.setOrigin(origins[o][0], origins[o][1]);
+     double slope = fabs(tan(origins[o][0] * DEG_TO_RAD)) * LOCAL_FRAME_RADIUS_M / EARTH_RADIUS_M;
+     double worstFrame = 0, worstFloat = 0;
+     
+     for (int i = 0; i < PAIRS; i++) {
+       float lat1, lng1, lat2, lng2;
+       offset(origins[o][0], origins[o][1], LOCAL_FRAME_RADIUS_M, lat1, lng1);
+       offset(lat1, lng1, 200, lat2, lng2);
+       LocalPoint a = frame.toLocal(lat1, lng1);
+       LocalPoint b = frame.toLocal(lat2, lng2);
+       if (!frame.isInside(a) || !frame.isInside(b)) {
+         continue;
+       }
+       
+       double reference = haversineDouble(lat1, lng1, lat2, lng2);
+       double error = fabs(LocalFrame::distance(a, b) - reference);
+       TEST_ASSERT_TRUE(error <= reference * (slope + 1e-5) + 0.015);
+       worstFrame = fmax(worstFrame, error);
+       worstFloat = fmax(worstFloat, fabs(haversineFloat(lat1, lng1, lat2, lng2) - reference));
+     }
+     
+     snprintf(message, sizeof(message), "lat %6.1f: worst error up to 200 m, frame %.1f cm, haversine %.1f cm",
+              origins[o][0], worstFrame * 100, worstFloat * 100);
+     TEST_MESSAGE(message);
+   }
+ }
+ 
+ // Test conversions back and forth, the frame edge and far positions
+ void test_round_trip_and_edges() {
+   LocalFrame frame;
+   TEST_ASSERT_FALSE(frame.isSet());
+   frame.setOrigin(33.5731f, -7.5898f);
+   TEST_ASSERT_TRUE(frame.isSet());
+   
+   // A float latitude here only resolves about 40 cm, the frame adds nothing
+   LocalPoint point = frame.toLocal(33.5741f, -7.5878f);
+   TEST_ASSERT_INT_WITHIN(1, (int)lround((33.5741f - 33.5731f) * 11119493.0), point.north);
+   float lat, lng;
+   frame.toGeo(point, lat, lng);
+   TEST_ASSERT_EQUAL_FLOAT(33.5741f, lat);
+   TEST_ASSERT_EQUAL_FLOAT(-7.5878f, lng);
+   
+   LocalPoint inside = {0, (LOCAL_FRAME_RADIUS_M - 1) * 100};
+   LocalPoint outside = {(LOCAL_FRAME_RADIUS_M + 1) * 100, 0};
+   TEST_ASSERT_TRUE(frame.isInside(inside));
+   TEST_ASSERT_FALSE(frame.isInside(outside));
+   
+   // The other side of the world clamps instead of overflowing
+   LocalPoint far = frame.toLocal(-33.5f, 172.4f);
+   TEST_ASSERT_EQUAL(LOCAL_FRAME_MAX_CM, far.east);
+   TEST_ASSERT_TRUE(LocalFrame::distanceSquared(far, frame.toLocal(-33.5f, -179.0f)) > 0);
+   TEST_ASSERT_FALSE(frame.isInside(far));
+   
+   // Radius checks are inclusive, as the map's were
+   LocalPoint a = {0, 0}, b = {300, 400};
+   TEST_ASSERT_TRUE(LocalFrame::isWithin(a, b, 5.0f));
+   TEST_ASSERT_FALSE(LocalFrame::isWithin(a, b, 4.99f));
+   TEST_ASSERT_EQUAL_FLOAT(5.0f, LocalFrame::distance(a, b));
+ }
+ 
+ // Compare a map-sized proximity scan with both methods
+ void test_proximity_benchmark() {
+   static float nodeLat[BENCH_NODES], nodeLng[BENCH_NODES];
+   static LocalPoint nodeLocal[BENCH_NODES];
+   static float queryLat[BENCH_QUERIES], queryLng[BENCH_QUERIES];
+   LocalFrame frame;
+   frame.setOrigin(33.5731f, -7.5898f);
+   srand(11);
+   for (int n = 0; n < BENCH_NODES; n++) {
+     offset(33.5731f, -7.5898f, 150, nodeLat[n], nodeLng[n]);
+     nodeLocal[n] = frame.toLocal(nodeLat[n], nodeLng[n]);
+   }
+   for (int q = 0; q < BENCH_QUERIES; q++) {
+     offset(33.5731f, -7.5898f, 150, queryLat[q], queryLng[q]);
+   }
+   
+   volatile float radius = 5.0f;
+   long haversineHits = 0, frameHits = 0;
+   auto begin = std::chrono::high_resolution_clock::now();
+   for (int q = 0; q < BENCH_QUERIES; q++) {
+     for (int n = 0; n < BENCH_NODES; n++) {
+       haversineHits += haversineFloat(queryLat[q], queryLng[q], nodeLat[n], nodeLng[n]) <= radius;
+     }
+   }
+   auto middle = std::chrono::high_resolution_clock::now();
+   for (int q = 0; q < BENCH_QUERIES; q++) {
+     LocalPoint centre = frame.toLocal(queryLat[q], queryLng[q]);
+     int64_t radiusSquared = LocalFrame::radiusSquared(radius);
+     for (int n = 0; n < BENCH_NODES; n++) {
+       frameHits += LocalFrame::distanceSquared(centre, nodeLocal[n]) <= radiusSquared;
+     }
+   }
+   auto end = std::chrono::high_resolution_clock::now();
+   
+   // Same answers, up to pairs within a centimetre or so of the radius
+   TEST_ASSERT_INT_WITHIN(haversineHits / 100 + 2, haversineHits, frameHits);
+   
+   double checks = (double)BENCH_QUERIES * BENCH_NODES;
+   double haversineNs = std::chrono::duration<double, std::nano>(middle - begin).count() / checks;
+   double frameNs = std::chrono::duration<double, std::nano>(end - middle).count() / checks;
+   TEST_ASSERT_TRUE(frameNs < haversineNs);
+   
+   char message[128];
+   snprintf(message, sizeof(message), "5 m proximity check: haversine %.2f ns, local frame %.2f ns (%.0fx)",
+            haversineNs, frameNs, haversineNs / frameNs);
+   TEST_MESSAGE(message);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_error_bound);
+   RUN_TEST(test_round_trip_and_edges);
+   RUN_TEST(test_proximity_benchmark);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
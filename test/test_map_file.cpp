@@ -0,0 +1,231 @@
+/*
+ * test_map_file.cpp
+ *
+ * Host unit tests for the binary map file, using a temporary file as a
+ * stand-in for the SD card
+ */
+
+ #include <unity.h>
+ #include <stdio.h>
+ #include <chrono>
+ #include "../src/main/MapFile.h"
+ #include "../src/main/MapStore.h"
+ #include "../src/main/NameTable.h"
+ 
+ typedef MapStore<100000, 150000> BigStore;
+ typedef NameTable<1024, 64> Names;
+ 
+ static BigStore source;
+ static BigStore loaded;
+ static Names sourceNames;
+ static Names loadedNames;
+ 
+ // Buffered stdio file with the read/write shape of an SD File
+ struct HostFile {
+   FILE* file;
+   
+   HostFile(const char* mode) { file = fopen("/tmp/test_map_file.bin", mode); }
+   ~HostFile() { if (file) fclose(file); }
+   size_t write(const uint8_t* data, size_t length) { return fwrite(data, 1, length, file); }
+   size_t read(uint8_t* data, size_t length) { return fread(data, 1, length, file); }
+ };
+ 
+ static long fileSize() {
+   HostFile f("rb");
+   fseek(f.file, 0, SEEK_END);
+   return ftell(f.file);
+ }
+ 
+ // Flip one byte of the saved file in place
+ static void corruptByte(long position) {
+   HostFile f("r+b");
+   fseek(f.file, position, SEEK_SET);
+   int value = fgetc(f.file);
+   fseek(f.file, position, SEEK_SET);
+   fputc(value ^ 0x5A, f.file);
+ }
+ 
+ static void cutFile(long length) {
+   uint8_t data[4096];
+   size_t kept;
+   {
+     HostFile f("rb");
+     kept = fread(data, 1, length < (long)sizeof(data) ? length : sizeof(data), f.file);
+   }
+   HostFile f("wb");
+   fwrite(data, 1, kept, f.file);
+ }
+ 
+ // Grid of nodes joined to their right and lower neighbours
+ static void buildMap(int nodes) {
+   source.clear();
+   sourceNames.clear();
+   int width = 100;
+   for (int i = 0; i < nodes; i++) {
+     MapHandle n = source.addNode(33.5f + (i / width) * 1e-4f, -7.6f + (i % width) * 1e-4f,
+                                  i % 17 == 0 ? NodeType::OBSTACLE : NodeType::PATH, i);
+     source.setVisitCount(n, i % 300);
+     if (source.isObstacle(n)) {
+       source.setObstacleType(n, ObstacleType::POLE);
+     }
+     if (i % width > 0) {
+       source.addEdge(n - 1, n, 11.1f, i);
+     }
+     if (i >= width && source.getEdgeCount() < BigStore::EDGE_CAPACITY) {
+       source.addEdge(n - width, n, 11.1f, i);
+     }
+   }
+   sourceNames.setName(0, "main gate");
+   sourceNames.setName(nodes - 1, "library");
+   source.setFlags(0, NODE_FLAG_NAMED);
+   source.setFlags(nodes - 1, NODE_FLAG_NAMED);
+ }
+ 
+ static MapFileStatus saveMap() {
+   static MapFile codec;
+   HostFile out("wb");
+   return codec.save(out, source, sourceNames);
+ }
+ 
+ static MapFileStatus loadMap() {
+   static MapFile codec;
+   HostFile in("rb");
+   return codec.load(in, loaded, loadedNames);
+ }
+ 
+ // Test that every field survives a save and load
+ void test_round_trip() {
+   buildMap(500);
+   TEST_ASSERT_EQUAL((int)MapFileStatus::OK, (int)saveMap());
+   TEST_ASSERT_EQUAL((int)MapFileStatus::OK, (int)loadMap());
+   
+   TEST_ASSERT_EQUAL(source.getNodeCount(), loaded.getNodeCount());
+   TEST_ASSERT_EQUAL(source.getEdgeCount(), loaded.getEdgeCount());
+   for (int n = 0; n < source.getNodeCount(); n++) {
+     TEST_ASSERT_FLOAT_WITHIN(1e-6, source.getLat(n), loaded.getLat(n));
+     TEST_ASSERT_FLOAT_WITHIN(1e-6, source.getLng(n), loaded.getLng(n));
+     TEST_ASSERT_EQUAL((int)source.getType(n), (int)loaded.getType(n));
+     TEST_ASSERT_EQUAL((int)source.getObstacleType(n), (int)loaded.getObstacleType(n));
+     TEST_ASSERT_EQUAL(source.getFlags(n), loaded.getFlags(n));
+     TEST_ASSERT_EQUAL(source.getVisitCount(n), loaded.getVisitCount(n));
+     TEST_ASSERT_EQUAL(source.getLastSeen(n), loaded.getLastSeen(n));
+   }
+   for (int e = 0; e < source.getEdgeCount(); e++) {
+     TEST_ASSERT_EQUAL(source.getSource(e), loaded.getSource(e));
+     TEST_ASSERT_EQUAL(source.getTarget(e), loaded.getTarget(e));
+     TEST_ASSERT_EQUAL_FLOAT(source.getWeight(e), loaded.getWeight(e));
+     TEST_ASSERT_EQUAL(source.getLastTraversed(e), loaded.getLastTraversed(e));
+   }
+   TEST_ASSERT_EQUAL_STRING("main gate", loadedNames.nameOf(0));
+   TEST_ASSERT_EQUAL_STRING("library", loadedNames.nameOf(499));
+   TEST_ASSERT_EQUAL(499, loadedNames.findNode("library"));
+   
+   // Free slots left by the simplifier load as free slots
+   source.freeEdge(3);
+   source.freeNode(250);
+   TEST_ASSERT_EQUAL((int)MapFileStatus::OK, (int)saveMap());
+   TEST_ASSERT_EQUAL((int)MapFileStatus::OK, (int)loadMap());
+   TEST_ASSERT_TRUE(loaded.isFreeEdge(3));
+   TEST_ASSERT_TRUE(loaded.isFree(250));
+   TEST_ASSERT_EQUAL(source.getLiveNodeCount(), loaded.getLiveNodeCount());
+   TEST_ASSERT_EQUAL(source.getLiveEdgeCount(), loaded.getLiveEdgeCount());
+   TEST_ASSERT_EQUAL(250, loaded.allocNode(33.5f, -7.6f, NodeType::PATH, 0));
+ }
+ 
+ // Test that damage anywhere is caught and leaves an empty map
+ void test_corruption_detected() {
+   buildMap(500);
+   saveMap();
+   
+   corruptByte(MAPFILE_HEADER_BYTES + MAPFILE_CHUNK_HEADER_BYTES + 100);
+   TEST_ASSERT_EQUAL((int)MapFileStatus::BAD_CRC, (int)loadMap());
+   TEST_ASSERT_EQUAL(0, loaded.getNodeCount());
+   TEST_ASSERT_EQUAL(0, loadedNames.getNamedCount());
+   
+   saveMap();
+   corruptByte(9);
+   TEST_ASSERT_EQUAL((int)MapFileStatus::BAD_HEADER, (int)loadMap());
+   
+   saveMap();
+   cutFile(fileSize() - MAPFILE_CHUNK_HEADER_BYTES);
+   TEST_ASSERT_EQUAL((int)MapFileStatus::IO_ERROR, (int)loadMap());
+   TEST_ASSERT_EQUAL(0, loaded.getNodeCount());
+ }
+ 
+ // Test that a file from a different format version is refused
+ void test_version_checked() {
+   buildMap(10);
+   saveMap();
+   
+   // Rewrite the version and re-seal the header so only the version differs
+   uint8_t header[MAPFILE_HEADER_BYTES];
+   {
+     HostFile f("rb");
+     fread(header, 1, sizeof(header), f.file);
+   }
+   header[4] = MAPFILE_VERSION + 1;
+   uint32_t crc = crc32(header, 28);
+   for (int i = 0; i < 4; i++) {
+     header[28 + i] = crc >> (8 * i);
+   }
+   {
+     HostFile f("r+b");
+     fwrite(header, 1, sizeof(header), f.file);
+   }
+   TEST_ASSERT_EQUAL((int)MapFileStatus::BAD_VERSION, (int)loadMap());
+ }
+ 
+ // Test that a file larger than memory loads what fits and says so
+ void test_truncated_load() {
+   static MapStore<300, 450> small;
+   static MapFile codec;
+   buildMap(500);
+   saveMap();
+   
+   HostFile in("rb");
+   NameTable<1024, 64> names;
+   TEST_ASSERT_EQUAL((int)MapFileStatus::TRUNCATED, (int)codec.load(in, small, names));
+   TEST_ASSERT_EQUAL(300, small.getNodeCount());
+   TEST_ASSERT_EQUAL_STRING("main gate", names.nameOf(0));
+   TEST_ASSERT_NULL(names.nameOf(499));
+ }
+ 
+ // Report save/load time and file size; buffer RAM is the same at every size
+ void test_benchmark() {
+   const int sizes[] = {500, 10000, 100000};
+   char message[128];
+   
+   for (int s = 0; s < 3; s++) {
+     buildMap(sizes[s]);
+     
+     auto start = std::chrono::high_resolution_clock::now();
+     MapFileStatus saved = saveMap();
+     auto middle = std::chrono::high_resolution_clock::now();
+     MapFileStatus read = loadMap();
+     auto end = std::chrono::high_resolution_clock::now();
+     
+     TEST_ASSERT_EQUAL((int)MapFileStatus::OK, (int)saved);
+     TEST_ASSERT_EQUAL((int)MapFileStatus::OK, (int)read);
+     TEST_ASSERT_EQUAL(source.getEdgeCount(), loaded.getEdgeCount());
+     
+     double saveMs = std::chrono::duration<double, std::milli>(middle - start).count();
+     double loadMs = std::chrono::duration<double, std::milli>(end - middle).count();
+     snprintf(message, sizeof(message), "%6d nodes %6d edges: save %.2f ms, load %.2f ms, %ld bytes, %u bytes RAM",
+              sizes[s], source.getEdgeCount(), saveMs, loadMs, fileSize(), (unsigned)sizeof(MapFile));
+     TEST_MESSAGE(message);
+   }
+   
+   TEST_ASSERT_TRUE(sizeof(MapFile) < 1400);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_round_trip);
+   RUN_TEST(test_corruption_detected);
+   RUN_TEST(test_version_checked);
+   RUN_TEST(test_truncated_load);
+   RUN_TEST(test_benchmark);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,275 @@
+/*
+ * test_map_journal.cpp
+ *
+ * Host crash-consistency tests for the map journal. An in-memory stand-in
+ * for the SD card cuts the power after a given number of bytes and file
+ * operations; the map recovered afterwards must hold every change whose
+ * journal record was written.
+ */
+
+ #include <unity.h>
+ #include <stdio.h>
+ #include <algorithm>
+ #include <map>
+ #include <string>
+ #include <vector>
+ 
+ #define MAPJOURNAL_COMPACT_BYTES 1024   // Compact often in these small runs
+ #include "../src/main/MapJournal.h"
+ #include "../src/main/NameTable.h"
+ 
+ typedef MapStore<256, 384> Store;
+ typedef NameTable<256, 8> Names;
+ 
+ #define SCENARIO_STEPS 120
+ #define NAMED_STEP 40
+ 
+ struct CrashFS;
+ 
+ // File handle with the shape of an SD File
+ struct MemFile {
+   CrashFS* fs;
+   std::string path;
+   size_t position;
+   bool open;
+   
+   MemFile() : fs(0), position(0), open(false) {}
+   operator bool() const { return open; }
+   size_t write(const uint8_t* data, size_t length);
+   int read(uint8_t* data, size_t length);
+   size_t size();
+   void flush() {}
+   void close() { open = false; }
+ };
+ 
+ // Files in memory. Once the budget of bytes and operations runs out the
+ // power is off: writes stop part way and nothing else changes.
+ struct CrashFS {
+   std::map<std::string, std::vector<uint8_t> > files;
+   long budget;
+   long spent;
+   
+   CrashFS() : budget(-1), spent(0) {}
+   
+   // How much of a change of the given size still happens
+   long spend(long amount) {
+     if (budget >= 0 && spent + amount > budget) {
+       amount = budget > spent ? budget - spent : 0;
+     }
+     spent += amount;
+     return amount;
+   }
+   bool powered() const { return budget < 0 || spent < budget; }
+   
+   MemFile open(const char* path, const char* mode) {
+     MemFile file;
+     if (mode[0] == 'r' && !exists(path)) {
+       return file;
+     }
+     if (mode[0] == 'w') {
+       if (spend(1) < 1) {
+         return file;
+       }
+       files[path].clear();
+     }
+     file.fs = this;
+     file.path = path;
+     file.position = mode[0] == 'a' ? files[path].size() : 0;
+     file.open = true;
+     return file;
+   }
+   bool exists(const char* path) { return files.count(path) > 0; }
+   bool remove(const char* path) {
+     if (spend(1) < 1) {
+       return false;
+     }
+     return files.erase(path) > 0;
+   }
+   bool rename(const char* from, const char* to) {
+     if (!exists(from) || spend(1) < 1) {
+       return false;
+     }
+     files[to] = files[from];
+     files.erase(from);
+     return true;
+   }
+ };
+ 
+ size_t MemFile::write(const uint8_t* data, size_t length) {
+   std::vector<uint8_t>& bytes = fs->files[path];
+   size_t written = fs->spend(length);
+   bytes.insert(bytes.end(), data, data + written);
+   position += written;
+   return written;
+ }
+ 
+ int MemFile::read(uint8_t* data, size_t length) {
+   std::vector<uint8_t>& bytes = fs->files[path];
+   size_t available = position < bytes.size() ? bytes.size() - position : 0;
+   size_t count = length < available ? length : available;
+   memcpy(data, bytes.data() + position, count);
+   position += count;
+   return count;
+ }
+ 
+ size_t MemFile::size() { return fs->files[path].size(); }
+ 
+ // What the scenario knows reached the card before the power went
+ struct Durable {
+   int nodes;                     // Nodes whose add record was written
+   int edges;
+   uint16_t visits[256];          // Last visit count written per node
+   bool named;
+ };
+ 
+ static float latOf(int i) { return 33.5f + i * 1e-4f; }
+ 
+ // Start from whatever is on the card and walk a chain of nodes, revisiting
+ // older ones and naming one. Returns the largest write of a single call.
+ static long runScenario(CrashFS& fs, Store& store, Names& names, Durable& durable) {
+   MapJournal<CrashFS> journal(fs);
+   store.clear();
+   names.clear();
+   journal.recover(store, names);
+   if (!journal.isReady()) {
+     journal.saveAll(store, names);
+   }
+   
+   memset(&durable, 0, sizeof(durable));
+   durable.nodes = store.getNodeCount();
+   durable.edges = store.getEdgeCount();
+   long largestCall = 0;
+   for (int i = store.getNodeCount(); i < SCENARIO_STEPS && fs.powered(); i++) {
+     MapHandle node = store.addNode(latOf(i), -7.6f, i % 9 == 0 ? NodeType::OBSTACLE : NodeType::PATH, i);
+     long before = fs.spent;
+     if (journal.logNode(store, node) && durable.nodes == i) {
+       durable.nodes = i + 1;
+       durable.visits[node] = store.getVisitCount(node);
+     }
+     largestCall = std::max(largestCall, fs.spent - before);
+     
+     if (i > 0) {
+       MapHandle edge = store.addEdge(node - 1, node, 11.1f, i);
+       if (journal.logEdge(store, edge) && durable.edges == edge) {
+         durable.edges = edge + 1;
+       }
+     }
+     if (i % 3 == 0) {
+       MapHandle old = i / 2;
+       store.visitNode(old, i);
+       if (journal.logNode(store, old)) {
+         durable.visits[old] = store.getVisitCount(old);
+       }
+     }
+     if (i == NAMED_STEP) {
+       names.setName(node, "bus stop");
+       store.setFlag(node, NODE_FLAG_NAMED);
+       durable.named = journal.logNode(store, node) && journal.logName(node, "bus stop");
+     }
+     
+     before = fs.spent;
+     journal.compactStep(store, names);
+     largestCall = std::max(largestCall, fs.spent - before);
+   }
+   return largestCall;
+ }
+ 
+ // Test that a run without power cuts compacts and recovers exactly
+ void test_replay_and_compaction() {
+   CrashFS fs;
+   static Store store, recovered;
+   Names names, recoveredNames;
+   Durable durable;
+   long largestCall = runScenario(fs, store, names, durable);
+   
+   MapJournal<CrashFS> journal(fs);
+   TEST_ASSERT_TRUE(journal.recover(recovered, recoveredNames));
+   TEST_ASSERT_TRUE(journal.isReady());
+   TEST_ASSERT_GREATER_THAN(2, journal.getGeneration());   // Compacted more than once
+   
+   TEST_ASSERT_EQUAL(store.getNodeCount(), recovered.getNodeCount());
+   TEST_ASSERT_EQUAL(store.getEdgeCount(), recovered.getEdgeCount());
+   for (int n = 0; n < store.getNodeCount(); n++) {
+     TEST_ASSERT_EQUAL(store.getVisitCount(n), recovered.getVisitCount(n));
+     TEST_ASSERT_EQUAL(store.getLastSeen(n), recovered.getLastSeen(n));
+     TEST_ASSERT_EQUAL((int)store.getType(n), (int)recovered.getType(n));
+   }
+   TEST_ASSERT_EQUAL(NAMED_STEP, recoveredNames.findNode("bus stop"));
+   
+   // Journal stays bounded and each call writes at most a record or two chunks
+   TEST_ASSERT_LESS_THAN(MAPJOURNAL_COMPACT_BYTES * 2, (long)journal.getJournalBytes());
+   TEST_ASSERT_LESS_OR_EQUAL(MAPJOURNAL_CHUNKS_PER_STEP * (MAPFILE_CHUNK_HEADER_BYTES + MAPFILE_CHUNK_PAYLOAD) +
+                             MAPFILE_HEADER_BYTES, largestCall);
+   
+   char message[96];
+   snprintf(message, sizeof(message), "largest write per call %ld bytes, %ld bytes written in total",
+            largestCall, fs.spent);
+   TEST_MESSAGE(message);
+ }
+ 
+ // Cut the power after every possible number of bytes and operations
+ void test_power_cut_anywhere() {
+   CrashFS full;
+   static Store store, recovered;
+   Names names, recoveredNames;
+   Durable durable;
+   runScenario(full, store, names, durable);
+   long total = full.spent;
+   
+   int failures = 0;
+   for (long budget = 0; budget <= total && failures < 5; budget++) {
+     CrashFS fs;
+     fs.budget = budget;
+     runScenario(fs, store, names, durable);
+     
+     // Power back on, recover and check against what was known to be written
+     fs.budget = -1;
+     MapJournal<CrashFS> journal(fs);
+     recovered.clear();
+     recoveredNames.clear();
+     journal.recover(recovered, recoveredNames);
+     
+     bool ok = recovered.getNodeCount() >= durable.nodes && recovered.getEdgeCount() >= durable.edges &&
+               recovered.getNodeCount() <= SCENARIO_STEPS;
+     for (int n = 0; ok && n < recovered.getNodeCount(); n++) {
+       ok = recovered.getLat(n) == latOf(n) && recovered.getVisitCount(n) >= durable.visits[n];
+     }
+     for (int e = 0; ok && e < recovered.getEdgeCount(); e++) {
+       ok = recovered.getSource(e) == e && recovered.getTarget(e) == e + 1;
+     }
+     if (ok && durable.named) {
+       ok = recoveredNames.findNode("bus stop") == NAMED_STEP;
+     }
+     
+     // The next run continues from the recovered map without losing it
+     if (ok) {
+       runScenario(fs, recovered, recoveredNames, durable);
+       ok = durable.nodes == SCENARIO_STEPS;
+       recovered.clear();
+       recoveredNames.clear();
+       MapJournal<CrashFS> again(fs);
+       ok = ok && again.recover(recovered, recoveredNames) && recovered.getNodeCount() == SCENARIO_STEPS;
+     }
+     
+     if (!ok) {
+       char message[64];
+       snprintf(message, sizeof(message), "inconsistent after power cut at %ld", budget);
+       TEST_MESSAGE(message);
+       failures++;
+     }
+   }
+   TEST_ASSERT_EQUAL(0, failures);
+   
+   char message[64];
+   snprintf(message, sizeof(message), "%ld power-cut points checked", total + 1);
+   TEST_MESSAGE(message);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_replay_and_compaction);
+   RUN_TEST(test_power_cut_anywhere);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
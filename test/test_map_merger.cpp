@@ -0,0 +1,340 @@
+/*
+ * test_map_merger.cpp
+ *
+ * Host unit tests for merging the maps of several canes: the same walk
+ * fused node for node, places kept apart by type and name, obstacles
+ * settled by recency, the result saved and loaded like a cane's map,
+ * and merge time on one core against all of them
+ */
+
+ #include <unity.h>
+ #include <math.h>
+ #include <chrono>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <vector>
+ #include <algorithm>
+ #include "../src/main/MapMerger.h"
+ #include "../src/main/NameTable.h"
+ 
+ typedef MapStore<5000, 7500> Store;
+ typedef NameTable<1024, 64> Names;
+ 
+ #define BASE_LAT 33.5731
+ #define BASE_LNG -7.5898
+ #define T0 1700000000UL
+ #define CANES 16
+ #define GRID_SIDE 25          // Corridor crossings along each side
+ #define GRID_SPACING_M 20.0
+ #define GRID_STEPS 4          // Nodes every 5 m along a corridor
+ 
+ static Store maps[2];
+ static Names mapNames[2];
+ static Store result;
+ static Names resultNames;
+ 
+ static float latAt(double northM) { return BASE_LAT + northM / (LOCAL_FRAME_CM_PER_DEG / 100.0); }
+ static float lngAt(double eastM) { return BASE_LNG + eastM / (LOCAL_FRAME_CM_PER_DEG / 100.0 * cos(BASE_LAT * M_PI / 180)); }
+ 
+ static MapHandle addNode(Store& store, double eastM, double northM, NodeType type, uint32_t seen, uint16_t visits) {
+   MapHandle node = store.addNode(latAt(northM), lngAt(eastM), type, seen);
+   store.setVisitCount(node, visits);
+   return node;
+ }
+ 
+ static MapHandle addEdge(Store& store, MapHandle a, MapHandle b, uint32_t when, uint16_t traversals) {
+   double north = (store.getLat(b) - store.getLat(a)) * (LOCAL_FRAME_CM_PER_DEG / 100.0);
+   double east = (store.getLng(b) - store.getLng(a)) * (LOCAL_FRAME_CM_PER_DEG / 100.0) * cos(BASE_LAT * M_PI / 180);
+   float weight = sqrt(north * north + east * east);
+   MapHandle edge = store.addEdge(a, b, weight, when);
+   store.setTraverseCount(edge, traversals);
+   return edge;
+ }
+ 
+ static void clearMaps() {
+   for (int i = 0; i < 2; i++) {
+     maps[i].clear();
+     mapNames[i].clear();
+   }
+ }
+ 
+ static int countType(const Store& store, NodeType type) {
+   int count = 0;
+   for (MapHandle n = 0; n < store.getNodeCount(); n++) {
+     count += store.getType(n) == type;
+   }
+   return count;
+ }
+ 
+ // Test two canes on the same corridor, a metre apart: one node each, not one in all
+ void test_same_walk() {
+   clearMaps();
+   for (int i = 0; i < 10; i++) {
+     addNode(maps[0], i * 5.0, 0, NodeType::PATH, T0 + i, 2);
+     addNode(maps[1], i * 5.0 + 1.0, 0.5, NodeType::PATH, T0 + 100 + i, 3);
+     if (i > 0) {
+       addEdge(maps[0], i - 1, i, T0 + i, 1);
+       addEdge(maps[1], i - 1, i, T0 + 100 + i, 4);
+     }
+   }
+   // A branch only the second cane walked
+   addNode(maps[1], 20.0, 10.0, NodeType::PATH, T0 + 200, 1);
+   addEdge(maps[1], 4, 10, T0 + 200, 1);
+   
+   MapMerger merger;
+   merger.addMap(maps[0], mapNames[0]);
+   merger.addMap(maps[1], mapNames[1]);
+   merger.merge(2);
+   TEST_ASSERT_TRUE(merger.build(result, resultNames));
+   
+   const MapMergeStats& stats = merger.getStats();
+   TEST_ASSERT_EQUAL(10, stats.fusedNodes);
+   TEST_ASSERT_EQUAL(11, result.getNodeCount());
+   TEST_ASSERT_EQUAL(10, result.getEdgeCount());
+   for (MapHandle n = 0; n < 10; n++) {
+     TEST_ASSERT_EQUAL(5, result.getVisitCount(n));
+     TEST_ASSERT_EQUAL(T0 + 100 + n, result.getLastSeen(n));
+     
+     // Where the more visited cane put it
+     TEST_ASSERT_FLOAT_WITHIN(1e-5, lngAt(n * 5.0 + 1.0), result.getLng(n));
+   }
+   for (MapHandle e = 0; e < result.getEdgeCount(); e++) {
+     if (result.getTarget(e) < 10) {
+       TEST_ASSERT_EQUAL(5, result.getTraverseCount(e));
+       TEST_ASSERT_EQUAL(T0 + 100 + result.getTarget(e), result.getLastTraversed(e));
+     }
+   }
+ }
+ 
+ // Test places: doors fuse with doors, names must agree
+ void test_places_and_names() {
+   clearMaps();
+   addNode(maps[0], 0, 0, NodeType::DOOR, T0, 1);
+   addNode(maps[0], 30, 0, NodeType::ROOM, T0, 1);
+   MapHandle kitchen = addNode(maps[0], 60, 0, NodeType::ROOM, T0, 1);
+   MapHandle office = addNode(maps[0], 90, 0, NodeType::ROOM, T0, 1);
+   mapNames[0].setName(kitchen, "Kitchen");
+   maps[0].setFlag(kitchen, NODE_FLAG_NAMED);
+   mapNames[0].setName(office, "Office");
+   maps[0].setFlag(office, NODE_FLAG_NAMED);
+   
+   addNode(maps[1], 3, 0, NodeType::DOOR, T0, 1);                 // Same door
+   addNode(maps[1], 33, 0, NodeType::DOOR, T0, 1);                // A door by the room
+   addNode(maps[1], 62, 0, NodeType::ROOM, T0, 4);              // Better known, unnamed
+   MapHandle other = addNode(maps[1], 92, 0, NodeType::ROOM, T0, 1);
+   mapNames[1].setName(other, "Lounge");
+   maps[1].setFlag(other, NODE_FLAG_NAMED);
+   
+   MapMerger merger;
+   merger.addMap(maps[0], mapNames[0]);
+   merger.addMap(maps[1], mapNames[1]);
+   merger.merge();
+   TEST_ASSERT_TRUE(merger.build(result, resultNames));
+   
+   TEST_ASSERT_EQUAL(2, merger.getStats().fusedNodes);
+   TEST_ASSERT_EQUAL(6, result.getNodeCount());
+   TEST_ASSERT_EQUAL(2, countType(result, NodeType::DOOR));
+   TEST_ASSERT_EQUAL(4, countType(result, NodeType::ROOM));
+   
+   // The kitchen stands where the unnamed, better known room was, and keeps its name
+   MapHandle fused = resultNames.findNode("Kitchen");
+   TEST_ASSERT_TRUE(fused >= 0);
+   TEST_ASSERT_FLOAT_WITHIN(1e-5, lngAt(62), result.getLng(fused));
+   TEST_ASSERT_TRUE(resultNames.findNode("Office") >= 0);
+   TEST_ASSERT_TRUE(resultNames.findNode("Lounge") >= 0);
+   TEST_ASSERT_EQUAL(3, resultNames.getNamedCount());
+ }
+ 
+ // Test obstacles: the newest sighting wins, lifetimes run by the newest clock,
+ // and a cane standing there later clears one
+ void test_obstacles_by_recency() {
+   clearMaps();
+   // A chair, seen again as a person who has since walked off
+   MapHandle chair = addNode(maps[0], 0, 0, NodeType::OBSTACLE, T0, 0);
+   maps[0].setObstacleType(chair, ObstacleType::CHAIR);
+   MapHandle person = addNode(maps[1], 1, 0, NodeType::OBSTACLE, T0 + 100, 0);
+   maps[1].setObstacleType(person, ObstacleType::PERSON);
+   
+   // A wall nobody has been back to, and a table the other cane later walked by
+   MapHandle wall = addNode(maps[0], 50, 0, NodeType::OBSTACLE, T0, 0);
+   maps[0].setObstacleType(wall, ObstacleType::WALL);
+   MapHandle table = addNode(maps[0], 100, 0, NodeType::OBSTACLE, T0, 0);
+   maps[0].setObstacleType(table, ObstacleType::TABLE);
+   MapHandle before = addNode(maps[1], 101, 0, NodeType::PATH, T0 - 10, 1);
+   MapHandle after = addNode(maps[1], 100, 1, NodeType::PATH, T0 + 10, 1);
+   addEdge(maps[1], before, after, T0 + 10, 1);
+   
+   // The seeing cane's own later steps beside a pole do not clear it
+   MapHandle pole = addNode(maps[0], 150, 0, NodeType::OBSTACLE, T0, 0);
+   maps[0].setObstacleType(pole, ObstacleType::POLE);
+   addNode(maps[0], 151, 0, NodeType::PATH, T0 + 5, 1);
+   
+   // The clock: the second cane's last step
+   addNode(maps[1], 300, 0, NodeType::PATH, T0 + 1000, 1);
+   
+   MapMerger merger;
+   merger.addMap(maps[0], mapNames[0]);
+   merger.addMap(maps[1], mapNames[1]);
+   merger.merge();
+   TEST_ASSERT_TRUE(merger.build(result, resultNames));
+   
+   const MapMergeStats& stats = merger.getStats();
+   TEST_ASSERT_EQUAL(1, stats.fusedNodes);
+   TEST_ASSERT_EQUAL(1, stats.expiredObstacles);   // The person: 120 s
+   TEST_ASSERT_EQUAL(1, stats.passedObstacles);    // The table
+   TEST_ASSERT_EQUAL(2, countType(result, NodeType::OBSTACLE));
+   for (MapHandle n = 0; n < result.getNodeCount(); n++) {
+     if (result.isObstacle(n)) {
+       TEST_ASSERT_TRUE(result.getObstacleType(n) == ObstacleType::WALL || result.getObstacleType(n) == ObstacleType::POLE);
+     }
+   }
+   TEST_ASSERT_EQUAL(6, result.getNodeCount());
+ }
+ 
+ // Test that a forgotten obstacle with edges stays as a path node
+ void test_forgotten_obstacle_keeps_edges() {
+   clearMaps();
+   MapHandle a = addNode(maps[0], 0, 0, NodeType::PATH, T0, 1);
+   MapHandle person = addNode(maps[0], 5, 0, NodeType::OBSTACLE, T0, 0);
+   maps[0].setObstacleType(person, ObstacleType::PERSON);
+   addEdge(maps[0], a, person, T0, 1);
+   addNode(maps[1], 500, 0, NodeType::PATH, T0 + 3600, 1);
+   
+   MapMerger merger;
+   merger.addMap(maps[0], mapNames[0]);
+   merger.addMap(maps[1], mapNames[1]);
+   merger.merge();
+   TEST_ASSERT_TRUE(merger.build(result, resultNames));
+   TEST_ASSERT_EQUAL(3, result.getNodeCount());
+   TEST_ASSERT_EQUAL(0, countType(result, NodeType::OBSTACLE));
+   TEST_ASSERT_EQUAL(1, result.getEdgeCount());
+ }
+ 
+ // In-memory file for the round trip
+ struct MemoryFile {
+   std::vector<uint8_t> bytes;
+   size_t position;
+   
+   MemoryFile() : position(0) {}
+   size_t write(const uint8_t* data, size_t length) {
+     bytes.insert(bytes.end(), data, data + length);
+     return length;
+   }
+   int read(uint8_t* data, size_t length) {
+     size_t count = std::min(length, bytes.size() - position);
+     memcpy(data, bytes.data() + position, count);
+     position += count;
+     return count;
+   }
+ };
+ 
+ // Each cane walked most corridors of one building grid, with its own GPS
+ // offset, a few obstacles of its own and its own clock
+ static void walkGrid(Store& store, Names& names, unsigned seed) {
+   srand(seed);
+   store.clear();
+   names.clear();
+   double offsetE = (rand() % 200 - 100) / 100.0, offsetN = (rand() % 200 - 100) / 100.0;
+   uint32_t start = T0 + rand() % 86400;
+   int side = (GRID_SIDE - 1) * GRID_STEPS + 1;
+   std::vector<MapHandle> at(side * side, MAP_NO_HANDLE);
+   
+   struct Lattice {
+     static bool onCorridor(int x, int y) { return x % GRID_STEPS == 0 || y % GRID_STEPS == 0; }
+   };
+   for (int y = 0; y < side; y++) {
+     for (int x = 0; x < side; x++) {
+       if (Lattice::onCorridor(x, y) && rand() % 10 < 8) {
+         at[y * side + x] = addNode(store, x * GRID_SPACING_M / GRID_STEPS + offsetE,
+                                    y * GRID_SPACING_M / GRID_STEPS + offsetN, NodeType::PATH,
+                                    start + rand() % 3600, 1 + rand() % 5);
+       }
+     }
+   }
+   for (int y = 0; y < side; y++) {
+     for (int x = 0; x < side; x++) {
+       MapHandle a = at[y * side + x];
+       if (a == MAP_NO_HANDLE) {
+         continue;
+       }
+       if (x + 1 < side && y % GRID_STEPS == 0 && at[y * side + x + 1] != MAP_NO_HANDLE) {
+         addEdge(store, a, at[y * side + x + 1], start + rand() % 3600, 1 + rand() % 3);
+       }
+       if (y + 1 < side && x % GRID_STEPS == 0 && at[(y + 1) * side + x] != MAP_NO_HANDLE) {
+         addEdge(store, a, at[(y + 1) * side + x], start + rand() % 3600, 1 + rand() % 3);
+       }
+     }
+   }
+   for (int i = 0; i < 20; i++) {
+     MapHandle obstacle = addNode(store, rand() % (int)((GRID_SIDE - 1) * GRID_SPACING_M), (rand() % (GRID_SIDE - 1)) *
+                                  GRID_SPACING_M + 1.0, NodeType::OBSTACLE, start + rand() % 3600, 0);
+     store.setObstacleType(obstacle, (ObstacleType)(rand() % (int)ObstacleType::COUNT));
+   }
+ }
+ 
+ // Test a merge of many canes' maps, and its speed on one core and on all
+ void test_benchmark_merge() {
+   static Store canes[CANES];
+   static Names caneNames[CANES];
+   uint32_t inputNodes = 0;
+   for (int c = 0; c < CANES; c++) {
+     walkGrid(canes[c], caneNames[c], 1000 + c);
+     inputNodes += canes[c].getLiveNodeCount();
+   }
+   
+   // At least four workers, so the split into runs of cells is exercised on any machine
+   int cores = std::max(1, (int)std::thread::hardware_concurrency());
+   int threads = std::max(4, cores);
+   double seconds[2];
+   uint32_t nodes[2], edges[2];
+   for (int run = 0; run < 2; run++) {
+     MapMerger merger;
+     for (int c = 0; c < CANES; c++) {
+       merger.addMap(canes[c], caneNames[c]);
+     }
+     auto t0 = std::chrono::steady_clock::now();
+     merger.merge(run == 0 ? 1 : threads);
+     seconds[run] = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+     TEST_ASSERT_TRUE(merger.build(result, resultNames));
+     nodes[run] = result.getNodeCount();
+     edges[run] = result.getEdgeCount();
+     if (run == 1) {
+       char message[200];
+       const MapMergeStats& stats = merger.getStats();
+       snprintf(message, sizeof(message), "%d maps, %u nodes: %u pairs, %u fused, %u expired, %u walked past",
+                CANES, stats.inputNodes, stats.pairs, stats.fusedNodes, stats.expiredObstacles, stats.passedObstacles);
+       TEST_MESSAGE(message);
+       snprintf(message, sizeof(message), "Merged to %u nodes and %u edges: 1 thread %.1f ms, %d threads on %d cores %.1f ms",
+                nodes[run], edges[run], seconds[0] * 1e3, threads, cores, seconds[1] * 1e3);
+       TEST_MESSAGE(message);
+     }
+   }
+   
+   // The same map however the work is split, about one node per corridor point
+   TEST_ASSERT_EQUAL(nodes[0], nodes[1]);
+   TEST_ASSERT_EQUAL(edges[0], edges[1]);
+   int corridor = GRID_SIDE * GRID_SIDE + 2 * GRID_SIDE * (GRID_SIDE - 1) * (GRID_STEPS - 1);
+   int paths = countType(result, NodeType::PATH);
+   TEST_ASSERT_TRUE(paths >= corridor * 98 / 100 && paths <= corridor * 102 / 100);
+   TEST_ASSERT_TRUE(inputNodes > (uint32_t)corridor * CANES / 2);
+   
+   // Saved and loaded back like a cane's own map
+   MemoryFile file;
+   MapFile codec;
+   TEST_ASSERT_TRUE(codec.save(file, result, resultNames, 1) == MapFileStatus::OK);
+   TEST_ASSERT_TRUE(codec.load(file, maps[0], mapNames[0]) == MapFileStatus::OK);
+   TEST_ASSERT_EQUAL(result.getNodeCount(), maps[0].getNodeCount());
+   TEST_ASSERT_EQUAL(result.getEdgeCount(), maps[0].getEdgeCount());
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_same_walk);
+   RUN_TEST(test_places_and_names);
+   RUN_TEST(test_obstacles_by_recency);
+   RUN_TEST(test_forgotten_obstacle_keeps_edges);
+   RUN_TEST(test_benchmark_merge);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,388 @@
+/*
+ * test_map_simplifier.cpp
+ *
+ * Host unit tests for the map simplifier: thinned chains stay within the
+ * tolerance of every point they absorbed, duplicates fuse without touching
+ * protected nodes, every change is reported, and a route walked again and
+ * again stops growing the map
+ */
+
+ #include <unity.h>
+ #include <math.h>
+ #include <chrono>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include "../src/main/MapSimplifier.h"
+ #include "../src/main/SpatialGrid.h"
+ 
+ #define MAX_NODES 4000
+ #define MAX_EDGES 6000
+ #define PROXIMITY_M 5.0f    // NODE_PROXIMITY_THRESHOLD in MapSystem
+ #define STEP_NODES 16       // MAP_SIMPLIFY_NODES_PER_STEP in MapSystem
+ #define BASE_LAT 33.5731f
+ #define BASE_LNG -7.5898f
+ 
+ typedef MapStore<MAX_NODES, MAX_EDGES> Store;
+ typedef SpatialGrid<MAX_NODES, 2048> Grid;
+ typedef EdgeIndex<MAX_NODES, MAX_EDGES> Adjacency;
+ typedef MapSimplifier<Store, Grid, Adjacency> Simplifier;
+ 
+ static Store store, mirror;
+ static Grid grid;
+ static Adjacency adjacency;
+ static LocalPoint local[MAX_NODES];
+ static LocalFrame frame;
+ static Simplifier simplifier(store, grid, adjacency, local);
+ 
+ // Copies every reported record into the mirror, as the journal would
+ struct Mirror {
+   int nodes, edges;
+   
+   void nodeChanged(MapHandle node) {
+     nodes++;
+     mirror.setPosition(node, store.getLat(node), store.getLng(node));
+     mirror.setType(node, store.getType(node));
+     mirror.setFlags(node, store.getFlags(node));
+     mirror.setVisitCount(node, store.getVisitCount(node));
+     mirror.setLastSeen(node, store.getLastSeen(node));
+   }
+   void edgeChanged(MapHandle edge) {
+     edges++;
+     mirror.setEdge(edge, store.getSource(edge), store.getTarget(edge), store.getWeight(edge));
+     mirror.setTraverseCount(edge, store.getTraverseCount(edge));
+     mirror.setLastTraversed(edge, store.getLastTraversed(edge));
+   }
+ };
+ 
+ static void reset() {
+   store.clear();
+   grid.clear();
+   adjacency.clear();
+   frame.setOrigin(BASE_LAT, BASE_LNG);
+   simplifier.pin(MAP_NO_HANDLE);
+ }
+ 
+ // Position the given meters east and north of the base
+ static void toGeo(float east, float north, float& lat, float& lng) {
+   LocalPoint point = {(int32_t)(east * 100), (int32_t)(north * 100)};
+   frame.toGeo(point, lat, lng);
+ }
+ 
+ static MapHandle addNode(float lat, float lng, NodeType type) {
+   MapHandle node = store.allocNode(lat, lng, type, 0);
+   if (node != MAP_NO_HANDLE) {
+     grid.insert(node, lat, lng);
+     local[node] = frame.toLocal(lat, lng);
+   }
+   return node;
+ }
+ 
+ static MapHandle addEdge(MapHandle a, MapHandle b) {
+   MapHandle edge = store.allocEdge(a, b, LocalFrame::distance(local[a], local[b]), 0);
+   if (edge != MAP_NO_HANDLE) {
+     adjacency.add(edge, a, b);
+   }
+   return edge;
+ }
+ 
+ // Run the simplifier until a whole pass changes nothing
+ static void settle(Mirror& changed) {
+   int quiet = 0;
+   while (quiet < store.getNodeCount()) {
+     quiet = simplifier.step(changed, STEP_NODES) > 0 ? 0 : quiet + STEP_NODES;
+   }
+ }
+ 
+ // Live edges join live nodes, once each, and the index agrees
+ static void assertConsistent() {
+   for (MapHandle e = 0; e < store.getEdgeCount(); e++) {
+     if (store.isFreeEdge(e)) {
+       continue;
+     }
+     MapHandle a = store.getSource(e), b = store.getTarget(e);
+     TEST_ASSERT_FALSE(store.isFree(a));
+     TEST_ASSERT_FALSE(store.isFree(b));
+     TEST_ASSERT_NOT_EQUAL(a, b);
+     TEST_ASSERT_EQUAL(e, adjacency.find(a, b));
+   }
+   int halves = 0;
+   for (MapHandle n = 0; n < store.getNodeCount(); n++) {
+     halves += store.isFree(n) ? 0 : adjacency.degree(n);
+     if (store.isFree(n)) {
+       TEST_ASSERT_EQUAL(0, adjacency.degree(n));
+     }
+   }
+   TEST_ASSERT_EQUAL(2 * store.getLiveEdgeCount(), halves);
+ }
+ 
+ // Test that a thinned walk passes within the tolerance of every point it had
+ void test_chain_within_tolerance() {
+   reset();
+   srand(3);
+   
+   // A straight stretch, then a quarter circle, with GPS jitter, a node every 5 m
+   static float pointLat[64], pointLng[64];
+   int points = 0;
+   MapHandle previous = MAP_NO_HANDLE;
+   for (int i = 0; i < 60; i++) {
+     float along = i * 5.0f, east, north;
+     if (along < 100) {
+       east = along;
+       north = 0;
+     } else {
+       float angle = (along - 100) / 60.0f;
+       east = 100 + 60 * sinf(angle);
+       north = 60 - 60 * cosf(angle);
+     }
+     east += (rand() % 100 - 50) / 50.0f * 0.7f;
+     north += (rand() % 100 - 50) / 50.0f * 0.7f;
+     toGeo(east, north, pointLat[points], pointLng[points]);
+     MapHandle node = addNode(pointLat[points], pointLng[points], NodeType::PATH);
+     if (previous != MAP_NO_HANDLE) {
+       addEdge(previous, node);
+     }
+     previous = node;
+     points++;
+   }
+   float walked = 0;
+   for (MapHandle e = 0; e < store.getEdgeCount(); e++) {
+     walked += store.getWeight(e);
+   }
+   
+   mirror = store;
+   Mirror changed = {0, 0};
+   settle(changed);
+   assertConsistent();
+   
+   // Far fewer nodes, the ends kept, the walked length kept
+   TEST_ASSERT_LESS_THAN(points / 3, store.getLiveNodeCount());
+   TEST_ASSERT_FALSE(store.isFree(0));
+   TEST_ASSERT_FALSE(store.isFree(points - 1));
+   float kept = 0;
+   for (MapHandle e = 0; e < store.getEdgeCount(); e++) {
+     kept += store.isFreeEdge(e) ? 0 : store.getWeight(e);
+   }
+   TEST_ASSERT_FLOAT_WITHIN(0.01f, walked, kept);
+   
+   // Every original point is near the simplified line
+   float worst = 0;
+   for (int p = 0; p < points; p++) {
+     LocalPoint point = frame.toLocal(pointLat[p], pointLng[p]);
+     float nearest = 1e9f;
+     for (MapHandle e = 0; e < store.getEdgeCount(); e++) {
+       if (!store.isFreeEdge(e)) {
+         nearest = fminf(nearest, LocalFrame::segmentDistance(point, local[store.getSource(e)], local[store.getTarget(e)]));
+       }
+     }
+     worst = fmaxf(worst, nearest);
+   }
+   TEST_ASSERT_TRUE(worst <= MAP_SIMPLIFY_TOLERANCE + 0.01f);
+   
+   // Every change reached the listener
+   for (MapHandle n = 0; n < store.getNodeCount(); n++) {
+     TEST_ASSERT_EQUAL(store.getFlags(n), mirror.getFlags(n));
+   }
+   for (MapHandle e = 0; e < store.getEdgeCount(); e++) {
+     TEST_ASSERT_EQUAL(store.getSource(e), mirror.getSource(e));
+     TEST_ASSERT_EQUAL(store.getTarget(e), mirror.getTarget(e));
+     TEST_ASSERT_EQUAL_FLOAT(store.getWeight(e), mirror.getWeight(e));
+   }
+   TEST_ASSERT_EQUAL(store.getLiveNodeCount(), mirror.getLiveNodeCount());
+   
+   char message[96];
+   snprintf(message, sizeof(message), "%d nodes thinned to %d, farthest point %.2f m from the line",
+            points, (int)store.getLiveNodeCount(), worst);
+   TEST_MESSAGE(message);
+ }
+ 
+ // Test that a drifted copy of a walk fuses into it and protected nodes stay
+ void test_duplicates_fused() {
+   reset();
+   
+   // A well-known walk along y = 0 and a drifted copy 6 m north of it,
+   // with corners so neither thins to a single edge
+   MapHandle first[12], second[12];
+   for (int i = 0; i < 12; i++) {
+     float lat, lng;
+     float bend = (i % 4 == 2) ? 4.0f : 0.0f;
+     toGeo(i * 6.0f, bend, lat, lng);
+     first[i] = addNode(lat, lng, NodeType::PATH);
+     store.setVisitCount(first[i], 5);
+     toGeo(i * 6.0f + 1, bend + 6, lat, lng);
+     second[i] = addNode(lat, lng, NodeType::PATH);
+     if (i > 0) {
+       addEdge(first[i - 1], first[i]);
+       addEdge(second[i - 1], second[i]);
+     }
+   }
+   addEdge(first[0], second[0]);
+   
+   // Protected: an obstacle beside the walk, a named node and the user's node
+   float lat, lng;
+   toGeo(30, 3, lat, lng);
+   MapHandle obstacle = addNode(lat, lng, NodeType::OBSTACLE);
+   store.setFlag(second[7], NODE_FLAG_NAMED);
+   simplifier.pin(second[9]);
+   
+   uint32_t fusedBefore = simplifier.getFusedCount();
+   Mirror changed = {0, 0};
+   settle(changed);
+   assertConsistent();
+   
+   TEST_ASSERT_FALSE(store.isFree(obstacle));
+   TEST_ASSERT_FALSE(store.isFree(second[7]));
+   TEST_ASSERT_FALSE(store.isFree(second[9]));
+   
+   // Every other node of the copy fused into the walk, which took its visits
+   int copyLeft = 0;
+   for (int i = 0; i < 12; i++) {
+     copyLeft += store.isFree(second[i]) ? 0 : 1;
+   }
+   TEST_ASSERT_LESS_OR_EQUAL(3, copyLeft);
+   TEST_ASSERT_GREATER_OR_EQUAL(8, (int)(simplifier.getFusedCount() - fusedBefore));
+   int absorbed = 0;
+   for (int i = 0; i < 12; i++) {
+     absorbed += !store.isFree(first[i]) && store.getVisitCount(first[i]) > 5 ? 1 : 0;
+   }
+   TEST_ASSERT_GREATER_THAN(3, absorbed);
+ }
+ 
+ // The mapping rules of MapSystem::updateCurrentPosition
+ struct Walker {
+   MapHandle current;
+   bool snapToEdges;
+   
+   MapHandle nearestNode(const LocalPoint& point) {
+     struct Nearest {
+       LocalPoint point;
+       MapHandle found;
+       int64_t best;
+       
+       bool operator()(int node) {
+         int64_t distance = LocalFrame::distanceSquared(point, local[node]);
+         if (distance <= best) {
+           best = distance;
+           found = node;
+         }
+         return true;
+       }
+     } search = {point, MAP_NO_HANDLE, LocalFrame::radiusSquared(PROXIMITY_M)};
+     float lat, lng;
+     frame.toGeo(point, lat, lng);
+     grid.forEachNear(lat, lng, PROXIMITY_M, search);
+     return search.found;
+   }
+   
+   MapHandle nearestEdge(const LocalPoint& point) {
+     struct Nearest {
+       LocalPoint point;
+       MapHandle found;
+       float best;
+       
+       bool operator()(int node) {
+         for (int32_t h = adjacency.first(node); h != EDGE_NONE; h = adjacency.next(h)) {
+           MapHandle edge = Adjacency::edgeOf(h);
+           float distance = LocalFrame::segmentDistance(point, local[store.getSource(edge)], local[store.getTarget(edge)]);
+           if (distance <= best) {
+             best = distance;
+             found = edge;
+           }
+         }
+         return true;
+       }
+     } search = {point, MAP_NO_HANDLE, PROXIMITY_M};
+     float lat, lng;
+     frame.toGeo(point, lat, lng);
+     grid.forEachNear(lat, lng, PROXIMITY_M + MAP_SIMPLIFY_MAX_EDGE / 2, search);
+     return search.found;
+   }
+   
+   void update(float lat, float lng) {
+     LocalPoint point = frame.toLocal(lat, lng);
+     if (current != MAP_NO_HANDLE && LocalFrame::isWithin(point, local[current], PROXIMITY_M)) {
+       store.visitNode(current, 0);
+       return;
+     }
+     MapHandle next = nearestNode(point);
+     if (next == MAP_NO_HANDLE && snapToEdges) {
+       MapHandle edge = nearestEdge(point);
+       if (edge != MAP_NO_HANDLE) {
+         MapHandle a = store.getSource(edge), b = store.getTarget(edge);
+         if (current == a || current == b) {
+           return;
+         }
+         next = LocalFrame::distanceSquared(point, local[a]) <= LocalFrame::distanceSquared(point, local[b]) ? a : b;
+       }
+     }
+     if (next == MAP_NO_HANDLE) {
+       next = addNode(lat, lng, NodeType::PATH);
+       if (next == MAP_NO_HANDLE) {
+         return;
+       }
+     }
+     if (current != MAP_NO_HANDLE && current != next && adjacency.find(current, next) == EDGE_NONE) {
+       addEdge(current, next);
+     }
+     current = next;
+   }
+ };
+ 
+ // Walk a 400 m block 25 times with drifting GPS, reporting nodes per lap
+ static void walkLaps(bool simplify, int* nodesAfterLap, double* worstStepUs) {
+   reset();
+   srand(5);
+   Walker walker = {MAP_NO_HANDLE, simplify};
+   Mirror changed = {0, 0};
+   *worstStepUs = 0;
+   for (int lap = 0; lap < 25; lap++) {
+     // The fix wanders a few meters from lap to lap and jitters within one
+     float biasEast = (rand() % 100 - 50) / 50.0f * 3, biasNorth = (rand() % 100 - 50) / 50.0f * 3;
+     for (float along = 0; along < 400; along += 1.4f) {
+       float side = fmodf(along, 100), east, north;
+       int leg = (int)(along / 100);
+       east = leg == 0 ? side : (leg == 1 ? 100 : (leg == 2 ? 100 - side : 0));
+       north = leg == 0 ? 0 : (leg == 1 ? side : (leg == 2 ? 100 : 100 - side));
+       float lat, lng;
+       toGeo(east + biasEast + (rand() % 100 - 50) / 50.0f, north + biasNorth + (rand() % 100 - 50) / 50.0f, lat, lng);
+       walker.update(lat, lng);
+       if (simplify) {
+         auto begin = std::chrono::high_resolution_clock::now();
+         simplifier.pin(walker.current);
+         simplifier.step(changed, STEP_NODES);
+         auto end = std::chrono::high_resolution_clock::now();
+         *worstStepUs = fmax(*worstStepUs, std::chrono::duration<double, std::micro>(end - begin).count());
+       }
+     }
+     nodesAfterLap[lap] = store.getLiveNodeCount();
+   }
+   assertConsistent();
+ }
+ 
+ // Test that the map stops growing on a route walked again and again
+ void test_repeated_route_plateau() {
+   int before[25], after[25];
+   double unused, worstStepUs;
+   walkLaps(false, before, &unused);
+   walkLaps(true, after, &worstStepUs);
+   
+   // Without simplification every lap adds nodes beside the old ones
+   TEST_ASSERT_GREATER_THAN(before[4] + 20, before[24]);
+   // With it a drift adds at most a strand, and the map levels off
+   TEST_ASSERT_LESS_OR_EQUAL(after[14] + 3, after[24]);
+   TEST_ASSERT_LESS_THAN(before[24] / 2, after[24]);
+   
+   char message[160];
+   snprintf(message, sizeof(message), "nodes after laps 1/15/25: %d/%d/%d before, %d/%d/%d now; slowest step %.1f us",
+            before[0], before[14], before[24], after[0], after[14], after[24], worstStepUs);
+   TEST_MESSAGE(message);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_chain_within_tolerance);
+   RUN_TEST(test_duplicates_fused);
+   RUN_TEST(test_repeated_route_plateau);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,147 @@
+/*
+ * test_map_store.cpp
+ *
+ * Host unit tests for the map node/edge store and the landmark name table
+ */
+
+ #include <unity.h>
+ #include <stdio.h>
+ #include "../src/main/MapStore.h"
+ #include "../src/main/NameTable.h"
+ 
+ typedef MapStore<4, 3> SmallStore;
+ typedef MapStore<5000, 7500> LargeStore;
+ 
+ // Test that handles are dense and records read back
+ void test_nodes_and_edges() {
+   SmallStore store;
+   MapHandle a = store.addNode(33.5f, -7.5f, NodeType::PATH, 100);
+   MapHandle b = store.addNode(33.6f, -7.6f, NodeType::OBSTACLE, 200);
+   store.setObstacleType(b, ObstacleType::POLE);
+   MapHandle e = store.addEdge(a, b, 12.5f, 300);
+   
+   TEST_ASSERT_EQUAL(0, a);
+   TEST_ASSERT_EQUAL(1, b);
+   TEST_ASSERT_EQUAL(0, e);
+   TEST_ASSERT_EQUAL(2, store.getNodeCount());
+   TEST_ASSERT_EQUAL_FLOAT(-7.6f, store.getLng(b));
+   TEST_ASSERT_FALSE(store.isObstacle(a));
+   TEST_ASSERT_TRUE(store.isObstacle(b));
+   TEST_ASSERT_EQUAL((int)ObstacleType::POLE, (int)store.getObstacleType(b));
+   TEST_ASSERT_EQUAL(b, store.getTarget(e));
+   TEST_ASSERT_EQUAL_FLOAT(12.5f, store.getWeight(e));
+   TEST_ASSERT_TRUE(store.isNode(b));
+   TEST_ASSERT_FALSE(store.isNode(2));
+   TEST_ASSERT_FALSE(store.isNode(MAP_NO_HANDLE));
+   
+   store.visitNode(a, 400);
+   store.traverseEdge(e, 500);
+   TEST_ASSERT_EQUAL(2, store.getVisitCount(a));
+   TEST_ASSERT_EQUAL(400, store.getLastSeen(a));
+   TEST_ASSERT_EQUAL(2, store.getTraverseCount(e));
+   TEST_ASSERT_EQUAL(500, store.getLastTraversed(e));
+ }
+ 
+ // Test that a full store refuses new records and counts saturate
+ void test_capacity_and_saturation() {
+   SmallStore store;
+   for (int i = 0; i < 4; i++) {
+     TEST_ASSERT_EQUAL(i, store.addNode(0, 0, NodeType::PATH, 0));
+   }
+   TEST_ASSERT_EQUAL(MAP_NO_HANDLE, store.addNode(0, 0, NodeType::PATH, 0));
+   
+   store.setVisitCount(0, 65535);
+   store.visitNode(0, 1);
+   TEST_ASSERT_EQUAL(65535, store.getVisitCount(0));
+   
+   store.clear();
+   TEST_ASSERT_EQUAL(0, store.getNodeCount());
+   TEST_ASSERT_EQUAL(0, store.addNode(0, 0, NodeType::PATH, 0));
+ }
+ 
+ // Test that removed records leave free slots that are filled first
+ void test_free_slots() {
+   SmallStore store;
+   for (int i = 0; i < 4; i++) {
+     store.addNode(i, 0, NodeType::PATH, 0);
+   }
+   MapHandle e0 = store.addEdge(0, 1, 1, 0);
+   MapHandle e1 = store.addEdge(1, 2, 1, 0);
+   
+   store.freeNode(2);
+   store.freeNode(1);
+   store.freeEdge(e0);
+   TEST_ASSERT_TRUE(store.isFree(1));
+   TEST_ASSERT_FALSE(store.isFree(3));
+   TEST_ASSERT_TRUE(store.isFreeEdge(e0));
+   TEST_ASSERT_EQUAL(4, store.getNodeCount());
+   TEST_ASSERT_EQUAL(2, store.getLiveNodeCount());
+   TEST_ASSERT_EQUAL(1, store.getLiveEdgeCount());
+   
+   // Lowest free slot first, then a new one once none are left
+   TEST_ASSERT_EQUAL(1, store.allocNode(5, 5, NodeType::DOOR, 9));
+   TEST_ASSERT_FALSE(store.isFree(1));
+   TEST_ASSERT_EQUAL_FLOAT(5, store.getLat(1));
+   TEST_ASSERT_EQUAL((int)NodeType::DOOR, (int)store.getType(1));
+   TEST_ASSERT_EQUAL(1, store.getVisitCount(1));
+   TEST_ASSERT_EQUAL(2, store.allocNode(6, 6, NodeType::PATH, 9));
+   TEST_ASSERT_EQUAL(MAP_NO_HANDLE, store.allocNode(7, 7, NodeType::PATH, 9));
+   TEST_ASSERT_EQUAL(e0, store.allocEdge(3, 0, 2, 9));
+   TEST_ASSERT_EQUAL(3, store.getSource(e0));
+   TEST_ASSERT_EQUAL(2, store.allocEdge(0, 3, 1, 9));
+   
+   // Flags and endpoints written back, as a file load does, keep the counts
+   store.setFlags(3, NODE_FLAG_FREE);
+   store.setEdge(e1, MAP_NO_HANDLE, MAP_NO_HANDLE, 0);
+   TEST_ASSERT_EQUAL(3, store.getLiveNodeCount());
+   TEST_ASSERT_EQUAL(2, store.getLiveEdgeCount());
+   TEST_ASSERT_EQUAL(3, store.allocNode(8, 8, NodeType::PATH, 9));
+ }
+ 
+ // Test that names are interned and follow their node
+ void test_name_table() {
+   NameTable<32, 3> names;
+   TEST_ASSERT_TRUE(names.setName(4, "library"));
+   TEST_ASSERT_TRUE(names.setName(9, "library"));
+   TEST_ASSERT_EQUAL(8, names.getPoolUsed());
+   
+   TEST_ASSERT_EQUAL_STRING("library", names.nameOf(9));
+   TEST_ASSERT_NULL(names.nameOf(5));
+   TEST_ASSERT_EQUAL(4, names.findNode("library"));
+   TEST_ASSERT_EQUAL(-1, names.findNode("cafe"));
+   
+   // Renaming keeps one entry per node
+   TEST_ASSERT_TRUE(names.setName(4, "main gate"));
+   TEST_ASSERT_EQUAL_STRING("main gate", names.nameOf(4));
+   TEST_ASSERT_EQUAL(2, names.getNamedCount());
+   
+   // Pool and entry limits
+   TEST_ASSERT_FALSE(names.setName(6, "a name far too long for the pool"));
+   TEST_ASSERT_TRUE(names.setName(6, "cafe"));
+   TEST_ASSERT_FALSE(names.setName(7, "cafe"));
+ }
+ 
+ // Report the storage cost per node at the PSRAM capacity
+ void test_bytes_per_node() {
+   char message[96];
+   snprintf(message, sizeof(message), "%d nodes + %d edges: %u bytes, %.1f per node",
+            LargeStore::NODE_CAPACITY, LargeStore::EDGE_CAPACITY, (unsigned)sizeof(LargeStore),
+            (double)sizeof(LargeStore) / LargeStore::NODE_CAPACITY);
+   TEST_MESSAGE(message);
+   
+   // 17 bytes per node and 18 per edge, nothing hidden per record;
+   // counts and free slot hints on top
+   TEST_ASSERT_TRUE(sizeof(LargeStore) <= 5000 * 17 + 7500 * 18 + 32);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_nodes_and_edges);
+   RUN_TEST(test_capacity_and_saturation);
+   RUN_TEST(test_free_slots);
+   RUN_TEST(test_name_table);
+   RUN_TEST(test_bytes_per_node);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
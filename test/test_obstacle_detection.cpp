@@ -8,6 +8,8 @@
  #include <unity.h>
  #include "../src/main/ObstacleDetection.h"
  
+ static ObstacleDetection* obstacleDetectorUnderTest;
+ 
  // Mock for Arduino's digitalWrite, digitalRead, etc.
  void digitalWrite(int pin, int value) { /* Mock implementation */ }
  void pinMode(int pin, int mode) { /* Mock implementation */ }
@@ -26,6 +28,40 @@
    return 0;
  }
  
+ // Simulated clock and echo line for the interrupt-driven ranging engine
+ static unsigned long mockMicros = 0;
+ static int mockEchoLevel = LOW;
+ static void (*echoHandlers[16])(void*);
+ static void* echoArgs[16];
+ 
+ unsigned long micros() { return mockMicros; }
+ void delayMicroseconds(unsigned int us) { mockMicros += us; }
+ int digitalRead(int pin) { return mockEchoLevel; }
+ void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+   echoHandlers[pin] = handler;
+   echoArgs[pin] = arg;
+ }
+ 
+ // Raise and drop an echo pin through its interrupt handler
+ void simulateEcho(int echoPin, unsigned long pulseUs) {
+   mockMicros += 460;
+   mockEchoLevel = HIGH;
+   echoHandlers[echoPin](echoArgs[echoPin]);
+   mockMicros += pulseUs;
+   mockEchoLevel = LOW;
+   echoHandlers[echoPin](echoArgs[echoPin]);
+ }
+ 
+ // Run one ping on the lower sensor (pins 10/11) and one on the upper sensor (pins 12/13)
+ void simulateScan(unsigned long lowerPulseUs, unsigned long upperPulseUs) {
+   mockMicros += 30000;
+   obstacleDetectorUnderTest->update();
+   simulateEcho(11, lowerPulseUs);
+   mockMicros += 30000;
+   obstacleDetectorUnderTest->update();
+   simulateEcho(13, upperPulseUs);
+ }
+ 
  // Test initialization
  void test_initialization() {
    ObstacleDetection detector;
@@ -33,23 +69,74 @@
    
    TEST_ASSERT_EQUAL(150, detector.getWarningThreshold());
    TEST_ASSERT_EQUAL(50, detector.getDangerThreshold());
+   
+   // Out-of-range sensors never read past the layout tables
+   TEST_ASSERT_EQUAL(detector.getWarningThreshold(0), detector.getWarningThreshold(-1));
+   TEST_ASSERT_EQUAL(detector.getDangerThreshold(CaneSensors::COUNT - 1), detector.getDangerThreshold(CaneSensors::COUNT));
  }
  
  // Test distance calculation
  void test_distance_measurement() {
    ObstacleDetection detector;
    detector.begin(10, 11, 12, 13);
+   obstacleDetectorUnderTest = &detector;
+   
+   // Nothing measured yet: max range
+   TEST_ASSERT_FLOAT_WITHIN(1, 400, detector.getRawSample(SENSOR_LOWER).distanceCm);
+   
+   simulateScan(2941, 23529);
+   float distance1 = detector.getRawSample(SENSOR_LOWER).distanceCm;
+   float upper1 = detector.getRawSample(SENSOR_UPPER).distanceCm;
    
-   float distance1 = detector.getLowerDistance();
-   float distance2 = detector.getLowerDistance();
-   float distance3 = detector.getLowerDistance();
-   float distance4 = detector.getLowerDistance();
+   // Samples carry the time their echo started, staggered between sensors
+   RangeSample lowerSample = detector.getLatestSample(SENSOR_LOWER);
+   RangeSample upperSample = detector.getLatestSample(SENSOR_UPPER);
+   TEST_ASSERT_TRUE(upperSample.timestampUs > lowerSample.timestampUs);
+   TEST_ASSERT_FALSE(lowerSample.timedOut);
+   simulateScan(5882, 11764);
+   float distance2 = detector.getRawSample(SENSOR_LOWER).distanceCm;
+   float upper2 = detector.getRawSample(SENSOR_UPPER).distanceCm;
+   float upper2Again = detector.getRawSample(SENSOR_UPPER).distanceCm;
+   simulateScan(11764, 5882);
+   float distance3 = detector.getRawSample(SENSOR_LOWER).distanceCm;
+   
+   // No echo at all: the engine times out on its own
+   mockMicros += 30000;
+   detector.update();
+   mockMicros += 30000;
+   detector.update();
+   float distance4 = detector.getRawSample(SENSOR_LOWER).distanceCm;
    
    // Test with 10% tolerance for floating point
    TEST_ASSERT_FLOAT_WITHIN(5, 50, distance1);
    TEST_ASSERT_FLOAT_WITHIN(10, 100, distance2);
    TEST_ASSERT_FLOAT_WITHIN(20, 200, distance3);
    TEST_ASSERT_FLOAT_WITHIN(40, 400, distance4);
+   TEST_ASSERT_FLOAT_WITHIN(40, 400, upper1);
+   TEST_ASSERT_FLOAT_WITHIN(20, 200, upper2);
+   
+   // Reading again without new measurements returns the last value
+   TEST_ASSERT_EQUAL_FLOAT(upper2, upper2Again);
+ }
+ 
+ // Test that a single spurious reading does not reach consumers
+ void test_filtered_distance() {
+   ObstacleDetection detector;
+   detector.begin(10, 11, 12, 13);
+   obstacleDetectorUnderTest = &detector;
+   
+   for (int i = 0; i < 10; i++) {
+     simulateScan(5882, 5882);
+   }
+   TEST_ASSERT_FLOAT_WITHIN(3, 100, detector.getLowerDistance());
+   
+   // Multipath echo on the lower sensor
+   simulateScan(23529, 5882);
+   TEST_ASSERT_FLOAT_WITHIN(200, 400, detector.getRawSample(SENSOR_LOWER).distanceCm);
+   TEST_ASSERT_FLOAT_WITHIN(5, 100, detector.getLowerDistance());
+   
+   simulateScan(5882, 5882);
+   TEST_ASSERT_FLOAT_WITHIN(5, 100, detector.getLowerDistance());
  }
  
  // Test direction suggestion
@@ -83,6 +170,7 @@
    
    RUN_TEST(test_initialization);
    RUN_TEST(test_distance_measurement);
+   RUN_TEST(test_filtered_distance);
    RUN_TEST(test_direction_suggestion);
    
    UNITY_END();
@@ -0,0 +1,63 @@
+/*
+ * test_obstacle_types.cpp
+ *
+ * Host unit tests for the obstacle and node type label tables
+ */
+
+ #include <unity.h>
+ #include <string.h>
+ #include "../src/main/ObstacleTypes.h"
+ 
+ // Labels are usable at compile time
+ static_assert(obstacleTypeLabel(ObstacleType::WALL)[0] == 'w', "Labels are constexpr");
+ static_assert(sizeof(ObstacleType) == 1 && sizeof(NodeType) == 1, "Types stay one byte");
+ 
+ // Test that every label parses back to its type
+ void test_label_round_trip() {
+   for (int i = 0; i < (int)ObstacleType::COUNT; i++) {
+     ObstacleType type = (ObstacleType)i;
+     TEST_ASSERT_EQUAL(i, (int)obstacleTypeFromLabel(obstacleTypeLabel(type)));
+   }
+   for (int i = 0; i < (int)NodeType::COUNT; i++) {
+     NodeType type = (NodeType)i;
+     TEST_ASSERT_EQUAL(i, (int)nodeTypeFromLabel(nodeTypeLabel(type)));
+   }
+ }
+ 
+ // Test the labels written to map files and spoken
+ void test_labels() {
+   TEST_ASSERT_EQUAL_STRING("stairs", obstacleTypeLabel(ObstacleType::STAIRS));
+   TEST_ASSERT_EQUAL_STRING("unknown", obstacleTypeLabel(ObstacleType::UNKNOWN));
+   TEST_ASSERT_EQUAL_STRING("path", nodeTypeLabel(NodeType::PATH));
+   TEST_ASSERT_EQUAL_STRING("unknown", nodeTypeLabel(NodeType::OTHER));
+ }
+ 
+ // Test that fixed structure stays and things that move go
+ void test_lifetimes() {
+   TEST_ASSERT_EQUAL(OBSTACLE_TTL_PERMANENT, obstacleTtl(ObstacleType::WALL));
+   TEST_ASSERT_EQUAL(OBSTACLE_TTL_PERMANENT, obstacleTtl(ObstacleType::STAIRS));
+   for (int i = 0; i < (int)ObstacleType::COUNT; i++) {
+     uint32_t ttl = obstacleTtl((ObstacleType)i);
+     TEST_ASSERT_TRUE(ttl == OBSTACLE_TTL_PERMANENT || ttl >= obstacleTtl(ObstacleType::PERSON));
+   }
+   TEST_ASSERT_EQUAL(obstacleTtl(ObstacleType::UNKNOWN), obstacleTtl(ObstacleType::COUNT));
+ }
+ 
+ // Test that unrecognized labels from older files fall back safely
+ void test_unknown_labels() {
+   TEST_ASSERT_EQUAL((int)ObstacleType::UNKNOWN, (int)obstacleTypeFromLabel("bicycle"));
+   TEST_ASSERT_EQUAL((int)ObstacleType::UNKNOWN, (int)obstacleTypeFromLabel(0));
+   TEST_ASSERT_EQUAL((int)NodeType::OTHER, (int)nodeTypeFromLabel("bench"));
+   TEST_ASSERT_EQUAL((int)NodeType::OTHER, (int)nodeTypeFromLabel(0));
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_label_round_trip);
+   RUN_TEST(test_labels);
+   RUN_TEST(test_lifetimes);
+   RUN_TEST(test_unknown_labels);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,401 @@
+/*
+ * test_osm_importer.cpp
+ *
+ * Host unit tests for the OpenStreetMap reader and importer: XML read in
+ * small pieces, pedestrian ways and node types kept, chains thinned
+ * without changing walked lengths, tiles that fit the device, and import
+ * speed and memory on a generated city extract
+ */
+
+ #include <unity.h>
+ #include <math.h>
+ #include <chrono>
+ #include <stdio.h>
+ #include <string>
+ #include <vector>
+ #include <algorithm>
+ #include <sys/resource.h>
+ #include "../src/main/OsmImporter.h"
+ 
+ #define BASE_LAT 33.5731
+ #define BASE_LNG -7.5898
+ #define CITY_SIDE 120               // Street corners along each side
+ #define CITY_BLOCK_M 60.0
+ #define CITY_STREET_STEP 10         // Street nodes every 6 m, as mapped
+ #define SLOTS 4
+ #define TILE_NODES 128
+ #define TILE_EDGES 256
+ 
+ // XML served a few bytes at a time, to cross every buffer boundary
+ struct TextInput {
+   std::string text;
+   size_t position;
+   size_t chunk;
+   
+   size_t read(uint8_t* data, size_t length) {
+     size_t count = std::min(std::min(length, chunk), text.size() - position);
+     memcpy(data, text.data() + position, count);
+     position += count;
+     return count;
+   }
+ };
+ 
+ // Archive bytes with the seek/read/write shape of an SD File
+ struct MemoryFile {
+   std::vector<uint8_t> bytes;
+   size_t position;
+   
+   MemoryFile() : position(0) {}
+   size_t write(const uint8_t* data, size_t length) {
+     bytes.insert(bytes.end(), data, data + length);
+     return length;
+   }
+   bool seek(uint32_t offset) {
+     position = offset;
+     return offset <= bytes.size();
+   }
+   int read(uint8_t* data, size_t length) {
+     size_t count = std::min(length, bytes.size() - position);
+     memcpy(data, bytes.data() + position, count);
+     position += count;
+     return count;
+   }
+ };
+ 
+ struct StdioFile {
+   FILE* file;
+   
+   size_t read(uint8_t* data, size_t length) { return fread(data, 1, length, file); }
+ };
+ 
+ typedef TileStore<MemoryFile, SLOTS, TILE_NODES, TILE_EDGES> Tiles;
+ 
+ static bool importText(OsmImporter& importer, const std::string& xml, MemoryFile& archive) {
+   TextInput ways = {xml, 0, 4096};
+   TextInput nodes = {xml, 0, 4096};
+   return importer.readWays(ways) && importer.readNodes(nodes) && importer.write(archive);
+ }
+ 
+ // Every node of an archive with its type, and the number of edge records
+ struct Collected {
+   std::vector<TileRef> refs;
+   std::vector<NodeType> types;
+   std::vector<ObstacleType> obstacles;
+   
+   bool operator()(const TileRef& node, float lat, float lng, NodeType type, ObstacleType obstacle) {
+     refs.push_back(node);
+     types.push_back(type);
+     obstacles.push_back(obstacle);
+     return true;
+   }
+ };
+ 
+ struct EdgeSum {
+   uint32_t count;
+   float meters;
+   
+   void operator()(const TileRef& target, float weight) {
+     count++;
+     meters += weight;
+   }
+ };
+ 
+ static void collect(Tiles& tiles, Collected& nodes, EdgeSum& edges) {
+   tiles.forEachNear(BASE_LAT, BASE_LNG, 1500, nodes);
+   edges.count = 0;
+   edges.meters = 0;
+   for (size_t i = 0; i < nodes.refs.size(); i++) {
+     tiles.forEachEdge(nodes.refs[i], edges);
+   }
+ }
+ 
+ static std::string node(long id, double lat, double lng, const char* tags = 0) {
+   char line[256];
+   if (!tags) {
+     snprintf(line, sizeof(line), "  <node id=\"%ld\" version=\"2\" lat=\"%.7f\" lon=\"%.7f\"/>\n", id, lat, lng);
+   } else {
+     snprintf(line, sizeof(line), "  <node id=\"%ld\" lat=\"%.7f\" lon=\"%.7f\">\n    %s\n  </node>\n", id, lat, lng, tags);
+   }
+   return line;
+ }
+ 
+ static std::string way(long id, const std::vector<long>& refs, const char* tags) {
+   std::string text = "  <way id=\"" + std::to_string(id) + "\">\n";
+   for (size_t i = 0; i < refs.size(); i++) {
+     text += "    <nd ref=\"" + std::to_string(refs[i]) + "\"/>\n";
+   }
+   return text + "    " + tags + "\n  </way>\n";
+ }
+ 
+ // Test the reader alone: declarations, comments, quotes, relations and cut values
+ void test_reader() {
+   std::string xml =
+     "<?xml version='1.0' encoding='UTF-8'?>\n<osm version=\"0.6\">\n<!-- a <node> in a comment -->\n"
+     "<bounds minlat=\"33.5\" minlon=\"-7.6\" maxlat=\"33.6\" maxlon=\"-7.5\"/>\n"
+     "<node id='5000000001' lat='33.5731000' lon='-7.5898000'/>\n"
+     "<node id=\"2\" lat=\"-33.9\" lon=\"151.2\"><tag k=\"entrance\" v=\"main\"/></node>\n"
+     "<way id=\"7\"><nd ref=\"5000000001\"/><nd ref=\"2\"/>"
+     "<tag k=\"name\" v=\"" + std::string(200, 'x') + "\"/><tag k=\"highway\" v=\"footway\"/></way>\n"
+     "<relation id=\"9\"><member type=\"way\" ref=\"7\" role=\"\"/><tag k=\"type\" v=\"route\"/></relation>\n"
+     "</osm>\n";
+   TextInput input = {xml, 0, 7};
+   OsmReader<TextInput, 16> reader(input);
+   
+   TEST_ASSERT_TRUE(reader.next() == OsmEvent::NODE);
+   TEST_ASSERT_TRUE(reader.getId() == 5000000001LL);
+   TEST_ASSERT_FLOAT_WITHIN(1e-7, 33.5731, reader.getLat());
+   TEST_ASSERT_FLOAT_WITHIN(1e-7, -7.5898, reader.getLng());
+   TEST_ASSERT_TRUE(reader.next() == OsmEvent::END);
+   
+   TEST_ASSERT_TRUE(reader.next() == OsmEvent::NODE);
+   TEST_ASSERT_TRUE(reader.getId() == 2);
+   TEST_ASSERT_TRUE(reader.next() == OsmEvent::TAG);
+   TEST_ASSERT_EQUAL_STRING("entrance", reader.getKey());
+   TEST_ASSERT_EQUAL_STRING("main", reader.getValue());
+   TEST_ASSERT_TRUE(reader.next() == OsmEvent::END);
+   
+   TEST_ASSERT_TRUE(reader.next() == OsmEvent::WAY);
+   TEST_ASSERT_TRUE(reader.getId() == 7);
+   TEST_ASSERT_TRUE(reader.next() == OsmEvent::ND);
+   TEST_ASSERT_TRUE(reader.getRef() == 5000000001LL);
+   TEST_ASSERT_TRUE(reader.next() == OsmEvent::ND);
+   TEST_ASSERT_TRUE(reader.getRef() == 2);
+   TEST_ASSERT_TRUE(reader.next() == OsmEvent::TAG);
+   TEST_ASSERT_EQUAL(OSM_TEXT_BYTES - 1, strlen(reader.getValue()));
+   TEST_ASSERT_TRUE(reader.next() == OsmEvent::TAG);
+   TEST_ASSERT_EQUAL_STRING("footway", reader.getValue());
+   TEST_ASSERT_TRUE(reader.next() == OsmEvent::END);
+   
+   // The relation's tag is not handed out
+   TEST_ASSERT_TRUE(reader.next() == OsmEvent::DONE);
+   TEST_ASSERT_EQUAL(xml.size(), reader.getBytesRead());
+ }
+ 
+ // Test a hand-made extract: which ways are kept and what their nodes become
+ void test_small_extract() {
+   double step = 5.0 / TILE_METERS_PER_DEG;
+   std::string xml = "<osm version=\"0.6\">\n";
+   for (long i = 0; i < 12; i++) {
+     xml += node(100 + i, BASE_LAT, BASE_LNG + i * step * 1.2);
+   }
+   xml += node(200, BASE_LAT + step, BASE_LNG, "<tag k=\"highway\" v=\"crossing\"/>");
+   xml += node(201, BASE_LAT + 2 * step, BASE_LNG, "<tag k=\"entrance\" v=\"yes\"/>");
+   xml += node(202, BASE_LAT + 3 * step, BASE_LNG);
+   xml += node(204, BASE_LAT + 2 * step, BASE_LNG + step, "<tag k=\"door\" v=\"hinged\"/>");
+   xml += node(203, BASE_LAT + 4 * step, BASE_LNG);
+   xml += node(300, BASE_LAT - step, BASE_LNG);
+   xml += node(301, BASE_LAT - 2 * step, BASE_LNG);
+   xml += node(400, BASE_LAT - 3 * step, BASE_LNG, "<tag k=\"amenity\" v=\"bench\"/>");
+   xml += way(1, {100, 101, 102, 103}, "<tag k=\"highway\" v=\"footway\"/>");
+   xml += way(2, {100, 200, 201, 204}, "<tag k=\"highway\" v=\"residential\"/>");
+   xml += way(3, {201, 202, 203}, "<tag k=\"highway\" v=\"steps\"/>");
+   xml += way(4, {100, 300, 301}, "<tag k=\"highway\" v=\"motorway\"/>");
+   xml += way(5, {103, 104, 105}, "<tag k=\"highway\" v=\"path\"/><tag k=\"foot\" v=\"no\"/>");
+   xml += way(6, {103, 106, 999}, "<tag k=\"highway\" v=\"service\"/><tag k=\"access\" v=\"private\"/>"
+                                  "<tag k=\"foot\" v=\"yes\"/>");
+   xml += way(7, {107, 108, 109}, "<tag k=\"building\" v=\"yes\"/>");
+   xml += "</osm>\n";
+   
+   OsmImporter importer(TILE_NODES, TILE_EDGES);
+   MemoryFile archive;
+   TEST_ASSERT_TRUE(importText(importer, xml, archive));
+   const OsmImportStats& stats = importer.getStats();
+   TEST_ASSERT_EQUAL(7, stats.osmWays);
+   TEST_ASSERT_EQUAL(4, stats.keptWays);
+   TEST_ASSERT_EQUAL(1, stats.missingNodes);
+   
+   Tiles tiles;
+   TEST_ASSERT_TRUE(tiles.attach(archive));
+   Collected nodes;
+   EdgeSum edges;
+   collect(tiles, nodes, edges);
+   
+   // Footway 100-103 thinned to its ends, the road to the doors, the stairs
+   // and the service road, whose last node is missing
+   int doors = 0, stairs = 0, streets = 0, paths = 0;
+   for (size_t i = 0; i < nodes.types.size(); i++) {
+     doors += nodes.types[i] == NodeType::DOOR;
+     stairs += nodes.types[i] == NodeType::OBSTACLE && nodes.obstacles[i] == ObstacleType::STAIRS;
+     streets += nodes.types[i] == NodeType::STREET;
+     paths += nodes.types[i] == NodeType::PATH;
+   }
+   TEST_ASSERT_EQUAL(1, doors);         // The entrance at the foot of the stairs is a stair
+   TEST_ASSERT_EQUAL(3, stairs);
+   TEST_ASSERT_EQUAL(2, streets);       // The crossing and the end of the service road
+   TEST_ASSERT_EQUAL(2, paths);
+   TEST_ASSERT_EQUAL(8, stats.nodes);
+   TEST_ASSERT_EQUAL(7, stats.edges);
+   TEST_ASSERT_EQUAL(2, stats.thinnedNodes);
+   TEST_ASSERT_EQUAL(stats.nodes, nodes.refs.size());
+   TEST_ASSERT_EQUAL(2 * stats.edges, edges.count);
+ }
+ 
+ // Test a long straight footway: thinned within the simplifier's limits, lengths kept
+ void test_thinning_and_tiles() {
+   double step = 2.0 / TILE_METERS_PER_DEG;
+   std::string xml = "<osm>\n";
+   std::vector<long> refs;
+   for (long i = 0; i < 500; i++) {
+     xml += node(i + 1, BASE_LAT + i * step, BASE_LNG + ((i / 7) % 2) * 0.5 * step);
+     refs.push_back(i + 1);
+   }
+   xml += way(1, refs, "<tag k=\"highway\" v=\"footway\"/>");
+   xml += "</osm>\n";
+   
+   // Tiles this small force the tile size down
+   OsmImporter importer(8, 16);
+   MemoryFile archive;
+   TEST_ASSERT_TRUE(importText(importer, xml, archive));
+   const OsmImportStats& stats = importer.getStats();
+   TEST_ASSERT_EQUAL(0, stats.oversizedTiles);
+   TEST_ASSERT_TRUE(stats.fullestTileNodes <= 8 && stats.fullestTileEdges <= 16);
+   TEST_ASSERT_TRUE(stats.tileDegE7 < OSM_TILE_DEG_E7_MAX);
+   TEST_ASSERT_TRUE(stats.nodes < 500 / 5);
+   TEST_ASSERT_EQUAL(500, stats.nodes + stats.thinnedNodes);
+   
+   Tiles tiles;
+   TEST_ASSERT_TRUE(tiles.attach(archive));
+   Collected nodes;
+   EdgeSum edges;
+   collect(tiles, nodes, edges);
+   TEST_ASSERT_EQUAL(stats.nodes, nodes.refs.size());
+   TEST_ASSERT_EQUAL(2 * (stats.nodes - 1), edges.count);
+   
+   // Each edge counted from both ends; the walk along the wiggles is kept
+   double walked = 0;
+   for (long i = 1; i < 500; i++) {
+     double dLng = (((i / 7) % 2) - (((i - 1) / 7) % 2)) * 0.5 * step * cos(BASE_LAT * M_PI / 180);
+     walked += TILE_METERS_PER_DEG * sqrt(step * step + dLng * dLng);
+   }
+   TEST_ASSERT_FLOAT_WITHIN(walked * 1e-3, walked, edges.meters / 2);
+ }
+ 
+ // Generated city: a street grid mapped every 6 m, footpaths through every
+ // fifth block, one building outline per block and shop nodes, none of
+ // which the importer should keep but all of which it has to read past
+ static long writeCity(FILE* file) {
+   double degLat = CITY_BLOCK_M / CITY_STREET_STEP / TILE_METERS_PER_DEG;
+   double degLng = degLat / cos(BASE_LAT * M_PI / 180);
+   int side = (CITY_SIDE - 1) * CITY_STREET_STEP + 1;
+   long nodes = 0;
+   fprintf(file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<osm version=\"0.6\" generator=\"test\">\n");
+   
+   // Street nodes on the lines of the grid, then building corners and shops
+   for (int y = 0; y < side; y++) {
+     for (int x = 0; x < side; x++) {
+       if (x % CITY_STREET_STEP == 0 || y % CITY_STREET_STEP == 0) {
+         bool crossing = x % CITY_STREET_STEP == 1 && y % CITY_STREET_STEP == 0;
+         fprintf(file, "  <node id=\"%ld\" version=\"3\" timestamp=\"2024-05-01T10:00:00Z\" changeset=\"1\" "
+                 "lat=\"%.7f\" lon=\"%.7f\"%s\n", 1000000000L + y * side + x, BASE_LAT + y * degLat,
+                 BASE_LNG + x * degLng, crossing ? "><tag k=\"highway\" v=\"crossing\"/></node>" : "/>");
+         nodes++;
+       }
+     }
+   }
+   long extra = 2000000000L;
+   for (int by = 0; by + 1 < CITY_SIDE; by++) {
+     for (int bx = 0; bx + 1 < CITY_SIDE; bx++) {
+       for (int corner = 0; corner < 8; corner++) {
+         double angle = corner * M_PI / 4;
+         fprintf(file, "  <node id=\"%ld\" version=\"1\" timestamp=\"2024-05-01T10:00:00Z\" changeset=\"1\" "
+                 "lat=\"%.7f\" lon=\"%.7f\"/>\n", extra++,
+                 BASE_LAT + (by + 0.5 + 0.3 * sin(angle)) * CITY_STREET_STEP * degLat,
+                 BASE_LNG + (bx + 0.5 + 0.3 * cos(angle)) * CITY_STREET_STEP * degLng);
+       }
+       fprintf(file, "  <node id=\"%ld\" lat=\"%.7f\" lon=\"%.7f\">\n    <tag k=\"shop\" v=\"bakery\"/>\n"
+               "    <tag k=\"name\" v=\"Boulangerie %d\"/>\n  </node>\n", extra++,
+               BASE_LAT + (by + 0.1) * CITY_STREET_STEP * degLat, BASE_LNG + (bx + 0.1) * CITY_STREET_STEP * degLng, bx);
+       nodes += 9;
+     }
+   }
+   
+   // One way per street between corners, then the outlines
+   long wayId = 1;
+   for (int line = 0; line < CITY_SIDE; line++) {
+     for (int along = 0; along + 1 < CITY_SIDE; along++) {
+       for (int vertical = 0; vertical < 2; vertical++) {
+         fprintf(file, "  <way id=\"%ld\" version=\"1\">\n", wayId++);
+         for (int i = 0; i <= CITY_STREET_STEP; i++) {
+           int a = along * CITY_STREET_STEP + i, b = line * CITY_STREET_STEP;
+           fprintf(file, "    <nd ref=\"%ld\"/>\n", 1000000000L + (vertical ? a * side + b : b * side + a));
+         }
+         fprintf(file, "    <tag k=\"highway\" v=\"%s\"/>\n    <tag k=\"name\" v=\"Rue %d\"/>\n  </way>\n",
+                 line % 5 == 0 ? "footway" : (line % 7 == 0 ? "motorway" : "residential"), line);
+       }
+     }
+   }
+   extra = 2000000000L;
+   for (int block = 0; block < (CITY_SIDE - 1) * (CITY_SIDE - 1); block++) {
+     fprintf(file, "  <way id=\"%ld\">\n", wayId++);
+     for (int corner = 0; corner <= 8; corner++) {
+       fprintf(file, "    <nd ref=\"%ld\"/>\n", extra + corner % 8);
+     }
+     fprintf(file, "    <tag k=\"building\" v=\"yes\"/>\n  </way>\n");
+     extra += 9;
+   }
+   fprintf(file, "</osm>\n");
+   return nodes;
+ }
+ 
+ void test_benchmark_city() {
+   FILE* file = tmpfile();
+   TEST_ASSERT_TRUE(file != 0);
+   long written = writeCity(file);
+   long fileBytes = ftell(file);
+   
+   struct rusage before;
+   getrusage(RUSAGE_SELF, &before);
+   OsmImporter importer(TILE_NODES, TILE_EDGES);
+   MemoryFile archive;
+   StdioFile in = {file};
+   auto t0 = std::chrono::steady_clock::now();
+   rewind(file);
+   TEST_ASSERT_TRUE(importer.readWays(in));
+   auto t1 = std::chrono::steady_clock::now();
+   rewind(file);
+   TEST_ASSERT_TRUE(importer.readNodes(in));
+   size_t graphBytes = importer.getMemoryBytes();
+   auto t2 = std::chrono::steady_clock::now();
+   TEST_ASSERT_TRUE(importer.write(archive));
+   auto t3 = std::chrono::steady_clock::now();
+   struct rusage after;
+   getrusage(RUSAGE_SELF, &after);
+   fclose(file);
+   
+   const OsmImportStats& stats = importer.getStats();
+   TEST_ASSERT_EQUAL(written, stats.osmNodes);
+   TEST_ASSERT_EQUAL(0, stats.missingNodes);
+   TEST_ASSERT_EQUAL(0, stats.oversizedTiles);
+   TEST_ASSERT_EQUAL(0, stats.droppedEdges);
+   TEST_ASSERT_TRUE(graphBytes < (size_t)fileBytes / 4);
+   
+   // Every street corner outside the motorways made it into the archive
+   Tiles tiles;
+   TEST_ASSERT_TRUE(tiles.attach(archive));
+   TEST_ASSERT_EQUAL(0, tiles.getTruncatedTiles());
+   
+   double seconds = std::chrono::duration<double>(t3 - t0).count();
+   char message[200];
+   snprintf(message, sizeof(message), "%.1f MB extract, %ld nodes, %u ways: ways %.2f s, nodes %.2f s, tiles %.2f s",
+            fileBytes / 1e6, written, stats.osmWays, std::chrono::duration<double>(t1 - t0).count(),
+            std::chrono::duration<double>(t2 - t1).count(), std::chrono::duration<double>(t3 - t2).count());
+   TEST_MESSAGE(message);
+   snprintf(message, sizeof(message), "%.0f nodes/s, %.0f MB/s read; kept %u nodes (%u thinned), %u edges, %u tiles of %.4f deg",
+            written / seconds, stats.bytesRead / 1e6 / seconds, stats.nodes, stats.thinnedNodes, stats.edges,
+            stats.tiles, stats.tileDegE7 / MAPFILE_COORD_SCALE);
+   TEST_MESSAGE(message);
+   snprintf(message, sizeof(message), "Graph %.1f MB, peak resident growth %.1f MB, archive %.1f MB",
+            graphBytes / 1e6, (after.ru_maxrss - before.ru_maxrss) / 1024.0, archive.bytes.size() / 1e6);
+   TEST_MESSAGE(message);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_reader);
+   RUN_TEST(test_small_extract);
+   RUN_TEST(test_thinning_and_tiles);
+   RUN_TEST(test_benchmark_city);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,27 @@
+/*
+ * test_random.h
+ *
+ * Seeded linear congruential generator shared by the host tests, so
+ * synthetic inputs are the same on every host and every run
+ */
+
+ #ifndef TEST_RANDOM_H
+ #define TEST_RANDOM_H
+ 
+ #include <stdint.h>
+ 
+ // Reset to a fixed seed where a test needs its own sequence
+ static uint32_t noiseState = 1;
+ 
+ // 24 random bits
+ static inline uint32_t nextRandom() {
+   noiseState = noiseState * 1664525 + 1013904223;
+   return noiseState >> 8;
+ }
+ 
+ // Uniform in [0, 1)
+ static inline float nextUniform() {
+   return nextRandom() / 16777216.0f;
+ }
+ 
+ #endif
\ No newline at end of file
@@ -0,0 +1,204 @@
+/*
+ * test_route_planner.cpp
+ *
+ * Host unit tests for the A* route planner and a planning benchmark
+ * on a 10k-node synthetic map
+ */
+
+ #include <unity.h>
+ #include <math.h>
+ #include <chrono>
+ #include <stdio.h>
+ #include "../src/main/RoutePlanner.h"
+ 
+ #define BASE_LAT 33.5731f
+ #define BASE_LNG -7.5898f
+ #define GRID_SIDE 100               // 100 x 100 nodes
+ #define GRID_NODES (GRID_SIDE * GRID_SIDE)
+ #define GRID_SPACING_M 5.0f
+ #define MAX_TEST_NODES GRID_NODES
+ #define MAX_TEST_EDGES (3 * GRID_NODES)
+ #define BENCH_PLANS 50
+ 
+ #include "test_lattice.h"
+ 
+ static float haversine(float lat1, float lng1, float lat2, float lng2) {
+   float dLat = (lat2 - lat1) * M_PI / 180;
+   float dLng = (lng2 - lng1) * M_PI / 180;
+   float a = sin(dLat / 2) * sin(dLat / 2) +
+             cos(lat1 * M_PI / 180) * cos(lat2 * M_PI / 180) * sin(dLng / 2) * sin(dLng / 2);
+   return 6371000.0 * 2 * atan2(sqrt(a), sqrt(1 - a));
+ }
+ 
+ // Synthetic walked map: the shared lattice with a few missing and diagonal
+ // edges, placed on the globe and weighted by great-circle distance
+ static float nodeLat[GRID_NODES];
+ static float nodeLng[GRID_NODES];
+ 
+ static void buildMap() {
+   buildLattice(GRID_SIDE, GRID_SPACING_M, 10, 25);
+   double degLat = 1 / 111195.0;
+   double degLng = degLat / cos(BASE_LAT * M_PI / 180);
+   for (int n = 0; n < nodeCount; n++) {
+     nodeLat[n] = BASE_LAT + nodeY[n] * degLat;
+     nodeLng[n] = BASE_LNG + nodeX[n] * degLng;
+   }
+   for (int e = 0; e < edgeCount; e++) {
+     edgeWeight[e] = haversine(nodeLat[edgeSource[e]], nodeLng[edgeSource[e]],
+                               nodeLat[edgeTarget[e]], nodeLng[edgeTarget[e]]);
+   }
+ }
+ 
+ struct EdgeList {
+   bool operator()(int i, int32_t& source, int32_t& target, float& weight) {
+     source = edgeSource[i];
+     target = edgeTarget[i];
+     weight = edgeWeight[i];
+     return weight >= 0;
+   }
+ };
+ 
+ struct GreatCircle {
+   int32_t goal;
+   float operator()(int32_t n) { return haversine(nodeLat[n], nodeLng[n], nodeLat[goal], nodeLng[goal]); }
+ };
+ 
+ struct NoHeuristic {
+   float operator()(int32_t n) { return 0; }
+ };
+ 
+ typedef RoutePlanner<GRID_NODES, MAX_TEST_EDGES> Planner;
+ static Planner planner;
+ 
+ // Test a small hand-made graph, including the detour and decrease-key
+ void test_small_graph() {
+   // 0 -1- 1 -1- 2
+   //  \----5----/ \-1- 3     4 (isolated)
+   static float smallWeight[] = {1, 1, 5, 1};
+   static int32_t smallSource[] = {0, 1, 0, 2};
+   static int32_t smallTarget[] = {1, 2, 2, 3};
+   struct Small {
+     bool operator()(int i, int32_t& s, int32_t& t, float& w) {
+       s = smallSource[i];
+       t = smallTarget[i];
+       w = smallWeight[i];
+       return true;
+     }
+   } small;
+   static RoutePlanner<5, 4> tiny;
+   tiny.build(5, 4, small);
+   NoHeuristic none;
+   
+   TEST_ASSERT_EQUAL(3, tiny.getDegree(2));
+   TEST_ASSERT_TRUE(tiny.findPath(0, 3, none));
+   TEST_ASSERT_EQUAL(4, tiny.getPathLength());
+   const int32_t expected[] = {0, 1, 2, 3};
+   for (int i = 0; i < 4; i++) {
+     TEST_ASSERT_EQUAL(expected[i], tiny.getPath()[i]);
+   }
+   TEST_ASSERT_EQUAL_FLOAT(3, tiny.getPathCost());
+   
+   // Walkable in both directions
+   TEST_ASSERT_TRUE(tiny.findPath(3, 0, none));
+   TEST_ASSERT_EQUAL(3, tiny.getPath()[0]);
+   
+   // Unreachable and out of range
+   TEST_ASSERT_FALSE(tiny.findPath(0, 4, none));
+   TEST_ASSERT_EQUAL(0, tiny.getPathLength());
+   TEST_ASSERT_FALSE(tiny.findPath(0, 7, none));
+   
+   // Start is the goal
+   TEST_ASSERT_TRUE(tiny.findPath(2, 2, none));
+   TEST_ASSERT_EQUAL(1, tiny.getPathLength());
+ }
+ 
+ // Test that A* finds routes as short as a plain Dijkstra search
+ void test_matches_dijkstra() {
+   buildMap();
+   EdgeList edges;
+   planner.build(GRID_NODES, edgeCount, edges);
+   NoHeuristic none;
+   
+   for (int q = 0; q < 20; q++) {
+     int32_t start = nextRandom() % GRID_NODES;
+     GreatCircle toGoal = {(int32_t)(nextRandom() % GRID_NODES)};
+     
+     bool found = planner.findPath(start, toGoal.goal, none);
+     float shortest = planner.getPathCost();
+     uint32_t dijkstraExpanded = planner.getExpandedCount();
+     
+     TEST_ASSERT_EQUAL(found, planner.findPath(start, toGoal.goal, toGoal));
+     if (!found) {
+       continue;
+     }
+     TEST_ASSERT_FLOAT_WITHIN(shortest * 1e-4, shortest, planner.getPathCost());
+     TEST_ASSERT_TRUE(planner.getExpandedCount() <= dijkstraExpanded);
+     
+     // Consecutive route nodes are joined by edges
+     const int32_t* path = planner.getPath();
+     TEST_ASSERT_EQUAL(start, path[0]);
+     TEST_ASSERT_EQUAL(toGoal.goal, path[planner.getPathLength() - 1]);
+     for (int i = 1; i < planner.getPathLength(); i++) {
+       TEST_ASSERT_TRUE(haversine(nodeLat[path[i - 1]], nodeLng[path[i - 1]],
+                                  nodeLat[path[i]], nodeLng[path[i]]) < 2 * GRID_SPACING_M);
+     }
+   }
+ }
+ 
+ // Planning time corner to corner and between random nodes
+ void test_benchmark_10k_nodes() {
+   buildMap();
+   EdgeList edges;
+   
+   auto buildStart = std::chrono::steady_clock::now();
+   planner.build(GRID_NODES, edgeCount, edges);
+   auto buildEnd = std::chrono::steady_clock::now();
+   
+   double aStarMs = 0, dijkstraMs = 0;
+   uint64_t aStarExpanded = 0, dijkstraExpanded = 0;
+   int plans = 0;
+   NoHeuristic none;
+   
+   for (int q = 0; q < BENCH_PLANS; q++) {
+     int32_t start = q == 0 ? 0 : nextRandom() % GRID_NODES;
+     GreatCircle toGoal = {q == 0 ? GRID_NODES - 1 : (int32_t)(nextRandom() % GRID_NODES)};
+     
+     auto t0 = std::chrono::steady_clock::now();
+     bool found = planner.findPath(start, toGoal.goal, toGoal);
+     auto t1 = std::chrono::steady_clock::now();
+     aStarExpanded += planner.getExpandedCount();
+     planner.findPath(start, toGoal.goal, none);
+     auto t2 = std::chrono::steady_clock::now();
+     dijkstraExpanded += planner.getExpandedCount();
+     
+     if (found) {
+       aStarMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+       dijkstraMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+       plans++;
+     }
+   }
+   TEST_ASSERT_TRUE(plans > BENCH_PLANS / 2);
+   
+   char message[128];
+   snprintf(message, sizeof(message), "%d nodes, %d edges: CSR build %.2f ms",
+            GRID_NODES, edgeCount, std::chrono::duration<double, std::milli>(buildEnd - buildStart).count());
+   TEST_MESSAGE(message);
+   snprintf(message, sizeof(message), "A*       %.3f ms/plan, %6.0f nodes expanded",
+            aStarMs / plans, (double)aStarExpanded / BENCH_PLANS);
+   TEST_MESSAGE(message);
+   snprintf(message, sizeof(message), "Dijkstra %.3f ms/plan, %6.0f nodes expanded",
+            dijkstraMs / plans, (double)dijkstraExpanded / BENCH_PLANS);
+   TEST_MESSAGE(message);
+   
+   TEST_ASSERT_LESS_THAN(dijkstraExpanded, aStarExpanded);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_small_graph);
+   RUN_TEST(test_matches_dijkstra);
+   RUN_TEST(test_benchmark_10k_nodes);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,273 @@
+/*
+ * test_route_replanner.cpp
+ *
+ * Host unit tests for the D* Lite replanner: repaired routes are as
+ * short as a fresh search, and rerouting around an obstacle on the way
+ * costs a fraction of planning again, on synthetic walked maps
+ */
+
+ #include <unity.h>
+ #include <math.h>
+ #include <chrono>
+ #include <stdio.h>
+ #include "../src/main/RoutePlanner.h"
+ #include "../src/main/RouteReplanner.h"
+ 
+ #define GRID_SIDE 100               // 100 x 100 nodes
+ #define GRID_NODES (GRID_SIDE * GRID_SIDE)
+ #define GRID_SPACING_M 5.0f
+ #define MAX_TEST_NODES GRID_NODES
+ #define MAX_TEST_EDGES (3 * GRID_NODES)
+ #define BENCH_ROUTES 50
+ 
+ #include "test_lattice.h"
+ 
+ // Synthetic walked map: the shared lattice with a few missing and diagonal
+ // edges, and every edge cost currently in effect
+ static float edgeCost[MAX_TEST_EDGES];
+ 
+ static void buildMap() {
+   buildLattice(GRID_SIDE, GRID_SPACING_M, 10, 25);
+   for (int e = 0; e < edgeCount; e++) {
+     edgeCost[e] = edgeWeight[e];
+   }
+ }
+ 
+ // The replanner walks the adjacency at the current costs, a fresh search
+ // packs the open edges
+ struct CostGraph {
+   int32_t first(int32_t node) { return adjacency.first(node); }
+   int32_t next(int32_t half) { return adjacency.next(half); }
+   int32_t neighbourOf(int32_t half) { return adjacency.neighbourOf(half); }
+   float weight(int32_t half) { return edgeCost[adjacency.edgeOf(half)]; }
+ };
+ 
+ struct OpenEdges {
+   bool operator()(int i, int32_t& source, int32_t& target, float& weight) {
+     source = edgeSource[i];
+     target = edgeTarget[i];
+     weight = edgeCost[i];
+     return edgeCost[i] != ROUTE_BLOCKED;
+   }
+ };
+ 
+ struct StraightLine {
+   float operator()(int32_t a, int32_t b) { return distance(a, b); }
+ };
+ 
+ struct ToGoal {
+   int32_t goal;
+   float operator()(int32_t n) { return distance(n, goal); }
+ };
+ 
+ static RouteReplanner<GRID_NODES> replanner;
+ static RoutePlanner<GRID_NODES, MAX_TEST_EDGES> fresh;
+ static CostGraph graph;
+ static StraightLine straight;
+ 
+ static void setEdgeCost(int e, float cost) {
+   edgeCost[e] = cost;
+   replanner.updateEdge(edgeSource[e], edgeTarget[e], graph, straight);
+ }
+ 
+ // Edge on the route between path[i] and path[i + 1]
+ static int32_t routeEdge(const int32_t* path, int i) {
+   for (int e = 0; e < edgeCount; e++) {
+     if ((edgeSource[e] == path[i] && edgeTarget[e] == path[i + 1]) ||
+         (edgeSource[e] == path[i + 1] && edgeTarget[e] == path[i])) {
+       return e;
+     }
+   }
+   return -1;
+ }
+ 
+ // Test a small hand-made graph: detour, reopening, cut off, a moved start
+ // and a new edge
+ void test_small_graph() {
+   // 0 -1- 1 -1- 2 -1- 3     4 (isolated)
+   //  \----5----/
+   static float smallCost[] = {1, 1, 5, 1};
+   static int32_t smallSource[] = {0, 1, 0, 2};
+   static int32_t smallTarget[] = {1, 2, 2, 3};
+   static EdgeIndex<5, 4> smallEdges;
+   struct Small {
+     int32_t first(int32_t node) { return smallEdges.first(node); }
+     int32_t next(int32_t half) { return smallEdges.next(half); }
+     int32_t neighbourOf(int32_t half) { return smallEdges.neighbourOf(half); }
+     float weight(int32_t half) { return smallCost[smallEdges.edgeOf(half)]; }
+   } small;
+   struct None {
+     float operator()(int32_t a, int32_t b) { return 0; }
+   } none;
+   static RouteReplanner<5> tiny;
+   smallEdges.clear();
+   for (int e = 0; e < 4; e++) {
+     smallEdges.add(e, smallSource[e], smallTarget[e]);
+   }
+   
+   TEST_ASSERT_TRUE(tiny.plan(0, 3, small, none));
+   TEST_ASSERT_EQUAL(4, tiny.getPathLength());
+   TEST_ASSERT_EQUAL_FLOAT(3, tiny.getPathCost());
+   
+   // Obstacle on 1-2: around by the long edge
+   smallCost[1] = ROUTE_BLOCKED;
+   tiny.updateEdge(1, 2, small, none);
+   TEST_ASSERT_TRUE(tiny.replan(small, none));
+   TEST_ASSERT_EQUAL(3, tiny.getPathLength());
+   TEST_ASSERT_EQUAL(2, tiny.getPath()[1]);
+   TEST_ASSERT_EQUAL_FLOAT(6, tiny.getPathCost());
+   
+   // Gone again
+   smallCost[1] = 1;
+   tiny.updateEdge(1, 2, small, none);
+   TEST_ASSERT_TRUE(tiny.replan(small, none));
+   TEST_ASSERT_EQUAL_FLOAT(3, tiny.getPathCost());
+   
+   // Walked on to 1, then both ways to 2 closed: no route
+   tiny.setStart(1, none);
+   TEST_ASSERT_TRUE(tiny.replan(small, none));
+   TEST_ASSERT_EQUAL(1, tiny.getPath()[0]);
+   TEST_ASSERT_EQUAL_FLOAT(2, tiny.getPathCost());
+   smallCost[1] = ROUTE_BLOCKED;
+   tiny.updateEdge(1, 2, small, none);
+   smallCost[2] = ROUTE_BLOCKED;
+   tiny.updateEdge(0, 2, small, none);
+   TEST_ASSERT_FALSE(tiny.replan(small, none));
+   TEST_ASSERT_EQUAL(0, tiny.getPathLength());
+   
+   // A new edge 1-3 opens a way again
+   smallEdges.remove(3, 2, 3);
+   smallSource[3] = 1;
+   smallCost[3] = 4;
+   smallEdges.add(3, 1, 3);
+   tiny.updateEdge(1, 3, small, none);
+   tiny.updateEdge(2, 3, small, none);
+   TEST_ASSERT_TRUE(tiny.replan(small, none));
+   TEST_ASSERT_EQUAL(2, tiny.getPathLength());
+   TEST_ASSERT_EQUAL_FLOAT(4, tiny.getPathCost());
+   
+   // Unreachable and out of range
+   TEST_ASSERT_FALSE(tiny.plan(0, 4, small, none));
+   TEST_ASSERT_FALSE(tiny.plan(0, 7, small, none));
+   TEST_ASSERT_TRUE(tiny.plan(3, 3, small, none));
+   TEST_ASSERT_EQUAL(1, tiny.getPathLength());
+ }
+ 
+ // Test that routes repaired along a walk match a fresh search every time
+ void test_matches_fresh_search() {
+   buildMap();
+   OpenEdges open;
+   
+   for (int route = 0; route < 10; route++) {
+     for (int e = 0; e < edgeCount; e++) {
+       edgeCost[e] = edgeWeight[e];
+     }
+     int32_t start = nextRandom() % GRID_NODES;
+     ToGoal toGoal = {(int32_t)(nextRandom() % GRID_NODES)};
+     if (!replanner.plan(start, toGoal.goal, graph, straight)) {
+       continue;
+     }
+     
+     // Walk a few nodes, then something blocks the way ahead and a
+     // few obstacles elsewhere come and go
+     while (replanner.getPathLength() > 3) {
+       int32_t here = replanner.getPath()[2];
+       int32_t ahead = routeEdge(replanner.getPath(), 2);
+       replanner.setStart(here, straight);
+       setEdgeCost(ahead, ROUTE_BLOCKED);
+       for (int k = 0; k < 3; k++) {
+         int e = nextRandom() % edgeCount;
+         setEdgeCost(e, nextRandom() % 2 ? ROUTE_BLOCKED : edgeWeight[e]);
+       }
+       bool repaired = replanner.replan(graph, straight);
+       
+       fresh.build(GRID_NODES, edgeCount, open);
+       ToGoal again = toGoal;
+       TEST_ASSERT_EQUAL(fresh.findPath(here, toGoal.goal, again), repaired);
+       if (!repaired) {
+         break;
+       }
+       float shortest = fresh.getPathCost();
+       TEST_ASSERT_FLOAT_WITHIN(shortest * 1e-4f + 1e-3f, shortest, replanner.getPathCost());
+       
+       // The route only uses open edges, from here to the goal
+       const int32_t* path = replanner.getPath();
+       TEST_ASSERT_EQUAL(here, path[0]);
+       TEST_ASSERT_EQUAL(toGoal.goal, path[replanner.getPathLength() - 1]);
+       for (int i = 0; i + 1 < replanner.getPathLength(); i++) {
+         TEST_ASSERT_TRUE(edgeCost[routeEdge(path, i)] != ROUTE_BLOCKED);
+       }
+     }
+   }
+ }
+ 
+ // Rerouting around an obstacle just ahead, against planning from scratch
+ void test_benchmark_reroute() {
+   buildMap();
+   OpenEdges open;
+   
+   double repairUs = 0, freshUs = 0, rebuildUs = 0;
+   uint64_t repairExpanded = 0, freshExpanded = 0, initialExpanded = 0;
+   int reroutes = 0;
+   for (int route = 0; route < BENCH_ROUTES; route++) {
+     for (int e = 0; e < edgeCount; e++) {
+       edgeCost[e] = edgeWeight[e];
+     }
+     int32_t start = nextRandom() % GRID_NODES;
+     ToGoal toGoal = {(int32_t)(nextRandom() % GRID_NODES)};
+     if (!replanner.plan(start, toGoal.goal, graph, straight) || replanner.getPathLength() < 20) {
+       continue;
+     }
+     initialExpanded += replanner.getExpandedCount();
+     
+     // A third of the way along, the next edge turns out to be blocked
+     int step = replanner.getPathLength() / 3;
+     int32_t here = replanner.getPath()[step];
+     int32_t ahead = routeEdge(replanner.getPath(), step);
+     
+     auto t0 = std::chrono::steady_clock::now();
+     replanner.setStart(here, straight);
+     setEdgeCost(ahead, ROUTE_BLOCKED);
+     bool repaired = replanner.replan(graph, straight);
+     auto t1 = std::chrono::steady_clock::now();
+     fresh.build(GRID_NODES, edgeCount, open);
+     auto t2 = std::chrono::steady_clock::now();
+     bool found = fresh.findPath(here, toGoal.goal, toGoal);
+     auto t3 = std::chrono::steady_clock::now();
+     
+     TEST_ASSERT_EQUAL(found, repaired);
+     if (!found) {
+       continue;
+     }
+     TEST_ASSERT_FLOAT_WITHIN(fresh.getPathCost() * 1e-4f + 1e-3f, fresh.getPathCost(), replanner.getPathCost());
+     repairUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+     rebuildUs += std::chrono::duration<double, std::micro>(t2 - t1).count();
+     freshUs += std::chrono::duration<double, std::micro>(t3 - t2).count();
+     repairExpanded += replanner.getExpandedCount();
+     freshExpanded += fresh.getExpandedCount();
+     reroutes++;
+   }
+   TEST_ASSERT_TRUE(reroutes > BENCH_ROUTES / 3);
+   TEST_ASSERT_LESS_THAN(freshExpanded, repairExpanded);
+   
+   char message[160];
+   snprintf(message, sizeof(message), "%d nodes, %d reroutes; first plan %.0f nodes expanded",
+            GRID_NODES, reroutes, (double)initialExpanded / reroutes);
+   TEST_MESSAGE(message);
+   snprintf(message, sizeof(message), "D* Lite repair %8.1f us, %6.0f nodes expanded",
+            repairUs / reroutes, (double)repairExpanded / reroutes);
+   TEST_MESSAGE(message);
+   snprintf(message, sizeof(message), "A* again      %8.1f us, %6.0f nodes expanded (+%.1f us CSR build)",
+            freshUs / reroutes, (double)freshExpanded / reroutes, rebuildUs / reroutes);
+   TEST_MESSAGE(message);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_small_graph);
+   RUN_TEST(test_matches_fresh_search);
+   RUN_TEST(test_benchmark_reroute);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,172 @@
+/*
+ * test_scan_scheduler.cpp
+ *
+ * Host unit tests for the staggered multi-sensor ping scheduler
+ */
+
+ #include <unity.h>
+ #include "../src/main/ScanScheduler.h"
+ 
+ // Run the scheduler for a while with a fast loop and record every ping
+ static int simulate(ScanScheduler& scheduler, uint32_t durationUs, uint32_t stepUs,
+                     uint32_t echoUs, int* fires, uint32_t* fireTimes, int maxFires) {
+   int count = 0;
+   uint32_t busyUntil = 0;
+   bool busy = false;
+   
+   for (uint32_t now = 0; now < durationUs; now += stepUs) {
+     busy = busy && now < busyUntil;
+     int sensor = scheduler.nextDue(now, busy);
+     if (sensor >= 0) {
+       scheduler.markFired(sensor, now);
+       busy = true;
+       busyUntil = now + echoUs;
+       if (count < maxFires) {
+         fires[count] = sensor;
+         fireTimes[count] = now;
+       }
+       count++;
+     }
+   }
+   return count;
+ }
+ 
+ // Test the default plan for the two-sensor cane
+ void test_default_plan_rate() {
+   ScanScheduler scheduler;
+   TEST_ASSERT_TRUE(scheduler.configure(2, SCAN_DEFAULT_RANGE_CM, SCAN_DEFAULT_QUIET_US));
+   
+   // Every slot covers the burst, a full round trip and the quiet window
+   TEST_ASSERT_GREATER_OR_EQUAL(SCAN_BURST_US + ScanScheduler::rangeToListenUs(300) + 2000, scheduler.getSlotUs());
+   
+   // 20-30 Hz per sensor
+   TEST_ASSERT_GREATER_OR_EQUAL(20.0, scheduler.getSensorRateHz(0));
+   TEST_ASSERT_LESS_OR_EQUAL(30.0, scheduler.getSensorRateHz(0));
+   TEST_ASSERT_EQUAL_FLOAT(scheduler.getSensorRateHz(0), scheduler.getSensorRateHz(1));
+ }
+ 
+ // Test that pings alternate and never share the air
+ void test_staggered_pings() {
+   ScanScheduler scheduler;
+   scheduler.configure(2, 250, 2000);
+   
+   int fires[64];
+   uint32_t times[64];
+   int count = simulate(scheduler, 1000000, 100, 3000, fires, times, 64);
+   
+   // One second of scanning at the planned rate
+   int expected = 1000000 / scheduler.getSlotUs();
+   TEST_ASSERT_INT_WITHIN(1, expected, count);
+   
+   for (int i = 1; i < count && i < 64; i++) {
+     TEST_ASSERT_NOT_EQUAL(fires[i - 1], fires[i]);
+     TEST_ASSERT_GREATER_OR_EQUAL(scheduler.getSlotUs(), times[i] - times[i - 1]);
+   }
+ }
+ 
+ // Test that a ping still in flight holds the next slot
+ void test_busy_channel_blocks() {
+   ScanScheduler scheduler;
+   scheduler.configure(2, 250, 2000);
+   
+   TEST_ASSERT_EQUAL(0, scheduler.nextDue(0, false));
+   scheduler.markFired(0, 0);
+   
+   uint32_t slot = scheduler.getSlotUs();
+   TEST_ASSERT_EQUAL(-1, scheduler.nextDue(slot - 1, false));
+   TEST_ASSERT_EQUAL(-1, scheduler.nextDue(slot, true));
+   TEST_ASSERT_EQUAL(1, scheduler.nextDue(slot, false));
+ }
+ 
+ // Test that a stalled loop does not produce a burst of pings afterwards
+ void test_late_loop_no_burst() {
+   ScanScheduler scheduler;
+   scheduler.configure(2, 250, 2000);
+   uint32_t slot = scheduler.getSlotUs();
+   
+   scheduler.markFired(0, 0);
+   uint32_t late = 10 * slot;
+   TEST_ASSERT_EQUAL(1, scheduler.nextDue(late, false));
+   scheduler.markFired(1, late);
+   TEST_ASSERT_EQUAL(-1, scheduler.nextDue(late + 1, false));
+   TEST_ASSERT_EQUAL(0, scheduler.nextDue(late + slot, false));
+ }
+ 
+ // Test custom plans and per-sensor quiet windows with more sensors
+ void test_custom_plan() {
+   ScanScheduler scheduler;
+   TEST_ASSERT_TRUE(scheduler.configure(4, 200, 1500));
+   
+   uint8_t badIndex[] = {0, 1, 2, 4};
+   uint8_t missing[] = {0, 1, 2, 2};
+   uint8_t frontFirst[] = {0, 1, 0, 2, 0, 3};
+   TEST_ASSERT_FALSE(scheduler.setPlan(badIndex, 4));
+   TEST_ASSERT_FALSE(scheduler.setPlan(missing, 4));
+   TEST_ASSERT_TRUE(scheduler.setPlan(frontFirst, 6));
+   
+   // Sensor 0 gets three of six slots
+   TEST_ASSERT_FLOAT_WITHIN(0.01, 3 * scheduler.getSensorRateHz(1), scheduler.getSensorRateHz(0));
+   
+   int fires[12];
+   uint32_t times[12];
+   simulate(scheduler, 12 * scheduler.getSlotUs(), 50, 1000, fires, times, 12);
+   for (int i = 0; i < 12; i++) {
+     TEST_ASSERT_EQUAL(frontFirst[i % 6], fires[i]);
+   }
+   
+   // A long per-sensor quiet window delays that sensor's next slot
+   scheduler.configure(2, 200, 1500);
+   scheduler.setSensorQuiet(0, 5 * scheduler.getSlotUs());
+   scheduler.markFired(0, 0);
+   scheduler.markFired(1, scheduler.getSlotUs());
+   TEST_ASSERT_EQUAL(-1, scheduler.nextDue(3 * scheduler.getSlotUs(), false));
+   TEST_ASSERT_EQUAL(0, scheduler.nextDue(5 * scheduler.getSlotUs(), false));
+ }
+ 
+ // Test that an echo from the farthest range a sensor hears arrives before
+ // the next sensor starts listening, whatever the listen range
+ void test_quiet_covers_far_echo() {
+   const float ranges[] = {100, 250, SCAN_DEFAULT_RANGE_CM, SCAN_ECHO_RANGE_CM, 500};
+   const uint32_t quiets[] = {0, SCAN_DEFAULT_QUIET_US, 10000};
+   uint32_t farEchoUs = ScanScheduler::rangeToListenUs(SCAN_ECHO_RANGE_CM);
+   
+   for (int r = 0; r < 5; r++) {
+     for (int q = 0; q < 3; q++) {
+       ScanScheduler scheduler;
+       TEST_ASSERT_TRUE(scheduler.configure(2, ranges[r], quiets[q]));
+       TEST_ASSERT_GREATER_OR_EQUAL(farEchoUs, scheduler.getListenUs() + scheduler.getQuietUs());
+       TEST_ASSERT_GREATER_OR_EQUAL(quiets[q], scheduler.getQuietUs());
+       
+       int fires[8];
+       uint32_t times[8];
+       simulate(scheduler, 8 * scheduler.getSlotUs(), 50, 1000, fires, times, 8);
+       for (int i = 1; i < 8; i++) {
+         // The previous ping's far echo against the next sensor's listen window
+         TEST_ASSERT_LESS_OR_EQUAL(times[i] + SCAN_BURST_US, times[i - 1] + SCAN_BURST_US + farEchoUs);
+       }
+     }
+   }
+ }
+ 
+ // Test configuration limits
+ void test_configuration_limits() {
+   ScanScheduler scheduler;
+   TEST_ASSERT_FALSE(scheduler.configure(0, 300, 2000));
+   TEST_ASSERT_FALSE(scheduler.configure(SCAN_MAX_SENSORS + 1, 300, 2000));
+   TEST_ASSERT_EQUAL(-1, scheduler.nextDue(0, false));
+   TEST_ASSERT_TRUE(scheduler.configure(SCAN_MAX_SENSORS, 300, 2000));
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_default_plan_rate);
+   RUN_TEST(test_staggered_pings);
+   RUN_TEST(test_busy_channel_blocks);
+   RUN_TEST(test_late_loop_no_burst);
+   RUN_TEST(test_custom_plan);
+   RUN_TEST(test_quiet_covers_far_echo);
+   RUN_TEST(test_configuration_limits);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
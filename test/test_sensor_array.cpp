@@ -0,0 +1,109 @@
+/*
+ * test_sensor_array.cpp
+ *
+ * Host unit tests for the compile-time sensor array layout
+ */
+
+ #include <unity.h>
+ #include "../src/main/SensorArray.h"
+ 
+ typedef SensorArray<2,
+   SensorPinConfig<12, 13, 30, 0, 150, 50>,
+   SensorPinConfig<14, 15, 110, 0, 150, 50>
+ > TwoSensors;
+ 
+ typedef SensorArray<6,
+   SensorPinConfig<12, 13, 30, 0, 150, 50>,
+   SensorPinConfig<14, 15, 110, 0, 150, 50>,
+   SensorPinConfig<16, 17, 30, -35, 100, 40>,
+   SensorPinConfig<18, 19, 30, 35, 100, 40>,
+   SensorPinConfig<25, 26, 110, -35, 100, 40>,
+   SensorPinConfig<27, 32, 110, 35, 100, 40>
+ > SixSensors;
+ 
+ // Layout must be usable in constant expressions
+ static_assert(TwoSensors::FEATURE_COUNT == 10 + 2 * SPECTRAL_BANDS, "Two-sensor layout keeps the original 10 features first");
+ static_assert(SixSensors::FEATURE_COUNT == 30 + 6 * SPECTRAL_BANDS, "Feature count follows N");
+ static_assert(SixSensors::echoPins[5] == 32, "Pin tables are constexpr");
+ 
+ // Records what forEach visits
+ struct Visitor {
+   int indices[8];
+   int trigPins[8];
+   int count;
+   
+   template <typename Config>
+   void operator()(int index, Config) {
+     indices[count] = index;
+     trigPins[count] = Config::trigPin;
+     count++;
+   }
+ };
+ 
+ // Test that the two-sensor layout matches the original feature order
+ void test_two_sensor_layout() {
+   TEST_ASSERT_EQUAL(0, TwoSensors::distanceFeature(0));
+   TEST_ASSERT_EQUAL(1, TwoSensors::distanceFeature(1));
+   TEST_ASSERT_EQUAL(2, TwoSensors::heightDiffFeature(0));
+   TEST_ASSERT_EQUAL(3, TwoSensors::averageFeature());
+   TEST_ASSERT_EQUAL(4, TwoSensors::rateFeature(0));
+   TEST_ASSERT_EQUAL(5, TwoSensors::rateFeature(1));
+   TEST_ASSERT_EQUAL(6, TwoSensors::varianceFeature(0));
+   TEST_ASSERT_EQUAL(7, TwoSensors::varianceFeature(1));
+   TEST_ASSERT_EQUAL(8, TwoSensors::frequencyFeature(0));
+   TEST_ASSERT_EQUAL(9, TwoSensors::frequencyFeature(1));
+   TEST_ASSERT_EQUAL(10, TwoSensors::bandFeature(0, 0));
+   TEST_ASSERT_EQUAL(10 + SPECTRAL_BANDS, TwoSensors::bandFeature(1, 0));
+   TEST_ASSERT_EQUAL(TwoSensors::FEATURE_COUNT - 1, TwoSensors::bandFeature(1, SPECTRAL_BANDS - 1));
+ }
+ 
+ // Test that every feature slot is used exactly once for a larger array
+ void test_six_sensor_layout() {
+   int used[SixSensors::FEATURE_COUNT] = {0};
+   
+   for (int s = 0; s < SixSensors::COUNT; s++) {
+     used[SixSensors::distanceFeature(s)]++;
+     used[SixSensors::rateFeature(s)]++;
+     used[SixSensors::varianceFeature(s)]++;
+     used[SixSensors::frequencyFeature(s)]++;
+     for (int b = 0; b < SPECTRAL_BANDS; b++) {
+       used[SixSensors::bandFeature(s, b)]++;
+     }
+   }
+   for (int p = 0; p < SixSensors::COUNT - 1; p++) {
+     used[SixSensors::heightDiffFeature(p)]++;
+   }
+   used[SixSensors::averageFeature()]++;
+   
+   for (int i = 0; i < SixSensors::FEATURE_COUNT; i++) {
+     TEST_ASSERT_EQUAL(1, used[i]);
+   }
+ }
+ 
+ // Test the constexpr tables and compile-time iteration
+ void test_tables_and_for_each() {
+   TEST_ASSERT_EQUAL(-35, SixSensors::yawsDeg[2]);
+   TEST_ASSERT_EQUAL(110, SixSensors::heightsCm[4]);
+   TEST_ASSERT_EQUAL(40, SixSensors::dangersCm[3]);
+   TEST_ASSERT_EQUAL(150, SixSensors::warningsCm[0]);
+   
+   Visitor visitor;
+   visitor.count = 0;
+   SixSensors::forEach(visitor);
+   
+   TEST_ASSERT_EQUAL(6, visitor.count);
+   for (int i = 0; i < 6; i++) {
+     TEST_ASSERT_EQUAL(i, visitor.indices[i]);
+     TEST_ASSERT_EQUAL(SixSensors::trigPins[i], visitor.trigPins[i]);
+   }
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_two_sensor_layout);
+   RUN_TEST(test_six_sensor_layout);
+   RUN_TEST(test_tables_and_for_each);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,134 @@
+/*
+ * test_sliding_dft.cpp
+ *
+ * Host unit tests and per-sample benchmark for the sliding DFT
+ */
+
+ #include <unity.h>
+ #include <math.h>
+ #include <chrono>
+ #include <stdio.h>
+ #include "../src/main/SlidingDft.h"
+ 
+ #define SAMPLE_HZ 10.0
+ #define BENCH_STEPS 20000
+ 
+ // Walking past a pole: distance swings with the user's gait
+ float gaitSignal(int n, float hz, float amplitude) {
+   return 150 + amplitude * sin(2 * M_PI * hz * n / SAMPLE_HZ);
+ }
+ 
+ // Test that the sliding bins match a direct DFT of the window
+ void test_matches_direct_dft() {
+   SlidingDft<32, 8> dft;
+   float history[500];
+   
+   for (int n = 0; n < 500; n++) {
+     history[n] = 100 + 20 * sin(n * 0.7) + 7 * cos(n * 2.1) + (n % 5);
+     dft.push(history[n]);
+   }
+   
+   for (int k = 0; k < 8; k++) {
+     double re = 0, im = 0;
+     for (int m = 0; m < 32; m++) {
+       re += history[500 - 32 + m] * cos(2 * M_PI * (k + 1) * m / 32);
+       im -= history[500 - 32 + m] * sin(2 * M_PI * (k + 1) * m / 32);
+     }
+     double expected = (re * re + im * im) / (32.0 * 32.0);
+     TEST_ASSERT_FLOAT_WITHIN(expected * 1e-3 + 1e-3, expected, dft.power(k));
+   }
+ }
+ 
+ // Test that a gait-like oscillation is found in the right bin
+ void test_dominant_frequency() {
+   SlidingDft<64, 16> dft;
+   
+   for (int n = 0; n < 200; n++) {
+     dft.push(gaitSignal(n, 1.8, 15));
+   }
+   
+   typedef SlidingDft<64, 16> GaitDft;
+   float resolution = SAMPLE_HZ / 64;
+   TEST_ASSERT_FLOAT_WITHIN(resolution, 1.8, dft.dominantFrequency(SAMPLE_HZ));
+   TEST_ASSERT_FLOAT_WITHIN(0.001, 2 * resolution, GaitDft::binFrequency(1, SAMPLE_HZ));
+ }
+ 
+ // Test that a steady distance has no dominant frequency
+ void test_steady_distance() {
+   SlidingDft<64, 16> dft;
+   
+   for (int n = 0; n < 10; n++) {
+     dft.push(230);
+   }
+   TEST_ASSERT_EQUAL_FLOAT(0, dft.dominantFrequency(SAMPLE_HZ));
+   TEST_ASSERT_FLOAT_WITHIN(1e-3, 0, dft.bandEnergy(0, 15));
+ }
+ 
+ // Test that the energy sits in the band holding the oscillation
+ void test_band_energy() {
+   SlidingDft<64, 16> dft;
+   
+   for (int n = 0; n < 128; n++) {
+     dft.push(gaitSignal(n, 1.5625, 10));  // Bin 10 (index 9), band 2
+   }
+   
+   float bands[4];
+   for (int b = 0; b < 4; b++) {
+     bands[b] = dft.bandEnergy(b * 4, b * 4 + 3);
+   }
+   // A sinusoid of amplitude A has power A^2 / 4 in its bin
+   TEST_ASSERT_FLOAT_WITHIN(1, 25, bands[2]);
+   TEST_ASSERT_LESS_THAN(0.5, bands[0] + bands[1] + bands[3]);
+ }
+ 
+ // Test that long runs stay exact through the periodic recomputation
+ void test_long_run_stability() {
+   SlidingDft<64, 16> dft;
+   
+   for (int n = 0; n < 100000; n++) {
+     dft.push(gaitSignal(n, 1.25, 10) + (n % 7) * 0.1);
+   }
+   TEST_ASSERT_FLOAT_WITHIN(1, 25, dft.power(7));
+ }
+ 
+ // Per-sample cost at growing window lengths
+ template <int WINDOW>
+ double benchmark() {
+   static SlidingDft<WINDOW, 16> dft;
+   volatile float sink = 0;
+   
+   auto start = std::chrono::steady_clock::now();
+   for (int n = 0; n < BENCH_STEPS; n++) {
+     dft.push(gaitSignal(n & 1023, 1.8, 15));
+     sink += dft.power(n & 15);
+   }
+   auto end = std::chrono::steady_clock::now();
+   
+   double ns = std::chrono::duration<double, std::nano>(end - start).count() / BENCH_STEPS;
+   char message[64];
+   snprintf(message, sizeof(message), "window %3d, 16 bins: %6.1f ns/sample", WINDOW, ns);
+   TEST_MESSAGE(message);
+   return ns;
+ }
+ 
+ // Cost must follow the number of bins, not the window length
+ void test_benchmark_per_sample() {
+   double ns32 = benchmark<32>();
+   benchmark<64>();
+   double ns128 = benchmark<128>();
+   
+   TEST_ASSERT_LESS_THAN(ns32 * 2, ns128);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_matches_direct_dft);
+   RUN_TEST(test_dominant_frequency);
+   RUN_TEST(test_steady_distance);
+   RUN_TEST(test_band_energy);
+   RUN_TEST(test_long_run_stability);
+   RUN_TEST(test_benchmark_per_sample);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
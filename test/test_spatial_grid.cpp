@@ -0,0 +1,248 @@
+/*
+ * test_spatial_grid.cpp
+ *
+ * Host unit tests for the map grid index and a nearest-node benchmark
+ * against the linear scan it replaces
+ */
+
+ #include <unity.h>
+ #include <math.h>
+ #include <chrono>
+ #include <stdio.h>
+ #include "../src/main/SpatialGrid.h"
+ #include "test_random.h"
+ 
+ #define BASE_LAT 33.5731f
+ #define BASE_LNG -7.5898f
+ #define NODE_SPACING_M 5.0      // One node per 5 m x 5 m, like a walked map
+ #define BENCH_QUERIES 2000
+ #define BENCH_MAX_NODES 100000
+ 
+ float haversine(float lat1, float lng1, float lat2, float lng2) {
+   float dLat = (lat2 - lat1) * M_PI / 180;
+   float dLng = (lng2 - lng1) * M_PI / 180;
+   float a = sin(dLat / 2) * sin(dLat / 2) +
+             cos(lat1 * M_PI / 180) * cos(lat2 * M_PI / 180) * sin(dLng / 2) * sin(dLng / 2);
+   return 6371000.0 * 2 * atan2(sqrt(a), sqrt(1 - a));
+ }
+ 
+ static float nodeLat[BENCH_MAX_NODES];
+ static float nodeLng[BENCH_MAX_NODES];
+ 
+ // Scatter n nodes over a square that keeps the walked-map density
+ void scatter(int n) {
+   float sideM = sqrt((float)n) * NODE_SPACING_M;
+   for (int i = 0; i < n; i++) {
+     nodeLat[i] = BASE_LAT + nextUniform() * sideM / GRID_METERS_PER_DEG;
+     nodeLng[i] = BASE_LNG + nextUniform() * sideM / (GRID_METERS_PER_DEG * cos(BASE_LAT * M_PI / 180));
+   }
+ }
+ 
+ // Nearest node within a radius, the query MapSystem runs per GPS fix
+ struct Nearest {
+   float lat;
+   float lng;
+   float radius;
+   int index;
+   float distance;
+   int visits;
+   
+   Nearest(float queryLat, float queryLng, float maxDistance) {
+     lat = queryLat;
+     lng = queryLng;
+     radius = maxDistance;
+     index = -1;
+     distance = maxDistance;
+     visits = 0;
+   }
+   
+   bool operator()(int i) {
+     visits++;
+     float d = haversine(lat, lng, nodeLat[i], nodeLng[i]);
+     // Float coordinates collide at this density, so break ties by index
+     if (d < distance || (d == distance && (index < 0 || i < index))) {
+       distance = d;
+       index = i;
+     }
+     return true;
+   }
+ };
+ 
+ int linearNearest(int n, float lat, float lng, float radius) {
+   Nearest best(lat, lng, radius);
+   for (int i = 0; i < n; i++) {
+     best(i);
+   }
+   return best.index;
+ }
+ 
+ typedef SpatialGrid<4096, 1024> SmallGrid;
+ typedef SpatialGrid<BENCH_MAX_NODES, 65536> LargeGrid;
+ static SmallGrid smallGrid;
+ static LargeGrid largeGrid;
+ 
+ // Test that every entry within the radius is visited exactly once
+ template <typename Grid>
+ void checkRadius(Grid& grid, int n, float lat, float lng, float radius) {
+   static int seen[4096];
+   for (int i = 0; i < n; i++) {
+     seen[i] = 0;
+   }
+   
+   struct Mark {
+     int* seen;
+     bool operator()(int i) { seen[i]++; return true; }
+   } mark = {seen};
+   grid.forEachNear(lat, lng, radius, mark);
+   
+   for (int i = 0; i < n; i++) {
+     TEST_ASSERT_TRUE(seen[i] <= 1);
+     if (haversine(lat, lng, nodeLat[i], nodeLng[i]) <= radius) {
+       TEST_ASSERT_EQUAL(1, seen[i]);
+     }
+   }
+ }
+ 
+ void test_radius_queries_match_scan() {
+   scatter(3000);
+   smallGrid.clear();
+   for (int i = 0; i < 3000; i++) {
+     smallGrid.insert(i, nodeLat[i], nodeLng[i]);
+   }
+   TEST_ASSERT_EQUAL(3000, smallGrid.size());
+   
+   for (int q = 0; q < 200; q++) {
+     int i = q * 13;
+     checkRadius(smallGrid, 3000, nodeLat[i], nodeLng[i], 3 + q % 40);
+   }
+   // Large enough to take the walk-all-buckets path
+   checkRadius(smallGrid, 3000, BASE_LAT, BASE_LNG, 400);
+ }
+ 
+ // Test that removed nodes are no longer found and others still are
+ void test_remove_and_move() {
+   scatter(500);
+   smallGrid.clear();
+   for (int i = 0; i < 500; i++) {
+     smallGrid.insert(i, nodeLat[i], nodeLng[i]);
+   }
+   
+   for (int i = 0; i < 500; i += 2) {
+     TEST_ASSERT_TRUE(smallGrid.remove(i));
+   }
+   TEST_ASSERT_FALSE(smallGrid.remove(0));
+   TEST_ASSERT_EQUAL(250, smallGrid.size());
+   
+   for (int i = 0; i < 500; i++) {
+     Nearest near(nodeLat[i], nodeLng[i], 0.01);
+     smallGrid.forEachNear(nodeLat[i], nodeLng[i], 0.01, near);
+     TEST_ASSERT_EQUAL(i % 2 == 0 ? -1 : i, near.index);
+   }
+   
+   // Move a node across the map
+   nodeLat[1] = BASE_LAT - 0.01f;
+   smallGrid.move(1, nodeLat[1], nodeLng[1]);
+   Nearest near(nodeLat[1], nodeLng[1], 1);
+   smallGrid.forEachNear(nodeLat[1], nodeLng[1], 1, near);
+   TEST_ASSERT_EQUAL(1, near.index);
+   TEST_ASSERT_EQUAL(250, smallGrid.size());
+ }
+ 
+ // Test that nodes far outside the cell range are still found
+ void test_far_from_origin() {
+   smallGrid.clear();
+   nodeLat[0] = BASE_LAT;
+   nodeLng[0] = BASE_LNG;
+   nodeLat[1] = BASE_LAT + 10;
+   nodeLng[1] = BASE_LNG + 20;
+   smallGrid.insert(0, nodeLat[0], nodeLng[0]);
+   smallGrid.insert(1, nodeLat[1], nodeLng[1]);
+   
+   Nearest near(nodeLat[1], nodeLng[1], 5);
+   smallGrid.forEachNear(nodeLat[1], nodeLng[1], 5, near);
+   TEST_ASSERT_EQUAL(1, near.index);
+ }
+ 
+ // Test that a visitor can stop the query early
+ void test_early_stop() {
+   scatter(100);
+   smallGrid.clear();
+   for (int i = 0; i < 100; i++) {
+     smallGrid.insert(i, BASE_LAT, BASE_LNG);
+   }
+   
+   struct First {
+     int visits;
+     bool operator()(int i) { visits++; return false; }
+   } first = {0};
+   smallGrid.forEachNear(BASE_LAT, BASE_LNG, 5, first);
+   TEST_ASSERT_EQUAL(1, first.visits);
+ }
+ 
+ // Microseconds per nearest-node query at a given map size
+ void benchmark(int n, double& linearUs, double& gridUs) {
+   scatter(n);
+   largeGrid.clear();
+   for (int i = 0; i < n; i++) {
+     largeGrid.insert(i, nodeLat[i], nodeLng[i]);
+   }
+   
+   volatile int sink = 0;
+   int queries = n > 10000 ? BENCH_QUERIES / 10 : BENCH_QUERIES;
+   
+   auto start = std::chrono::steady_clock::now();
+   for (int q = 0; q < queries; q++) {
+     int i = (q * 7919) % n;
+     sink += linearNearest(n, nodeLat[i] + 2e-5f, nodeLng[i], 5);
+   }
+   auto middle = std::chrono::steady_clock::now();
+   for (int q = 0; q < queries; q++) {
+     int i = (q * 7919) % n;
+     Nearest near(nodeLat[i] + 2e-5f, nodeLng[i], 5);
+     largeGrid.forEachNear(near.lat, near.lng, 5, near);
+     sink += near.index;
+   }
+   auto end = std::chrono::steady_clock::now();
+   
+   linearUs = std::chrono::duration<double, std::micro>(middle - start).count() / queries;
+   gridUs = std::chrono::duration<double, std::micro>(end - middle).count() / queries;
+   
+   // Both must agree on the answer
+   for (int q = 0; q < 50; q++) {
+     int i = (q * 7919) % n;
+     Nearest near(nodeLat[i] + 2e-5f, nodeLng[i], 5);
+     largeGrid.forEachNear(near.lat, near.lng, 5, near);
+     TEST_ASSERT_EQUAL(linearNearest(n, near.lat, near.lng, 5), near.index);
+   }
+   
+   char message[96];
+   snprintf(message, sizeof(message), "%6d nodes: linear %9.2f us, grid %6.2f us per nearest query",
+            n, linearUs, gridUs);
+   TEST_MESSAGE(message);
+ }
+ 
+ // Grid queries must stay flat while the linear scan grows with the map
+ void test_benchmark_nearest() {
+   const int sizes[] = {500, 1000, 10000, 50000, BENCH_MAX_NODES};
+   double linearUs[5];
+   double gridUs[5];
+   
+   for (int s = 0; s < 5; s++) {
+     benchmark(sizes[s], linearUs[s], gridUs[s]);
+   }
+   
+   TEST_ASSERT_LESS_THAN(linearUs[2] / 10, gridUs[2]);
+   TEST_ASSERT_LESS_THAN(gridUs[0] * 10 + 1, gridUs[4]);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_radius_queries_match_scan);
+   RUN_TEST(test_remove_and_move);
+   RUN_TEST(test_far_from_origin);
+   RUN_TEST(test_early_stop);
+   RUN_TEST(test_benchmark_nearest);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,93 @@
+/*
+ * test_tflite_backend.cpp
+ *
+ * Host tests and latency benchmark for the TFLite Micro backend. Build
+ * with -DSMARTGUIDE_USE_TFLITE against a tflite-micro tree generated by
+ * tensorflow/lite/micro/tools/project_generation/create_tflm_tree.py
+ * and src/main/model_data.cpp. Without the flag only the fallback
+ * is checked.
+ */
+
+ #include <unity.h>
+ #include <chrono>
+ #include <stdio.h>
+ #include "../src/main/TfliteBackend.h"
+ 
+ #define FEATURE_COUNT 18
+ #define WINDOW 8
+ #define BENCH_RUNS 1000
+ 
+ // Test that the backend loads the model or reports that it is unavailable
+ void test_begin() {
+   TfliteBackend backend;
+ #ifdef SMARTGUIDE_USE_TFLITE
+   TEST_ASSERT_TRUE(backend.begin(FEATURE_COUNT * WINDOW));
+   TEST_ASSERT_TRUE(backend.isReady());
+   TEST_ASSERT_TRUE(backend.getStatus() == ModelStatus::READY);
+   TEST_ASSERT_TRUE(backend.getArenaUsedBytes() > 0);
+   TEST_ASSERT_TRUE(backend.getArenaUsedBytes() <= backend.getArenaBytes());
+   TEST_ASSERT_EQUAL(8, backend.getClassCount());
+   
+   // Wrong input size is refused
+   TfliteBackend mismatched;
+   TEST_ASSERT_FALSE(mismatched.begin(FEATURE_COUNT * WINDOW + 1));
+   TEST_ASSERT_TRUE(mismatched.getStatus() == ModelStatus::BAD_TENSORS);
+ #else
+   TEST_ASSERT_FALSE(backend.begin(FEATURE_COUNT * WINDOW));
+   TEST_ASSERT_FALSE(backend.isReady());
+   TEST_ASSERT_TRUE(backend.getStatus() == ModelStatus::NOT_BUILT);
+   
+   int bestClass;
+   float confidence;
+   TEST_ASSERT_FALSE(backend.invoke(bestClass, confidence));
+ #endif
+ }
+ 
+ // Per-inference latency and arena usage
+ void test_benchmark_inference() {
+ #ifdef SMARTGUIDE_USE_TFLITE
+   TfliteBackend backend;
+   TEST_ASSERT_TRUE(backend.begin(FEATURE_COUNT * WINDOW));
+   
+   int8_t* input = backend.getInput();
+   double worstUs = 0;
+   double totalUs = 0;
+   
+   for (int run = 0; run < BENCH_RUNS; run++) {
+     for (int i = 0; i < FEATURE_COUNT * WINDOW; i++) {
+       input[i] = (int8_t)((i * 37 + run * 11) % 256 - 128);
+     }
+     
+     int bestClass;
+     float confidence;
+     auto start = std::chrono::steady_clock::now();
+     TEST_ASSERT_TRUE(backend.invoke(bestClass, confidence));
+     auto end = std::chrono::steady_clock::now();
+     
+     TEST_ASSERT_TRUE(bestClass >= 0 && bestClass < backend.getClassCount());
+     TEST_ASSERT_TRUE(confidence >= 0 && confidence <= 1.01);
+     
+     double us = std::chrono::duration<double, std::micro>(end - start).count();
+     totalUs += us;
+     if (us > worstUs) {
+       worstUs = us;
+     }
+   }
+   
+   char message[128];
+   snprintf(message, sizeof(message), "inference: mean %.1f us, worst %.1f us, arena %u of %u bytes",
+            totalUs / BENCH_RUNS, worstUs, (unsigned)backend.getArenaUsedBytes(), (unsigned)backend.getArenaBytes());
+   TEST_MESSAGE(message);
+ #else
+   TEST_IGNORE_MESSAGE("Built without SMARTGUIDE_USE_TFLITE");
+ #endif
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_begin);
+   RUN_TEST(test_benchmark_inference);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
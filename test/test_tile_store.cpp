@@ -0,0 +1,337 @@
+/*
+ * test_tile_store.cpp
+ *
+ * Host unit tests for the paged tile store and the tiled route search,
+ * on a synthetic 4 km street lattice held in a memory-backed archive
+ */
+
+ #include <unity.h>
+ #include <math.h>
+ #include <chrono>
+ #include <stdio.h>
+ #include <vector>
+ #include <algorithm>
+ #include "../src/main/TileStore.h"
+ #include "../src/main/TileRouter.h"
+ #include "../src/main/RoutePlanner.h"
+ 
+ #define BASE_LAT 33.5731f
+ #define BASE_LNG -7.5898f
+ #define CITY_SIDE 200               // 200 x 200 street corners
+ #define CITY_NODES (CITY_SIDE * CITY_SIDE)
+ #define CITY_SPACING_M 20.0
+ #define TILE_DEG_E7 20000           // 0.002 degrees, about 220 m
+ #define SLOTS 4
+ #define TILE_NODES 256
+ #define TILE_EDGES 1024
+ 
+ // Archive bytes with the seek/read/write shape of an SD File
+ struct MemoryFile {
+   std::vector<uint8_t> bytes;
+   size_t position;
+   uint32_t seeks;
+   
+   MemoryFile() : position(0), seeks(0) {}
+   size_t write(const uint8_t* data, size_t length) {
+     bytes.insert(bytes.end(), data, data + length);
+     return length;
+   }
+   bool seek(uint32_t offset) {
+     seeks++;
+     position = offset;
+     return offset <= bytes.size();
+   }
+   int read(uint8_t* data, size_t length) {
+     size_t count = std::min(length, bytes.size() - position);
+     memcpy(data, bytes.data() + position, count);
+     position += count;
+     return count;
+   }
+ };
+ 
+ typedef TileStore<MemoryFile, SLOTS, TILE_NODES, TILE_EDGES> Tiles;
+ 
+ static float nodeLat[CITY_NODES];
+ static float nodeLng[CITY_NODES];
+ static std::vector<int> neighbours[CITY_NODES];
+ static TileRef nodeRef[CITY_NODES];
+ static MemoryFile archive;
+ static Tiles tiles;
+ static TileRouter<16384> router;
+ 
+ float haversine(float lat1, float lng1, float lat2, float lng2) {
+   float dLat = (lat2 - lat1) * M_PI / 180;
+   float dLng = (lng2 - lng1) * M_PI / 180;
+   float a = sin(dLat / 2) * sin(dLat / 2) +
+             cos(lat1 * M_PI / 180) * cos(lat2 * M_PI / 180) * sin(dLng / 2) * sin(dLng / 2);
+   return 6371000.0 * 2 * atan2(sqrt(a), sqrt(1 - a));
+ }
+ 
+ static TileKey keyOf(float lat, float lng) {
+   double deg = TILE_DEG_E7 / 1e7;
+   TileKey key = {(int32_t)floor((lng + 180.0) / deg), (int32_t)floor((lat + 90.0) / deg)};
+   return key;
+ }
+ 
+ static bool keyLess(const TileKey& a, const TileKey& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); }
+ 
+ // A street lattice with every fifth block missing a side, written as an archive
+ static void buildCity() {
+   double degLat = CITY_SPACING_M / 111195.0;
+   double degLng = degLat / cos(BASE_LAT * M_PI / 180);
+   for (int n = 0; n < CITY_NODES; n++) {
+     // Store coordinates as the archive will return them
+     nodeLat[n] = MapFile::fromFixed(MapFile::toFixed(BASE_LAT + (n / CITY_SIDE) * degLat));
+     nodeLng[n] = MapFile::fromFixed(MapFile::toFixed(BASE_LNG + (n % CITY_SIDE) * degLng));
+   }
+   for (int n = 0; n < CITY_NODES; n++) {
+     int x = n % CITY_SIDE, y = n / CITY_SIDE;
+     if (x + 1 < CITY_SIDE && (x * 7 + y) % 5 != 0) {
+       neighbours[n].push_back(n + 1);
+       neighbours[n + 1].push_back(n);
+     }
+     if (y + 1 < CITY_SIDE) {
+       neighbours[n].push_back(n + CITY_SIDE);
+       neighbours[n + CITY_SIDE].push_back(n);
+     }
+   }
+   
+   // Group nodes by tile, in archive order
+   std::vector<TileKey> keys;
+   std::vector<std::vector<int> > members;
+   std::vector<int> order(CITY_NODES);
+   for (int n = 0; n < CITY_NODES; n++) {
+     order[n] = n;
+   }
+   std::stable_sort(order.begin(), order.end(), [](int a, int b) {
+     return keyLess(keyOf(nodeLat[a], nodeLng[a]), keyOf(nodeLat[b], nodeLng[b]));
+   });
+   for (int n : order) {
+     TileKey key = keyOf(nodeLat[n], nodeLng[n]);
+     if (keys.empty() || keyLess(keys.back(), key)) {
+       keys.push_back(key);
+       members.push_back(std::vector<int>());
+     }
+     TileRef ref = {key.x, key.y, (uint16_t)members.back().size()};
+     nodeRef[n] = ref;
+     members.back().push_back(n);
+   }
+   
+   TileWriter writer;
+   archive = MemoryFile();
+   writer.writeHeader(archive, keys.size(), TILE_DEG_E7);
+   for (size_t t = 0; t < keys.size(); t++) {
+     int edges = 0;
+     for (int n : members[t]) {
+       edges += neighbours[n].size();
+     }
+     writer.writeIndex(archive, keys[t], members[t].size(), edges);
+   }
+   for (size_t t = 0; t < keys.size(); t++) {
+     int edges = 0;
+     for (int n : members[t]) {
+       edges += neighbours[n].size();
+     }
+     writer.beginTile(archive, members[t].size(), edges);
+     for (int n : members[t]) {
+       writer.writeNode(archive, nodeLat[n], nodeLng[n], n % 50 == 0 ? NodeType::OBSTACLE : NodeType::PATH,
+                        n % 50 == 0 ? ObstacleType::POLE : ObstacleType::UNKNOWN);
+     }
+     for (int n : members[t]) {
+       for (int m : neighbours[n]) {
+         writer.writeEdge(archive, nodeRef[n].index, nodeRef[m].index, nodeRef[m].x - keys[t].x,
+                          nodeRef[m].y - keys[t].y, haversine(nodeLat[n], nodeLng[n], nodeLat[m], nodeLng[m]));
+       }
+     }
+     writer.endTile(archive);
+   }
+ }
+ 
+ static void attach() {
+   tiles.detach();
+   TEST_ASSERT_TRUE(tiles.attach(archive));
+ }
+ 
+ // Test that nodes read back and radius queries match a full scan
+ void test_archive_and_queries() {
+   buildCity();
+   attach();
+   TEST_ASSERT_GREATER_THAN(100, (int)tiles.getTileCount());
+   TEST_ASSERT_EQUAL(0, (int)tiles.getTruncatedTiles());
+   
+   float lat, lng;
+   for (int n = 0; n < CITY_NODES; n += 997) {
+     TEST_ASSERT_TRUE(tiles.getNode(nodeRef[n], lat, lng));
+     TEST_ASSERT_EQUAL_FLOAT(nodeLat[n], lat);
+     TEST_ASSERT_EQUAL_FLOAT(nodeLng[n], lng);
+   }
+   
+   // Circle straddling a tile corner
+   struct Collect {
+     float lat, lng, radius;
+     int found;
+     int obstacles;
+     
+     bool operator()(const TileRef& node, float nLat, float nLng, NodeType type, ObstacleType obstacle) {
+       if (haversine(lat, lng, nLat, nLng) <= radius) {
+         found++;
+         obstacles += type == NodeType::OBSTACLE;
+       }
+       return true;
+     }
+   } near = {nodeLat[100 * CITY_SIDE + 100], nodeLng[100 * CITY_SIDE + 100], 150, 0, 0};
+   tiles.forEachNear(near.lat, near.lng, near.radius, near);
+   
+   int expected = 0, expectedObstacles = 0;
+   for (int n = 0; n < CITY_NODES; n++) {
+     if (haversine(near.lat, near.lng, nodeLat[n], nodeLng[n]) <= near.radius) {
+       expected++;
+       expectedObstacles += n % 50 == 0;
+     }
+   }
+   TEST_ASSERT_EQUAL(expected, near.found);
+   TEST_ASSERT_EQUAL(expectedObstacles, near.obstacles);
+ }
+ 
+ // Test that the least recently used tile is the one replaced
+ void test_lru_eviction() {
+   attach();
+   float lat, lng;
+   int row = 100 * CITY_SIDE;
+   int step = 15;   // Columns per tile, roughly
+   
+   // Five different tiles through four slots
+   TileRef first = nodeRef[row];
+   for (int i = 0; i < 5; i++) {
+     tiles.getNode(nodeRef[row + i * step], lat, lng);
+   }
+   TEST_ASSERT_EQUAL(5, (int)tiles.getFaults());
+   TEST_ASSERT_FALSE(tiles.isResident(first.x, first.y));
+   
+   TileRef last = nodeRef[row + 4 * step];
+   tiles.getNode(last, lat, lng);
+   TEST_ASSERT_EQUAL(1, (int)tiles.getHits());
+   TEST_ASSERT_TRUE(tiles.isResident(last.x, last.y));
+ }
+ 
+ // Test that walking east after a prefetch finds its tiles resident
+ void test_heading_prefetch() {
+   attach();
+   
+   // Last corner before a tile edge, two blocks in from it
+   int start = 100 * CITY_SIDE + 20;
+   while (nodeRef[start + 2].x == nodeRef[start].x) {
+     start++;
+   }
+   tiles.prefetch(nodeLat[start], nodeLng[start], 90, 1.4f);
+   uint32_t faults = tiles.getFaults();
+   TEST_ASSERT_EQUAL(2, (int)faults);
+   
+   // One minute of walking at 1.4 m/s is about 4 blocks
+   float lat, lng;
+   for (int n = start; n <= start + 4; n++) {
+     tiles.getNode(nodeRef[n], lat, lng);
+   }
+   TEST_ASSERT_EQUAL(faults, tiles.getFaults());
+   
+   // Turning round loads the tile behind instead
+   start = 100 * CITY_SIDE + 20;
+   while (nodeRef[start - 2].x == nodeRef[start].x) {
+     start--;
+   }
+   TileRef behind = nodeRef[start - 2];
+   TEST_ASSERT_FALSE(tiles.isResident(behind.x, behind.y));
+   tiles.prefetch(nodeLat[start], nodeLng[start], 270, 1.4f);
+   TEST_ASSERT_TRUE(tiles.isResident(behind.x, behind.y));
+ }
+ 
+ // Test that a route across far more tiles than slots is optimal
+ void test_route_matches_in_memory_planner() {
+   static RoutePlanner<CITY_NODES, 2 * CITY_NODES> planner;
+   struct Reader {
+     std::vector<int32_t> source, target;
+     std::vector<float> weight;
+     
+     bool operator()(int i, int32_t& s, int32_t& t, float& w) {
+       s = source[i];
+       t = target[i];
+       w = weight[i];
+       return true;
+     }
+   } reader;
+   for (int n = 0; n < CITY_NODES; n++) {
+     for (int m : neighbours[n]) {
+       if (m > n) {
+         reader.source.push_back(n);
+         reader.target.push_back(m);
+         reader.weight.push_back(haversine(nodeLat[n], nodeLng[n], nodeLat[m], nodeLng[m]));
+       }
+     }
+   }
+   planner.build(CITY_NODES, reader.source.size(), reader);
+   
+   struct Zero {
+     float operator()(int32_t node) { return 0; }
+   } dijkstra;
+   
+   attach();
+   int routes[][2] = {{10 * CITY_SIDE + 10, 60 * CITY_SIDE + 70}, {5, 80 * CITY_SIDE + 3}, {0, 90 * CITY_SIDE + 90}};
+   char message[128];
+   for (int r = 0; r < 3; r++) {
+     int from = routes[r][0], to = routes[r][1];
+     TEST_ASSERT_TRUE(planner.findPath(from, to, dijkstra));
+     
+     uint32_t faults = tiles.getFaults(), hits = tiles.getHits();
+     auto begin = std::chrono::high_resolution_clock::now();
+     TileRouteStatus status = router.findPath(tiles, nodeRef[from], nodeRef[to]);
+     auto end = std::chrono::high_resolution_clock::now();
+     
+     TEST_ASSERT_EQUAL((int)TileRouteStatus::FOUND, (int)status);
+     TEST_ASSERT_FLOAT_WITHIN(0.5f, planner.getPathCost(), router.getPathCost());
+     TEST_ASSERT_TRUE(router.getPath()[0] == nodeRef[from]);
+     TEST_ASSERT_TRUE(router.getPath()[router.getPathLength() - 1] == nodeRef[to]);
+     
+     snprintf(message, sizeof(message), "%.0f m route: %.2f ms, %u expanded, %u tile faults, %u hits",
+              router.getPathCost(), std::chrono::duration<double, std::milli>(end - begin).count(),
+              (unsigned)router.getExpandedCount(), (unsigned)(tiles.getFaults() - faults),
+              (unsigned)(tiles.getHits() - hits));
+     TEST_MESSAGE(message);
+   }
+   
+   snprintf(message, sizeof(message), "%d-node map: %u bytes of tile slots, %u bytes of archive",
+            CITY_NODES, (unsigned)sizeof(Tiles), (unsigned)archive.bytes.size());
+   TEST_MESSAGE(message);
+ }
+ 
+ // Test that a damaged tile reads as empty and its neighbours still work
+ void test_corrupt_tile() {
+   TileRef victim = nodeRef[50 * CITY_SIDE + 50];
+   std::vector<uint8_t> saved = archive.bytes;
+   
+   // Find the victim's data through the index and damage its first node
+   uint32_t count = MapFile::get32(archive.bytes.data() + 8);
+   for (uint32_t i = 0; i < count; i++) {
+     const uint8_t* entry = archive.bytes.data() + TILE_HEADER_BYTES + i * TILE_INDEX_BYTES;
+     if ((int32_t)MapFile::get32(entry) == victim.x && (int32_t)MapFile::get32(entry + 4) == victim.y) {
+       archive.bytes[MapFile::get32(entry + 8) + 4] ^= 0xFF;
+     }
+   }
+   
+   attach();
+   float lat, lng;
+   TEST_ASSERT_FALSE(tiles.getNode(victim, lat, lng));
+   TEST_ASSERT_TRUE(tiles.getNode(nodeRef[10], lat, lng));
+   archive.bytes = saved;
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_archive_and_queries);
+   RUN_TEST(test_lru_eviction);
+   RUN_TEST(test_heading_prefetch);
+   RUN_TEST(test_route_matches_in_memory_planner);
+   RUN_TEST(test_corrupt_tile);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
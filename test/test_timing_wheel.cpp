@@ -0,0 +1,200 @@
+/*
+ * test_timing_wheel.cpp
+ *
+ * Host unit tests for the timing wheel: expiries reported exactly once,
+ * on time and in order, across big jumps and level boundaries, and the
+ * cost of a tick against scanning every obstacle
+ */
+
+ #include <unity.h>
+ #include <chrono>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include "../src/main/TimingWheel.h"
+ 
+ #define ENTRIES 5000
+ #define NOT_DUE 0xFFFFFFFFu
+ #define GPS_EPOCH_NOW 1760000000u   // October 2025, in Unix seconds
+ 
+ static TimingWheel<ENTRIES> wheel;
+ static uint32_t due[ENTRIES];        // Reference: expiry of each scheduled entry
+ 
+ struct Recorder {
+   uint32_t now;
+   uint32_t previous;
+   int reported;
+   bool inOrder;
+   
+   void operator()(int entry) {
+     TEST_ASSERT_NOT_EQUAL(NOT_DUE, due[entry]);
+     TEST_ASSERT_TRUE(due[entry] <= now);
+     inOrder = inOrder && due[entry] >= previous;
+     previous = due[entry];
+     due[entry] = NOT_DUE;
+     reported++;
+   }
+ };
+ 
+ static uint32_t randomDelay() {
+   switch (rand() % 5) {
+     case 0: return 1 + rand() % 100;
+     case 1: return 1 + rand() % 10000;
+     case 2: return 1 + rand() % (30 * 86400);
+     case 3: return 200u * 86400 + rand() % (200 * 86400);   // Past the top level
+     default: return 1 + rand() % 600;
+   }
+ }
+ 
+ static uint32_t randomStep() {
+   switch (rand() % 4) {
+     case 0: return 1;
+     case 1: return rand() % 120;
+     case 2: return rand() % 7200;
+     default: return rand() % (3 * 86400);
+   }
+ }
+ 
+ // Test against a plain array, across the 2^24 boundary and long gaps
+ void test_matches_reference() {
+   srand(17);
+   uint32_t now = (105u << 24) - 5000;
+   wheel.clear(now);
+   for (int i = 0; i < ENTRIES; i++) {
+     due[i] = NOT_DUE;
+   }
+   
+   for (int round = 0; round < 3000; round++) {
+     for (int op = 0; op < 8; op++) {
+       int entry = rand() % ENTRIES;
+       if (rand() % 4 == 0) {
+         wheel.cancel(entry);
+         due[entry] = NOT_DUE;
+       } else {
+         due[entry] = now + randomDelay();
+         wheel.schedule(entry, due[entry]);
+       }
+     }
+     
+     now += randomStep();
+     Recorder recorder = {now, 0, 0, true};
+     wheel.advance(now, recorder);
+     TEST_ASSERT_TRUE(recorder.inOrder);
+     
+     // Nothing due was left behind
+     int scheduled = 0;
+     for (int i = 0; i < ENTRIES; i++) {
+       TEST_ASSERT_TRUE(due[i] == NOT_DUE || due[i] > now);
+       TEST_ASSERT_EQUAL(due[i] != NOT_DUE, wheel.isScheduled(i));
+       scheduled += due[i] != NOT_DUE;
+     }
+     TEST_ASSERT_EQUAL(scheduled, wheel.getCount());
+   }
+   
+   // Far enough ahead, everything goes
+   now += 400u * 86400;
+   Recorder recorder = {now, 0, 0, true};
+   wheel.advance(now, recorder);
+   TEST_ASSERT_EQUAL(0, wheel.getCount());
+ }
+ 
+ // Test the edges: due now, already due, rescheduled and cancelled
+ void test_edges() {
+   wheel.clear(GPS_EPOCH_NOW);
+   for (int i = 0; i < 4; i++) {
+     due[i] = NOT_DUE;
+   }
+   Recorder recorder = {GPS_EPOCH_NOW, 0, 0, true};
+   
+   // Already due: reported on the next advance, even to the same time
+   due[0] = GPS_EPOCH_NOW - 10;
+   wheel.schedule(0, due[0]);
+   wheel.advance(GPS_EPOCH_NOW, recorder);
+   TEST_ASSERT_EQUAL(1, recorder.reported);
+   
+   // Due exactly at the time advanced to, not a second before
+   due[1] = GPS_EPOCH_NOW + 64;
+   wheel.schedule(1, due[1]);
+   recorder.now = GPS_EPOCH_NOW + 63;
+   wheel.advance(recorder.now, recorder);
+   TEST_ASSERT_EQUAL(1, recorder.reported);
+   recorder.now = GPS_EPOCH_NOW + 64;
+   wheel.advance(recorder.now, recorder);
+   TEST_ASSERT_EQUAL(2, recorder.reported);
+   
+   // Seen again: the later expiry replaces the earlier one
+   due[2] = GPS_EPOCH_NOW + 5000;
+   wheel.schedule(2, GPS_EPOCH_NOW + 100);
+   wheel.schedule(2, due[2]);
+   TEST_ASSERT_EQUAL(1, wheel.getCount());
+   recorder.now = GPS_EPOCH_NOW + 4999;
+   wheel.advance(recorder.now, recorder);
+   TEST_ASSERT_EQUAL(2, recorder.reported);
+   TEST_ASSERT_TRUE(wheel.isScheduled(2));
+   
+   // Cancelled entries are never reported, and time never goes back
+   wheel.cancel(2);
+   due[2] = NOT_DUE;
+   recorder.now = GPS_EPOCH_NOW + 100000;
+   wheel.advance(recorder.now, recorder);
+   TEST_ASSERT_EQUAL(2, recorder.reported);
+   wheel.advance(GPS_EPOCH_NOW, recorder);
+   TEST_ASSERT_EQUAL(GPS_EPOCH_NOW + 100000, wheel.getTime());
+ }
+ 
+ // A day of one-second ticks over a full map of obstacles, against a scan
+ void test_benchmark() {
+   static uint32_t expiry[ENTRIES];
+   const uint32_t ttls[] = {120, 600, 3600, 6 * 3600, 7 * 86400};
+   srand(23);
+   wheel.clear(GPS_EPOCH_NOW);
+   for (int i = 0; i < ENTRIES; i++) {
+     expiry[i] = due[i] = GPS_EPOCH_NOW + 1 + rand() % ttls[rand() % 5];
+     wheel.schedule(i, expiry[i]);
+   }
+   
+   // A full scan of every obstacle each tick, as without the wheel
+   volatile int scanned = 0;
+   auto begin = std::chrono::high_resolution_clock::now();
+   for (uint32_t now = GPS_EPOCH_NOW + 1; now <= GPS_EPOCH_NOW + 86400; now++) {
+     for (int i = 0; i < ENTRIES; i++) {
+       if (expiry[i] == now) {
+         scanned = scanned + 1;
+       }
+     }
+   }
+   auto middle = std::chrono::high_resolution_clock::now();
+   Recorder recorder = {0, 0, 0, true};
+   for (uint32_t now = GPS_EPOCH_NOW + 1; now <= GPS_EPOCH_NOW + 86400; now++) {
+     recorder.now = now;
+     wheel.advance(now, recorder);
+   }
+   auto end = std::chrono::high_resolution_clock::now();
+   
+   TEST_ASSERT_EQUAL(scanned, recorder.reported);
+   TEST_ASSERT_TRUE(recorder.inOrder);
+   
+   // The rest expire in one jump after a week switched off
+   recorder.now = GPS_EPOCH_NOW + 8 * 86400;
+   auto jumpBegin = std::chrono::high_resolution_clock::now();
+   wheel.advance(recorder.now, recorder);
+   auto jumpEnd = std::chrono::high_resolution_clock::now();
+   TEST_ASSERT_EQUAL(ENTRIES, recorder.reported);
+   
+   double scanUs = std::chrono::duration<double, std::micro>(middle - begin).count() / 86400;
+   double wheelUs = std::chrono::duration<double, std::micro>(end - middle).count() / 86400;
+   double jumpUs = std::chrono::duration<double, std::micro>(jumpEnd - jumpBegin).count();
+   char message[160];
+   snprintf(message, sizeof(message), "%d obstacles, 1 s tick: scan %.2f us, wheel %.3f us; 7-day jump %.0f us",
+            ENTRIES, scanUs, wheelUs, jumpUs);
+   TEST_MESSAGE(message);
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_matches_reference);
+   RUN_TEST(test_edges);
+   RUN_TEST(test_benchmark);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,150 @@
+/*
+ * test_ultrasonic_ranger.cpp
+ *
+ * Host unit tests for the interrupt-driven ranging state machine,
+ * driven by a simulated microsecond clock
+ */
+
+ #include <unity.h>
+ #include "../src/main/UltrasonicRanger.h"
+ 
+ // Simulate one complete echo: trigger, rise after the sensor's burst, fall after the round trip
+ static uint32_t runEcho(UltrasonicRanger& ranger, uint32_t now, uint32_t pulseUs) {
+   TEST_ASSERT_TRUE(ranger.startPing(now));
+   now += 460; // HC-SR04 burst before echo goes high
+   ranger.onEchoEdge(true, now);
+   now += pulseUs;
+   ranger.onEchoEdge(false, now);
+   return now;
+ }
+ 
+ // Test a normal echo cycle
+ void test_echo_cycle() {
+   UltrasonicRanger ranger;
+   RangeSample sample;
+   
+   TEST_ASSERT_EQUAL(UltrasonicRanger::IDLE, ranger.getState());
+   TEST_ASSERT_FALSE(ranger.readSample(sample));
+   
+   TEST_ASSERT_TRUE(ranger.startPing(1000));
+   TEST_ASSERT_EQUAL(UltrasonicRanger::TRIGGERED, ranger.getState());
+   TEST_ASSERT_FALSE(ranger.startPing(1010)); // Already in flight
+   
+   ranger.onEchoEdge(true, 1460);
+   TEST_ASSERT_EQUAL(UltrasonicRanger::ECHO_HIGH, ranger.getState());
+   ranger.poll(2000); // Not timed out yet
+   TEST_ASSERT_FALSE(ranger.readSample(sample));
+   
+   ranger.onEchoEdge(false, 1460 + 5882); // ~100cm
+   TEST_ASSERT_EQUAL(UltrasonicRanger::IDLE, ranger.getState());
+   TEST_ASSERT_TRUE(ranger.readSample(sample));
+   TEST_ASSERT_FLOAT_WITHIN(1, 100, sample.distanceCm);
+   TEST_ASSERT_EQUAL_UINT32(1460, sample.timestampUs);
+   TEST_ASSERT_FALSE(sample.timedOut);
+   TEST_ASSERT_FALSE(ranger.readSample(sample));
+ }
+ 
+ // Test several measurements queued before the consumer reads them
+ void test_multiple_samples() {
+   UltrasonicRanger ranger;
+   RangeSample sample;
+   uint32_t now = 0;
+   
+   now = runEcho(ranger, now, 2941) + 10000;  // ~50cm
+   now = runEcho(ranger, now, 11764) + 10000; // ~200cm
+   
+   TEST_ASSERT_TRUE(ranger.readSample(sample));
+   TEST_ASSERT_FLOAT_WITHIN(1, 50, sample.distanceCm);
+   TEST_ASSERT_TRUE(ranger.readSample(sample));
+   TEST_ASSERT_FLOAT_WITHIN(2, 200, sample.distanceCm);
+   TEST_ASSERT_FALSE(ranger.readSample(sample));
+ }
+ 
+ // Test timeout when no echo returns within range
+ void test_echo_timeout() {
+   UltrasonicRanger ranger;
+   RangeSample sample;
+   
+   TEST_ASSERT_TRUE(ranger.startPing(0));
+   ranger.onEchoEdge(true, 460);
+   ranger.poll(460 + RANGER_ECHO_TIMEOUT_US + 1);
+   
+   TEST_ASSERT_TRUE(ranger.readSample(sample));
+   TEST_ASSERT_TRUE(sample.timedOut);
+   TEST_ASSERT_FLOAT_WITHIN(0.1, 400, sample.distanceCm);
+   
+   // Echo line still high: no new ping until it falls
+   TEST_ASSERT_FALSE(ranger.startPing(30000));
+   
+   // Late falling edge must not publish a second sample
+   ranger.onEchoEdge(false, 38000);
+   TEST_ASSERT_FALSE(ranger.readSample(sample));
+   TEST_ASSERT_TRUE(ranger.startPing(40000));
+ }
+ 
+ // Test a sensor that never raises its echo line
+ void test_missing_echo() {
+   UltrasonicRanger ranger;
+   RangeSample sample;
+   
+   TEST_ASSERT_TRUE(ranger.startPing(0));
+   ranger.poll(RANGER_RISE_TIMEOUT_US);
+   TEST_ASSERT_FALSE(ranger.readSample(sample));
+   ranger.poll(RANGER_RISE_TIMEOUT_US + 1);
+   TEST_ASSERT_TRUE(ranger.readSample(sample));
+   TEST_ASSERT_TRUE(sample.timedOut);
+   TEST_ASSERT_EQUAL(UltrasonicRanger::IDLE, ranger.getState());
+ }
+ 
+ // Test that edges without a pending ping are ignored
+ void test_spurious_edges() {
+   UltrasonicRanger ranger;
+   RangeSample sample;
+   
+   ranger.onEchoEdge(true, 100);
+   ranger.onEchoEdge(false, 200);
+   TEST_ASSERT_EQUAL(UltrasonicRanger::IDLE, ranger.getState());
+   TEST_ASSERT_FALSE(ranger.readSample(sample));
+ }
+ 
+ // Test behaviour across the 32-bit micros() rollover
+ void test_clock_wraparound() {
+   UltrasonicRanger ranger;
+   RangeSample sample;
+   uint32_t now = 0xFFFFFF00;
+   
+   runEcho(ranger, now, 5882);
+   TEST_ASSERT_TRUE(ranger.readSample(sample));
+   TEST_ASSERT_FLOAT_WITHIN(1, 100, sample.distanceCm);
+   
+   TEST_ASSERT_TRUE(ranger.startPing(0xFFFFFFF0));
+   ranger.poll(0x00000100);
+   TEST_ASSERT_EQUAL(UltrasonicRanger::TRIGGERED, ranger.getState());
+ }
+ 
+ // Test overrun accounting when the consumer never reads
+ void test_buffer_overrun() {
+   UltrasonicRanger ranger;
+   uint32_t now = 0;
+   
+   for (int i = 0; i < 10; i++) {
+     now = runEcho(ranger, now, 2941) + 1000;
+   }
+   
+   // Ring holds size - 1 entries
+   TEST_ASSERT_EQUAL(3, ranger.getDroppedSamples());
+ }
+ 
+ int main(int argc, char **argv) {
+   UNITY_BEGIN();
+   
+   RUN_TEST(test_echo_cycle);
+   RUN_TEST(test_multiple_samples);
+   RUN_TEST(test_echo_timeout);
+   RUN_TEST(test_missing_echo);
+   RUN_TEST(test_spurious_edges);
+   RUN_TEST(test_clock_wraparound);
+   RUN_TEST(test_buffer_overrun);
+   
+   return UNITY_END();
+ }
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*
+ * mapmerge.cpp
+ *
+ * Merges the learned maps of several canes into one (see MapMerger.h).
+ * Each input is a copy of a cane's SD card, or just its map files
+ * (map_data.bin and the map_journal files); journals are replayed as on
+ * the device. Map files already in the output directory are replaced by
+ * a fresh snapshot and empty journal: copy both to each card in place of
+ * its map files.
+ *
+ *   g++ -O2 -std=c++11 -pthread -I src/main tools/mapmerge.cpp -o mapmerge
+ *   ./mapmerge merged_dir card1_dir card2_dir ...
+ *
+ * Set MAPMERGE_THREADS to use fewer cores. Maps written before the
+ * binary format (map_data.json) are converted by the cane on its next
+ * start; merge them after that.
+ */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <chrono>
+ #include <string>
+ #include <sys/stat.h>
+ #include <sys/resource.h>
+ #include "MapJournal.h"
+ #include "NameTable.h"
+ #include "MapMerger.h"
+ 
+ // Largest map a cane loads (MAX_MAP_NODES and friends in MapSystem.h,
+ // boards with PSRAM); a merged map over 1000 nodes needs such a board
+ #define MERGE_MAX_NODES 5000
+ #define MERGE_MAX_EDGES (MERGE_MAX_NODES * 3 / 2)
+ #define MERGE_SMALL_BOARD_NODES 1000
+ #define MERGE_NAME_POOL_BYTES 1024
+ #define MERGE_MAX_LANDMARKS 64
+ 
+ typedef MapStore<MERGE_MAX_NODES, MERGE_MAX_EDGES> Store;
+ typedef NameTable<MERGE_NAME_POOL_BYTES, MERGE_MAX_LANDMARKS> Names;
+ 
+ // stdio in the shape of an SD File
+ struct DirFile {
+   FILE* file;
+   
+   DirFile() : file(0) {}
+   operator bool() const { return file != 0; }
+   size_t read(uint8_t* data, size_t length) { return fread(data, 1, length, file); }
+   size_t write(const uint8_t* data, size_t length) { return fwrite(data, 1, length, file); }
+   void flush() { fflush(file); }
+   size_t size() {
+     long at = ftell(file);
+     fseek(file, 0, SEEK_END);
+     long end = ftell(file);
+     fseek(file, at, SEEK_SET);
+     return end;
+   }
+   void close() {
+     fclose(file);
+     file = 0;
+   }
+ };
+ 
+ // A directory standing in for the card's root
+ struct DirFS {
+   std::string root;
+   
+   std::string at(const char* path) const { return root + path; }
+   DirFile open(const char* path, const char* mode) {
+     DirFile handle;
+     handle.file = fopen(at(path).c_str(), mode[0] == 'w' ? "wb" : mode[0] == 'a' ? "ab" : "rb");
+     return handle;
+   }
+   bool exists(const char* path) const {
+     struct stat info;
+     return stat(at(path).c_str(), &info) == 0;
+   }
+   bool remove(const char* path) { return ::remove(at(path).c_str()) == 0; }
+   bool rename(const char* from, const char* to) { return ::rename(at(from).c_str(), at(to).c_str()) == 0; }
+ };
+ 
+ int main(int argc, char** argv) {
+   if (argc < 3) {
+     fprintf(stderr, "Usage: %s merged_dir card_dir...\n", argv[0]);
+     return 2;
+   }
+   const char* threads = getenv("MAPMERGE_THREADS");
+   Store* store = new Store();
+   Names* names = new Names();
+   
+   MapMerger merger;
+   for (int i = 2; i < argc; i++) {
+     DirFS card = {argv[i]};
+     MapJournal<DirFS> journal(card);
+     if (!journal.recover(*store, *names)) {
+       fprintf(stderr, "No readable map in %s\n", argv[i]);
+       return 1;
+     }
+     printf("%s: %d nodes, %d edges\n", argv[i], store->getLiveNodeCount(), store->getLiveEdgeCount());
+     merger.addMap(*store, *names);
+   }
+   
+   auto begin = std::chrono::steady_clock::now();
+   merger.merge(threads ? atoi(threads) : 0);
+   double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+   const MapMergeStats& stats = merger.getStats();
+   if (!merger.build(*store, *names)) {
+     fprintf(stderr, "The merged map does not fit a cane (%d nodes, %d edges, %d names at most)\n",
+             MERGE_MAX_NODES, MERGE_MAX_EDGES, MERGE_MAX_LANDMARKS);
+     return 1;
+   }
+   
+   mkdir(argv[1], 0755);
+   DirFS out = {argv[1]};
+   MapJournal<DirFS> journal(out);
+   journal.clear();
+   if (!journal.saveAll(*store, *names)) {
+     fprintf(stderr, "Cannot write the map to %s\n", argv[1]);
+     return 1;
+   }
+   struct rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+   printf("Merged %u maps (%u nodes, %u edges) on %u threads in %.3f s\n", stats.maps, stats.inputNodes,
+          stats.inputEdges, stats.threads, seconds);
+   printf("%u candidate pairs, %u nodes fused, %u obstacles expired, %u walked past\n", stats.pairs,
+          stats.fusedNodes, stats.expiredObstacles, stats.passedObstacles);
+   printf("Merged map: %u nodes, %u edges, peak resident %.1f MB\n", stats.nodes, stats.edges,
+          usage.ru_maxrss / 1024.0);
+   if (stats.nodes > MERGE_SMALL_BOARD_NODES) {
+     printf("Over %d nodes: only boards with PSRAM load all of it\n", MERGE_SMALL_BOARD_NODES);
+   }
+   return 0;
+ }
\ No newline at end of file
@@ -0,0 +1,73 @@
+/*
+ * osm2tiles.cpp
+ *
+ * Builds the base map archive for the SD card from an OpenStreetMap XML
+ * extract (see OsmImporter.h). Copy the output to /map_tiles.bin.
+ *
+ *   g++ -O2 -std=c++11 -I src/main tools/osm2tiles.cpp -o osm2tiles
+ *   ./osm2tiles city.osm map_tiles.bin [tile nodes] [tile edges]
+ *
+ * The tile limits default to the boards without PSRAM (MAP_TILE_NODES
+ * and MAP_TILE_EDGES in MapSystem.h), so the archive works on both.
+ */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <chrono>
+ #include <sys/resource.h>
+ #include "OsmImporter.h"
+ 
+ // stdio in the read/write shape of an SD File
+ struct StdioFile {
+   FILE* file;
+   
+   size_t read(uint8_t* data, size_t length) { return fread(data, 1, length, file); }
+   size_t write(const uint8_t* data, size_t length) { return fwrite(data, 1, length, file); }
+ };
+ 
+ static bool readPass(OsmImporter& importer, const char* path, bool ways) {
+   StdioFile in = {fopen(path, "rb")};
+   if (!in.file) {
+     fprintf(stderr, "Cannot open %s\n", path);
+     return false;
+   }
+   bool ok = ways ? importer.readWays(in) : importer.readNodes(in);
+   fclose(in.file);
+   return ok;
+ }
+ 
+ int main(int argc, char** argv) {
+   if (argc < 3) {
+     fprintf(stderr, "Usage: %s extract.osm map_tiles.bin [tile nodes] [tile edges]\n", argv[0]);
+     return 2;
+   }
+   uint32_t tileNodes = argc > 3 ? atoi(argv[3]) : 128;
+   uint32_t tileEdges = argc > 4 ? atoi(argv[4]) : 256;
+   
+   OsmImporter importer(tileNodes, tileEdges);
+   auto begin = std::chrono::steady_clock::now();
+   if (!readPass(importer, argv[1], true) || !readPass(importer, argv[1], false)) {
+     return 1;
+   }
+   size_t graphBytes = importer.getMemoryBytes();
+   
+   StdioFile out = {fopen(argv[2], "wb")};
+   if (!out.file || !importer.write(out) || fclose(out.file) != 0) {
+     fprintf(stderr, "Cannot write %s\n", argv[2]);
+     return 1;
+   }
+   double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+   
+   const OsmImportStats& stats = importer.getStats();
+   struct rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+   printf("Read %u nodes and %u ways (%.1f MB over two passes) in %.2f s, %.0f nodes/s\n", stats.osmNodes,
+          stats.osmWays, stats.bytesRead / 1e6, seconds, stats.osmNodes / seconds);
+   printf("Kept %u ways: %u nodes (%u thinned, %u missing), %u edges (%u too long)\n", stats.keptWays,
+          stats.nodes, stats.thinnedNodes, stats.missingNodes, stats.edges, stats.droppedEdges);
+   printf("%u tiles of %.4f degrees, fullest %u nodes and %u edge records, %u over the limits\n", stats.tiles,
+          stats.tileDegE7 / MAPFILE_COORD_SCALE, stats.fullestTileNodes, stats.fullestTileEdges,
+          stats.oversizedTiles);
+   printf("Graph memory %.1f MB, peak resident %.1f MB\n", graphBytes / 1e6, usage.ru_maxrss / 1024.0);
+   return 0;
+ }
\ No newline at end of file